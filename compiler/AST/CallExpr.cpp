@@ -242,6 +242,7 @@ void CallExpr::verify() {
     case PRIM_BLOCK_BEGIN:
     case PRIM_BLOCK_COBEGIN:
     case PRIM_BLOCK_COFORALL:
+    case PRIM_BLOCK_COFORALL_TEAM:
     case PRIM_BLOCK_ON:
     case PRIM_BLOCK_BEGIN_ON:
     case PRIM_BLOCK_COBEGIN_ON:
@@ -735,6 +736,19 @@ CallExpr* callChplHereAlloc(Type* type, VarSymbol* md) {
   return allocExpr;
 }
 
+// This is like callChplHereAlloc(), but the space comes from the
+// running task's arena.  See chpl_here_task_alloc().
+//
+// This function should be used *before* resolution
+CallExpr* callChplHereTaskAlloc(Type* type) {
+  INT_ASSERT(resolved == false);
+
+  CallExpr*  sizeExpr  = new CallExpr(PRIM_SIZEOF, new SymExpr(type->symbol));
+  VarSymbol* mdExpr    = newMemDesc(type);
+
+  return new CallExpr("chpl_here_task_alloc", sizeExpr, mdExpr);
+}
+
 // This insert normalized call expressions for allocation of enough
 // space to hold a variable of the given type.
 //
@@ -1554,6 +1554,72 @@ static BlockStmt* buildLoweredCoforall(Expr* indices,
 }
 
 
+// Does 'byref_vars' carry a reduce intent? Those are combined per loop
+// iteration by createTaskFunctions(), so they need the per-iteration form.
+static bool hasReduceTaskIntent(CallExpr* byref_vars) {
+  bool isMark = true;
+
+  if (byref_vars == NULL)
+    return false;
+
+  // The list alternates between an intent marker and the outer variable;
+  // a reduce intent has the reduce op in place of the marker.
+  for_actuals(actual, byref_vars) {
+    if (isMark) {
+      SymExpr* se = toSymExpr(actual);
+
+      if (se == NULL || isArgSymbol(se->symbol()) == false)
+        return true;
+    }
+
+    isMark = !isMark;
+  }
+
+  return false;
+}
+
+// Build up a coforall over a bounded range as a single task team. Rather
+// than one PRIM_BLOCK_COFORALL per iteration, the body is outlined once and
+// launched as numTasks tasks sharing one argument bundle. Each task
+// recovers its index from its position in the team.
+static BlockStmt* buildCoforallTeam(Expr* indices,
+                                    VarSymbol* iterator,
+                                    CallExpr* byref_vars,
+                                    BlockStmt* body) {
+  BlockStmt*  block         = new BlockStmt();
+  BlockStmt*  taskBlk       = new BlockStmt();
+  VarSymbol*  coforallCount = newTempConst("_coforallCount");
+  VarSymbol*  numTasks      = newTemp("numTasks");
+  CallExpr*   orderToIndex  = new CallExpr(".", iterator,
+                                           new_CStringSymbol("orderToIndex"));
+  CallExpr*   toIndex       = new CallExpr(orderToIndex,
+                                new CallExpr("chpl_task_getTeamIndex"));
+
+  taskBlk->insertAtHead(body);
+  destructureIndices(taskBlk, indices, toIndex, false);
+  taskBlk->insertAtTail(new CallExpr("_downEndCount", coforallCount, gNil));
+  taskBlk->blockInfoSet(new CallExpr(PRIM_BLOCK_COFORALL_TEAM));
+  addByrefVars(taskBlk, byref_vars);
+
+  block->insertAtTail(new DefExpr(coforallCount));
+  block->insertAtTail(new CallExpr(PRIM_MOVE, coforallCount,
+                                   new CallExpr("_endCountAlloc", gTrue)));
+  block->insertAtTail(new DefExpr(numTasks));
+  block->insertAtTail(new CallExpr(PRIM_MOVE, numTasks,
+                                   new CallExpr(".", iterator,
+                                                new_CStringSymbol("size"))));
+  block->insertAtTail(new CallExpr("_upTeamEndCount", coforallCount,
+                                   numTasks));
+  block->insertAtTail(taskBlk);
+  block->insertAtTail(new DeferStmt(new CallExpr("_endCountFree",
+                                                 coforallCount)));
+  block->insertAtTail(new CallExpr("_waitEndCount", coforallCount, gTrue,
+                                   numTasks));
+
+  return block;
+}
+
+
 // Build up AST for coforalls. For something like:
 //
 //     coforall indices in iterator with (byref_vars) { body(); }
@@ -1563,7 +1629,18 @@ static BlockStmt* buildLoweredCoforall(Expr* indices,
 //     var tmpIter = iterator;
 //     param bounded = isBoundedRange(tmpIter) || isDomain(tmpIter) || isArray(tmpIter);
 //     param useLocalEndCount, countRunningTasks = !bodyContainsOnStmt();
-//     if bounded {
+//     if isBoundedRange(tmpIter) && useTeam {
+//       var _coforallCount = _endCountAlloc(true);
+//       var numTasks = tmpIter.size;
+//       _upTeamEndCount(_coforallCount, numTasks);
+//       /* PRIM_BLOCK_COFORALL_TEAM (byref_vars) */ {
+//         const indices = tmpIter.orderToIndex(chpl_task_getTeamIndex());
+//         body();
+//         _downEndCount(_coforallCount, nil);
+//       }
+//       _waitEndCount(_coforallCount, true, numTasks);
+//       _endCountFree(_coforallCount);
+//     } else if bounded {
 //       var numTasks = tmpIter.size;
 //       var _coforallCount = _endCountAlloc(useLocalEndCount);
 //       // only bump EndCount once, instead of once per task
@@ -1597,6 +1674,10 @@ static BlockStmt* buildLoweredCoforall(Expr* indices,
 // they're available, we won't manipulate here.runningTaskCount, and we'll use
 // PRIM_BLOCK_COFORALL_ON instead of PRIM_BLOCK_COFORALL so that we just do
 // remote-forks instead of creating any tasks locally.
+//
+// useTeam holds when the loop is not zippered, has a single index, no 'on'
+// body and no reduce intents. The task team is spawned with one call to
+// chpl_taskListAddTeam() rather than once per iteration.
 BlockStmt* buildCoforallLoopStmt(Expr* indices,
                                  Expr* iterator,
                                  CallExpr* byref_vars,
@@ -1620,6 +1701,16 @@ BlockStmt* buildCoforallLoopStmt(Expr* indices,
   coforallBlk->insertAtTail(new DefExpr(tmpIter));
   coforallBlk->insertAtTail(new CallExpr(PRIM_MOVE, tmpIter, iterator));
 
+  bool useTeam = zippered == false &&
+                 isUnresolvedSymExpr(indices) &&
+                 findStmtWithTag(PRIM_BLOCK_ON, body) == NULL &&
+                 hasReduceTaskIntent(byref_vars) == false;
+
+  BlockStmt* teamCoforallBlk = NULL;
+  if (useTeam)
+    teamCoforallBlk = buildCoforallTeam(indices->copy(), tmpIter,
+                                        copyByrefVars(byref_vars),
+                                        body->copy());
   BlockStmt* vectorCoforallBlk = buildLoweredCoforall(indices, tmpIter, copyByrefVars(byref_vars), body->copy(), zippered, /*bounded=*/true);
   BlockStmt* nonVectorCoforallBlk = buildLoweredCoforall(indices, tmpIter, byref_vars, body, zippered, /*bounded=*/false);
 
@@ -1631,6 +1722,18 @@ BlockStmt* buildCoforallLoopStmt(Expr* indices,
                             new CallExpr("||", new CallExpr("isBoundedRange", tmpIter),
                             new CallExpr("||", new CallExpr("isDomain", tmpIter), new CallExpr("isArray", tmpIter)))));
 
+  if (useTeam) {
+    VarSymbol* isRng = newTemp("isRng");
+    isRng->addFlag(FLAG_MAYBE_PARAM);
+    coforallBlk->insertAtTail(new DefExpr(isRng));
+    coforallBlk->insertAtTail(new CallExpr(PRIM_MOVE, isRng,
+                              new CallExpr("isBoundedRange", tmpIter)));
+
+    vectorCoforallBlk = new BlockStmt(new CondStmt(new SymExpr(isRng),
+                                                   teamCoforallBlk,
+                                                   vectorCoforallBlk));
+  }
+
   coforallBlk->insertAtTail(new CondStmt(new SymExpr(isRngDomArr),
                                          vectorCoforallBlk,
                                          nonVectorCoforallBlk));
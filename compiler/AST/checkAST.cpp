@@ -256,6 +256,9 @@ void checkPrimitives()
      case PRIM_CHPL_COMM_REMOTE_PREFETCH:
      case PRIM_CHPL_COMM_GET_STRD:      // Direct calls to the Chapel comm layer for strided comm
      case PRIM_CHPL_COMM_PUT_STRD:      //  may eventually add others (e.g.: non-blocking)
+     case PRIM_COMM_STREAM_START:
+     case PRIM_COMM_STREAM_BASE:
+     case PRIM_COMM_STREAM_FINISH:
      case PRIM_ARRAY_ALLOC:
      case PRIM_ARRAY_FREE:
      case PRIM_ARRAY_GET:
@@ -271,6 +274,7 @@ void checkPrimitives()
      case PRIM_BLOCK_BEGIN:             // BlockStmt::blockInfo - begin block
      case PRIM_BLOCK_COBEGIN:           // BlockStmt::blockInfo - cobegin block
      case PRIM_BLOCK_COFORALL:          // BlockStmt::blockInfo - coforall block
+     case PRIM_BLOCK_COFORALL_TEAM:     // BlockStmt::blockInfo - coforall team
      case PRIM_BLOCK_ON:                // BlockStmt::blockInfo - on block
      case PRIM_BLOCK_BEGIN_ON:
      case PRIM_BLOCK_COBEGIN_ON:
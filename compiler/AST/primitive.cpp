@@ -154,6 +154,15 @@ returnInfoFirst(CallExpr* call) {
   return call->get(1)->qualType();
 }
 
+// the narrow version of the wide _ddata passed second
+static QualifiedType
+returnInfoStreamBase(CallExpr* call) {
+  Type* type = call->get(2)->typeInfo();
+  if (type->symbol->hasFlag(FLAG_WIDE_CLASS))
+    type = type->getField("addr")->type;
+  return QualifiedType(type, QUAL_VAL);
+}
+
 static QualifiedType
 returnInfoFirstDeref(CallExpr* call) {
   QualifiedType tmp = call->get(1)->qualType();
@@ -677,6 +686,12 @@ initPrimitive() {
   prim_def(PRIM_CHPL_COMM_GET_STRD, "chpl_comm_get_strd", returnInfoVoid, true, true);
   prim_def(PRIM_CHPL_COMM_PUT_STRD, "chpl_comm_put_strd", returnInfoVoid, true, true);
 
+  // (data, first, count) for a wide _ddata 'data'
+  prim_def(PRIM_COMM_STREAM_START, "comm_stream_start", returnInfoCVoidPtr, true, true);
+  // (stream, data, idx) returns a local _ddata holding element 'idx'
+  prim_def(PRIM_COMM_STREAM_BASE, "comm_stream_base", returnInfoStreamBase, true);
+  prim_def(PRIM_COMM_STREAM_FINISH, "comm_stream_finish", returnInfoVoid, true);
+
   prim_def(PRIM_ARRAY_SHIFT_BASE_POINTER, "shift_base_pointer", returnInfoVoid, true, true);
   prim_def(PRIM_ARRAY_ALLOC, "array_alloc", returnInfoVoid, true, true);
   prim_def(PRIM_ARRAY_FREE, "array_free", returnInfoVoid, true, true);
@@ -700,6 +715,7 @@ initPrimitive() {
   prim_def(PRIM_BLOCK_BEGIN, "begin block", returnInfoVoid);
   prim_def(PRIM_BLOCK_COBEGIN, "cobegin block", returnInfoVoid);
   prim_def(PRIM_BLOCK_COFORALL, "coforall loop", returnInfoVoid);
+  prim_def(PRIM_BLOCK_COFORALL_TEAM, "coforall team block", returnInfoVoid);
   prim_def(PRIM_BLOCK_ON, "on block", returnInfoVoid);
   prim_def(PRIM_BLOCK_BEGIN_ON, "begin on block", returnInfoVoid);
   prim_def(PRIM_BLOCK_COBEGIN_ON, "cobegin on block", returnInfoVoid);
@@ -42,6 +42,7 @@ AggregateType* dtTuple;
 // The well-known functions
 FnSymbol *gChplHereAlloc;
 FnSymbol *gChplHereFree;
+FnSymbol *gChplHereTaskAlloc;
 FnSymbol *gChplDecRunningTask;
 FnSymbol *gChplIncRunningTask;
 FnSymbol *gChplDoDirectExecuteOn;
@@ -198,6 +199,12 @@ static WellKnownFn sWellKnownFns[] = {
     FLAG_LOCALE_MODEL_FREE
   },
 
+  {
+    "chpl_here_task_alloc",
+    &gChplHereTaskAlloc,
+    FLAG_UNKNOWN
+  },
+
   {
     "chpl_taskRunningCntInc",
     &gChplIncRunningTask,
@@ -36,7 +36,34 @@
 #ifdef HAVE_LLVM
 
 
-static llvm::MDNode* generateLoopMetadata(bool addVectorizeEnableMetadata)
+// Returns what memory accesses in the body of a new parallel loop refer
+// to:  'node', this loop's own loop id or access group, if the loop is not
+// nested in another parallel loop, or else a list of 'enclosing', the
+// enclosing loop's entries, followed by 'node'.  Listing the enclosing
+// loops keeps them parallel too.
+static llvm::MDNode* nestInEnclosingLoops(llvm::MDNode* node,
+                                          llvm::MDNode* enclosing)
+{
+  GenInfo* info = gGenInfo;
+
+  if (enclosing == NULL)
+    return node;
+
+  // Only parallel loops are pushed on loopStack, so the enclosing loop's
+  // entry is a list exactly when that loop is nested itself.
+  std::vector<llvm::Metadata*> nodes;
+
+  if (info->loopStack.size() == 1)
+    nodes.push_back(enclosing);
+  else
+    nodes.insert(nodes.end(), enclosing->op_begin(), enclosing->op_end());
+
+  nodes.push_back(node);
+
+  return llvm::MDNode::get(info->module->getContext(), nodes);
+}
+
+static llvm::MDNode* generateLoopMetadata(llvm::MDNode* loopGroup)
 {
   GenInfo* info = gGenInfo;
   auto &ctx = info->module->getContext();
@@ -45,25 +72,30 @@ static llvm::MDNode* generateLoopMetadata(bool addVectorizeEnableMetadata)
   auto tmpNode        = llvm::MDNode::getTemporary(ctx, llvm::None);
   args.push_back(tmpNode.get());
 
+  // Loads and stores in the loop body are tagged with the loop's access
+  // group (see addParallelAccessMetadata), which tells LLVM there are no
+  // loop-carried dependencies between them, so it can vectorize without
+  // runtime alias checks.  LLVMs before 8 ignore this and go by
+  // llvm.mem.parallel_loop_access on the accesses instead.
+  llvm::Metadata *parallelAccesses[] = { llvm::MDString::get(ctx, "llvm.loop.parallel_accesses"),
+                                         loopGroup };
+  args.push_back(llvm::MDNode::get(ctx, parallelAccesses));
+
+#ifdef HAVE_LLVM_RV
   // llvm.loop.vectorize.enable metadata is only used by LoopVectorizer to:
   // 1) Explicitly disable vectorization of particular loop
   // 2) Print warning when vectorization is enabled (using metadata) and vectorization didn't occur
   // It is however required for the Region Vectorizer
-  if(addVectorizeEnableMetadata)
-  {
-    llvm::Metadata *loopVectorizeEnable[] = { llvm::MDString::get(ctx, "llvm.loop.vectorize.enable"),
-                                              llvm::ConstantAsMetadata::get(llvm::ConstantInt::get(llvm::Type::getInt1Ty(ctx), true))};
-    args.push_back(llvm::MDNode::get(ctx, loopVectorizeEnable));
-
-#ifdef HAVE_LLVM_RV
-    // Region Vectorizer needs loop width to be specified
-    llvm::Metadata *loopVectorWidth[] = { llvm::MDString::get(ctx, "llvm.loop.vectorize.width"),
-                                          llvm::ConstantAsMetadata::get(llvm::ConstantInt::get(llvm::Type::getInt32Ty(ctx), 8))};
-    args.push_back(llvm::MDNode::get(ctx, loopVectorWidth));
+  llvm::Metadata *loopVectorizeEnable[] = { llvm::MDString::get(ctx, "llvm.loop.vectorize.enable"),
+                                            llvm::ConstantAsMetadata::get(llvm::ConstantInt::get(llvm::Type::getInt1Ty(ctx), true))};
+  args.push_back(llvm::MDNode::get(ctx, loopVectorizeEnable));
+
+  // Region Vectorizer needs loop width to be specified
+  llvm::Metadata *loopVectorWidth[] = { llvm::MDString::get(ctx, "llvm.loop.vectorize.width"),
+                                        llvm::ConstantAsMetadata::get(llvm::ConstantInt::get(llvm::Type::getInt32Ty(ctx), 8))};
+  args.push_back(llvm::MDNode::get(ctx, loopVectorWidth));
 #endif
 
-  }
-
   llvm::MDNode *loopMetadata = llvm::MDNode::get(ctx, args);
   loopMetadata->replaceOperandWith(0, loopMetadata);
   return loopMetadata;
@@ -189,12 +221,20 @@ GenRet CForLoop::codegen()
 
     llvm::MDNode* loopMetadata = nullptr;
     if(fNoVectorize == false && isOrderIndependent()) {
-      bool addVectorizeEnable = false;
-#ifdef HAVE_LLVM_RV
-      addVectorizeEnable = true;
-#endif
-      loopMetadata = generateLoopMetadata(addVectorizeEnable);
-      info->loopStack.emplace(loopMetadata, true);
+      llvm::MDNode* loopGroup = llvm::MDNode::getDistinct(info->module->getContext(),
+                                                          llvm::None);
+      llvm::MDNode* outerLoops  = NULL;
+      llvm::MDNode* outerGroups = NULL;
+
+      if (!info->loopStack.empty()) {
+        outerLoops  = info->loopStack.top().parallelLoops;
+        outerGroups = info->loopStack.top().accessGroups;
+      }
+
+      loopMetadata = generateLoopMetadata(loopGroup);
+      info->loopStack.emplace(nestInEnclosingLoops(loopMetadata, outerLoops),
+                              nestInEnclosingLoops(loopGroup, outerGroups),
+                              true);
     }
 
     body.codegen("");
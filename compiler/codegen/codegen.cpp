@@ -787,11 +787,16 @@ static void genFilenameTable() {
 // chpl_funSymTable     = cname, Chapel name
 // chpl_filenumSymTable = Chapel file name index, Chapel line number
 //
+// Besides the stack unwinder, the runtime's sampling profiler uses
+// these tables to attribute samples to Chapel functions, so they are
+// also filled in when --sample-profile is thrown.
+//
 static void genUnwindSymbolTable(){
   std::vector<FnSymbol*> symbols;
 
-  //If CHPL_UNWIND is none we don't want any symbols in our tables
-  if(strcmp(CHPL_UNWIND, "none") != 0){
+  //If CHPL_UNWIND is none and there is no profiling support
+  //we don't want any symbols in our tables
+  if(strcmp(CHPL_UNWIND, "none") != 0 || fSampleProfile){
     // Gets only user symbols
     forv_Vec(FnSymbol, fn, gFnSymbols) {
       if(strncmp(fn->name, "chpl_", 5) || fn->hasFlag(FLAG_MODULE_INIT)) {
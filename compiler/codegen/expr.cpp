@@ -439,6 +439,27 @@ void codegenInvariantStart(llvm::Value *val, llvm::Value *addr)
   info->irBuilder->CreateCall(invariantStart, args);
 }
 
+// Mark a memory access in the body of a parallel (order independent)
+// loop as having no loop-carried dependencies with the other accesses
+// of that loop and of any enclosing parallel loops.
+static
+void addParallelAccessMetadata(llvm::Instruction* access)
+{
+  GenInfo* info = gGenInfo;
+
+  if (info->loopStack.empty() || !info->loopStack.top().parallel)
+    return;
+
+  const LoopData& loopData = info->loopStack.top();
+
+  // LLVM 8 and later go by the access groups, earlier versions by
+  // llvm.mem.parallel_loop_access.  Both are emitted for every version,
+  // so the IR does not depend on which LLVM the compiler was built with.
+  access->setMetadata("llvm.mem.parallel_loop_access",
+                      loopData.parallelLoops);
+  access->setMetadata("llvm.access.group", loopData.accessGroups);
+}
+
 // Create an LLVM store instruction possibly adding
 // appropriate metadata based upon the Chapel type of val.
 //
@@ -467,14 +488,7 @@ llvm::StoreInst* codegenStoreLLVM(llvm::Value* val,
   }
   if( tbaa ) ret->setMetadata(llvm::LLVMContext::MD_tbaa, tbaa);
 
-  if(!info->loopStack.empty()) {
-    const auto &loopData = info->loopStack.top();
-    // Currently, the parallel_loop_access metadata refers to the
-    // innermost loop the instruction is in, while for some cases
-    // this could refer to the group of loops it is in.
-    if(loopData.parallel)
-      ret->setMetadata("llvm.mem.parallel_loop_access", loopData.loopMetadata);
-  }
+  addParallelAccessMetadata(ret);
 
   if(addInvariantStart)
     codegenInvariantStart(val, ptr);
@@ -540,11 +554,7 @@ llvm::LoadInst* codegenLoadLLVM(llvm::Value* ptr,
     }
   }
 
-  if(!info->loopStack.empty()) {
-    const auto &loopData = info->loopStack.top();
-    if(loopData.parallel)
-      ret->setMetadata(llvm::StringRef("llvm.mem.parallel_loop_access"), loopData.loopMetadata);
-  }
+  addParallelAccessMetadata(ret);
 
   if( tbaa ) ret->setMetadata(llvm::LLVMContext::MD_tbaa, tbaa);
   return ret;
@@ -2821,6 +2831,8 @@ void codegenCallMemcpy(GenRet dest, GenRet src, GenRet size,
     // Adding scalar tbaa metadata here causes incorrect code to be generated.
     if( tbaaStructTag )
       CI->setMetadata(llvm::LLVMContext::MD_tbaa_struct, tbaaStructTag);
+
+    addParallelAccessMetadata(CI);
 #endif
   }
 }
@@ -3394,7 +3406,10 @@ GenRet CallExpr::codegen() {
     codegenInvokeTaskFun("chpl_taskListAddBegin");
 
   } else if (fn->hasFlag(FLAG_COBEGIN_OR_COFORALL_BLOCK) == true)  {
-    codegenInvokeTaskFun("chpl_taskListAddCoStmt");
+    if (fn->hasFlag(FLAG_COFORALL_TEAM))
+      codegenInvokeTaskFun("chpl_taskListAddTeam");
+    else
+      codegenInvokeTaskFun("chpl_taskListAddCoStmt");
 
   } else if (fn->hasFlag(FLAG_NO_CODEGEN)                == false) {
     std::vector<GenRet> args(numActuals());
@@ -4591,6 +4606,43 @@ GenRet CallExpr::codegenPrimitive() {
     break;
   }
 
+  case PRIM_COMM_STREAM_START: {
+    // args are: wide _ddata, first, count, line, file
+    Type* narrowType = get(1)->typeInfo()->getField("addr")->typeInfo();
+    Type* eltType    = getDataClassType(narrowType->symbol)->typeInfo();
+    std::vector<GenRet> args;
+
+    args.push_back(codegenRnode(get(1)));
+    args.push_back(codegenCastToVoidStar(codegenRaddr(get(1))));
+    args.push_back(codegenSizeof(eltType));
+    args.push_back(get(2));
+    args.push_back(get(3));
+    args.push_back(genTypeStructureIndex(eltType->symbol));
+    args.push_back(genCommID(gGenInfo));
+    args.push_back(get(4));
+    args.push_back(get(5));
+
+    ret = codegenCallExpr("chpl_comm_stream_start", args);
+    break;
+  }
+
+  case PRIM_COMM_STREAM_BASE: {
+    // args are: stream, wide _ddata, idx
+    Type* narrowType = get(2)->typeInfo()->getField("addr")->typeInfo();
+    GenRet base      = codegenCallExpr("chpl_comm_stream_base",
+                                       get(1),
+                                       codegenCastToVoidStar(
+                                         codegenRaddr(get(2))),
+                                       get(3));
+
+    ret = codegenCast(narrowType, base);
+    break;
+  }
+
+  case PRIM_COMM_STREAM_FINISH:
+    codegenCall("chpl_comm_stream_finish", get(1));
+    break;
+
   // Strided versions of get and put
   case PRIM_CHPL_COMM_PUT_STRD:
   case PRIM_CHPL_COMM_GET_STRD: {
@@ -5593,13 +5645,14 @@ void CallExpr::codegenInvokeTaskFun(const char* name) {
   GenRet              taskBundle;
   GenRet              bundleSize;
 
-  std::vector<GenRet> args(8);
+  std::vector<GenRet> args(6);
 
   // get(1) is a ref/wide ref to a task list value
   // get(2) is the node ID owning the task list
   // get(3) is a buffer containing bundled arguments
   // get(4) is the buffer's length
-  // get(5) is a dummy class type for the argument bundle
+  // get(5), for a task team only, is the number of tasks in the team
+  // get(5) or get(6) is a dummy class type for the argument bundle
   if (get(1)->isWideRef()) {
     taskList = codegenRaddr(taskList);
   }
@@ -5614,8 +5667,12 @@ void CallExpr::codegenInvokeTaskFun(const char* name) {
   args[3]      = bundleSize;
   args[4]      = taskList;
   args[5]      = codegenValue(taskListNode);
-  args[6]      = fn->linenum();
-  args[7]      = new_IntSymbol(gFilenameLookupCache[fn->fname()], INT_SIZE_32);
+
+  if (fn->hasFlag(FLAG_COFORALL_TEAM))
+    args.push_back(codegenValue(get(5)));
+
+  args.push_back(fn->linenum());
+  args.push_back(new_IntSymbol(gFilenameLookupCache[fn->fname()], INT_SIZE_32));
 
   genComment(fn->cname, true);
 
@@ -130,6 +130,7 @@ private:
 };
 
 CallExpr* callChplHereAlloc(Type* type, VarSymbol* md = NULL);
+CallExpr* callChplHereTaskAlloc(Type* type);
 
 void      insertChplHereAlloc(Expr*      call,
                               bool       insertAfter,
@@ -49,16 +49,19 @@ void check_bulkCopyRecords();
 void check_removeUnnecessaryAutoCopyCalls();
 void check_inlineFunctions();
 void check_scalarReplace();
+void check_stackAllocateClasses();
 void check_refPropagation();
 void check_copyPropagation();
 void check_deadCodeElimination();
 void check_removeEmptyRecords();
 void check_localizeGlobals();
 void check_loopInvariantCodeMotion();
+void check_specializeForallLoops();
 void check_prune2();
 void check_returnStarTuplesByRefArgs();
 void check_insertWideReferences();
 void check_optimizeOnClauses();
+void check_prefetchRemoteArrayReads();
 void check_addInitCalls();
 void check_insertLineNumbers();
 void check_denormalize();
@@ -53,10 +53,16 @@ class LayeredValueTable;
 struct LoopData
 {
 #ifdef HAVE_LLVM
-  LoopData(llvm::MDNode *loopMetadata, bool parallel)
-    : loopMetadata(loopMetadata), parallel(parallel)
+  LoopData(llvm::MDNode *parallelLoops, llvm::MDNode *accessGroups,
+           bool parallel)
+    : parallelLoops(parallelLoops), accessGroups(accessGroups),
+      parallel(parallel)
   { }
-  llvm::MDNode* loopMetadata;
+  /* What memory accesses in the loop body refer to:  this loop's id
+   * and access group, or lists of them and those of any enclosing
+   * parallel loops. */
+  llvm::MDNode* parallelLoops;
+  llvm::MDNode* accessGroups;
   bool parallel; /* There is no dependency between loops */
 #endif
 };
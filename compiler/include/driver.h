@@ -50,9 +50,13 @@ extern bool fNoCastChecks;
 extern bool fNoDivZeroChecks;
 extern bool fMungeUserIdents;
 extern bool fEnableTaskTracking;
+extern bool fSampleProfile;
 extern bool fLLVMWideOpt;
 
 extern bool fNoRemoteValueForwarding;
+extern bool fNoBulkRemoteReads;
+extern bool fNoStackAllocateClasses;
+extern bool fNoRefCountElision;
 extern bool fNoRemoteSerialization;
 extern bool fNoRemoveCopyCalls;
 extern bool fNoScalarReplacement;
@@ -69,6 +73,7 @@ extern int  optimize_on_clause_limit;
 extern int  scalar_replace_limit;
 extern int  inline_iter_yield_limit;
 extern int  tuple_copy_limit;
+extern int  stack_allocate_class_limit;
 
 
 extern bool report_inlining;
@@ -149,6 +154,9 @@ extern bool llvmCodegen;
 // Is the cache for remote data enabled?
 extern bool fCacheRemote;
 
+// Are iterator classes allocated in per-task arenas?
+extern bool fTaskArenas;
+
 // externC allows blocks like extern { } to be parsed
 // with clang and then added to the enclosing module's scope
 extern bool externC;
@@ -188,6 +196,10 @@ extern bool fReportOrderIndependentLoops;
 extern bool fReportOptimizedOn;
 extern bool fReportPromotion;
 extern bool fReportScalarReplace;
+extern bool fReportVectorization;
+extern bool fReportBulkRemoteReads;
+extern bool fReportStackAllocateClasses;
+extern bool fReportRefCountElision;
 extern bool fReportDeadBlocks;
 extern bool fReportDeadModules;
 
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2004-2018 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOOP_REPORT_H_
+#define _LOOP_REPORT_H_
+
+#include <string>
+#include <vector>
+
+class CForLoop;
+
+//
+// Collects one line per source loop for the --report-* flags of the
+// loop optimizations.  A forall usually turns into several CForLoops
+// (e.g. fast and regular followers); a source loop is reported as
+// optimized if any of them was.  Loops outside user modules are only
+// reported with --devel.
+//
+class LoopReport {
+public:
+  // 'reason' is NULL if the loop was optimized, else why it wasn't.
+  void note(CForLoop* loop, const char* reason);
+
+  // Print the loops sorted by file and line, as "<done> at file:line"
+  // or "<notDone> at file:line: reason".
+  void print(const char* done, const char* notDone);
+
+private:
+  struct Entry {
+    std::string file;
+    int         line;
+    bool        optimized;
+    const char* reason;
+
+    bool operator<(const Entry& other) const;
+  };
+
+  std::vector<Entry> entries;
+};
+
+#endif
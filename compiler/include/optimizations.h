@@ -38,6 +38,7 @@
 class BaseAST;
 class BitVec;
 class BlockStmt;
+class CForLoop;
 class FnSymbol;
 class Symbol;
 class SymExpr;
@@ -61,6 +62,15 @@ void liveVariableAnalysis(FnSymbol* fn,
 
 void remoteValueForwarding();
 
+// Recognize 'for (i1 = ..., i2 = ...; lead <= end; i1 += 1, i2 += 1)'
+// with a loop invariant 'end'.  Returns NULL if the header has this
+// shape, else the reason why not.
+const char* findCountedLoopHeader(CForLoop*             loop,
+                                  std::vector<Symbol*>& indices,
+                                  Symbol*&              lead,
+                                  Symbol*&              end);
+bool isCForLoopInvariant(Symbol* sym, CForLoop* loop);
+
 void inferConstRefs();
 
 
@@ -61,6 +61,7 @@ void makeBinary();
 void normalize();
 void optimizeOnClauses();
 void parallel();
+void prefetchRemoteArrayReads();
 void prune();
 void prune2();
 void readExternC();
@@ -73,6 +74,8 @@ void resolveIntents();
 void returnStarTuplesByRefArgs();
 void scalarReplace();
 void scopeResolve();
+void specializeForallLoops();
+void stackAllocateClasses();
 void verify();
 
 //
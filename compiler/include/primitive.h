@@ -141,6 +141,10 @@ enum PrimitiveTag {
   PRIM_CHPL_COMM_GET_STRD,      // Direct calls to the Chapel comm layer for strided comm
   PRIM_CHPL_COMM_PUT_STRD,      //  may eventually add others (e.g., non-blocking)
 
+  PRIM_COMM_STREAM_START,       // bulk prefetch of remote array reads,
+  PRIM_COMM_STREAM_BASE,        //  see prefetchRemoteArrayReads
+  PRIM_COMM_STREAM_FINISH,
+
   PRIM_ARRAY_ALLOC,
   PRIM_ARRAY_FREE,
   PRIM_ARRAY_GET,
@@ -166,6 +170,7 @@ enum PrimitiveTag {
   PRIM_BLOCK_BEGIN,             // BlockStmt::blockInfo - begin block
   PRIM_BLOCK_COBEGIN,           // BlockStmt::blockInfo - cobegin block
   PRIM_BLOCK_COFORALL,          // BlockStmt::blockInfo - coforall block
+  PRIM_BLOCK_COFORALL_TEAM,     // BlockStmt::blockInfo - coforall team block
   PRIM_BLOCK_ON,                // BlockStmt::blockInfo - on block
   PRIM_BLOCK_BEGIN_ON,          // BlockStmt::blockInfo - begin on block
   PRIM_BLOCK_COBEGIN_ON,        // BlockStmt::blockInfo - cobegin on block
@@ -50,6 +50,7 @@ extern AggregateType* dtTuple;
 // The well-known functions
 extern FnSymbol *gChplHereAlloc;
 extern FnSymbol *gChplHereFree;
+extern FnSymbol *gChplHereTaskAlloc;
 extern FnSymbol *gChplDecRunningTask;
 extern FnSymbol *gChplIncRunningTask;
 extern FnSymbol *gChplDoDirectExecuteOn;
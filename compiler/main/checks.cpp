@@ -287,6 +287,16 @@ void check_scalarReplace()
   // Suggestion: Ensure no constant expressions.
 }
 
+void check_stackAllocateClasses()
+{
+  check_afterEveryPass();
+  check_afterNormalization();
+  check_afterCallDestructors();
+  check_afterLowerIterators();
+  check_afterResolveIntents();
+  check_afterInlineFunctions();
+}
+
 void check_refPropagation()
 {
   check_afterEveryPass();
@@ -350,6 +360,16 @@ void check_loopInvariantCodeMotion()
   check_afterInlineFunctions();
 }
 
+void check_specializeForallLoops()
+{
+  check_afterEveryPass();
+  check_afterNormalization();
+  check_afterCallDestructors();
+  check_afterLowerIterators();
+  check_afterResolveIntents();
+  check_afterInlineFunctions();
+}
+
 void check_prune2()
 {
   check_afterEveryPass();
@@ -391,6 +411,16 @@ void check_optimizeOnClauses()
   check_afterInlineFunctions();
 }
 
+void check_prefetchRemoteArrayReads()
+{
+  check_afterEveryPass();
+  check_afterNormalization();
+  check_afterCallDestructors();
+  check_afterLowerIterators();
+  check_afterResolveIntents();
+  check_afterInlineFunctions();
+}
+
 void check_addInitCalls()
 {
   check_afterEveryPass();
@@ -663,6 +693,7 @@ checkTaskRemovedPrims()
        case PRIM_BLOCK_BEGIN:
        case PRIM_BLOCK_COBEGIN:
        case PRIM_BLOCK_COFORALL:
+       case PRIM_BLOCK_COFORALL_TEAM:
        case PRIM_BLOCK_ON:
        case PRIM_BLOCK_BEGIN_ON:
        case PRIM_BLOCK_COBEGIN_ON:
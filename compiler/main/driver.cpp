@@ -106,6 +106,7 @@ bool ignore_errors_for_pass = false;
 bool ignore_warnings = false;
 int  fcg = 0;
 bool fCacheRemote = false;
+bool fTaskArenas = false;
 bool fFastFlag = false;
 bool fUseNoinit = true;
 bool fNoUserConstructors = false;
@@ -114,6 +115,9 @@ bool fNoDeadCodeElimination = false;
 bool fNoScalarReplacement = false;
 bool fNoTupleCopyOpt = false;
 bool fNoRemoteValueForwarding = false;
+bool fNoBulkRemoteReads = false;
+bool fNoStackAllocateClasses = false;
+bool fNoRefCountElision = false;
 bool fNoRemoteSerialization = false;
 bool fNoRemoveCopyCalls = false;
 bool fNoOptimizeLoopIterators = false;
@@ -134,6 +138,7 @@ bool fUserSetStackChecks = false;
 bool fNoCastChecks = false;
 bool fMungeUserIdents = true;
 bool fEnableTaskTracking = false;
+bool fSampleProfile = false;
 
 bool  printPasses     = false;
 FILE* printPassesFile = NULL;
@@ -165,6 +170,7 @@ int optimize_on_clause_limit = 20;
 int scalar_replace_limit = 8;
 int inline_iter_yield_limit = 10;
 int tuple_copy_limit = scalar_replace_limit;
+int stack_allocate_class_limit = 1024;
 bool fGenIDS = false;
 int fLinkStyle = LS_DEFAULT; // use backend compiler's default
 bool fUserSetLocal = false;
@@ -199,6 +205,10 @@ bool fReportOrderIndependentLoops = false;
 bool fReportOptimizedOn = false;
 bool fReportPromotion = false;
 bool fReportScalarReplace = false;
+bool fReportVectorization = false;
+bool fReportBulkRemoteReads = false;
+bool fReportStackAllocateClasses = false;
+bool fReportRefCountElision = false;
 bool fReportDeadBlocks = false;
 bool fReportDeadModules = false;
 bool fPermitUnhandledModuleErrors = false;
@@ -655,9 +665,12 @@ static void setFastFlag(const ArgumentDescription* desc, const char* unused) {
   fNoOptimizeLoopIterators = false;
   fNoLiveAnalysis = false;
   fNoRemoteValueForwarding = false;
+  fNoBulkRemoteReads = false;
   fNoRemoteSerialization = false;
   fNoRemoveCopyCalls = false;
   fNoScalarReplacement = false;
+  fNoStackAllocateClasses = false;
+  fNoRefCountElision = false;
   fNoTupleCopyOpt = false;
   fNoPrivatization = false;
   fNoChecks = true;
@@ -701,9 +714,12 @@ static void setBaselineFlag(const ArgumentDescription* desc, const char* unused)
   fNoOptimizeLoopIterators = true;    // --no-optimize-loop-iterators
   fNoVectorize = true;                // --no-vectorize
   fNoRemoteValueForwarding = true;    // --no-remote-value-forwarding
+  fNoBulkRemoteReads = true;          // --no-bulk-remote-reads
   fNoRemoteSerialization = true;      // --no-remote-serialization
   fNoRemoveCopyCalls = true;          // --no-remove-copy-calls
   fNoScalarReplacement = true;        // --no-scalar-replacement
+  fNoStackAllocateClasses = true;     // --no-stack-allocate-classes
+  fNoRefCountElision = true;          // --no-refcount-elision
   fNoTupleCopyOpt = true;             // --no-tuple-copy-opt
   fNoPrivatization = true;            // --no-privatization
   fNoOptimizeOnClauses = true;        // --no-optimize-on-clauses
@@ -718,6 +734,11 @@ static void setCacheEnable(const ArgumentDescription* desc, const char* unused)
   parseCmdLineConfig("CHPL_CACHE_REMOTE", val);
 }
 
+static void setTaskArenas(const ArgumentDescription* desc, const char* unused) {
+  const char *val = fTaskArenas ? "true" : "false";
+  parseCmdLineConfig("CHPL_TASK_ARENAS", val);
+}
+
 static void setHtmlUser(const ArgumentDescription* desc, const char* unused) {
   fdump_html = true;
   fdump_html_include_system_modules = false;
@@ -806,6 +827,7 @@ static ArgumentDescription arg_desc[] = {
 
  {"", ' ', NULL, "Optimization Control Options", NULL, NULL, NULL, NULL},
  {"baseline", ' ', NULL, "Disable all Chapel optimizations", "F", &fBaseline, "CHPL_BASELINE", setBaselineFlag},
+ {"bulk-remote-reads", ' ', NULL, "Enable [disable] bulk prefetching of remote array reads in loops", "n", &fNoBulkRemoteReads, "CHPL_DISABLE_BULK_REMOTE_READS", NULL},
  {"cache-remote", ' ', NULL, "[Don't] enable cache for remote data", "N", &fCacheRemote, "CHPL_CACHE_REMOTE", setCacheEnable},
  {"copy-propagation", ' ', NULL, "Enable [disable] copy propagation", "n", &fNoCopyPropagation, "CHPL_DISABLE_COPY_PROPAGATION", NULL},
  {"dead-code-elimination", ' ', NULL, "Enable [disable] dead code elimination", "n", &fNoDeadCodeElimination, "CHPL_DISABLE_DEAD_CODE_ELIMINATION", NULL},
@@ -822,11 +844,15 @@ static ArgumentDescription arg_desc[] = {
  {"optimize-on-clauses", ' ', NULL, "Enable [disable] optimization of on clauses", "n", &fNoOptimizeOnClauses, "CHPL_DISABLE_OPTIMIZE_ON_CLAUSES", NULL},
  {"optimize-on-clause-limit", ' ', "<limit>", "Limit recursion depth of on clause optimization search", "I", &optimize_on_clause_limit, "CHPL_OPTIMIZE_ON_CLAUSE_LIMIT", NULL},
  {"privatization", ' ', NULL, "Enable [disable] privatization of distributed arrays and domains", "n", &fNoPrivatization, "CHPL_DISABLE_PRIVATIZATION", NULL},
+ {"refcount-elision", ' ', NULL, "Enable [disable] removal of balanced reference count updates", "n", &fNoRefCountElision, "CHPL_DISABLE_REFCOUNT_ELISION", NULL},
  {"remote-value-forwarding", ' ', NULL, "Enable [disable] remote value forwarding", "n", &fNoRemoteValueForwarding, "CHPL_DISABLE_REMOTE_VALUE_FORWARDING", NULL},
  {"remote-serialization", ' ', NULL, "Enable [disable] serialization for remote consts", "n", &fNoRemoteSerialization, "CHPL_DISABLE_REMOTE_SERIALIZATION", NULL},
  {"remove-copy-calls", ' ', NULL, "Enable [disable] remove copy calls", "n", &fNoRemoveCopyCalls, "CHPL_DISABLE_REMOVE_COPY_CALLS", NULL},
  {"scalar-replacement", ' ', NULL, "Enable [disable] scalar replacement", "n", &fNoScalarReplacement, "CHPL_DISABLE_SCALAR_REPLACEMENT", NULL},
  {"scalar-replace-limit", ' ', "<limit>", "Limit on the size of tuples being replaced during scalar replacement", "I", &scalar_replace_limit, "CHPL_SCALAR_REPLACE_TUPLE_LIMIT", NULL},
+ {"stack-allocate-classes", ' ', NULL, "Enable [disable] stack allocation of class instances that do not escape", "n", &fNoStackAllocateClasses, "CHPL_DISABLE_STACK_ALLOCATE_CLASSES", NULL},
+ {"stack-allocate-class-limit", ' ', "<limit>", "Limit on the size in bytes of class instances allocated on the stack", "I", &stack_allocate_class_limit, "CHPL_STACK_ALLOCATE_CLASS_LIMIT", NULL},
+ {"task-arenas", ' ', NULL, "[Don't] allocate iterator classes in per-task arenas", "N", &fTaskArenas, "CHPL_TASK_ARENAS", setTaskArenas},
  {"tuple-copy-opt", ' ', NULL, "Enable [disable] tuple (memcpy) optimization", "n", &fNoTupleCopyOpt, "CHPL_DISABLE_TUPLE_COPY_OPT", NULL},
  {"tuple-copy-limit", ' ', "<limit>", "Limit on the size of tuples considered for optimization", "I", &tuple_copy_limit, "CHPL_TUPLE_COPY_LIMIT", NULL},
  {"use-noinit", ' ', NULL, "Enable [disable] ability to skip default initialization through the keyword noinit", "N", &fUseNoinit, NULL, NULL},
@@ -885,6 +911,7 @@ static ArgumentDescription arg_desc[] = {
  {"print-callgraph", ' ', NULL, "[Don't] print a representation of the callgraph for the program", "N", &fPrintCallGraph, "CHPL_PRINT_CALLGRAPH", NULL},
  {"print-callstack-on-error", ' ', NULL, "[Don't] print the Chapel call stack leading to each error or warning", "N", &fPrintCallStackOnError, "CHPL_PRINT_CALLSTACK_ON_ERROR", NULL},
  {"print-unused-functions", ' ', NULL, "[Don't] print the name and location of unused functions", "N", &fPrintUnusedFns, NULL, NULL},
+ {"sample-profile", ' ', NULL, "Enable [disable] Chapel names in sampling profiles", "N", &fSampleProfile, "CHPL_SAMPLE_PROFILE", NULL},
  {"set", 's', "<name>[=<value>]", "Set config param value", "S", NULL, NULL, readConfig},
  {"permit-unhandled-module-errors", ' ', NULL, "Permit unhandled errors in explicit modules; such errors halt at runtime", "N", &fPermitUnhandledModuleErrors, "CHPL_PERMIT_UNHANDLED_MODULE_ERRORS", NULL},
  {"task-tracking", ' ', NULL, "Enable [disable] runtime task tracking", "N", &fEnableTaskTracking, "CHPL_TASK_TRACKING", NULL},
@@ -951,6 +978,7 @@ static ArgumentDescription arg_desc[] = {
  {"print-dispatch", ' ', NULL, "Print dynamic dispatch table", "F", &fPrintDispatch, NULL, NULL},
  {"print-statistics", ' ', "[n|k|t]", "Print AST statistics", "S256", fPrintStatistics, NULL, NULL},
  {"report-inlining", ' ', NULL, "Print inlined functions", "F", &report_inlining, NULL, NULL},
+ {"report-bulk-remote-reads", ' ', NULL, "Print which loops had their remote array reads prefetched in bulk", "F", &fReportBulkRemoteReads, NULL, NULL},
  {"report-dead-blocks", ' ', NULL, "Print dead block removal stats", "F", &fReportDeadBlocks, NULL, NULL},
  {"report-dead-modules", ' ', NULL, "Print dead module removal stats", "F", &fReportDeadModules, NULL, NULL},
  {"report-optimized-loop-iterators", ' ', NULL, "Print stats on optimized single loop iterators", "F", &fReportOptimizedLoopIterators, NULL, NULL},
@@ -958,7 +986,10 @@ static ArgumentDescription arg_desc[] = {
  {"report-order-independent-loops", ' ', NULL, "Print stats on order independent loops", "F", &fReportOrderIndependentLoops, NULL, NULL},
  {"report-optimized-on", ' ', NULL, "Print information about on clauses that have been optimized for potential fast remote fork operation", "F", &fReportOptimizedOn, NULL, NULL},
  {"report-promotion", ' ', NULL, "Print information about scalar promotion", "F", &fReportPromotion, NULL, NULL},
+ {"report-refcount-elision", ' ', NULL, "Print which copies of reference-counted records were elided", "F", &fReportRefCountElision, NULL, NULL},
  {"report-scalar-replace", ' ', NULL, "Print scalar replacement stats", "F", &fReportScalarReplace, NULL, NULL},
+ {"report-stack-allocate-classes", ' ', NULL, "Print which class allocations were moved to the stack", "F", &fReportStackAllocateClasses, NULL, NULL},
+ {"report-vectorization", ' ', NULL, "Print which order independent loops were specialized for vectorization", "F", &fReportVectorization, NULL, NULL},
  {"warn-unstable", ' ', NULL, "Enable [disable] warnings code that is about to change or recently changed behavior", "N", &fWarnUnstable, "CHPL_WARN_UNSTABLE", NULL},
  {"default-unmanaged", ' ', NULL, "Enable [disable] class type defaulting to unmanaged", "N", &fDefaultUnmanaged, "CHPL_DEFAULT_UNMANAGED", NULL},
 
@@ -1224,6 +1255,19 @@ static void postStackCheck() {
   }
 }
 
+static void postTaskArenas() {
+  if (fTaskArenas) {
+    // The arenas hang off each task's private data, which massivethreads
+    // keeps in a single static shared by all of its tasks.
+    if (strcmp(CHPL_TASKS, "massivethreads") == 0) {
+      USR_WARN("CHPL_TASKS=%s does not support --task-arenas, ignoring flag.",
+               CHPL_TASKS);
+      fTaskArenas = false;
+      setTaskArenas(NULL, NULL);
+    }
+  }
+}
+
 static void postTaskTracking() {
   if (fEnableTaskTracking) {
     if (strcmp(CHPL_TASKS, "fifo") != 0) {
@@ -1290,6 +1334,8 @@ static void postprocess_args() {
 
   postStackCheck();
 
+  postTaskArenas();
+
   postStaticLink();
 
   setPrintCppLineno();
@@ -66,16 +66,19 @@ struct PassInfo {
 #define LOG_removeUnnecessaryAutoCopyCalls     LOG_NO_SHORT
 #define LOG_inlineFunctions                    LOG_NO_SHORT
 #define LOG_scalarReplace                      LOG_NO_SHORT
+#define LOG_stackAllocateClasses               LOG_NO_SHORT
 #define LOG_refPropagation                     LOG_NO_SHORT
 #define LOG_copyPropagation                    LOG_NO_SHORT
 #define LOG_deadCodeElimination                LOG_NO_SHORT
 #define LOG_removeEmptyRecords                 LOG_NO_SHORT
 #define LOG_localizeGlobals                    LOG_NO_SHORT
 #define LOG_loopInvariantCodeMotion            LOG_NO_SHORT
+#define LOG_specializeForallLoops              LOG_NO_SHORT
 #define LOG_prune2                             LOG_NO_SHORT
 #define LOG_returnStarTuplesByRefArgs          LOG_NO_SHORT
 #define LOG_insertWideReferences               LOG_NO_SHORT
 #define LOG_optimizeOnClauses                  LOG_NO_SHORT
+#define LOG_prefetchRemoteArrayReads           LOG_NO_SHORT
 #define LOG_addInitCalls                       LOG_NO_SHORT
 #define LOG_insertLineNumbers                  LOG_NO_SHORT
 #define LOG_denormalize                        LOG_NO_SHORT
@@ -133,18 +136,21 @@ static PassInfo sPassList[] = {
   RUN(removeUnnecessaryAutoCopyCalls),
   RUN(inlineFunctions),         // function inlining
   RUN(scalarReplace),           // scalar replace all tuples
+  RUN(stackAllocateClasses),    // stack allocate non-escaping classes
   RUN(refPropagation),          // reference propagation
   RUN(copyPropagation),         // copy propagation
   RUN(deadCodeElimination),     // eliminate dead code
   RUN(removeEmptyRecords),      // remove empty records
   RUN(localizeGlobals),         // pull out global constants from loop runs
   RUN(loopInvariantCodeMotion), // move loop invariant code above loop runs
+  RUN(specializeForallLoops),   // canonicalize order independent loops
   RUN(prune2),                  // prune AST of dead functions and types again
 
   RUN(returnStarTuplesByRefArgs),
 
   RUN(insertWideReferences),    // inserts wide references for on clauses
   RUN(optimizeOnClauses),       // Optimize on clauses
+  RUN(prefetchRemoteArrayReads), // bulk GETs for remote reads in loops
   RUN(addInitCalls),            // Add module init calls and guards.
 
   // AST to C or LLVM
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2004-2018 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "loopReport.h"
+
+#include "CForLoop.h"
+#include "driver.h"
+#include "symbol.h"
+
+#include <algorithm>
+#include <cstdio>
+
+bool LoopReport::Entry::operator<(const Entry& other) const {
+  if (file != other.file)
+    return file < other.file;
+  return line < other.line;
+}
+
+void LoopReport::note(CForLoop* loop, const char* reason) {
+  ModuleSymbol* mod = loop->getModule();
+
+  if (!developer && mod->modTag != MOD_USER)
+    return;
+
+  Entry entry = { loop->fname(), loop->linenum(), reason == NULL, reason };
+
+  for (size_t i = 0; i < entries.size(); i++) {
+    if (entries[i].file == entry.file && entries[i].line == entry.line) {
+      if (reason == NULL)
+        entries[i].optimized = true;
+      return;
+    }
+  }
+
+  entries.push_back(entry);
+}
+
+void LoopReport::print(const char* done, const char* notDone) {
+  std::sort(entries.begin(), entries.end());
+
+  for (size_t i = 0; i < entries.size(); i++) {
+    if (entries[i].optimized)
+      printf("%s at %s:%d\n", done,
+             entries[i].file.c_str(), entries[i].line);
+    else
+      printf("%s at %s:%d: %s\n", notDone,
+             entries[i].file.c_str(), entries[i].line, entries[i].reason);
+  }
+}
@@ -242,6 +242,12 @@ classifyPrimitive(CallExpr *call) {
   case PRIM_CHPL_COMM_REMOTE_PREFETCH:
   case PRIM_CHPL_COMM_GET_STRD:
   case PRIM_CHPL_COMM_PUT_STRD:
+  // prefetchRemoteArrayReads runs after this pass, but classify the
+  // stream primitives anyway: start issues GETs, base may wait on them
+  // and finish waits for the rest.
+  case PRIM_COMM_STREAM_START:
+  case PRIM_COMM_STREAM_BASE:
+  case PRIM_COMM_STREAM_FINISH:
     // These involve communication
     // MPF: Couldn't these be fast if in a local block?
     // Shouldn't this be return FAST_NOT_LOCAL ?
@@ -284,6 +290,7 @@ classifyPrimitive(CallExpr *call) {
   case PRIM_BLOCK_BEGIN:
   case PRIM_BLOCK_COBEGIN:
   case PRIM_BLOCK_COFORALL:
+  case PRIM_BLOCK_COFORALL_TEAM:
   case PRIM_BLOCK_ON:
   case PRIM_BLOCK_BEGIN_ON:
   case PRIM_BLOCK_COBEGIN_ON:
@@ -0,0 +1,600 @@
+/*
+ * Copyright 2004-2018 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// prefetchRemoteArrayReads
+//
+// A serial loop reading a remote DefaultRectangular array, e.g.
+//
+//   for i in 1..n do sum += B[i];
+//
+// does one blocking GET per element.  After insertWideReferences such a
+// loop looks like
+//
+//   for (i = lo; i <= hi; i += 1) {
+//     data = B->shiftedData;           // wide _ddata
+//     ref = &data[i + c];              // wide reference
+//     sum += *ref;
+//   }
+//
+// When the loop makes no calls and writes nothing but locals, nothing it
+// does can change the array elements it reads, so they can be fetched
+// before they are used.  This pass rewrites the loop into
+//
+//   i = lo;
+//   if (i <= hi) {
+//     data = B->shiftedData;
+//     s = comm_stream_start(data, i + c, hi - i + 1);
+//     for (; i <= hi; i += 1) {
+//       ref = &comm_stream_base(s, data, i + c)[i + c];   // narrow
+//       sum += *ref;
+//     }
+//     comm_stream_finish(s);
+//   }
+//
+// where the runtime stream (see chpl-comm-stream.h) GETs the elements in
+// large non-blocking strips ahead of their use, and does nothing at all
+// when the data turns out to be local.
+//
+
+#include "passes.h"
+
+#include "astutil.h"
+#include "CForLoop.h"
+#include "driver.h"
+#include "expr.h"
+#include "loopReport.h"
+#include "misc.h"
+#include "optimizations.h"
+#include "stlUtil.h"
+#include "stmt.h"
+#include "symbol.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <vector>
+
+struct RemoteRead {
+  CallExpr* move;       // (move ref (array_get data idx))
+  Symbol*   data;
+  Symbol*   index;      // induction variable 'idx' is offset from
+  int64_t   offset;
+};
+
+typedef std::pair<Symbol*, int64_t>     IndexOffset;   // idx + offset
+typedef std::pair<Symbol*, IndexOffset> StreamKey;     // data, first
+
+//
+// Is 'expr' in the loop body, as opposed to its header clauses?
+//
+static bool isInLoopBody(Expr* expr, CForLoop* loop) {
+  for (Expr* e = expr; e != NULL; e = e->parentExpr) {
+    if (e->parentExpr == loop) {
+      return e != loop->initBlockGet() &&
+             e != loop->testBlockGet() &&
+             e != loop->incrBlockGet();
+    }
+  }
+  return false;
+}
+
+static bool isDefinedInLoop(Symbol* sym, CForLoop* loop) {
+  for_SymbolSymExprs(se, sym) {
+    if (loop->contains(se) && (isDefAndOrUse(se) & 1))
+      return true;
+  }
+  return false;
+}
+
+//
+// A non-reference variable of the loop's function; writing it cannot
+// change any array element.
+//
+static bool isLocalValue(Symbol* sym, FnSymbol* fn) {
+  return isVarSymbol(sym) &&
+         !sym->isRefOrWideRef() &&
+         sym->defPoint->parentSymbol == fn;
+}
+
+static bool makesReference(Expr* expr) {
+  if (SymExpr* se = toSymExpr(expr))
+    return se->isRefOrWideRef();
+
+  CallExpr* call = toCallExpr(expr);
+  return call != NULL &&
+         (call->isPrimitive(PRIM_ARRAY_GET)          ||
+          call->isPrimitive(PRIM_SET_REFERENCE)      ||
+          call->isPrimitive(PRIM_ADDR_OF)            ||
+          call->isPrimitive(PRIM_GET_MEMBER)         ||
+          call->isPrimitive(PRIM_GET_SVEC_MEMBER));
+}
+
+//
+// A narrow reference that only ever refers to a local value, as in
+// '_ref_tmp_ = &sum'.
+//
+static bool isLocalRef(Symbol* sym, FnSymbol* fn) {
+  if (!isVarSymbol(sym) || sym->isWideRef() || !sym->isRef() ||
+      sym->defPoint->parentSymbol != fn)
+    return false;
+
+  for_SymbolDefs(def, sym) {
+    // Stores through the reference are defs too; only check bindings.
+    CallExpr* move = toCallExpr(def->parentExpr);
+    if (move == NULL || !move->isPrimitive(PRIM_MOVE))
+      continue;
+
+    CallExpr* rhs = toCallExpr(move->get(2));
+    if (rhs != NULL &&
+        (rhs->isPrimitive(PRIM_SET_REFERENCE) ||
+         rhs->isPrimitive(PRIM_ADDR_OF))) {
+      SymExpr* target = toSymExpr(rhs->get(1));
+      if (target == NULL || !isLocalValue(target->symbol(), fn))
+        return false;
+
+    } else if (makesReference(move->get(2)) ||
+               (rhs != NULL && rhs->primitive == NULL)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+//
+// Can 'call' write memory other than locals, or do anything else that
+// would make reading array elements early visible?
+//
+static bool writesNonLocalMemory(CallExpr* call, FnSymbol* fn) {
+  if (call->primitive == NULL)
+    return true;
+
+  switch (call->primitive->tag) {
+  case PRIM_MOVE: {
+    Symbol* lhs = toSymExpr(call->get(1))->symbol();
+
+    if (lhs->isRefOrWideRef() && makesReference(call->get(2)))
+      return false;
+
+    return !isLocalValue(lhs, fn) && !isLocalRef(lhs, fn);
+  }
+
+  case PRIM_ASSIGN:
+  case PRIM_ADD_ASSIGN:
+  case PRIM_SUBTRACT_ASSIGN:
+  case PRIM_MULT_ASSIGN:
+  case PRIM_DIV_ASSIGN:
+  case PRIM_MOD_ASSIGN:
+  case PRIM_LSH_ASSIGN:
+  case PRIM_RSH_ASSIGN:
+  case PRIM_AND_ASSIGN:
+  case PRIM_OR_ASSIGN:
+  case PRIM_XOR_ASSIGN: {
+    SymExpr* lhs = toSymExpr(call->get(1));
+
+    return lhs == NULL ||
+           (!isLocalValue(lhs->symbol(), fn) &&
+            !isLocalRef(lhs->symbol(), fn));
+  }
+
+  case PRIM_NOOP:
+  case PRIM_UNARY_MINUS:
+  case PRIM_UNARY_PLUS:
+  case PRIM_UNARY_NOT:
+  case PRIM_UNARY_LNOT:
+  case PRIM_ADD:
+  case PRIM_SUBTRACT:
+  case PRIM_MULT:
+  case PRIM_DIV:
+  case PRIM_MOD:
+  case PRIM_LSH:
+  case PRIM_RSH:
+  case PRIM_EQUAL:
+  case PRIM_NOTEQUAL:
+  case PRIM_LESSOREQUAL:
+  case PRIM_GREATEROREQUAL:
+  case PRIM_LESS:
+  case PRIM_GREATER:
+  case PRIM_AND:
+  case PRIM_OR:
+  case PRIM_XOR:
+  case PRIM_POW:
+  case PRIM_MIN:
+  case PRIM_MAX:
+  case PRIM_GET_MEMBER:
+  case PRIM_GET_MEMBER_VALUE:
+  case PRIM_GET_SVEC_MEMBER:
+  case PRIM_GET_SVEC_MEMBER_VALUE:
+  case PRIM_GET_REAL:
+  case PRIM_GET_IMAG:
+  case PRIM_ADDR_OF:
+  case PRIM_DEREF:
+  case PRIM_SET_REFERENCE:
+  case PRIM_ARRAY_GET:
+  case PRIM_ARRAY_GET_VALUE:
+  case PRIM_CAST:
+  case PRIM_WIDE_GET_LOCALE:
+  case PRIM_WIDE_GET_NODE:
+  case PRIM_WIDE_GET_ADDR:
+    return false;
+
+  default:
+    return true;
+  }
+}
+
+static const char* checkBody(CForLoop* loop) {
+  FnSymbol* fn = loop->getFunction();
+
+  for_alist(stmt, loop->body) {
+    std::vector<Expr*> exprs;
+    collectExprs(stmt, exprs);
+    exprs.push_back(stmt);
+
+    for_vector(Expr, expr, exprs) {
+      if (isGotoStmt(expr))
+        return "loop body may exit the loop early";
+
+      if (BlockStmt* block = toBlockStmt(expr)) {
+        if (block->isLoopStmt())
+          return "loop contains another loop";
+      }
+
+      if (CallExpr* call = toCallExpr(expr)) {
+        if (writesNonLocalMemory(call, fn))
+          return "loop body makes calls or writes non-local memory";
+      }
+    }
+  }
+
+  return NULL;
+}
+
+//
+// Temps of the form 'tmp = idx + c' or 'tmp = idx - c', c a constant.
+//
+static void findOffsetTemps(CForLoop*                         loop,
+                            std::vector<Symbol*>&             indices,
+                            std::map<Symbol*, IndexOffset>&   offsets) {
+  for_alist(stmt, loop->body) {
+    CallExpr* move = toCallExpr(stmt);
+    if (move == NULL || !move->isPrimitive(PRIM_MOVE))
+      continue;
+
+    Symbol*   tmp = toSymExpr(move->get(1))->symbol();
+    CallExpr* add = toCallExpr(move->get(2));
+    if (add == NULL || tmp->getSingleDef() == NULL ||
+        (!add->isPrimitive(PRIM_ADD) && !add->isPrimitive(PRIM_SUBTRACT)))
+      continue;
+
+    SymExpr* lhs = toSymExpr(add->get(1));
+    Expr*    rhs = add->get(2);
+    int64_t  c   = 0;
+
+    if (add->isPrimitive(PRIM_ADD) && get_int(lhs, &c)) {
+      lhs = toSymExpr(add->get(2));
+      rhs = add->get(1);
+    }
+
+    if (lhs == NULL || !get_int(rhs, &c) ||
+        std::find(indices.begin(), indices.end(),
+                  lhs->symbol()) == indices.end() ||
+        tmp->type != lhs->symbol()->type)
+      continue;
+
+    offsets[tmp] = IndexOffset(lhs->symbol(),
+                               add->isPrimitive(PRIM_ADD) ? c : -c);
+  }
+}
+
+//
+// 'stmt' defines a temp from values that do not change in the loop, as
+// in 'data = B->shiftedData'.  Since the loop writes no memory this can
+// be evaluated once, before the loop.
+//
+static Symbol* hoistableDef(Expr*              stmt,
+                            CForLoop*          loop,
+                            std::set<Symbol*>& hoistable) {
+  FnSymbol* fn   = loop->getFunction();
+  CallExpr* move = toCallExpr(stmt);
+
+  if (move == NULL || !move->isPrimitive(PRIM_MOVE))
+    return NULL;
+
+  Symbol* lhs = toSymExpr(move->get(1))->symbol();
+  if (!isLocalValue(lhs, fn) || lhs->getSingleDef() == NULL)
+    return NULL;
+
+  for_SymbolUses(use, lhs) {
+    if (!isInLoopBody(use, loop))
+      return NULL;
+  }
+
+  Expr* src = move->get(2);
+  if (CallExpr* call = toCallExpr(src)) {
+    if (!call->isPrimitive(PRIM_GET_MEMBER_VALUE) &&
+        !call->isPrimitive(PRIM_DEREF))
+      return NULL;
+    src = call->get(1);
+  }
+
+  SymExpr* se = toSymExpr(src);
+  if (se == NULL)
+    return NULL;
+
+  Symbol* sym = se->symbol();
+  if (hoistable.count(sym) ||
+      ((isVarSymbol(sym) || isArgSymbol(sym)) &&
+       sym->defPoint->parentSymbol == fn &&
+       !isDefinedInLoop(sym, loop)))
+    return lhs;
+
+  return NULL;
+}
+
+static bool isStreamable(Type* type) {
+  return is_arithmetic_type(type) || is_bool_type(type);
+}
+
+//
+// Returns NULL if the loop's remote reads can be prefetched, else the
+// reason why not.
+//
+static const char* checkLoop(CForLoop*                loop,
+                             Symbol*&                 lead,
+                             Symbol*&                 end,
+                             std::vector<RemoteRead>& reads,
+                             std::vector<Expr*>&      hoist) {
+  std::vector<Symbol*> indices;
+
+  if (const char* reason = findCountedLoopHeader(loop, indices, lead, end))
+    return reason;
+
+  if (lead->type != dtInt[INT_SIZE_64])
+    return "induction variable is not an int(64)";
+
+  for_vector(Symbol, index, indices) {
+    for_SymbolDefs(def, index) {
+      if (isInLoopBody(def, loop))
+        return "induction variable is modified in the loop body";
+    }
+  }
+
+  if (const char* reason = checkBody(loop))
+    return reason;
+
+  std::map<Symbol*, IndexOffset> offsets;
+  findOffsetTemps(loop, indices, offsets);
+
+  std::set<Symbol*>         hoistable;
+  std::map<Symbol*, Expr*>  hoistableDefs;
+
+  for_alist(stmt, loop->body) {
+    if (Symbol* sym = hoistableDef(stmt, loop, hoistable)) {
+      hoistable.insert(sym);
+      hoistableDefs[sym] = stmt;
+      continue;
+    }
+
+    // Only reads done on every iteration are candidates, so prefetching
+    // them never reads an element the loop would not have read.
+    CallExpr* move = toCallExpr(stmt);
+    if (move == NULL || !move->isPrimitive(PRIM_MOVE))
+      continue;
+
+    Symbol*   ref = toSymExpr(move->get(1))->symbol();
+    CallExpr* get = toCallExpr(move->get(2));
+    if (get == NULL || !get->isPrimitive(PRIM_ARRAY_GET) ||
+        !ref->isWideRef() || ref->getSingleDef() == NULL)
+      continue;
+
+    SymExpr* dataSe = toSymExpr(get->get(1));
+    SymExpr* idxSe  = toSymExpr(get->get(2));
+    if (dataSe == NULL || idxSe == NULL)
+      continue;
+
+    Symbol* data = dataSe->symbol();
+    Type*   wide = data->type;
+    if (!wide->symbol->hasFlag(FLAG_WIDE_CLASS) ||
+        !wide->getField("addr")->type->symbol->hasFlag(FLAG_DATA_CLASS))
+      continue;
+
+    TypeSymbol* eltType = getDataClassType(wide->getField("addr")->type->symbol);
+    if (!isStreamable(eltType->type))
+      continue;
+
+    if (!hoistable.count(data) && !isCForLoopInvariant(data, loop))
+      continue;
+
+    bool onlyDerefs = true;
+    for_SymbolUses(use, ref) {
+      CallExpr* parent = toCallExpr(use->parentExpr);
+      if (parent == NULL || !parent->isPrimitive(PRIM_DEREF))
+        onlyDerefs = false;
+    }
+    if (!onlyDerefs)
+      continue;
+
+    Symbol* idx = idxSe->symbol();
+    RemoteRead read = { move, data, idx, 0 };
+
+    if (offsets.count(idx)) {
+      read.index  = offsets[idx].first;
+      read.offset = offsets[idx].second;
+    } else if (std::find(indices.begin(), indices.end(), idx) ==
+               indices.end()) {
+      continue;
+    }
+
+    reads.push_back(read);
+  }
+
+  if (reads.size() == 0)
+    return "loop does not read consecutive remote array elements";
+
+  // Hoist exactly the definitions the array data depends on.
+  std::set<Expr*>      needed;
+  std::vector<Symbol*> work;
+
+  for (size_t i = 0; i < reads.size(); i++)
+    work.push_back(reads[i].data);
+
+  while (work.size() > 0) {
+    Symbol* sym = work.back();
+    work.pop_back();
+
+    if (hoistableDefs.count(sym) == 0 || needed.count(hoistableDefs[sym]))
+      continue;
+
+    CallExpr* move = toCallExpr(hoistableDefs[sym]);
+    needed.insert(move);
+
+    std::vector<SymExpr*> symExprs;
+    collectSymExprs(move->get(2), symExprs);
+    for_vector(SymExpr, se, symExprs)
+      work.push_back(se->symbol());
+  }
+
+  for_alist(stmt, loop->body) {
+    if (needed.count(stmt))
+      hoist.push_back(stmt);
+  }
+
+  return NULL;
+}
+
+static void narrowReference(Symbol* ref) {
+  if (ref->type->symbol->hasFlag(FLAG_WIDE_REF))
+    ref->type = ref->type->getField("addr")->type;
+
+  ref->qual = QUAL_REF;
+}
+
+static void prefetchLoop(CForLoop*                loop,
+                         Symbol*                  lead,
+                         Symbol*                  end,
+                         std::vector<RemoteRead>& reads,
+                         std::vector<Expr*>&      hoist) {
+  SET_LINENO(loop);
+
+  VarSymbol* cond  = newTemp("pf_cond",  dtBool);
+  VarSymbol* count = newTemp("pf_count", lead->type);
+  BlockStmt* body  = new BlockStmt();
+
+  // Hoist the induction variable initializations; the loop then runs
+  // at least once exactly when 'lead <= end'.
+  for_alist(expr, loop->initBlockGet()->body)
+    loop->insertBefore(expr->remove());
+
+  loop->insertBefore(new DefExpr(cond));
+  loop->insertBefore(new CallExpr(PRIM_MOVE, cond,
+                                  new CallExpr(PRIM_LESSOREQUAL, lead, end)));
+  loop->insertBefore(new CondStmt(new SymExpr(cond), body));
+  body->insertAtTail(loop->remove());
+
+  loop->insertBefore(new DefExpr(count));
+  loop->insertBefore(new CallExpr(PRIM_MOVE, count,
+                                  new CallExpr(PRIM_SUBTRACT, end, lead)));
+  loop->insertBefore(new CallExpr(PRIM_ADD_ASSIGN, count, new_IntSymbol(1)));
+
+  for_vector(Expr, stmt, hoist) {
+    Symbol* sym = toSymExpr(toCallExpr(stmt)->get(1))->symbol();
+
+    if (loop->contains(sym->defPoint))
+      loop->insertBefore(sym->defPoint->remove());
+    loop->insertBefore(stmt->remove());
+  }
+
+  std::map<StreamKey, Symbol*> streams;
+
+  for (size_t i = 0; i < reads.size(); i++) {
+    RemoteRead* read = &reads[i];
+    StreamKey   key(read->data, IndexOffset(read->index, read->offset));
+
+    if (streams.count(key) == 0) {
+      VarSymbol* stream = newTemp("pf_stream", dtCVoidPtr);
+      Symbol*    first  = read->index;
+
+      if (read->offset != 0) {
+        first = newTemp("pf_first", lead->type);
+        loop->insertBefore(new DefExpr(first));
+        loop->insertBefore(new CallExpr(PRIM_MOVE, first,
+                             new CallExpr(PRIM_ADD, read->index,
+                                          new_IntSymbol(read->offset))));
+      }
+
+      loop->insertBefore(new DefExpr(stream));
+      loop->insertBefore(new CallExpr(PRIM_MOVE, stream,
+                           new CallExpr(PRIM_COMM_STREAM_START,
+                                        read->data, first, count)));
+      loop->insertAfter(new CallExpr(PRIM_COMM_STREAM_FINISH, stream));
+
+      streams[key] = stream;
+    }
+
+    CallExpr*  get  = toCallExpr(read->move->get(2));
+    Type*      type = read->data->type->getField("addr")->type;
+    VarSymbol* base = newTemp("pf_base", type);
+
+    read->move->insertBefore(new DefExpr(base));
+    read->move->insertBefore(new CallExpr(PRIM_MOVE, base,
+                               new CallExpr(PRIM_COMM_STREAM_BASE,
+                                            streams[key],
+                                            read->data,
+                                            get->get(2)->copy())));
+    get->get(1)->replace(new SymExpr(base));
+
+    narrowReference(toSymExpr(read->move->get(1))->symbol());
+  }
+}
+
+void prefetchRemoteArrayReads() {
+  if (fNoBulkRemoteReads || !requireWideReferences())
+    return;
+
+  std::vector<CForLoop*>  loops;
+  LoopReport              report;
+
+  forv_Vec(BlockStmt, block, gBlockStmts) {
+    if (CForLoop* loop = toCForLoop(block)) {
+      if (loop->inTree())
+        loops.push_back(loop);
+    }
+  }
+
+  for_vector(CForLoop, loop, loops) {
+    Symbol*                 lead = NULL;
+    Symbol*                 end  = NULL;
+    std::vector<RemoteRead> reads;
+    std::vector<Expr*>      hoist;
+
+    const char* reason = checkLoop(loop, lead, end, reads, hoist);
+
+    if (reason == NULL)
+      prefetchLoop(loop, lead, end, reads, hoist);
+
+    if (fReportBulkRemoteReads)
+      report.note(loop, reason);
+  }
+
+  if (fReportBulkRemoteReads)
+    report.print("Prefetched remote reads in loop",
+                 "Did not prefetch remote reads in loop");
+}
@@ -0,0 +1,424 @@
+/*
+ * Copyright 2004-2018 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// specializeForallLoops
+//
+// After iterator inlining, a zippered forall over contiguous
+// DefaultRectangular arrays, e.g.
+//
+//   forall (a, b, c) in zip(A, B, C) do a = b + alpha*c;
+//
+// ends up as a CForLoop that steps one induction variable per follower
+// and indexes each array's shifted data with its own variable:
+//
+//   for (i1 = lo1, i2 = lo2, i3 = lo3; i1 <= hi; i1++, i2++, i3++)
+//     A->shiftedData[i1] = B->shiftedData[i2] + alpha*C->shiftedData[i3];
+//
+// Backend compilers often fail to recognize such loops as counted loops
+// and so don't vectorize them.  For order independent loops of this
+// shape this pass rewrites them into the canonical form
+//
+//   a = A->shiftedData + lo1; b = B->shiftedData + lo2; ...; n = hi - lo1;
+//   for (k = 0; k <= n; k++)
+//     a[k] = b[k] + alpha*c[k];
+//
+// which, together with the order independence hints emitted during
+// codegen, is what the backends need to vectorize them.
+//
+
+#include "passes.h"
+
+#include "astutil.h"
+#include "CForLoop.h"
+#include "driver.h"
+#include "expr.h"
+#include "loopReport.h"
+#include "optimizations.h"
+#include "stlUtil.h"
+#include "stmt.h"
+#include "symbol.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <vector>
+
+typedef std::map<Symbol*, std::vector<SymExpr*> > IndexUseMap;
+
+static bool isInsideLoop(Expr* expr, CForLoop* loop) {
+  for (Expr* e = expr; e != NULL; e = e->parentExpr) {
+    if (e == loop)
+      return true;
+  }
+  return false;
+}
+
+static bool isInLoopHeader(SymExpr* se, CForLoop* loop) {
+  Expr* clause = se->getStmtExpr()->parentExpr;
+
+  return clause == loop->initBlockGet() ||
+         clause == loop->testBlockGet() ||
+         clause == loop->incrBlockGet();
+}
+
+static bool isArrayAccess(CallExpr* call) {
+  return call->isPrimitive(PRIM_ARRAY_GET)       ||
+         call->isPrimitive(PRIM_ARRAY_GET_VALUE) ||
+         call->isPrimitive(PRIM_ARRAY_SET)       ||
+         call->isPrimitive(PRIM_ARRAY_SET_FIRST);
+}
+
+static bool isIntOne(Expr* expr) {
+  int64_t val = 0;
+  return get_int(expr, &val) && val == 1;
+}
+
+//
+// A symbol is loop invariant if it is a local value (not a reference,
+// which could be redirected) of the loop's function and nothing inside
+// the loop defines it or takes a reference to it.
+//
+bool isCForLoopInvariant(Symbol* sym, CForLoop* loop) {
+  if (sym->isRef() || sym->type->symbol->hasFlag(FLAG_REF))
+    return false;
+
+  if (!isVarSymbol(sym) && !isArgSymbol(sym))
+    return false;
+
+  if (sym->defPoint->parentSymbol != loop->getFunction())
+    return false;
+
+  for_SymbolSymExprs(se, sym) {
+    if (isInsideLoop(se, loop) && (isDefAndOrUse(se) & 1))
+      return false;
+  }
+
+  return true;
+}
+
+//
+// Collect the induction variables from the init clause:  each statement
+// must be a move or assignment into a distinct local.
+//
+static bool findIndexVars(CForLoop* loop, std::vector<Symbol*>& indices) {
+  for_alist(expr, loop->initBlockGet()->body) {
+    CallExpr* move = toCallExpr(expr);
+    if (move == NULL ||
+        (!move->isPrimitive(PRIM_MOVE) && !move->isPrimitive(PRIM_ASSIGN)))
+      return false;
+
+    SymExpr* lhs = toSymExpr(move->get(1));
+    if (lhs == NULL || !isVarSymbol(lhs->symbol()))
+      return false;
+
+    Symbol* index = lhs->symbol();
+    if (!is_int_type(index->type) || index->isRef())
+      return false;
+
+    for_vector(Symbol, other, indices) {
+      if (other == index)
+        return false;
+    }
+
+    indices.push_back(index);
+  }
+
+  return indices.size() > 0;
+}
+
+//
+// Every induction variable must be stepped by exactly one in the incr
+// clause, either directly or through a temp:
+//
+//   i += 1;               or    tmp = i; tmp += 1; i = tmp;
+//
+static bool indexVarsStepByOne(CForLoop* loop, std::vector<Symbol*>& indices) {
+  std::map<Symbol*, Symbol*> tmpOf;     // tmp -> index it was loaded from
+  std::set<Symbol*>          bumped;    // tmps that have been incremented
+  std::set<Symbol*>          stepped;   // indices that have been stepped
+
+  for_alist(expr, loop->incrBlockGet()->body) {
+    if (isDefExpr(expr))
+      continue;
+
+    CallExpr* call = toCallExpr(expr);
+    if (call == NULL || call->numActuals() != 2)
+      return false;
+
+    SymExpr* lhs = toSymExpr(call->get(1));
+    SymExpr* rhs = toSymExpr(call->get(2));
+    if (lhs == NULL || rhs == NULL)
+      return false;
+
+    if (call->isPrimitive(PRIM_ADD_ASSIGN) && isIntOne(rhs)) {
+      if (tmpOf.count(lhs->symbol()))
+        bumped.insert(lhs->symbol());
+      else if (std::find(indices.begin(), indices.end(),
+                         lhs->symbol()) != indices.end())
+        stepped.insert(lhs->symbol());
+      else
+        return false;
+
+    } else if (call->isPrimitive(PRIM_MOVE) &&
+               std::find(indices.begin(), indices.end(),
+                         rhs->symbol()) != indices.end()) {
+      tmpOf[lhs->symbol()] = rhs->symbol();
+
+    } else if (call->isPrimitive(PRIM_MOVE) &&
+               bumped.count(rhs->symbol()) &&
+               tmpOf[rhs->symbol()] == lhs->symbol()) {
+      stepped.insert(lhs->symbol());
+
+    } else {
+      return false;
+    }
+  }
+
+  return stepped.size() == indices.size();
+}
+
+//
+// The test clause must be 'lead <= end' or 'tmp = lead <= end; tmp' with
+// a loop invariant 'end'.
+//
+static bool findBound(CForLoop*             loop,
+                      std::vector<Symbol*>& indices,
+                      Symbol*&              lead,
+                      Symbol*&              end) {
+  CallExpr* cmp = NULL;
+
+  for_alist(expr, loop->testBlockGet()->body) {
+    if (CallExpr* call = toCallExpr(expr)) {
+      if (cmp != NULL)
+        return false;
+
+      if (call->isPrimitive(PRIM_MOVE))
+        cmp = toCallExpr(call->get(2));
+      else
+        cmp = call;
+    }
+  }
+
+  if (cmp == NULL || !cmp->isPrimitive(PRIM_LESSOREQUAL))
+    return false;
+
+  SymExpr* lhs = toSymExpr(cmp->get(1));
+  SymExpr* rhs = toSymExpr(cmp->get(2));
+  if (lhs == NULL || rhs == NULL)
+    return false;
+
+  lead = lhs->symbol();
+  end  = rhs->symbol();
+
+  return std::find(indices.begin(), indices.end(), lead) != indices.end() &&
+         end->type == lead->type &&
+         isCForLoopInvariant(end, loop);
+}
+
+const char* findCountedLoopHeader(CForLoop*             loop,
+                                  std::vector<Symbol*>& indices,
+                                  Symbol*&              lead,
+                                  Symbol*&              end) {
+  if (!findIndexVars(loop, indices))
+    return "loop header is not a simple counted loop";
+
+  if (!indexVarsStepByOne(loop, indices))
+    return "induction variables are not stepped by one";
+
+  if (!findBound(loop, indices, lead, end))
+    return "loop bound is not a loop invariant upper bound";
+
+  return NULL;
+}
+
+//
+// Returns NULL if the loop can be specialized, else the reason why not.
+//
+static const char* checkLoop(CForLoop*             loop,
+                             std::vector<Symbol*>& indices,
+                             Symbol*&              lead,
+                             Symbol*&              end,
+                             IndexUseMap&          arrayUses,
+                             IndexUseMap&          otherUses) {
+  if (const char* reason = findCountedLoopHeader(loop, indices, lead, end))
+    return reason;
+
+  for_vector(Symbol, index, indices) {
+    if (index->type != lead->type)
+      return "induction variables have different types";
+
+    for_SymbolSymExprs(se, index) {
+      // Outside the loop the induction variables may only be written,
+      // since they no longer hold the last index value after the loop.
+      if (!isInsideLoop(se, loop)) {
+        if (isDefAndOrUse(se) != 1)
+          return "induction variable is used outside the loop";
+        continue;
+      }
+
+      // Uses in the header clauses have been checked above.
+      if (isInLoopHeader(se, loop))
+        continue;
+
+      if (isDefAndOrUse(se) & 1)
+        return "induction variable is modified in the loop body";
+
+      CallExpr* call = toCallExpr(se->parentExpr);
+      if (call != NULL && isArrayAccess(call) && call->get(2) == se) {
+        SymExpr* base = toSymExpr(call->get(1));
+        if (base == NULL || !isCForLoopInvariant(base->symbol(), loop))
+          return "array data is not loop invariant";
+        arrayUses[index].push_back(se);
+      } else {
+        otherUses[index].push_back(se);
+      }
+    }
+  }
+
+  if (arrayUses.size() == 0)
+    return "loop does not index any array data";
+
+  return NULL;
+}
+
+static void specializeLoop(CForLoop*             loop,
+                           std::vector<Symbol*>& indices,
+                           Symbol*               lead,
+                           Symbol*               end,
+                           IndexUseMap&          arrayUses,
+                           IndexUseMap&          otherUses) {
+  SET_LINENO(loop);
+
+  Type*      idxType = lead->type;
+  VarSymbol* k       = newTemp("vec_k",     idxType);
+  VarSymbol* last    = newTemp("vec_last",  idxType);
+  VarSymbol* cond    = newTemp("vec_cond",  dtBool);
+  VarSymbol* runs    = newTemp("vec_runs",  dtBool);
+  BlockStmt* body    = new BlockStmt();
+
+  // Hoist the induction variable initializations; from here on the
+  // induction variables just hold the start of each iteration space.
+  for_alist(expr, loop->initBlockGet()->body)
+    loop->insertBefore(expr->remove());
+
+  // The loop runs at least once exactly when 'lead <= end'.  Guard the
+  // rewritten loop so 'end - lead' can't wrap for an unsigned index
+  // type (or overflow for a signed one) when the loop is empty.
+  loop->insertBefore(new DefExpr(runs));
+  loop->insertBefore(new CallExpr(PRIM_MOVE, runs,
+                                  new CallExpr(PRIM_LESSOREQUAL, lead, end)));
+  loop->insertBefore(new CondStmt(new SymExpr(runs), body));
+  body->insertAtTail(loop->remove());
+
+  loop->insertBefore(new DefExpr(k));
+  loop->insertBefore(new DefExpr(last));
+  loop->insertBefore(new CallExpr(PRIM_MOVE, last,
+                                  new CallExpr(PRIM_SUBTRACT, end, lead)));
+
+  // Point each array's data at the start of its iteration space.
+  std::map<std::pair<Symbol*, Symbol*>, Symbol*> shifted;
+
+  for_vector(Symbol, index, indices) {
+    for_vector(SymExpr, se, arrayUses[index]) {
+      CallExpr* call = toCallExpr(se->parentExpr);
+      Symbol*   base = toSymExpr(call->get(1))->symbol();
+      std::pair<Symbol*, Symbol*> key(base, index);
+
+      if (shifted.count(key) == 0) {
+        VarSymbol* data = newTemp("vec_data", base->type);
+        loop->insertBefore(new DefExpr(data));
+        loop->insertBefore(new CallExpr(PRIM_ARRAY_SHIFT_BASE_POINTER,
+                                        data, base, index));
+        shifted[key] = data;
+      }
+
+      call->get(1)->replace(new SymExpr(shifted[key]));
+      se->replace(new SymExpr(k));
+    }
+  }
+
+  // Any other use of an induction variable sees its current value.
+  for_vector(Symbol, index, indices) {
+    if (otherUses[index].size() == 0)
+      continue;
+
+    VarSymbol* cur = newTemp("vec_i", idxType);
+
+    loop->insertAtHead(new CallExpr(PRIM_MOVE, cur,
+                                    new CallExpr(PRIM_ADD, index, k)));
+    loop->insertAtHead(new DefExpr(cur));
+
+    for_vector(SymExpr, se, otherUses[index])
+      se->replace(new SymExpr(cur));
+  }
+
+  // Rebuild the header as 'for (k = 0; k <= last; k += 1)'.
+  for_alist(expr, loop->testBlockGet()->body)
+    expr->remove();
+  for_alist(expr, loop->incrBlockGet()->body)
+    expr->remove();
+
+  loop->initBlockGet()->insertAtTail(new CallExpr(PRIM_MOVE, k,
+                                                  new_IntSymbol(0)));
+
+  loop->testBlockGet()->insertAtTail(new DefExpr(cond));
+  loop->testBlockGet()->insertAtTail(
+    new CallExpr(PRIM_MOVE, cond, new CallExpr(PRIM_LESSOREQUAL, k, last)));
+  loop->testBlockGet()->insertAtTail(new SymExpr(cond));
+
+  loop->incrBlockGet()->insertAtTail(new CallExpr(PRIM_ADD_ASSIGN, k,
+                                                  new_IntSymbol(1)));
+}
+
+void specializeForallLoops() {
+  if (fNoVectorize)
+    return;
+
+  std::vector<CForLoop*>  loops;
+  LoopReport              report;
+
+  forv_Vec(BlockStmt, block, gBlockStmts) {
+    if (CForLoop* loop = toCForLoop(block)) {
+      if (loop->inTree() && loop->isOrderIndependent())
+        loops.push_back(loop);
+    }
+  }
+
+  for_vector(CForLoop, loop, loops) {
+    std::vector<Symbol*> indices;
+    Symbol*              lead = NULL;
+    Symbol*              end  = NULL;
+    IndexUseMap          arrayUses;
+    IndexUseMap          otherUses;
+
+    const char* reason = checkLoop(loop, indices, lead, end,
+                                   arrayUses, otherUses);
+
+    if (reason == NULL)
+      specializeLoop(loop, indices, lead, end, arrayUses, otherUses);
+
+    if (fReportVectorization)
+      report.note(loop, reason);
+  }
+
+  if (fReportVectorization)
+    report.print("Specialized loop for vectorization",
+                 "Did not specialize loop");
+}
@@ -0,0 +1,590 @@
+/*
+ * Copyright 2004-2018 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// stackAllocateClasses
+//
+// A class instance that is allocated in a function and never leaves it,
+// e.g. 'p' in
+//
+//   proc f(i: int) {
+//     var p = new unmanaged Point(i, i+1);
+//     const r = p.norm2();
+//     delete p;
+//     return r;
+//   }
+//
+// or an iterator class that scalar replacement could not eliminate, need
+// not come from the heap.  After inlining such an allocation looks like
+//
+//   tmp = chpl_here_alloc(sizeof(Point), md);
+//   p = (Point) tmp;
+//   ...
+//   chpl_here_free((void*) p);
+//
+// and when escape analysis shows that p, and every copy of it and every
+// reference into it, stay local to the function, this pass replaces the
+// allocation with storage in the function's stack frame and removes the
+// frees.
+//
+// A value escapes if it is stored into a field, a global, an array or
+// through a reference; if it is returned or yielded; or if it is passed
+// to a function that lets the corresponding formal escape, frees it, or
+// is not known at compile time.  Task functions see their arguments
+// through a heap-allocated bundle, so anything passed to a task escapes.
+// Formals are summarized once per function.  A function that returns a
+// formal passes the value through to its call's result.
+//
+// Instances larger than --stack-allocate-class-limit bytes stay on the
+// heap, so that a few big objects can't blow up a task's stack frame.
+//
+// The storage for an allocation is a single slot per function, so an
+// allocation in a loop is reused by every iteration.  The variables
+// that may hold the instance must therefore be declared within the
+// innermost loop around the allocation, so that no instance outlives
+// its iteration.
+//
+
+#include "passes.h"
+
+#include "astutil.h"
+#include "driver.h"
+#include "expr.h"
+#include "LoopStmt.h"
+#include "stlUtil.h"
+#include "stmt.h"
+#include "stringutil.h"
+#include "symbol.h"
+#include "wellknown.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+//
+// What a function may do with the value passed for one of its formals.
+//
+struct FormalSummary {
+  bool escapes;         // it may outlive the call, or the call frees it
+  bool returned;        // the result may be (or point into) it
+  bool alwaysReturned;  // the result is always the value itself
+};
+
+static std::map<ArgSymbol*, FormalSummary> formalSummaries;
+static std::set<ArgSymbol*>                summarizing;
+
+static FormalSummary summarizeFormal(FnSymbol* fn, ArgSymbol* formal);
+
+//
+// Tracks everything in one function that may hold the class instance
+// being analyzed, or a reference into it.
+//
+class EscapeAnalysis {
+public:
+                EscapeAnalysis(FnSymbol* fn, bool inCallee);
+
+  // 'sym' holds the instance itself (definite) or may hold it.
+  void          start(Symbol* sym, bool definite);
+
+  bool          escapes;
+  bool          returned;
+  bool          alwaysReturned;
+  const char*   reason;
+
+  std::set<Symbol*>      holders;
+  std::vector<CallExpr*> frees;
+
+private:
+  void          addHolder(Symbol* sym, bool definite);
+  void          flowsTo(Expr* expr, bool definite);
+  void          escape(const char* why);
+
+  FnSymbol*             fn;
+  bool                  inCallee;
+  std::set<Symbol*>     definites;
+  std::vector<Symbol*>  worklist;
+};
+
+EscapeAnalysis::EscapeAnalysis(FnSymbol* fn, bool inCallee) {
+  this->fn       = fn;
+  this->inCallee = inCallee;
+  escapes        = false;
+  returned       = false;
+  alwaysReturned = true;
+  reason         = NULL;
+}
+
+void EscapeAnalysis::escape(const char* why) {
+  if (escapes == false) {
+    escapes = true;
+    reason  = why;
+  }
+}
+
+static bool isDefOf(SymExpr* se) {
+  if (CallExpr* call = toCallExpr(se->parentExpr)) {
+    if ((call->isPrimitive(PRIM_MOVE) || call->isPrimitive(PRIM_ASSIGN)) &&
+        call->get(1) == se)
+      return true;
+  }
+
+  return false;
+}
+
+static int countDefsOf(Symbol* sym) {
+  int count = 0;
+
+  for_SymbolSymExprs(se, sym) {
+    if (isDefOf(se))
+      count++;
+  }
+
+  return count;
+}
+
+void EscapeAnalysis::start(Symbol* sym, bool definite) {
+  addHolder(sym, definite);
+
+  while (escapes == false && worklist.empty() == false) {
+    Symbol* holder = worklist.back();
+    bool    def    = definites.count(holder) != 0;
+
+    worklist.pop_back();
+
+    for_SymbolSymExprs(se, holder) {
+      if (escapes == true)
+        break;
+
+      if (isDefOf(se) == false)
+        flowsTo(se, def);
+    }
+  }
+
+  if (returned == false)
+    alwaysReturned = false;
+}
+
+void EscapeAnalysis::addHolder(Symbol* sym, bool definite) {
+  if (holders.count(sym) != 0) {
+    // A second flow into the same variable; it can't be relied upon
+    // to hold just this instance.
+    definites.erase(sym);
+    return;
+  }
+
+  holders.insert(sym);
+
+  if (definite == true && countDefsOf(sym) <= 1)
+    definites.insert(sym);
+
+  worklist.push_back(sym);
+}
+
+//
+// 'expr' evaluates to the instance (if 'definite'), to something that
+// may be the instance, or to a reference into it.  Follow it.
+//
+void EscapeAnalysis::flowsTo(Expr* expr, bool definite) {
+  CallExpr* call = toCallExpr(expr->parentExpr);
+
+  if (call == NULL) {
+    escape("used outside of a call");
+
+  } else if (call->isPrimitive(PRIM_MOVE) ||
+             call->isPrimitive(PRIM_ASSIGN)) {
+    SymExpr* lhs = toSymExpr(call->get(1));
+    Symbol*  sym = lhs->symbol();
+
+    if (expr->isRef() == true && sym->isRef() == false) {
+      // A copy of what the reference refers to.
+
+    } else if (isVarSymbol(sym)                      == false ||
+               sym->defPoint->parentSymbol           != fn    ||
+               sym->hasFlag(FLAG_EXTERN)             == true  ||
+               (sym->isRef() == true && expr->isRef() == false)) {
+      escape("stored outside of a local variable");
+
+    } else {
+      addHolder(sym, definite && expr->isRef() == false);
+    }
+
+  } else if (call->isPrimitive(PRIM_CAST)) {
+    flowsTo(call, definite);
+
+  } else if (call->isPrimitive(PRIM_CAST_TO_VOID_STAR) ||
+             call->isPrimitive(PRIM_WIDE_GET_ADDR)) {
+    flowsTo(call, definite);
+
+  } else if (call->isPrimitive(PRIM_DYNAMIC_CAST)) {
+    flowsTo(call, false);
+
+  } else if (call->isPrimitive(PRIM_GET_MEMBER) ||
+             call->isPrimitive(PRIM_GET_SVEC_MEMBER)) {
+    if (call->get(1) == expr)
+      flowsTo(call, false);        // a reference to one of its fields
+    else
+      escape("used as a field index");
+
+  } else if (call->isPrimitive(PRIM_SET_MEMBER) ||
+             call->isPrimitive(PRIM_SET_SVEC_MEMBER)) {
+    if (call->get(1) != expr)
+      escape("stored in a field");
+
+  } else if (call->isPrimitive(PRIM_GET_MEMBER_VALUE) ||
+             call->isPrimitive(PRIM_GET_SVEC_MEMBER_VALUE) ||
+             call->isPrimitive(PRIM_DEREF)                 ||
+             call->isPrimitive(PRIM_GETCID)                ||
+             call->isPrimitive(PRIM_SETCID)                ||
+             call->isPrimitive(PRIM_TESTCID)               ||
+             call->isPrimitive(PRIM_CHECK_NIL)             ||
+             call->isPrimitive(PRIM_EQUAL)                 ||
+             call->isPrimitive(PRIM_NOTEQUAL)              ||
+             call->isPrimitive(PRIM_PTR_EQUAL)             ||
+             call->isPrimitive(PRIM_PTR_NOTEQUAL)) {
+    // Reads it, or its fields, without keeping it.
+
+  } else if (call->isPrimitive(PRIM_RETURN)) {
+    if (inCallee == true) {
+      returned = true;
+      if (definite == false)
+        alwaysReturned = false;
+    } else {
+      escape("returned");
+    }
+
+  } else if (FnSymbol* callee = call->resolvedFunction()) {
+    if (callee->hasFlag(FLAG_LOCALE_MODEL_FREE)) {
+      if (inCallee == true || definite == false)
+        escape("freed where it may not be this instance");
+      else
+        frees.push_back(call);
+
+    } else if (callee->hasFlag(FLAG_EXTERN)) {
+      escape("passed to an extern function");
+
+    } else {
+      ArgSymbol*    formal  = actual_to_formal(expr);
+      FormalSummary summary = summarizeFormal(callee, formal);
+
+      if (formal->isRef() == true && expr->isRef() == false)
+        escape("passed by reference");
+      else if (summary.escapes == true)
+        escape("passed to a function it escapes from");
+      else if (summary.returned == true)
+        flowsTo(call, definite && summary.alwaysReturned);
+    }
+
+  } else if (call->primitive != NULL) {
+    escape(astr("used by primitive '", call->primitive->name, "'"));
+
+  } else {
+    escape("passed to an unresolved call");
+  }
+}
+
+static FormalSummary summarizeFormal(FnSymbol* fn, ArgSymbol* formal) {
+  std::map<ArgSymbol*, FormalSummary>::iterator it;
+  FormalSummary                                 retval;
+
+  it = formalSummaries.find(formal);
+
+  if (it != formalSummaries.end())
+    return it->second;
+
+  retval.escapes        = true;
+  retval.returned       = true;
+  retval.alwaysReturned = false;
+
+  // Recursion is conservatively assumed to let everything escape.
+  if (summarizing.count(formal) != 0)
+    return retval;
+
+  if (fn->hasFlag(FLAG_EXTERN) == false && fn->body->body.length > 0) {
+    EscapeAnalysis analysis(fn, true);
+
+    summarizing.insert(formal);
+
+    // A formal that is not assigned holds the actual throughout.
+    analysis.start(formal, formal->isRef() == false &&
+                           countDefsOf(formal) == 0);
+
+    summarizing.erase(formal);
+
+    retval.escapes        = analysis.escapes;
+    retval.returned       = analysis.returned;
+    retval.alwaysReturned = analysis.alwaysReturned;
+  }
+
+  formalSummaries[formal] = retval;
+
+  return retval;
+}
+
+/************************************* | **************************************
+*                                                                             *
+* Finding and converting allocations                                          *
+*                                                                             *
+************************************** | *************************************/
+
+struct Allocation {
+  CallExpr*      allocMove;   // (move tmp (chpl_here_alloc size md))
+  CallExpr*      castMove;    // (move sym (cast C tmp))
+  Symbol*        tmp;
+  Symbol*        sym;
+  AggregateType* ct;
+};
+
+struct AllocReport {
+  std::string file;
+  int         line;
+  std::string type;
+  const char* reason;         // NULL if stack allocated
+
+  bool operator<(const AllocReport& other) const {
+    if (file != other.file)
+      return file < other.file;
+    return line < other.line;
+  }
+};
+
+static bool isAllocation(CallExpr* call, Allocation& alloc) {
+  FnSymbol* callee = call->resolvedFunction();
+
+  if (callee == NULL ||
+      (callee != gChplHereAlloc && callee != gChplHereTaskAlloc))
+    return false;
+
+  CallExpr* allocMove = toCallExpr(call->parentExpr);
+
+  if (allocMove == NULL || allocMove->isPrimitive(PRIM_MOVE) == false)
+    return false;
+
+  Symbol*  tmp = toSymExpr(allocMove->get(1))->symbol();
+  SymExpr* use = tmp->getSingleUse();
+
+  if (tmp->getSingleDef() == NULL || use == NULL)
+    return false;
+
+  CallExpr* cast     = toCallExpr(use->parentExpr);
+  CallExpr* castMove = cast ? toCallExpr(cast->parentExpr) : NULL;
+
+  if (cast     == NULL || cast->isPrimitive(PRIM_CAST)         == false ||
+      castMove == NULL || castMove->isPrimitive(PRIM_MOVE)     == false ||
+      castMove->get(2) != cast)
+    return false;
+
+  Symbol*        sym = toSymExpr(castMove->get(1))->symbol();
+  AggregateType* ct  = toAggregateType(sym->type);
+
+  if (ct == NULL || isClass(ct) == false ||
+      ct->symbol->hasFlag(FLAG_EXTERN) == true ||
+      sym->isRef() == true ||
+      isVarSymbol(sym) == false ||
+      sym->defPoint->parentSymbol != allocMove->getFunction())
+    return false;
+
+  alloc.allocMove = allocMove;
+  alloc.castMove  = castMove;
+  alloc.tmp       = tmp;
+  alloc.sym       = sym;
+  alloc.ct        = ct;
+
+  return true;
+}
+
+//
+// An estimate of the size of a value of type t, in bytes.  Records and
+// tuples are stored inline, and so is the parent part of a class;
+// anything else is at most pointer-sized.
+//
+static int64_t valueSize(Type* t) {
+  if (is_bool_type(t) || is_int_type(t) || is_uint_type(t) ||
+      is_real_type(t) || is_imag_type(t) || is_complex_type(t))
+    return std::max(get_width(t) / 8, 1);
+
+  if (AggregateType* at = toAggregateType(t)) {
+    if (at->symbol->hasFlag(FLAG_REF)        == true ||
+        at->symbol->hasFlag(FLAG_WIDE_REF)   == true ||
+        at->symbol->hasFlag(FLAG_WIDE_CLASS) == true)
+      return 16;
+
+    if (isRecord(at) || isUnion(at)) {
+      int64_t size = 0;
+
+      for_fields(field, at) {
+        size += valueSize(field->type);
+      }
+
+      return size;
+    }
+  }
+
+  return 8;
+}
+
+static int64_t instanceSize(AggregateType* ct) {
+  int64_t size = 0;
+
+  for_fields(field, ct) {
+    AggregateType* parent = toAggregateType(field->type);
+
+    if (field->hasFlag(FLAG_SUPER_CLASS) == true && parent != NULL)
+      size += instanceSize(parent);
+    else
+      size += valueSize(field->type);
+  }
+
+  return size;
+}
+
+//
+// Every holder must be declared within the innermost loop around the
+// allocation (see above).
+//
+static bool holdersAreScopedToLoop(Allocation&        alloc,
+                                   std::set<Symbol*>& holders) {
+  LoopStmt* loop = LoopStmt::findEnclosingLoop(alloc.allocMove);
+
+  if (loop == NULL)
+    return true;
+
+  for (std::set<Symbol*>::iterator it = holders.begin();
+       it != holders.end();
+       ++it) {
+    if (loop->contains((*it)->defPoint) == false)
+      return false;
+  }
+
+  return true;
+}
+
+// Iterator advance functions resume in the middle of their bodies, so
+// their control flow is not structured enough for the loop check.
+static bool hasResumeGotos(FnSymbol* fn) {
+  std::vector<GotoStmt*> gotos;
+
+  collectGotoStmts(fn, gotos);
+
+  for_vector(GotoStmt, gotoStmt, gotos) {
+    if (gotoStmt->gotoTag == GOTO_ITER_RESUME)
+      return true;
+  }
+
+  return false;
+}
+
+static void stackAllocate(Allocation& alloc, std::vector<CallExpr*>& frees) {
+  SET_LINENO(alloc.castMove);
+
+  alloc.castMove->get(2)->replace(new CallExpr(PRIM_STACK_ALLOCATE_CLASS,
+                                               alloc.ct->symbol));
+  alloc.allocMove->remove();
+  alloc.tmp->defPoint->remove();
+
+  for_vector(CallExpr, free, frees) {
+    free->remove();
+  }
+}
+
+static void noteAllocation(std::vector<AllocReport>& reports,
+                           Allocation&               alloc,
+                           const char*               reason) {
+  ModuleSymbol* mod     = alloc.allocMove->getModule();
+  ModuleSymbol* typeMod = alloc.ct->symbol->getModule();
+
+  if (!developer && (mod->modTag != MOD_USER || typeMod->modTag != MOD_USER))
+    return;
+
+  // Classes that the compiler makes up to carry arguments, such as the
+  // _fn_arg_bundle of a recursive iterator's loop body, mean nothing to
+  // the user.  They are the ones without the root 'object' class.
+  // Iterator classes are still reported; they stand for user iterators.
+  if (!developer && alloc.ct->symbol->hasFlag(FLAG_NO_OBJECT))
+    return;
+
+  AllocReport report = { alloc.allocMove->fname(),
+                         alloc.allocMove->linenum(),
+                         alloc.ct->symbol->name,
+                         reason };
+
+  reports.push_back(report);
+}
+
+void stackAllocateClasses() {
+  if (fNoStackAllocateClasses == true)
+    return;
+
+  std::vector<AllocReport> reports;
+
+  forv_Vec(FnSymbol, fn, gFnSymbols) {
+    if (fn->defPoint->parentSymbol == NULL || hasResumeGotos(fn) == true)
+      continue;
+
+    std::vector<CallExpr*> calls;
+
+    collectCallExprs(fn, calls);
+
+    for_vector(CallExpr, call, calls) {
+      Allocation alloc;
+
+      if (call->parentSymbol == NULL || isAllocation(call, alloc) == false)
+        continue;
+
+      EscapeAnalysis analysis(fn, false);
+      const char*    reason = NULL;
+
+      if (instanceSize(alloc.ct) > stack_allocate_class_limit) {
+        if (fReportStackAllocateClasses == true)
+          noteAllocation(reports, alloc, "too large for the stack");
+
+        continue;
+      }
+
+      analysis.start(alloc.sym, true);
+
+      if (analysis.escapes == true)
+        reason = analysis.reason;
+      else if (holdersAreScopedToLoop(alloc, analysis.holders) == false)
+        reason = "may outlive its loop iteration";
+
+      if (fReportStackAllocateClasses == true)
+        noteAllocation(reports, alloc, reason);
+
+      if (reason == NULL)
+        stackAllocate(alloc, analysis.frees);
+    }
+  }
+
+  formalSummaries.clear();
+
+  std::stable_sort(reports.begin(), reports.end());
+
+  for (size_t i = 0; i < reports.size(); i++) {
+    if (reports[i].reason == NULL)
+      printf("Stack allocated %s at %s:%d\n",
+             reports[i].type.c_str(),
+             reports[i].file.c_str(), reports[i].line);
+    else
+      printf("Did not stack allocate %s at %s:%d: %s\n",
+             reports[i].type.c_str(),
+             reports[i].file.c_str(), reports[i].line, reports[i].reason);
+  }
+}
@@ -112,13 +112,11 @@ void parse() {
 *                            ./localeModels/knl/LocaleModel.chpl              *
 *                            ./localeModels/numa/LocaleModel.chpl             *
 *                                                                             *
-*   NetworkAtomicTypes       ./comm/ugni/NetworkAtomicTypes.chpl              *
-*                            ./NetworkAtomicTypes.chpl                        *
-*                                                                             *
 * The search paths include the value of configuration variables.              *
-* This means that a search for the first two cases will be unique.            *
+* This means that a search for these cases will be unique.                    *
 *                                                                             *
-* However the third case is currently ambiguous.  This is handled by          *
+* A module that is in both a configuration-specific directory and in          *
+* internal/ itself would be ambiguous.  This is handled by                    *
 *    a) preferring the first hit to later hits                                *
 *    b) disabling the warning message for searches in internal/               *
 *                                                                             *
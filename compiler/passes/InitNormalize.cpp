@@ -62,8 +62,9 @@ InitNormalize::InitNormalize(BlockStmt* block, const InitNormalize& curr) {
       // should match against them here
       mBlockType = cBlockCobegin;
 
-    } else if (blockInfo->isPrimitive(PRIM_BLOCK_COFORALL)    == true ||
-               blockInfo->isPrimitive(PRIM_BLOCK_COFORALL_ON) == true) {
+    } else if (blockInfo->isPrimitive(PRIM_BLOCK_COFORALL)      == true ||
+               blockInfo->isPrimitive(PRIM_BLOCK_COFORALL_TEAM) == true ||
+               blockInfo->isPrimitive(PRIM_BLOCK_COFORALL_ON)   == true) {
       mBlockType = cBlockCoforall;
 
     } else if (blockInfo->isPrimitive(PRIM_BLOCK_ON) == true) {
@@ -760,6 +760,11 @@ void createTaskFunctions(void) {
         fn = new FnSymbol("coforall_fn");
         fn->addFlag(FLAG_COBEGIN_OR_COFORALL);
         isCoforall = true;
+      } else if (info->isPrimitive(PRIM_BLOCK_COFORALL_TEAM)) {
+        fn = new FnSymbol("coforall_fn");
+        fn->addFlag(FLAG_COBEGIN_OR_COFORALL);
+        fn->addFlag(FLAG_COFORALL_TEAM);
+        isCoforall = true;
       } else if (info->isPrimitive(PRIM_BLOCK_ON) ||
                  info->isPrimitive(PRIM_BLOCK_BEGIN_ON) ||
                  info->isPrimitive(PRIM_BLOCK_COBEGIN_ON) ||
@@ -106,7 +106,7 @@ static int broadcastGlobalID = 0;
 static void insertEndCounts();
 static void passArgsToNestedFns();
 static void create_block_fn_wrapper(FnSymbol* fn, CallExpr* fcall, BundleArgsFnData &baData);
-static void call_block_fn_wrapper(FnSymbol* fn, CallExpr* fcall, VarSymbol* args_buf, VarSymbol* args_buf_len, VarSymbol* tempc, FnSymbol *wrap_fn, Symbol* taskList, Symbol* taskListNode);
+static void call_block_fn_wrapper(FnSymbol* fn, CallExpr* fcall, VarSymbol* args_buf, VarSymbol* args_buf_len, VarSymbol* tempc, FnSymbol *wrap_fn, Symbol* taskList, Symbol* taskListNode, Symbol* teamSize);
 static void findBlockRefActuals(Vec<Symbol*>& refSet, Vec<Symbol*>& refVec);
 static void findHeapVarsAndRefs(Map<Symbol*,Vec<SymExpr*>*>& defMap,
                                 Vec<Symbol*>& refSet, Vec<Symbol*>& refVec,
@@ -267,6 +267,11 @@ static bool needsAutoCopyAutoDestroyForArg(ArgSymbol* formal, Expr* arg,
   if (shouldAddFormalTempAtCallSite(formal, fn))
     return false;
 
+  // Every task in a team reads the same bundle, and the parent outlives
+  // the team. The task function copies its own value formals.
+  if (fn->hasFlag(FLAG_COFORALL_TEAM))
+    return false;
+
   if (!formal->isRef() && isRecord(baseType))
     return true;
 
@@ -473,6 +478,7 @@ bundleArgs(CallExpr* fcall, BundleArgsFnData &baData) {
   Symbol* endCount = NULL;
   VarSymbol *taskList = NULL;
   VarSymbol *taskListNode = NULL;
+  VarSymbol *teamSize = NULL;
 
   if (!fn->hasFlag(FLAG_ON)) {
     for_actuals(arg, fcall) {
@@ -523,6 +529,17 @@ bundleArgs(CallExpr* fcall, BundleArgsFnData &baData) {
       fcall->insertBefore(new CallExpr(PRIM_MOVE, taskListNode,
                                        new CallExpr(PRIM_WIDE_GET_NODE,
                                                     endCount)));
+
+      // A task team also needs its size, which _upTeamEndCount()
+      // recorded in the end count.
+      if (fn->hasFlag(FLAG_COFORALL_TEAM)) {
+        teamSize = newTemp(astr("_teamSize", fn->name), dtInt[INT_SIZE_DEFAULT]);
+        fcall->insertBefore(new DefExpr(teamSize));
+        fcall->insertBefore(new CallExpr(PRIM_MOVE, teamSize,
+                                         new CallExpr(PRIM_GET_MEMBER_VALUE,
+                                                      endCount,
+                                                      endCount->typeInfo()->getField("teamSize"))));
+      }
     }
   }
 
@@ -531,7 +548,7 @@ bundleArgs(CallExpr* fcall, BundleArgsFnData &baData) {
     create_block_fn_wrapper(fn, fcall, baData);
 
   // call wrapper-function
-  call_block_fn_wrapper(fn, fcall, allocated_args, tmpsz, tempc, baData.wrap_fn, taskList, taskListNode);
+  call_block_fn_wrapper(fn, fcall, allocated_args, tmpsz, tempc, baData.wrap_fn, taskList, taskListNode, teamSize);
   baData.firstCall = false;
 }
 
@@ -735,6 +752,7 @@ static void create_block_fn_wrapper(FnSymbol* fn, CallExpr* fcall, BundleArgsFnD
   if (fn->hasFlag(FLAG_COBEGIN_OR_COFORALL))    wrap_fn->addFlag(FLAG_COBEGIN_OR_COFORALL_BLOCK);
   if (fn->hasFlag(FLAG_BEGIN))                  wrap_fn->addFlag(FLAG_BEGIN_BLOCK);
   if (fn->hasFlag(FLAG_LOCAL_ON))               wrap_fn->addFlag(FLAG_LOCAL_ON);
+  if (fn->hasFlag(FLAG_COFORALL_TEAM))          wrap_fn->addFlag(FLAG_COFORALL_TEAM);
 
   if (fn->hasFlag(FLAG_ON)) {
     // The wrapper function for 'on' block has an additional argument, which
@@ -779,6 +797,13 @@ static void create_block_fn_wrapper(FnSymbol* fn, CallExpr* fcall, BundleArgsFnD
   ArgSymbol *allocated_sz = new ArgSymbol( INTENT_IN, "buf_size",  dtInt[INT_SIZE_DEFAULT]);
   allocated_sz->addFlag(FLAG_NO_CODEGEN);
   wrap_fn->insertFormalAtTail(allocated_sz);
+  if (fn->hasFlag(FLAG_COFORALL_TEAM)) {
+    // The number of tasks in the team, passed through to the spawn call.
+    ArgSymbol *teamSize = new ArgSymbol( INTENT_IN, "dummy_teamSize",
+                                         dtInt[INT_SIZE_DEFAULT]);
+    teamSize->addFlag(FLAG_NO_CODEGEN);
+    wrap_fn->insertFormalAtTail(teamSize);
+  }
   ArgSymbol *wrap_c = new ArgSymbol( INTENT_IN, "c", ctype);
   //wrap_c->addFlag(FLAG_NO_CODEGEN);
   wrap_fn->insertFormalAtTail(wrap_c);
@@ -874,7 +899,7 @@ static void create_block_fn_wrapper(FnSymbol* fn, CallExpr* fcall, BundleArgsFnD
 
 static void call_block_fn_wrapper(FnSymbol* fn, CallExpr* fcall, VarSymbol*
     args_buf, VarSymbol* args_buf_len, VarSymbol* tempc, FnSymbol *wrap_fn,
-    Symbol* taskList, Symbol* taskListNode)
+    Symbol* taskList, Symbol* taskListNode, Symbol* teamSize)
 {
   // The wrapper function is called with the bundled argument list.
   if (fn->hasFlag(FLAG_ON)) {
@@ -887,7 +912,11 @@ static void call_block_fn_wrapper(FnSymbol* fn, CallExpr* fcall, VarSymbol*
     // (so that codegen can find it).
     // We need the taskList.
     INT_ASSERT(taskList);
-    fcall->insertBefore(new CallExpr(wrap_fn, new SymExpr(taskList), new SymExpr(taskListNode), args_buf, args_buf_len, tempc));
+    CallExpr* wrap_call = new CallExpr(wrap_fn, new SymExpr(taskList), new SymExpr(taskListNode), args_buf, args_buf_len);
+    if (teamSize)
+      wrap_call->insertAtTail(teamSize);
+    wrap_call->insertAtTail(tempc);
+    fcall->insertBefore(wrap_call);
   }
 
   fcall->remove();                     // rm orig. call
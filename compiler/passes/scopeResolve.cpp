@@ -1245,6 +1245,7 @@ static void checkIdInsideWithClause(Expr*              exprInAst,
         // Ensure that an issue, indeed, occurred a task construct.
         INT_ASSERT(blockInfo->isPrimitive(PRIM_BLOCK_COBEGIN)  ||
                    blockInfo->isPrimitive(PRIM_BLOCK_COFORALL) ||
+                   blockInfo->isPrimitive(PRIM_BLOCK_COFORALL_TEAM) ||
                    blockInfo->isPrimitive(PRIM_BLOCK_BEGIN));
 
         errorDotInsideWithClause(origUSE, blockInfo->primitive->name);
@@ -21,6 +21,7 @@
 
 #include "addAutoDestroyCalls.h"
 #include "astutil.h"
+#include "elideRefCountCopies.h"
 #include "errorHandling.h"
 #include "ForallStmt.h"
 #include "iterator.h"
@@ -1387,6 +1388,8 @@ void callDestructors() {
 
   lateConstCheck(NULL);
 
+  elideRefCountCopies();
+
   insertGlobalAutoDestroyCalls();
   insertReferenceTemps();
 
@@ -0,0 +1,578 @@
+/*
+ * Copyright 2004-2018 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "elideRefCountCopies.h"
+
+#include "astutil.h"
+#include "driver.h"
+#include "expr.h"
+#include "resolution.h"
+#include "stlUtil.h"
+#include "stmt.h"
+#include "symbol.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+/* This file removes copies of reference-counted records that are
+   balanced by a destroy of the copy within the lifetime of the original.
+
+   Copying a record marked pragma "refcounted" (e.g. Shared) only
+   increments a count shared by every copy, and destroying the copy
+   decrements it again.  In
+
+     const c = s;
+     ...
+     // end of c's scope
+
+   the increment and the decrement are atomic operations on the same
+   cache line no matter how many tasks are doing this, but they cancel
+   out whenever s keeps the count above zero for as long as c is alive.
+   That is the case when
+
+     * s is not modified or handed to anything that might modify or
+       destroy it, and
+     * c's scope is nested within s's, and
+     * c is only read, and never stored or moved anywhere that could
+       outlive it.
+
+   Then c can simply be a bitwise copy of s and its destroy can go.  The
+   lifetime checker has already run, so every borrow from c is known to
+   end within c's scope, and therefore within s's as well.
+
+   The same pattern shows up for task intents.  A coforall task copies
+   each outer 'const' variable when it starts and destroys the copy when
+   it ends; a cobegin does the copy in the parent and lets each task
+   destroy its own.  Neither kind of task can outlive the statement that
+   created it, so as long as the outer variable is stable the copies can
+   be elided in the same way.  A begin is not covered, since it may
+   outlive the variable.
+
+   Formals with 'in' intent are the function's own copy.  Task functions
+   also receive a bitwise snapshot of the outer variable through by-value
+   formals, which stays valid because the parent waits for the task.
+   Both are therefore stable sources if they are only read.
+ */
+
+namespace {
+  struct ElisionReport {
+    std::string file;
+    int         line;
+    std::string type;
+
+    bool operator<(const ElisionReport& other) const {
+      if (file != other.file)
+        return file < other.file;
+      return line < other.line;
+    }
+  };
+}
+
+// How far to follow aliases and formals when checking that a value is
+// only read.
+static const int maxDepth = 4;
+
+static std::map<ArgSymbol*, bool> readOnlyFormals;
+static std::set<ArgSymbol*>       checkingFormals;
+
+static bool onlyReadUses(Symbol* sym, SymExpr* except, int depth);
+
+static bool isRefCounted(Type* type) {
+  return type->symbol->hasFlag(FLAG_REFCOUNTED);
+}
+
+static bool isDestroy(CallExpr* call) {
+  FnSymbol* fn = call->resolvedFunction();
+
+  return fn != NULL && fn->hasFlag(FLAG_AUTO_DESTROY_FN);
+}
+
+static bool isInitCopy(CallExpr* call) {
+  FnSymbol* fn = call->resolvedFunction();
+
+  return fn != NULL && fn->hasFlag(FLAG_INIT_COPY_FN) && call->numActuals() == 1;
+}
+
+static bool isCopyInit(CallExpr* call) {
+  FnSymbol* fn = call->resolvedFunction();
+
+  return fn                                    != NULL &&
+         fn->isInitializer()                   == true &&
+         fn->numFormals()                      == 2    &&
+         fn->getFormal(1)->hasFlag(FLAG_ARG_THIS)      &&
+         fn->getFormal(1)->getValType()        == fn->getFormal(2)->getValType();
+}
+
+static bool isLocalValue(Symbol* sym, FnSymbol* fn) {
+  return isVarSymbol(sym)                    == true &&
+         sym->defPoint->parentSymbol         == fn   &&
+         sym->isRef()                        == false &&
+         sym->hasFlag(FLAG_REF_VAR)          == false;
+}
+
+// Is 'expr' inside the block that declares 'sym'?
+static bool isInScopeOf(Expr* expr, Symbol* sym) {
+  Expr* block = sym->defPoint->parentExpr;
+
+  for (Expr* e = expr; e != NULL; e = e->parentExpr) {
+    if (e == block)
+      return true;
+  }
+
+  return false;
+}
+
+static bool isStableFormal(ArgSymbol* formal) {
+  FnSymbol* fn = toFnSymbol(formal->defPoint->parentSymbol);
+
+  if (formal->isRef() == true || (formal->intent & INTENT_FLAG_IN) == 0)
+    return false;
+
+  // A begin, or an on that does not wait, may outlive its caller.
+  if (fn->hasFlag(FLAG_BEGIN) == true)
+    return false;
+
+  if (fn->hasFlag(FLAG_NON_BLOCKING)        == true &&
+      fn->hasFlag(FLAG_COBEGIN_OR_COFORALL) == false)
+    return false;
+
+  return true;
+}
+
+static bool formalIsOnlyRead(ArgSymbol* formal, int depth) {
+  std::map<ArgSymbol*, bool>::iterator it = readOnlyFormals.find(formal);
+
+  if (it != readOnlyFormals.end())
+    return it->second;
+
+  // Recursive functions: assume the worst.
+  if (checkingFormals.count(formal) != 0)
+    return false;
+
+  checkingFormals.insert(formal);
+
+  bool retval = onlyReadUses(formal, NULL, depth);
+
+  checkingFormals.erase(formal);
+
+  // Results found at the depth limit are not final.
+  if (retval == true || depth == maxDepth)
+    readOnlyFormals[formal] = retval;
+
+  return retval;
+}
+
+// Does this use of a reference-counted value only read it?  It must not
+// modify, destroy or transfer the value, and any alias it creates must
+// only be read in turn.
+static bool isReadOnlyUse(SymExpr* se, int depth) {
+  CallExpr* call = toCallExpr(se->parentExpr);
+
+  if (call == NULL) {
+    // The outer variable of a forall shadow variable.
+    ShadowVarSymbol* svar = toShadowVarSymbol(se->parentSymbol);
+
+    return se->parentExpr   == NULL &&
+           svar             != NULL &&
+           svar->isConstant() == true;
+  }
+
+  if (FnSymbol* fn = call->resolvedFunction()) {
+    ArgSymbol* formal = actual_to_formal(se);
+
+    if (fn->hasFlag(FLAG_AUTO_DESTROY_FN) == true)
+      return false;
+
+    if (formal->intent == INTENT_CONST_REF)
+      return true;
+
+    if (fn->hasFlag(FLAG_EXTERN) == true || depth == 0)
+      return false;
+
+    // 'in' and 'ref' formals may or may not take the value over;
+    // look at what the callee does with them.
+    return formalIsOnlyRead(formal, depth - 1);
+  }
+
+  if (call->isPrimitive(PRIM_MOVE) == true && call->get(2) == se) {
+    Symbol* lhs = toSymExpr(call->get(1))->symbol();
+
+    // A bitwise copy into a temp that is never destroyed is an alias.
+    if (depth                                         == 0     ||
+        isLocalValue(lhs, call->getFunction())        == false ||
+        lhs->hasFlag(FLAG_INSERT_AUTO_DESTROY_FOR_EXPLICIT_NEW) == true)
+      return false;
+
+    if (lhs->hasFlag(FLAG_INSERT_AUTO_DESTROY) == true &&
+        lhs->hasFlag(FLAG_NO_AUTO_DESTROY)     == false)
+      return false;
+
+    return onlyReadUses(lhs, toSymExpr(call->get(1)), depth - 1);
+  }
+
+  if ((call->isPrimitive(PRIM_ADDR_OF)       == true ||
+       call->isPrimitive(PRIM_SET_REFERENCE) == true) &&
+      depth > 0) {
+    CallExpr* move = toCallExpr(call->parentExpr);
+
+    if (move != NULL && move->isPrimitive(PRIM_MOVE) && move->get(2) == call) {
+      Symbol* ref = toSymExpr(move->get(1))->symbol();
+
+      return ref->defPoint->parentSymbol == call->getFunction() &&
+             onlyReadUses(ref, toSymExpr(move->get(1)), depth - 1);
+    }
+
+    return false;
+  }
+
+  if (call->isPrimitive(PRIM_GET_MEMBER_VALUE) == true && call->get(1) == se)
+    return true;
+
+  return false;
+}
+
+static bool onlyReadUses(Symbol* sym, SymExpr* except, int depth) {
+  for_SymbolSymExprs(se, sym) {
+    if (se != except && isReadOnlyUse(se, depth) == false)
+      return false;
+  }
+
+  return true;
+}
+
+// Will 'src' keep its count above zero, unchanged, for as long as a
+// copy made at 'scope' is alive?
+static bool isStableSource(Symbol* src, Expr* scope, int depth) {
+  FnSymbol* fn = scope->getFunction();
+
+  if (src->isRef() == true)
+    return false;
+
+  if (isModuleSymbol(src->defPoint->parentSymbol) == true)
+    return src->hasFlag(FLAG_CONST) == true && src->hasFlag(FLAG_EXTERN) == false;
+
+  if (ArgSymbol* formal = toArgSymbol(src))
+    return formal->defPoint->parentSymbol == fn &&
+           isStableFormal(formal)     == true &&
+           formalIsOnlyRead(formal, maxDepth) == true;
+
+  if (isLocalValue(src, fn) == false || isInScopeOf(scope, src) == false)
+    return false;
+
+  bool owned = src->hasFlag(FLAG_INSERT_AUTO_DESTROY) == true &&
+               src->hasFlag(FLAG_NO_AUTO_DESTROY)     == false;
+
+  for_SymbolSymExprs(se, src) {
+    CallExpr* call = toCallExpr(se->parentExpr);
+
+    if (call != NULL && call->isPrimitive(PRIM_MOVE) && call->get(1) == se) {
+      // Initialization.  If src does not own its value, it is an alias
+      // of whatever it was initialized from.
+      SymExpr* rhs = toSymExpr(call->get(2));
+
+      if (owned == false && rhs != NULL &&
+          (depth == 0 || isStableSource(rhs->symbol(), scope, depth - 1) == false))
+        return false;
+
+    } else if (call != NULL && call->resolvedFunction() != NULL &&
+               call->resolvedFunction()->isInitializer() == true &&
+               call->get(1) == se) {
+      continue;
+
+    } else if (call != NULL && isDestroy(call) == true) {
+      // src's own destroy, at the end of a scope enclosing the copy's.
+      if (owned == false)
+        return false;
+
+    } else if (isReadOnlyUse(se, maxDepth) == false) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Check that 'copy' is only read apart from its initialization 'def',
+// and gather the calls that destroy it.
+static bool isReadOnlyCopy(Symbol*                 copy,
+                           Expr*                   def,
+                           std::vector<CallExpr*>& destroys) {
+  for_SymbolSymExprs(se, copy) {
+    CallExpr* call = toCallExpr(se->parentExpr);
+
+    if (call == def)
+      continue;
+
+    if (call != NULL && isDestroy(call) == true)
+      destroys.push_back(call);
+
+    else if (isReadOnlyUse(se, maxDepth) == false)
+      return false;
+  }
+
+  return true;
+}
+
+static void noteElision(std::vector<ElisionReport>& reports,
+                        BaseAST*                    where,
+                        Type*                       type) {
+  ModuleSymbol* mod = where->getModule();
+
+  if (fReportRefCountElision == false ||
+      (developer == false && mod->modTag != MOD_USER))
+    return;
+
+  ElisionReport report = { where->fname(), where->linenum(), type->symbol->name };
+
+  reports.push_back(report);
+}
+
+//
+// init(dst, src);   or   move dst, chpl__initCopy(src);
+//
+static bool isCopy(CallExpr* call, SymExpr*& dst, SymExpr*& src) {
+  dst = NULL;
+  src = NULL;
+
+  if (isCopyInit(call) == true) {
+    dst = toSymExpr(call->get(1));
+    src = toSymExpr(call->get(2));
+
+  } else if (call->isPrimitive(PRIM_MOVE) == true) {
+    CallExpr* rhs = toCallExpr(call->get(2));
+
+    if (rhs != NULL && isInitCopy(rhs) == true) {
+      dst = toSymExpr(call->get(1));
+      src = toSymExpr(rhs->get(1));
+    }
+  }
+
+  return dst                                 != NULL &&
+         src                                 != NULL &&
+         isRefCounted(dst->symbol()->type)   == true &&
+         src->symbol()->type                 == dst->symbol()->type;
+}
+
+// Turn the copy into a bitwise move that shares src's count.
+static void replaceCopy(CallExpr* call, Symbol* dst, Symbol* src) {
+  SET_LINENO(call);
+
+  call->replace(new CallExpr(PRIM_MOVE, dst, src));
+}
+
+//
+// const c = s;   or   _formal_tmp = chpl__initCopy(s);
+//
+static bool elideLocalCopy(CallExpr* call, std::vector<ElisionReport>& reports) {
+  FnSymbol* fn   = call->getFunction();
+  SymExpr*  dst  = NULL;
+  SymExpr*  src  = NULL;
+
+  if (isCopy(call, dst, src) == false)
+    return false;
+
+  Symbol* copy = dst->symbol();
+
+  if (isLocalValue(copy, fn)                     == false ||
+      copy->hasFlag(FLAG_INSERT_AUTO_DESTROY)    == false)
+    return false;
+
+  std::vector<CallExpr*> destroys;
+
+  if (isReadOnlyCopy(copy, call, destroys)               == false ||
+      isStableSource(src->symbol(), copy->defPoint, maxDepth) == false)
+    return false;
+
+  // A task's copy of an outer variable is reported at the task.
+  if (isArgSymbol(src->symbol()) == true &&
+      fn->hasFlag(FLAG_COBEGIN_OR_COFORALL) == true)
+    noteElision(reports, fn, copy->type);
+  else
+    noteElision(reports, call, copy->type);
+
+  replaceCopy(call, copy, src->symbol());
+
+  for_vector(CallExpr, destroy, destroys) {
+    destroy->remove();
+  }
+
+  copy->addFlag(FLAG_NO_AUTO_DESTROY);
+
+  return true;
+}
+
+// Follow a value that is never destroyed through bitwise moves into
+// temps until it reaches its only other use, which must be a call to a
+// cobegin task.
+static CallExpr* findTaskCall(Symbol* tmp, Expr* def, Symbol*& actual) {
+  FnSymbol* fn = def->getFunction();
+
+  while (isLocalValue(tmp, fn)                  == true  &&
+         (tmp->hasFlag(FLAG_INSERT_AUTO_DESTROY) == false ||
+          tmp->hasFlag(FLAG_NO_AUTO_DESTROY)     == true)) {
+    SymExpr* use = NULL;
+
+    for_SymbolSymExprs(se, tmp) {
+      if (se->parentExpr == def)
+        continue;
+
+      if (use != NULL)
+        return NULL;
+
+      use = se;
+    }
+
+    CallExpr* parent = use ? toCallExpr(use->parentExpr) : NULL;
+
+    if (parent == NULL)
+      return NULL;
+
+    if (parent->isPrimitive(PRIM_MOVE) == true && parent->get(2) == use) {
+      tmp = toSymExpr(parent->get(1))->symbol();
+      def = parent;
+      continue;
+    }
+
+    FnSymbol* taskFn = parent->resolvedFunction();
+
+    if (taskFn                                    == NULL  ||
+        taskFn->hasFlag(FLAG_COBEGIN_OR_COFORALL) == false ||
+        taskFn->hasFlag(FLAG_BEGIN)               == true  ||
+        taskFn->hasFlag(FLAG_ON)                  == true)
+      return NULL;
+
+    actual = tmp;
+
+    return parent;
+  }
+
+  return NULL;
+}
+
+//
+// tmp = chpl__initCopy(s);      // in the parent, possibly moved
+// cobegin_fn(tmp, ...);         // through more temps first
+//
+// proc cobegin_fn(ref arg) {
+//   _formal_tmp = arg;          // takes over the copy
+//   ...
+//   chpl__autoDestroy(_formal_tmp);
+// }
+//
+static bool elideTaskCopy(CallExpr* call, std::vector<ElisionReport>& reports) {
+  SymExpr* dst = NULL;
+  SymExpr* src = NULL;
+
+  if (isCopy(call, dst, src) == false)
+    return false;
+
+  Symbol*   actual   = NULL;
+  CallExpr* taskCall = findTaskCall(dst->symbol(), call, actual);
+
+  if (taskCall == NULL)
+    return false;
+
+  FnSymbol*  taskFn = taskCall->resolvedFunction();
+  ArgSymbol* formal = NULL;
+
+  for_formals_actuals(f, a, taskCall) {
+    SymExpr* se = toSymExpr(a);
+
+    if (se != NULL && se->symbol() == actual)
+      formal = f;
+  }
+
+  // In the task, the formal must only be moved into the variable that
+  // owns it from then on.
+  CallExpr* take = NULL;
+
+  for_SymbolSymExprs(se, formal) {
+    CallExpr* parent = toCallExpr(se->parentExpr);
+
+    if (take != NULL || parent == NULL ||
+        parent->isPrimitive(PRIM_MOVE) == false || parent->get(2) != se)
+      return false;
+
+    take = parent;
+  }
+
+  if (take == NULL)
+    return false;
+
+  Symbol*                owner = toSymExpr(take->get(1))->symbol();
+  std::vector<CallExpr*> destroys;
+
+  if (isLocalValue(owner, taskFn)                 == false ||
+      owner->hasFlag(FLAG_INSERT_AUTO_DESTROY)    == false ||
+      isReadOnlyCopy(owner, take, destroys)       == false ||
+      isStableSource(src->symbol(), taskCall, maxDepth) == false)
+    return false;
+
+  noteElision(reports, taskCall, dst->symbol()->type);
+
+  replaceCopy(call, dst->symbol(), src->symbol());
+
+  for_vector(CallExpr, destroy, destroys) {
+    destroy->remove();
+  }
+
+  owner->addFlag(FLAG_NO_AUTO_DESTROY);
+
+  return true;
+}
+
+void elideRefCountCopies() {
+  if (fNoRefCountElision == true)
+    return;
+
+  std::vector<ElisionReport> reports;
+
+  forv_Vec(FnSymbol, fn, gFnSymbols) {
+    if (fn->defPoint->parentSymbol == NULL)
+      continue;
+
+    std::vector<CallExpr*> calls;
+
+    collectCallExprs(fn, calls);
+
+    for_vector(CallExpr, call, calls) {
+      if (call->parentSymbol == NULL)
+        continue;
+
+      // An elision can turn a copy into an alias, so earlier answers
+      // about formals may no longer hold.
+      if (elideLocalCopy(call, reports) == true ||
+          elideTaskCopy(call, reports)  == true)
+        readOnlyFormals.clear();
+    }
+  }
+
+  readOnlyFormals.clear();
+
+  std::stable_sort(reports.begin(), reports.end());
+
+  for (size_t i = 0; i < reports.size(); i++) {
+    printf("Elided reference count update for %s at %s:%d\n",
+           reports[i].type.c_str(),
+           reports[i].file.c_str(), reports[i].line);
+  }
+}
@@ -5532,7 +5532,8 @@ static void resolveMoveForRhsCallExpr(CallExpr* call) {
 
   moveSetConstFlagsAndCheck(call);
 
-  if (rhs->resolvedFunction() == gChplHereAlloc) {
+  if (rhs->resolvedFunction() == gChplHereAlloc ||
+      rhs->resolvedFunction() == gChplHereTaskAlloc) {
     Symbol*  lhsType = call->get(1)->typeInfo()->symbol;
     Symbol*  tmp     = newTemp("cast_tmp", rhs->typeInfo());
 
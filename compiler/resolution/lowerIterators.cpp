@@ -170,7 +170,8 @@ static void nonLeaderParCheckInt(FnSymbol* fn, bool allowYields)
   for_vector(CallExpr, call, calls) {
     if ((call->isPrimitive(PRIM_BLOCK_BEGIN)) ||
         (call->isPrimitive(PRIM_BLOCK_COBEGIN)) ||
-        (call->isPrimitive(PRIM_BLOCK_COFORALL))) {
+        (call->isPrimitive(PRIM_BLOCK_COFORALL)) ||
+        (call->isPrimitive(PRIM_BLOCK_COFORALL_TEAM))) {
       // begin/cobegin/coforall *blocks* are eliminated earlier.
       // If they are not, need issue the USR_FATAL_CONT like below.
       INT_ASSERT(false);
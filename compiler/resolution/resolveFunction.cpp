@@ -754,9 +754,15 @@ static const char* iteratorClassName(FnSymbol* fn) {
 static FnSymbol* makeGetIterator(AggregateType* iClass,
                                  AggregateType* iRecord) {
   VarSymbol* ret         = newTemp("_ic_", iClass);
-  CallExpr*  icAllocCall = callChplHereAlloc(ret->typeInfo());
+  CallExpr*  icAllocCall = NULL;
   FnSymbol*  retval      = new FnSymbol("_getIterator");
 
+  if (fTaskArenas == true) {
+    icAllocCall = callChplHereTaskAlloc(ret->typeInfo());
+  } else {
+    icAllocCall = callChplHereAlloc(ret->typeInfo());
+  }
+
   retval->addFlag(FLAG_AUTO_II);
   retval->addFlag(FLAG_INLINE);
   retval->addFlag(FLAG_UNSAFE);
@@ -1333,6 +1339,9 @@ bool shouldAddFormalTempAtCallSite(ArgSymbol* formal, FnSymbol* fn) {
     // For now, rule out default ctor/init/_new
     if (fn->hasFlag(FLAG_DEFAULT_CONSTRUCTOR))
       return false; // old strategy for old-path in wrapAndCleanUpActuals
+    // A task team runs many tasks from one call, so each copies for itself
+    else if (fn->hasFlag(FLAG_COFORALL_TEAM))
+      return false;
     else {
       if (formal->intent == INTENT_IN ||
           formal->intent == INTENT_CONST_IN ||
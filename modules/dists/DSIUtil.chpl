@@ -177,6 +177,33 @@ proc _computeBlock(numelems, numblocks, blocknum, wayhi,
   return (blo, bhi);
 }
 
+//
+// Iterate over the chunk numbers 0..#numChunks of a coforall, setting
+// a NUMA placement hint before each task is created so that successive
+// blocks of chunks run on successive NUMA domains.  This matches how
+// the memory layer spreads the pages of a large array across domains,
+// and how first touch places them when the array is initialized by a
+// forall.  Locale models with sublocales place tasks with on-statements
+// instead, so for them this is just 0..#numChunks.
+//
+iter _numaChunks(numChunks: int) {
+  extern proc chpl_task_getNumNumaDomains(): int(32);
+  extern proc chpl_task_setNumaHint(hint: chpl_sublocID_t);
+
+  const numDomains = if localeModelHasSublocales then 1
+                     else chpl_task_getNumNumaDomains(): int;
+  if numDomains <= 1 || numChunks <= 1 {
+    for chunk in 0..#numChunks do
+      yield chunk;
+  } else {
+    for chunk in 0..#numChunks {
+      chpl_task_setNumaHint((chunk * numDomains / numChunks):chpl_sublocID_t);
+      yield chunk;
+    }
+    chpl_task_setNumaHint(c_sublocid_any);
+  }
+}
+
 //
 // naive routine for dividing numLocales into rank factors
 //
@@ -103,6 +103,10 @@ module Atomics {
   extern proc atomic_thread_fence(order:memory_order);
   extern proc atomic_signal_fence(order:memory_order);
 
+  // Backoff for the timed waitFor() methods, here and in NetworkAtomics
+  extern proc chpl_task_waitDeadline(secs:real):real;
+  extern proc chpl_task_waitBackoff(deadline:real, attempt:int(32)):bool;
+
   extern proc atomic_is_lock_free_bool(ref obj:atomic_bool):bool;
   extern proc atomic_init_bool(ref obj:atomic_bool, value:bool);
   extern proc atomic_destroy_bool(ref obj:atomic_bool);
@@ -411,6 +415,35 @@ module Atomics {
       }
     }
 
+    /*
+       :arg val: Value to compare against.
+       :arg timeout: Maximum time to wait, in seconds.
+       :returns: true if the stored value became equal to `val`, false
+                 if `timeout` seconds passed first.
+
+       Like :proc:`waitFor`, but gives up after `timeout` seconds.  After
+       a short while the implementation sleeps between checks rather than
+       just yielding, so long waits don't keep a processor busy.
+    */
+    inline proc const waitFor(val:bool, timeout:real,
+                              order:memory_order = memory_order_seq_cst):bool {
+      var ret = true;
+      on this {
+        const deadline = chpl_task_waitDeadline(timeout);
+        var attempt:int(32) = 0;
+        while (atomic_load_explicit_bool(_v, memory_order_relaxed) != val) {
+          if !chpl_task_waitBackoff(deadline, attempt) {
+            ret = false;
+            break;
+          }
+          attempt += 1;
+        }
+        // As above, fence in case the on statement is omitted.
+        atomic_thread_fence(order);
+      }
+      return ret;
+    }
+
     /*
        :returns: Stored value using memory_order_relaxed.
     */
@@ -523,6 +556,26 @@ module Atomics {
       }
     }
 
+    inline proc const waitFor(val:uint(8), timeout:real,
+                              order:memory_order = memory_order_seq_cst):bool {
+      var ret = true;
+      on this {
+        const deadline = chpl_task_waitDeadline(timeout);
+        var attempt:int(32) = 0;
+        while (atomic_load_explicit_uint_least8_t(_v, memory_order_relaxed)
+                != val) {
+          if !chpl_task_waitBackoff(deadline, attempt) {
+            ret = false;
+            break;
+          }
+          attempt += 1;
+        }
+        // As above, fence in case the on statement is omitted.
+        atomic_thread_fence(order);
+      }
+      return ret;
+    }
+
     inline proc const peek() {
       return this.read(order=memory_order_relaxed);
     }
@@ -627,6 +680,26 @@ module Atomics {
       }
     }
 
+    inline proc const waitFor(val:uint(16), timeout:real,
+                              order:memory_order = memory_order_seq_cst):bool {
+      var ret = true;
+      on this {
+        const deadline = chpl_task_waitDeadline(timeout);
+        var attempt:int(32) = 0;
+        while (atomic_load_explicit_uint_least16_t(_v, memory_order_relaxed)
+                != val) {
+          if !chpl_task_waitBackoff(deadline, attempt) {
+            ret = false;
+            break;
+          }
+          attempt += 1;
+        }
+        // As above, fence in case the on statement is omitted.
+        atomic_thread_fence(order);
+      }
+      return ret;
+    }
+
     inline proc const peek() {
       return this.read(order=memory_order_relaxed);
     }
@@ -731,6 +804,26 @@ module Atomics {
       }
     }
 
+    inline proc const waitFor(val:uint(32), timeout:real,
+                              order:memory_order = memory_order_seq_cst):bool {
+      var ret = true;
+      on this {
+        const deadline = chpl_task_waitDeadline(timeout);
+        var attempt:int(32) = 0;
+        while (atomic_load_explicit_uint_least32_t(_v, memory_order_relaxed)
+                != val) {
+          if !chpl_task_waitBackoff(deadline, attempt) {
+            ret = false;
+            break;
+          }
+          attempt += 1;
+        }
+        // As above, fence in case the on statement is omitted.
+        atomic_thread_fence(order);
+      }
+      return ret;
+    }
+
     inline proc const peek() {
       return this.read(order=memory_order_relaxed);
     }
@@ -835,6 +928,26 @@ module Atomics {
       }
     }
 
+    inline proc const waitFor(val:uint(64), timeout:real,
+                              order:memory_order = memory_order_seq_cst):bool {
+      var ret = true;
+      on this {
+        const deadline = chpl_task_waitDeadline(timeout);
+        var attempt:int(32) = 0;
+        while (atomic_load_explicit_uint_least64_t(_v, memory_order_relaxed)
+                != val) {
+          if !chpl_task_waitBackoff(deadline, attempt) {
+            ret = false;
+            break;
+          }
+          attempt += 1;
+        }
+        // As above, fence in case the on statement is omitted.
+        atomic_thread_fence(order);
+      }
+      return ret;
+    }
+
     inline proc const peek() {
       return this.read(order=memory_order_relaxed);
     }
@@ -939,6 +1052,26 @@ module Atomics {
       }
     }
 
+    inline proc const waitFor(val:int(8), timeout:real,
+                              order:memory_order = memory_order_seq_cst):bool {
+      var ret = true;
+      on this {
+        const deadline = chpl_task_waitDeadline(timeout);
+        var attempt:int(32) = 0;
+        while (atomic_load_explicit_int_least8_t(_v, memory_order_relaxed)
+                != val) {
+          if !chpl_task_waitBackoff(deadline, attempt) {
+            ret = false;
+            break;
+          }
+          attempt += 1;
+        }
+        // As above, fence in case the on statement is omitted.
+        atomic_thread_fence(order);
+      }
+      return ret;
+    }
+
     inline proc const peek() {
       return this.read(order=memory_order_relaxed);
     }
@@ -1043,6 +1176,26 @@ module Atomics {
       }
     }
 
+    inline proc const waitFor(val:int(16), timeout:real,
+                              order:memory_order = memory_order_seq_cst):bool {
+      var ret = true;
+      on this {
+        const deadline = chpl_task_waitDeadline(timeout);
+        var attempt:int(32) = 0;
+        while (atomic_load_explicit_int_least16_t(_v, memory_order_relaxed)
+                != val) {
+          if !chpl_task_waitBackoff(deadline, attempt) {
+            ret = false;
+            break;
+          }
+          attempt += 1;
+        }
+        // As above, fence in case the on statement is omitted.
+        atomic_thread_fence(order);
+      }
+      return ret;
+    }
+
     inline proc const peek() {
       return this.read(order=memory_order_relaxed);
     }
@@ -1146,6 +1299,26 @@ module Atomics {
       }
     }
 
+    inline proc const waitFor(val:int(32), timeout:real,
+                              order:memory_order = memory_order_seq_cst):bool {
+      var ret = true;
+      on this {
+        const deadline = chpl_task_waitDeadline(timeout);
+        var attempt:int(32) = 0;
+        while (atomic_load_explicit_int_least32_t(_v, memory_order_relaxed)
+                != val) {
+          if !chpl_task_waitBackoff(deadline, attempt) {
+            ret = false;
+            break;
+          }
+          attempt += 1;
+        }
+        // As above, fence in case the on statement is omitted.
+        atomic_thread_fence(order);
+      }
+      return ret;
+    }
+
     inline proc const peek() {
       return this.read(order=memory_order_relaxed);
     }
@@ -1353,6 +1526,26 @@ module Atomics {
       }
     }
 
+    inline proc const waitFor(val:int(64), timeout:real,
+                              order:memory_order = memory_order_seq_cst):bool {
+      var ret = true;
+      on this {
+        const deadline = chpl_task_waitDeadline(timeout);
+        var attempt:int(32) = 0;
+        while (atomic_load_explicit_int_least64_t(_v, memory_order_relaxed)
+                != val) {
+          if !chpl_task_waitBackoff(deadline, attempt) {
+            ret = false;
+            break;
+          }
+          attempt += 1;
+        }
+        // As above, fence in case the on statement is omitted.
+        atomic_thread_fence(order);
+      }
+      return ret;
+    }
+
     /*
        :returns: Stored value using memory_order_relaxed.
     */
@@ -1442,6 +1635,25 @@ module Atomics {
       }
     }
 
+    inline proc const waitFor(val:real(64), timeout:real,
+                              order:memory_order = memory_order_seq_cst):bool {
+      var ret = true;
+      on this {
+        const deadline = chpl_task_waitDeadline(timeout);
+        var attempt:int(32) = 0;
+        while (atomic_load_explicit__real64(_v, memory_order_relaxed) != val) {
+          if !chpl_task_waitBackoff(deadline, attempt) {
+            ret = false;
+            break;
+          }
+          attempt += 1;
+        }
+        // As above, fence in case the on statement is omitted.
+        atomic_thread_fence(order);
+      }
+      return ret;
+    }
+
     inline proc const peek() {
       return this.read(order=memory_order_relaxed);
     }
@@ -1522,6 +1734,25 @@ module Atomics {
       }
     }
 
+    inline proc const waitFor(val:real(32), timeout:real,
+                              order:memory_order = memory_order_seq_cst):bool {
+      var ret = true;
+      on this {
+        const deadline = chpl_task_waitDeadline(timeout);
+        var attempt:int(32) = 0;
+        while (atomic_load_explicit__real32(_v, memory_order_relaxed) != val) {
+          if !chpl_task_waitBackoff(deadline, attempt) {
+            ret = false;
+            break;
+          }
+          attempt += 1;
+        }
+        // As above, fence in case the on statement is omitted.
+        atomic_thread_fence(order);
+      }
+      return ret;
+    }
+
     inline proc const peek() {
       return this.read(order=memory_order_relaxed);
     }
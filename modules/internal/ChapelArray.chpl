@@ -220,35 +220,55 @@ module ChapelArray {
   // with a privatized value that can be retrieved by the pid
   // without communication.
   proc _newPrivatizedClass(value) : int {
+    return _newPrivatizedClasses(value)(1);
+  }
+
+  // Privatize several dsi Dists/Doms/Arrays with a single walk of the
+  // locale tree instead of one walk each, returning their pids in
+  // order.  On each locale the values are privatized in argument order.
+  // Their privatize data is gathered before any of them has a pid, so a
+  // value must not be batched with one whose pid it depends on, e.g. a
+  // domain with its own distribution.
+  proc _newPrivatizedClasses(values...?k) : k*int {
 
-    const n = numPrivateObjects.fetchAdd(1);
+    const n = numPrivateObjects.fetchAdd(k);
 
     const hereID = here.id;
-    const privatizeData = value.dsiGetPrivatizeData();
+    const privatizeData = _getPrivatizeData(values);
     on Locales[0] do
-      _newPrivatizedClassHelp(value, value, n, hereID, privatizeData);
+      _newPrivatizedClassesHelp(values, values, n, hereID, privatizeData);
 
-    proc _newPrivatizedClassHelp(parentValue, originalValue, n, hereID, privatizeData) {
-      var newValue = originalValue;
-      if hereID != here.id {
-        newValue = parentValue.dsiPrivatize(privatizeData);
-        __primitive("chpl_newPrivatizedClass", newValue, n);
-        newValue.pid = n;
-      } else {
-        __primitive("chpl_newPrivatizedClass", newValue, n);
-        newValue.pid = n;
+    proc _getPrivatizeData(values, param i = 1) {
+      if i == values.size then
+        return (values(i).dsiGetPrivatizeData(),);
+      else
+        return (values(i).dsiGetPrivatizeData(),
+                (..._getPrivatizeData(values, i+1)));
+    }
+
+    proc _newPrivatizedClassesHelp(parentValues, originalValues, n, hereID, privatizeData) {
+      var newValues = originalValues;
+      for param i in 1..k {
+        if hereID != here.id then
+          newValues(i) = parentValues(i).dsiPrivatize(privatizeData(i));
+        const newValue = newValues(i);
+        __primitive("chpl_newPrivatizedClass", newValue, n+i-1);
+        newValue.pid = n+i-1;
       }
       cobegin {
         if chpl_localeTree.left then
           on chpl_localeTree.left do
-            _newPrivatizedClassHelp(newValue, originalValue, n, hereID, privatizeData);
+            _newPrivatizedClassesHelp(newValues, originalValues, n, hereID, privatizeData);
         if chpl_localeTree.right then
           on chpl_localeTree.right do
-            _newPrivatizedClassHelp(newValue, originalValue, n, hereID, privatizeData);
+            _newPrivatizedClassesHelp(newValues, originalValues, n, hereID, privatizeData);
       }
     }
 
-    return n;
+    var pids: k*int;
+    for param i in 1..k do
+      pids(i) = n+i-1;
+    return pids;
   }
 
   // original is the value this method shouldn't free, because it's the
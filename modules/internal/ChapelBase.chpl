@@ -30,6 +30,9 @@ module ChapelBase {
   // Is the cache for remote data enabled at compile time?
   config param CHPL_CACHE_REMOTE: bool = false;
 
+  // Are iterator classes allocated in per-task arenas?
+  config param CHPL_TASK_ARENAS: bool = false;
+
   config param warnMaximalRange = false;    // Warns if integer rollover will cause
                                             // the iterator to yield zero times.
   proc _throwOpError(param op: string) {
@@ -898,6 +901,8 @@ module ChapelBase {
   class _EndCountBase {
     var errors: unmanaged chpl_TaskErrors;
     var taskList: c_void_ptr = _defaultOf(c_void_ptr);
+    // number of tasks in a coforall task team, see _upTeamEndCount()
+    var teamSize: int;
   }
 
   pragma "end count"
@@ -982,6 +987,19 @@ module ChapelBase {
     }
   }
 
+  // This function is called once by the task that launches a coforall
+  // task team.  The team size is recorded so that the single spawn call
+  // for the team can find it next to the task list.
+  pragma "dont disable remote value forwarding"
+  pragma "no remote memory fence"
+  proc _upTeamEndCount(e: _EndCount, numTasks) {
+    e.teamSize = numTasks:int;
+    _upEndCount(e, true, numTasks);
+  }
+
+  // Position of the running task within its coforall task team.
+  extern proc chpl_task_getTeamIndex(): int;
+
   // This function is called once by each newly initiated task.  No on
   // statement is needed because the call to sub() will do a remote
   // fork (on) if needed.
@@ -169,7 +169,10 @@ module ChapelIteratorSupport {
   }
 
   inline proc _freeIterator(ic: _iteratorClass) {
-    chpl_here_free(__primitive("cast_to_void_star", ic));
+    if CHPL_TASK_ARENAS then
+      chpl_here_task_free(__primitive("cast_to_void_star", ic));
+    else
+      chpl_here_free(__primitive("cast_to_void_star", ic));
   }
 
   inline proc _freeIterator(x: _tuple) {
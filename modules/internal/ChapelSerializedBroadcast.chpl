@@ -26,41 +26,76 @@ module ChapelSerializedBroadcast {
 
   config param chpl__enableSerializedGlobals = true;
 
+  //
+  // Broadcasts go down a tree of locales rooted at the initiating
+  // locale, rather than fanning out from it directly.  This way no
+  // locale starts more than chpl__serializedBroadcastFanout remote
+  // tasks, and the depth of the broadcast is logarithmic in the
+  // number of locales.  Each locale also deserializes from its
+  // parent's copy, so the initiator isn't the source of every read.
+  //
+  config param chpl__serializedBroadcastFanout = 4;
+
+  if chpl__serializedBroadcastFanout < 1 then
+    compilerError("chpl__serializedBroadcastFanout must be at least 1");
+
   extern proc chpl_get_global_serialize_table(idx : int) : c_void_ptr;
 
+  // The locale at position 'rank' in the tree rooted at locale 'root'
+  private inline proc treeLocale(root : int, rank : int) {
+    return Locales[(root + rank) % numLocales];
+  }
+
+  // The positions of the children of position 'rank' in the tree
+  private inline proc treeChildren(rank : int) {
+    const first = chpl__serializedBroadcastFanout * rank + 1;
+    return first..min(first + chpl__serializedBroadcastFanout - 1,
+                      numLocales - 1);
+  }
+
   proc chpl__broadcastGlobal(ref localeZeroGlobal : ?T, id : int)
   where chpl__enableSerializedGlobals {
     const data = localeZeroGlobal.chpl__serialize();
-    const root = here.id;
-    coforall loc in Locales do on loc {
-      if here.id != root {
-        pragma "no copy"
-        pragma "no auto destroy"
-        var temp = T.chpl__deserialize(data);
+    broadcastSubtree(T, data, id, here.id, 0);
+  }
+
+  private proc broadcastSubtree(type T, const data, id : int,
+                                root : int, rank : int) {
+    coforall child in treeChildren(rank) do on treeLocale(root, child) {
+      pragma "no copy"
+      pragma "no auto destroy"
+      var temp = T.chpl__deserialize(data);
 
-        const destVoidPtr = chpl_get_global_serialize_table(id);
-        const dest = destVoidPtr:c_ptr(localeZeroGlobal.type);
+      const destVoidPtr = chpl_get_global_serialize_table(id);
+      const dest = destVoidPtr:c_ptr(T);
 
-        __primitive("=", dest.deref(), temp);
+      __primitive("=", dest.deref(), temp);
+
+      if treeChildren(child).size > 0 {
+        const myData = dest.deref().chpl__serialize();
+        broadcastSubtree(T, myData, id, root, child);
       }
     }
   }
 
   proc chpl__destroyBroadcastedGlobal(ref localeZeroGlobal, id : int)
   where chpl__enableSerializedGlobals {
-    type globalType = localeZeroGlobal.type;
-    const root = here.id;
-    coforall loc in Locales do on loc {
-      if here.id != root {
-        const voidPtr = chpl_get_global_serialize_table(id);
-        var ptr = voidPtr:c_ptr(globalType);
-
-        pragma "no copy"
-        pragma "no auto destroy"
-        var temp = ptr.deref();
-
-        chpl__autoDestroy(temp);
-      }
+    destroySubtree(localeZeroGlobal.type, id, here.id, 0);
+  }
+
+  private proc destroySubtree(type globalType, id : int,
+                              root : int, rank : int) {
+    coforall child in treeChildren(rank) do on treeLocale(root, child) {
+      destroySubtree(globalType, id, root, child);
+
+      const voidPtr = chpl_get_global_serialize_table(id);
+      var ptr = voidPtr:c_ptr(globalType);
+
+      pragma "no copy"
+      pragma "no auto destroy"
+      var temp = ptr.deref();
+
+      chpl__autoDestroy(temp);
     }
   }
 }
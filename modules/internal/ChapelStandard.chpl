@@ -61,6 +61,7 @@ module ChapelStandard {
   use ChapelTaskID;
   use ChapelTaskTable;
   use MemTracking;
+  use SampleProfiling;
   use ChapelUtil;
   use ChapelError;
   use ChapelDynDispHack;
@@ -226,6 +226,42 @@ module ChapelSyncvar {
     wrapped.writeXF(x);
   }
 
+  /*
+    Like :proc:`readFE`, but give up if the sync variable does not
+    become full within `timeout` seconds.
+
+    :arg timeout: Maximum time to wait, in seconds.
+    :arg val: Receives the value of the sync variable if it was read.
+    :returns: true if the value was read, false on timeout.
+  */
+  proc _syncvar.readFE(timeout : real, out val : valType) : bool {
+    return wrapped.readFE(timeout, val);
+  }
+
+  /*
+    Like :proc:`readFF`, but give up if the sync variable does not
+    become full within `timeout` seconds.
+
+    :arg timeout: Maximum time to wait, in seconds.
+    :arg val: Receives the value of the sync variable if it was read.
+    :returns: true if the value was read, false on timeout.
+  */
+  proc _syncvar.readFF(timeout : real, out val : valType) : bool {
+    return wrapped.readFF(timeout, val);
+  }
+
+  /*
+    Like :proc:`writeEF`, but give up if the sync variable does not
+    become empty within `timeout` seconds.
+
+    :arg val: New value of the sync variable.
+    :arg timeout: Maximum time to wait, in seconds.
+    :returns: true if the value was written, false on timeout.
+  */
+  proc _syncvar.writeEF(x : valType, timeout : real) : bool {
+    return wrapped.writeEF(x, timeout);
+  }
+
   /*
     Resets the value of this sync variable to the default value of
     its type. This method is non-blocking and the state of the sync
@@ -459,6 +495,72 @@ module ChapelSyncvar {
       }
     }
 
+    proc readFE(timeout : real, out val : valType) : bool {
+      var ret : valType;
+      var gotIt : bool;
+
+      on this {
+        var localRet : valType;
+
+        chpl_rmem_consist_release();
+        gotIt = chpl_sync_waitFullAndLockTimeout(syncAux, timeout);
+
+        if gotIt {
+          localRet = value;
+
+          chpl_sync_markAndSignalEmpty(syncAux);
+        }
+        chpl_rmem_consist_acquire();
+
+        ret = localRet;
+      }
+
+      val = ret;
+      return gotIt;
+    }
+
+    proc readFF(timeout : real, out val : valType) : bool {
+      var ret : valType;
+      var gotIt : bool;
+
+      on this {
+        var localRet : valType;
+
+        chpl_rmem_consist_release();
+        gotIt = chpl_sync_waitFullAndLockTimeout(syncAux, timeout);
+
+        if gotIt {
+          localRet = value;
+
+          chpl_sync_markAndSignalFull(syncAux);
+        }
+        chpl_rmem_consist_acquire();
+
+        ret = localRet;
+      }
+
+      val = ret;
+      return gotIt;
+    }
+
+    proc writeEF(val : valType, timeout : real) : bool {
+      var gotIt : bool;
+
+      on this {
+        chpl_rmem_consist_release();
+        gotIt = chpl_sync_waitEmptyAndLockTimeout(syncAux, timeout);
+
+        if gotIt {
+          value = val;
+
+          chpl_sync_markAndSignalFull(syncAux);
+        }
+        chpl_rmem_consist_acquire();
+      }
+
+      return gotIt;
+    }
+
     proc reset() {
       on this {
         const defaultValue : valType;
@@ -579,6 +681,61 @@ module ChapelSyncvar {
       }
     }
 
+    // The native FEB operations have no timed forms, so these retry the
+    // non-blocking forms, which only act when the FEB is already in the
+    // right state, until they succeed or the timeout expires.
+    proc readFE(timeout : real, out val : valType) : bool {
+      var ret : valType;
+      var gotIt : bool;
+
+      on this {
+        var alignedLocalRet : aligned_t;
+
+        chpl_rmem_consist_release();
+        gotIt = qthread_retryFEB("readFE", alignedLocalRet, alignedValue,
+                                 timeout);
+        chpl_rmem_consist_acquire();
+
+        ret = alignedLocalRet : valType;
+      }
+
+      val = ret;
+      return gotIt;
+    }
+
+    proc readFF(timeout : real, out val : valType) : bool {
+      var ret : valType;
+      var gotIt : bool;
+
+      on this {
+        var alignedLocalRet : aligned_t;
+
+        chpl_rmem_consist_release();
+        gotIt = qthread_retryFEB("readFF", alignedLocalRet, alignedValue,
+                                 timeout);
+        chpl_rmem_consist_acquire();
+
+        ret = alignedLocalRet : valType;
+      }
+
+      val = ret;
+      return gotIt;
+    }
+
+    proc writeEF(val : valType, timeout : real) : bool {
+      var gotIt : bool;
+
+      on this {
+        const alignedVal = val : aligned_t;
+
+        chpl_rmem_consist_release();
+        gotIt = qthread_retryFEB("writeEF", alignedValue, alignedVal, timeout);
+        chpl_rmem_consist_acquire();
+      }
+
+      return gotIt;
+    }
+
     proc reset() {
       on this {
         chpl_rmem_consist_release();
@@ -879,6 +1036,15 @@ private module SyncVarRuntimeSupport {
   pragma "insert line file info"
   extern proc   chpl_sync_waitFullAndLock (ref aux : chpl_sync_aux_t);
 
+  // These return false, with the sync var unlocked, on timeout
+  pragma "insert line file info"
+  extern proc   chpl_sync_waitEmptyAndLockTimeout(ref aux : chpl_sync_aux_t,
+                                                  secs    : real) : bool;
+
+  pragma "insert line file info"
+  extern proc   chpl_sync_waitFullAndLockTimeout (ref aux : chpl_sync_aux_t,
+                                                  secs    : real) : bool;
+
   extern proc   chpl_sync_lock  (ref aux : chpl_sync_aux_t);
   extern proc   chpl_sync_unlock(ref aux : chpl_sync_aux_t);
 
@@ -935,6 +1101,32 @@ private module SyncVarRuntimeSupport {
   extern proc qthread_empty      (const ref dest : aligned_t) : c_int;
   extern proc qthread_fill       (const ref dest : aligned_t) : c_int;
   extern proc qthread_feb_status (const ref dest : aligned_t) : c_int;
+
+  extern proc qthread_readFE_nb  (ref dest : aligned_t, const ref src: aligned_t) : c_int;
+  extern proc qthread_readFF_nb  (ref dest : aligned_t, const ref src: aligned_t) : c_int;
+  extern proc qthread_writeEF_nb (ref dest : aligned_t, const ref src: aligned_t) : c_int;
+
+  extern const QTHREAD_SUCCESS : c_int;
+
+  // Retry a non-blocking FEB operation ("readFE", "readFF" or "writeEF")
+  // until it succeeds or timeout seconds have passed
+  proc qthread_retryFEB(param op : string, ref dest : aligned_t,
+                        const ref src : aligned_t, timeout : real) : bool {
+    const deadline = chpl_task_waitDeadline(timeout);
+    var attempt : int(32) = 0;
+
+    while true {
+      const status = if op == "readFE" then qthread_readFE_nb(dest, src)
+                     else if op == "readFF" then qthread_readFF_nb(dest, src)
+                     else qthread_writeEF_nb(dest, src);
+      if status == QTHREAD_SUCCESS then
+        return true;
+      if !chpl_task_waitBackoff(deadline, attempt) then
+        return false;
+      attempt += 1;
+    }
+    return false;
+  }
 }
 
 
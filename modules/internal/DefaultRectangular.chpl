@@ -37,6 +37,10 @@ module DefaultRectangular {
   config param defaultDisableLazyRADOpt = false;
   config param earlyShiftData = true;
 
+  // Bulk transfers of at least this many bytes are split into chunks of
+  // at least this size which are copied by concurrent tasks.
+  config const bulkTransferParMinBytes = 4 * 1024 * 1024;
+
   pragma "use default init"
   class DefaultDist: BaseDist {
     proc dsiNewRectangularDom(param rank: int, type idxType, param stridable: bool, inds) {
@@ -220,7 +224,7 @@ module DefaultRectangular {
         if debugDefaultDist {
           chpl_debug_writeln("*** DI: locBlock = ", locBlock);
         }
-        coforall chunk in 0..#numChunks {
+        coforall chunk in _numaChunks(numChunks) {
           var followMe: rank*range(intIdxType) = locBlock;
           const (lo,hi) = _computeBlock(locBlock(parDim).length,
                                         numChunks, chunk,
@@ -401,7 +405,7 @@ module DefaultRectangular {
             locBlock(i) = offset(i)..#(ranges(i).length);
           if debugDefaultDist then
             chpl_debug_writeln("*** DI: locBlock = ", locBlock);
-          coforall chunk in 0..#numChunks {
+          coforall chunk in _numaChunks(numChunks) {
             var followMe: rank*range(intIdxType) = locBlock;
             const (lo,hi) = _computeBlock(locBlock(parDim).length,
                                           numChunks, chunk,
@@ -1238,8 +1242,7 @@ module DefaultRectangular {
                                             stridable=d._value.stridable,
                                             dom=d._value);
 
-        // MPF: could this be parallel?
-        for i in d((...dom.ranges)) do
+        forall i in d((...dom.ranges)) do
           copy.dsiAccess(i) = dsiAccess(i);
         off = copy.off;
         blk = copy.blk;
@@ -1718,15 +1721,81 @@ module DefaultRectangular {
     if Adata.locale.id==here.id {
       if debugDefaultDistBulkTransfer then
         chpl_debug_writeln("\tlocal get() from ", B.locale.id);
-      __primitive("chpl_comm_array_get", Adata[0], Bdata.locale.id, Bdata[0], len);
+      _chunkedArrayTransfer(true, A.eltType, Adata, Bdata.locale.id, Bdata,
+                            len);
     } else if Bdata.locale.id==here.id {
       if debugDefaultDistBulkTransfer then
         chpl_debug_writeln("\tlocal put() to ", A.locale.id);
-      __primitive("chpl_comm_array_put", Bdata[0], Adata.locale.id, Adata[0], len);
+      _chunkedArrayTransfer(false, A.eltType, Bdata, Adata.locale.id, Adata,
+                            len);
     } else on Adata.locale {
       if debugDefaultDistBulkTransfer then
         chpl_debug_writeln("\tremote get() on ", here.id, " from ", B.locale.id);
-      __primitive("chpl_comm_array_get", Adata[0], Bdata.locale.id, Bdata[0], len);
+      _chunkedArrayTransfer(true, A.eltType, Adata, Bdata.locale.id, Bdata,
+                            len);
+    }
+  }
+
+  //
+  // The number of concurrent tasks to use for a bulk transfer of 'numUnits'
+  // units of 'unitLen' contiguous elements each.  Chunks are kept at least
+  // bulkTransferParMinBytes large, and transfers started from a serial
+  // context or while the locale is already busy use fewer tasks.
+  //
+  private proc _bulkTransferNumChunks(type eltType, numUnits, unitLen) {
+    if __primitive("task_get_serial") then return 1;
+
+    const unitBytes = max(1, unitLen:int * c_sizeof(eltType):int);
+    const minUnits = max(1, bulkTransferParMinBytes / unitBytes);
+    if numUnits:int < 2 * minUnits then return 1;
+
+    const numTasks = if dataParTasksPerLocale == 0 then here.maxTaskPar
+                     else dataParTasksPerLocale;
+    return _computeNumChunks(numTasks, dataParIgnoreRunningTasks,
+                             minUnits, numUnits);
+  }
+
+  //
+  // Move 'len' contiguous elements between 'localData' on this locale and
+  // 'remoteData' on locale 'remoteLocId': a GET into 'localData' if 'isGet'
+  // and a PUT from it otherwise.  Large transfers are split into chunks
+  // that are moved by concurrent tasks, turning a local copy into a
+  // parallel memcpy and keeping several transfers in flight for a remote
+  // one.  With a locale model that has sublocales, consecutive chunks are
+  // spread across the sublocales in the same order the parallel iterators
+  // above use when first touching array data.
+  //
+  private proc _chunkedArrayTransfer(param isGet: bool, type eltType,
+                                     localData, remoteLocId, remoteData,
+                                     len) {
+    const numChunks = _bulkTransferNumChunks(eltType, len, 1);
+
+    proc transferChunk(lo, n) {
+      if isGet then
+        __primitive("chpl_comm_array_get", localData[lo], remoteLocId,
+                    remoteData[lo], n);
+      else
+        __primitive("chpl_comm_array_put", localData[lo], remoteLocId,
+                    remoteData[lo], n);
+    }
+
+    if numChunks <= 1 {
+      transferChunk(0, len);
+      return;
+    }
+
+    if debugDefaultDistBulkTransfer then
+      chpl_debug_writeln("\tsplitting transfer into ", numChunks, " chunks");
+
+    const numSublocs = here.getChildCount();
+    coforall chunk in _numaChunks(numChunks) {
+      const (lo, hi) = _computeBlock(len, numChunks, chunk, len-1);
+      if localeModelHasSublocales && numSublocs != 0 {
+        local do on here.getChild(chunk * numSublocs / numChunks) do
+          transferChunk(lo, hi-lo+1);
+      } else {
+        transferChunk(lo, hi-lo+1);
+      }
     }
   }
 
@@ -1947,45 +2016,78 @@ module DefaultRectangular {
 
     const dststr = dstStride._value.data;
     const srcstr = srcStride._value.data;
-    const cnt    = count._value.data;
 
-    if dest.locale.id == here.id {
-      const srclocale = src.locale.id : int(32);
+    proc transferStrided(AO, BO, cnt) {
+      if dest.locale.id == here.id {
+        const srclocale = src.locale.id : int(32);
 
-      if debugBulkTransfer {
-        chpl_debug_writeln("BulkTransferStride: On LHS - GET from ", srclocale);
+        if debugBulkTransfer {
+          chpl_debug_writeln("BulkTransferStride: On LHS - GET from ", srclocale);
+        }
+
+        __primitive("chpl_comm_get_strd",
+                    dest[AO],
+                    dststr[0],
+                    srclocale,
+                    src[BO],
+                    srcstr[0],
+                    cnt[0],
+                    stridelevels);
       }
+      else {
+        const destlocale = dest.locale.id : int(32);
 
-      __primitive("chpl_comm_get_strd",
-                  dest[AO],
-                  dststr[0],
-                  srclocale,
-                  src[BO],
-                  srcstr[0],
-                  cnt[0],
-                  stridelevels);
-    }
-    else {
-      const destlocale = dest.locale.id : int(32);
+        if debugDefaultDistBulkTransfer {
+          assert(src.locale.id == here.id,
+                 "BulkTransferStride: Expected to be on ", src.locale.id,
+                 ", actually on ", here.id);
+        }
 
-      if debugDefaultDistBulkTransfer {
-        assert(src.locale.id == here.id,
-               "BulkTransferStride: Expected to be on ", src.locale.id,
-               ", actually on ", here.id);
-      }
+        if debugBulkTransfer {
+          chpl_debug_writeln("BulkTransferStride: On RHS - PUT to ", destlocale);
+        }
 
-      if debugBulkTransfer {
-        chpl_debug_writeln("BulkTransferStride: On RHS - PUT to ", destlocale);
+        __primitive("chpl_comm_put_strd",
+                    dest[AO],
+                    dststr[0],
+                    destlocale,
+                    src[BO],
+                    srcstr[0],
+                    cnt[0],
+                    stridelevels);
       }
+    }
 
-      __primitive("chpl_comm_put_strd",
-                  dest[AO],
-                  dststr[0],
-                  destlocale,
-                  src[BO],
-                  srcstr[0],
-                  cnt[0],
-                  stridelevels);
+    //
+    // Split large transfers across tasks along the outermost stride level.
+    // Each chunk is the same strided transfer with a smaller outer count,
+    // starting 'lo' outer strides further into both arrays.
+    //
+    const outer = stridelevels + 1;
+    var unitLen = 1:size_t;
+    for i in 1..stridelevels do unitLen *= count[i];
+    const numChunks = _bulkTransferNumChunks(A.eltType, count[outer], unitLen);
+
+    if numChunks <= 1 {
+      transferStrided(AO, BO, count._value.data);
+      return;
+    }
+
+    if debugDefaultDistBulkTransfer then
+      chpl_debug_writeln("BulkTransferStride: splitting into ", numChunks,
+                         " chunks");
+
+    const (dstOuter, srcOuter) = if stridelevels == 0 then (1:size_t, 1:size_t)
+                                 else (dstStride[stridelevels],
+                                       srcStride[stridelevels]);
+    coforall chunk in _numaChunks(numChunks) {
+      const (lo, hi) = _computeBlock(count[outer], numChunks, chunk,
+                                     count[outer]-1);
+      var chunkCount: [count.domain] size_t;
+      for i in count.domain do chunkCount[i] = count[i]; // serial
+      chunkCount[outer] = hi-lo+1;
+      transferStrided(AO + (lo*dstOuter):AO.type, BO + (lo*srcOuter):BO.type,
+                      chunkCount._value.data);
     }
   }
 
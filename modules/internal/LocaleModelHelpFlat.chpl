@@ -67,8 +67,8 @@ module LocaleModelHelpFlat {
     } else {
       var tls = chpl_task_getChapelData();
       chpl_task_data_setup(chpl_comm_on_bundle_task_bundle(args), tls);
-      chpl_comm_execute_on(node, chpl_sublocFromLocaleID(loc),
-                           fn, args, args_size);
+      chpl_gen_comm_execute_on(node, chpl_sublocFromLocaleID(loc),
+                               fn, args, args_size);
     }
   }
 
@@ -90,8 +90,8 @@ module LocaleModelHelpFlat {
     } else {
       var tls = chpl_task_getChapelData();
       chpl_task_data_setup(chpl_comm_on_bundle_task_bundle(args), tls);
-      chpl_comm_execute_on_fast(node, chpl_sublocFromLocaleID(loc),
-                                fn, args, args_size);
+      chpl_gen_comm_execute_on_fast(node, chpl_sublocFromLocaleID(loc),
+                                    fn, args, args_size);
     }
   }
 
@@ -123,9 +123,9 @@ module LocaleModelHelpFlat {
     } else {
       chpl_task_data_setup(chpl_comm_on_bundle_task_bundle(args), tls);
       if isSerial {
-        chpl_comm_execute_on(node, c_sublocid_any, fn, args, args_size);
+        chpl_gen_comm_execute_on(node, c_sublocid_any, fn, args, args_size);
       } else {
-        chpl_comm_execute_on_nb(node, c_sublocid_any, fn, args, args_size);
+        chpl_gen_comm_execute_on_nb(node, c_sublocid_any, fn, args, args_size);
       }
     }
   }
@@ -92,4 +92,24 @@ module LocaleModelHelpMem {
       extern proc chpl_mem_free(ptr:c_void_ptr) : void;
     chpl_mem_free(ptr);
   }
+
+  // With --task-arenas, the compiler allocates iterator classes with
+  // chpl_here_task_alloc() and frees them with chpl_here_task_free().
+  // The memory comes from an arena owned by the running task, so it
+  // must be freed by that task, before it ends.
+  pragma "allocator"
+  pragma "always propagate line file info"
+  proc chpl_here_task_alloc(size:int(64), md:chpl_mem_descInt_t): c_void_ptr {
+    pragma "insert line file info"
+      extern proc chpl_mem_task_alloc(size:size_t, md:chpl_mem_descInt_t) : c_void_ptr;
+    return chpl_mem_task_alloc(size.safeCast(size_t), md + chpl_memhook_md_num());
+  }
+
+  pragma "locale model free"
+  pragma "always propagate line file info"
+  proc chpl_here_task_free(ptr:c_void_ptr): void {
+    pragma "insert line file info"
+      extern proc chpl_mem_task_free(ptr:c_void_ptr) : void;
+    chpl_mem_task_free(ptr);
+  }
 }
@@ -90,7 +90,7 @@ module LocaleModelHelpNUMA {
     if dnode != chpl_nodeID {
       var tls = chpl_task_getChapelData();
       chpl_task_data_setup(chpl_comm_on_bundle_task_bundle(args), tls);
-      chpl_comm_execute_on(dnode, dsubloc, fn, args, args_size);
+      chpl_gen_comm_execute_on(dnode, dsubloc, fn, args, args_size);
     } else {
       // run directly on this node
       var origSubloc = chpl_task_getRequestedSubloc();
@@ -123,7 +123,7 @@ module LocaleModelHelpNUMA {
     if dnode != chpl_nodeID {
       var tls = chpl_task_getChapelData();
       chpl_task_data_setup(chpl_comm_on_bundle_task_bundle(args), tls);
-      chpl_comm_execute_on_fast(dnode, dsubloc, fn, args, args_size);
+      chpl_gen_comm_execute_on_fast(dnode, dsubloc, fn, args, args_size);
     } else {
       var origSubloc = chpl_task_getRequestedSubloc();
       if (dsubloc==origSubloc ||
@@ -167,9 +167,9 @@ module LocaleModelHelpNUMA {
     } else {
       chpl_task_data_setup(chpl_comm_on_bundle_task_bundle(args), tls);
       if isSerial {
-        chpl_comm_execute_on(dnode, dsubloc, fn, args, args_size);
+        chpl_gen_comm_execute_on(dnode, dsubloc, fn, args, args_size);
       } else {
-        chpl_comm_execute_on_nb(dnode, dsubloc, fn, args, args_size);
+        chpl_gen_comm_execute_on_nb(dnode, dsubloc, fn, args, args_size);
       }
     }
   }
@@ -95,12 +95,15 @@ module LocaleModelHelpRuntime {
   //
   // runtime interface
   //
-  extern proc chpl_comm_execute_on(loc_id: int, subloc_id: int, fn: int,
-                                   args: chpl_comm_on_bundle_p, arg_size: size_t);
-  extern proc chpl_comm_execute_on_fast(loc_id: int, subloc_id: int, fn: int,
-                                        args: chpl_comm_on_bundle_p, args_size: size_t);
-  extern proc chpl_comm_execute_on_nb(loc_id: int, subloc_id: int, fn: int,
-                                      args: chpl_comm_on_bundle_p, args_size: size_t);
+  pragma "insert line file info"
+  extern proc chpl_gen_comm_execute_on(loc_id: int, subloc_id: int, fn: int,
+                                       args: chpl_comm_on_bundle_p, arg_size: size_t);
+  pragma "insert line file info"
+  extern proc chpl_gen_comm_execute_on_fast(loc_id: int, subloc_id: int, fn: int,
+                                            args: chpl_comm_on_bundle_p, args_size: size_t);
+  pragma "insert line file info"
+  extern proc chpl_gen_comm_execute_on_nb(loc_id: int, subloc_id: int, fn: int,
+                                          args: chpl_comm_on_bundle_p, args_size: size_t);
   pragma "insert line file info"
     extern proc chpl_comm_taskCallFTable(fn: int,
                                          args: chpl_comm_on_bundle_p, args_size: size_t,
@@ -122,7 +125,13 @@ module LocaleModelHelpRuntime {
                                       subloc_id: int,
                                       ref tlist: c_void_ptr, tlist_node_id: int,
                                       is_begin: bool);
+  pragma "insert line file info"
+  extern proc chpl_task_addTeamToTaskList(fn: int,
+                                          args: chpl_task_bundle_p, args_size: size_t,
+                                          num_tasks: int, subloc_id: int,
+                                          ref tlist: c_void_ptr, tlist_node_id: int);
   extern proc chpl_task_executeTasksInList(ref tlist: c_void_ptr);
+  extern proc chpl_task_setTeamIndex(idx: int);
 
   //
   // add a task to a list of tasks being built for a begin statement
@@ -171,6 +180,36 @@ module LocaleModelHelpRuntime {
      }
   }
 
+  //
+  // add a whole coforall task team to a list of tasks; every task in
+  // the team shares the argument bundle and is told its team index
+  //
+  pragma "insert line file info"
+  export
+  proc chpl_taskListAddTeam(subloc_id: int,        // target sublocale
+                            fn: int,               // task body function idx
+                            args: chpl_task_bundle_p,      // function args
+                            args_size: size_t,     // args size
+                            ref tlist: c_void_ptr, // task list
+                            tlist_node_id: int,    // task list owner node
+                            num_tasks: int         // tasks in the team
+                           ) {
+    var tls = chpl_task_getChapelData();
+    var isSerial = chpl_task_data_getSerial(tls);
+    if isSerial {
+      const saveIndex = chpl_task_getTeamIndex();
+      for i in 0..#num_tasks {
+        chpl_task_setTeamIndex(i);
+        chpl_ftable_call(fn, args);
+      }
+      chpl_task_setTeamIndex(saveIndex);
+    } else {
+      chpl_task_data_setup(args, tls);
+      chpl_task_addTeamToTaskList(fn, args, args_size, num_tasks,
+                                  subloc_id, tlist, tlist_node_id);
+    }
+  }
+
   //
   // make sure all tasks in a list have an opportunity to run
   //
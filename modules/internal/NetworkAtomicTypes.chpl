@@ -17,8 +17,28 @@
  * limitations under the License.
  */
 
-// Stub file for atomics-specific set up
+// Maps atomic types onto the network atomic records.  This is only used
+// when CHPL_NETWORK_ATOMICS is not none, and is the same for every comm
+// layer that provides network atomics.
 //
 module NetworkAtomicTypes {
+  use NetworkAtomics;
+
+  proc chpl__networkAtomicType(type base_type) type {
+    if base_type==bool then return ratomicbool;
+    else if base_type==uint(32) then return ratomic_uint32;
+    else if base_type==uint(64) then return ratomic_uint64;
+    else if base_type==int(32) then return ratomic_int32;
+    else if base_type==int(64) then return ratomic_int64;
+    else if base_type==real then return ratomic_real64;
+    else {
+      compilerWarning("Unsupported network atomic type");
+      if base_type==uint(8) then return atomic_uint8;
+      else if base_type==uint(16) then return atomic_uint16;
+      else if base_type==int(8) then return atomic_int8;
+      else if base_type==int(16) then return atomic_int16;
+      else compilerError("Unsupported atomic type");
+    }
+  }
 
 }
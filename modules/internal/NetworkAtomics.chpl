@@ -176,6 +176,25 @@ module NetworkAtomics {
       }
     }
 
+    inline proc const waitFor(val:int(64), timeout:real,
+                              order:memory_order = memory_order_seq_cst):bool {
+      var ret = true;
+      on this {
+        const deadline = chpl_task_waitDeadline(timeout);
+        var attempt:int(32) = 0;
+        while (read(memory_order_relaxed) != val) {
+          if !chpl_task_waitBackoff(deadline, attempt) {
+            ret = false;
+            break;
+          }
+          attempt += 1;
+        }
+        // As above, fence in case the on statement is omitted.
+        atomic_thread_fence(order);
+      }
+      return ret;
+    }
+
     inline proc const peek():int(64) {
       return _v;
     }
@@ -368,6 +387,25 @@ module NetworkAtomics {
       }
     }
 
+    inline proc const waitFor(val:int(32), timeout:real,
+                              order:memory_order = memory_order_seq_cst):bool {
+      var ret = true;
+      on this {
+        const deadline = chpl_task_waitDeadline(timeout);
+        var attempt:int(32) = 0;
+        while (read(memory_order_relaxed) != val) {
+          if !chpl_task_waitBackoff(deadline, attempt) {
+            ret = false;
+            break;
+          }
+          attempt += 1;
+        }
+        // As above, fence in case the on statement is omitted.
+        atomic_thread_fence(order);
+      }
+      return ret;
+    }
+
     inline proc peek():int(32) {
       return _v;
     }
@@ -560,6 +598,25 @@ module NetworkAtomics {
       }
     }
 
+    inline proc const waitFor(val:uint(64), timeout:real,
+                              order:memory_order = memory_order_seq_cst):bool {
+      var ret = true;
+      on this {
+        const deadline = chpl_task_waitDeadline(timeout);
+        var attempt:int(32) = 0;
+        while (read(memory_order_relaxed) != val) {
+          if !chpl_task_waitBackoff(deadline, attempt) {
+            ret = false;
+            break;
+          }
+          attempt += 1;
+        }
+        // As above, fence in case the on statement is omitted.
+        atomic_thread_fence(order);
+      }
+      return ret;
+    }
+
     inline proc const peek():uint(64) {
       return _v;
     }
@@ -752,6 +809,25 @@ module NetworkAtomics {
       }
     }
 
+    inline proc const waitFor(val:uint(32), timeout:real,
+                              order:memory_order = memory_order_seq_cst):bool {
+      var ret = true;
+      on this {
+        const deadline = chpl_task_waitDeadline(timeout);
+        var attempt:int(32) = 0;
+        while (read(memory_order_relaxed) != val) {
+          if !chpl_task_waitBackoff(deadline, attempt) {
+            ret = false;
+            break;
+          }
+          attempt += 1;
+        }
+        // As above, fence in case the on statement is omitted.
+        atomic_thread_fence(order);
+      }
+      return ret;
+    }
+
     inline proc const peek():uint(32) {
       return _v;
     }
@@ -844,6 +920,25 @@ inline proc compareExchangeWeak(expected:bool, desired:bool,
       }
     }
 
+    inline proc const waitFor(val:bool, timeout:real,
+                              order:memory_order = memory_order_seq_cst):bool {
+      var ret = true;
+      on this {
+        const deadline = chpl_task_waitDeadline(timeout);
+        var attempt:int(32) = 0;
+        while (read(memory_order_relaxed) != val) {
+          if !chpl_task_waitBackoff(deadline, attempt) {
+            ret = false;
+            break;
+          }
+          attempt += 1;
+        }
+        // As above, fence in case the on statement is omitted.
+        atomic_thread_fence(order);
+      }
+      return ret;
+    }
+
     inline proc const peek():bool {
       return _v:bool;
     }
@@ -1003,6 +1098,25 @@ inline proc compareExchangeWeak(expected:bool, desired:bool,
       }
     }
 
+    inline proc const waitFor(val:real(64), timeout:real,
+                              order:memory_order = memory_order_seq_cst):bool {
+      var ret = true;
+      on this {
+        const deadline = chpl_task_waitDeadline(timeout);
+        var attempt:int(32) = 0;
+        while (read(memory_order_relaxed) != val) {
+          if !chpl_task_waitBackoff(deadline, attempt) {
+            ret = false;
+            break;
+          }
+          attempt += 1;
+        }
+        // As above, fence in case the on statement is omitted.
+        atomic_thread_fence(order);
+      }
+      return ret;
+    }
+
     inline proc const peek():real(64) {
       return _v;
     }
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2004-2018 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+// SampleProfiling.chpl
+//
+module SampleProfiling
+{
+  use ChapelStandard;
+
+  //
+  // Settings for the runtime's task-aware sampling profiler.  When
+  // sampleProfile is true, each locale samples its stack
+  // sampleProfileHz times per second of CPU time, and at exit writes
+  // the samples as folded stacks to sampleProfileFile (with the locale
+  // ID appended, in multi-locale runs).  With sampleProfileByTask,
+  // samples are further split by task ID.
+  //
+  config const
+    sampleProfile: bool = false,
+    sampleProfileHz: int = 100,
+    sampleProfileByTask: bool = false,
+    sampleProfileFile: string = "chpl-profile.folded";
+
+  //
+  // This communicates the settings above to the runtime.  Like
+  // chpl_memTracking_returnConfigVals(), it is called from the runtime
+  // on every locale, so the file name has to be copied to a local
+  // string that we leak on the remote ones.  The runtime makes its own
+  // copy of it, and only looks at it when profiling is on.
+  //
+  export
+  proc chpl_sampleProf_returnConfigVals(ref ret_sampleProfile: bool,
+                                        ref ret_sampleProfileHz: int,
+                                        ref ret_sampleProfileByTask: bool,
+                                        ref ret_sampleProfileFile: c_string) {
+    ret_sampleProfile = sampleProfile;
+    ret_sampleProfileHz = sampleProfileHz;
+    ret_sampleProfileByTask = sampleProfileByTask;
+
+    if !sampleProfile {
+      ret_sampleProfileFile = nil;
+    } else if (here.id != 0) {
+      var local_sampleProfileFile = sampleProfileFile;
+      // Intentionally leak the string to persist the underlying buffer
+      local_sampleProfileFile.isowned = false;
+      ret_sampleProfileFile = local_sampleProfileFile.c_str();
+    } else {
+      ret_sampleProfileFile = sampleProfileFile.c_str();
+    }
+  }
+}
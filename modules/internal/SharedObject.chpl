@@ -91,6 +91,7 @@ module SharedObject {
 
    */
   pragma "managed pointer"
+  pragma "refcounted"
   record _shared {
     pragma "no doc"
     type t;              // contained type (class type)
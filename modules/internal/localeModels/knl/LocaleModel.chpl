@@ -637,4 +637,26 @@ module LocaleModel {
     else
       chpl_mem_free(ptr);
   }
+
+  pragma "allocator"
+  proc chpl_here_task_alloc(size:int(64), md:chpl_mem_descInt_t): c_void_ptr {
+    pragma "insert line file info"
+      extern proc chpl_mem_task_alloc(size:size_t, md:chpl_mem_descInt_t) : c_void_ptr;
+    if allocatingInHbmSublocale() then
+      return hbw_malloc(size.safeCast(size_t));
+    else
+      return chpl_mem_task_alloc(size.safeCast(size_t), md + chpl_memhook_md_num());
+  }
+
+  pragma "locale model free"
+  proc chpl_here_task_free(ptr:c_void_ptr): void {
+    if ptr == nil then
+      return;
+    pragma "insert line file info"
+      extern proc chpl_mem_task_free(ptr:c_void_ptr) : void;
+    if addrIsInHbm(ptr) then
+      hbw_free(ptr);
+    else
+      chpl_mem_task_free(ptr);
+  }
 }
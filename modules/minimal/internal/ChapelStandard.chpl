@@ -24,5 +24,6 @@ module ChapelStandard {
   use ChapelLocale;
   use ChapelTaskTable;
   use MemTracking;
+  use SampleProfiling;
   use ChapelUtil;
 }
@@ -23,12 +23,14 @@
    can be used as a barrier between all locales, optionally with multiple tasks
    per locale.
 
-   The :var:`allLocalesBarrier` barrier only supports the
-   :proc:`~Barriers.Barrier.barrier()` and :proc:`~Barriers.Barrier.reset()`
+   The :var:`allLocalesBarrier` barrier supports the
+   :proc:`~Barriers.Barrier.barrier()`, :proc:`~Barriers.Barrier.notify()`,
+   :proc:`~Barriers.Barrier.wait()` and :proc:`~Barriers.Barrier.reset()`
    methods of the :attr:`~Barriers.Barrier` interface. By default it can be
    used as a barrier between 1 task on each locale. The
    :proc:`~Barriers.Barrier.reset()` method can be used change how many tasks
-   per locale will participate in each barrier.
+   per locale will participate in each barrier.  :proc:`~Barriers.Barrier.wait()`
+   behaves as it does for a reusable barrier.
 
    Use of this barrier is similar to :proc:`shmem_barrier_all()` or
    :proc:`MPI_Barrier(MPI_COMM_WORLD)`, except that it's possible for multiple
@@ -59,33 +61,123 @@
        }
      }
 
-   The implementation is dependent on the communication layer and the
-   underlying hardware, but typically some sort of tree or dissemination based
-   barrier that's optimized for the network will be used.
+   The barrier is hierarchical.  The tasks on each locale first gather using
+   the combining tree of :mod:`Barriers`.  The last task to arrive on each
+   locale then runs a dissemination barrier with the other locales: in
+   round `r` it signals the locale `2**r` ahead of it with a nonblocking
+   PUT and waits to be signaled by the locale `2**r` behind it, so
+   ``ceil(log2(numLocales))`` rounds are needed.  Only then are the tasks on
+   that locale released.  With :proc:`~Barriers.Barrier.notify()` and
+   :proc:`~Barriers.Barrier.wait()`, the exchange between locales happens
+   in :proc:`~Barriers.Barrier.wait()`, so :proc:`~Barriers.Barrier.notify()`
+   never blocks.
 */
 module AllLocalesBarriers {
   use BlockDist, Barriers;
 
+  pragma "no doc"
+  extern const CHPL_TYPE_int64_t: int(32);
+
+  pragma "no doc"
+  pragma "insert line file info"
+  extern proc chpl_comm_put_nb(addr: c_void_ptr, node: int(32),
+                               raddr: c_void_ptr, size: size_t,
+                               typeIndex: int(32),
+                               commID: int(32)): c_void_ptr;
+
+  pragma "no doc"
+  extern proc chpl_comm_wait_nb_some(h: c_ptr(c_void_ptr), nhandles: size_t);
+
+  /* This locale's part of the dissemination barrier between locales.  It is
+     run by the task that completes the barrier on this locale.
+   */
+  pragma "no doc"
+  class localeExchange: BarrierCompletionHook {
+    const id: int;
+    const numRounds: int;
+    // Episodes completed by this locale.  Every locale passes through the
+    // same sequence of episodes, so this also names the episode being
+    // signaled to the partners.
+    var episodes: int;
+    // flags[r] holds the latest episode signaled to this locale in round r
+    var flags: [0..#numRounds] barrierCounter;
+    var partnerNode: [0..#numRounds] int(32);
+    var partnerFlag: [0..#numRounds] c_void_ptr;
+    var handles: [0..#numRounds] c_void_ptr;
+
+    proc init(id: int, numLocales: int) {
+      this.id = id;
+      var rounds = 0;
+      while (1 << rounds) < numLocales do
+        rounds += 1;
+      this.numRounds = rounds;
+    }
+
+    /* Record where each round's partner keeps the flag we signal. */
+    proc connect(exchanges) {
+      for r in 0..#numRounds {
+        const partner = (id + (1 << r)) % numLocales;
+        const other = exchanges[partner];
+        var addr: c_void_ptr;
+        on other do
+          addr = c_ptrTo(other.flags[r].a): c_void_ptr;
+        partnerNode[r] = partner: int(32);
+        partnerFlag[r] = addr;
+      }
+    }
+
+    proc episodeComplete() {
+      episodes += 1;
+      var e = episodes;
+      for r in 0..#numRounds {
+        handles[r] = chpl_comm_put_nb(c_ptrTo(e): c_void_ptr, partnerNode[r],
+                                      partnerFlag[r], numBytes(int): size_t,
+                                      CHPL_TYPE_int64_t, -1);
+        while flags[r].a.read() < e do
+          chpl_task_yield();
+        // 'e' is the source of every PUT, so they must finish before we
+        // return.  chpl_comm_wait_nb_some() only waits until one of the
+        // handles it is given completes, so wait on each one by itself.
+        chpl_comm_wait_nb_some(c_ptrTo(handles[r]), 1);
+      }
+    }
+  }
+
   pragma "no doc"
   class AllLocalesBarrier: BarrierBaseType {
 
     const BarrierSpace = LocaleSpace dmapped Block(LocaleSpace);
-    var globalBarrier: [BarrierSpace] aBarrier(reusable=true, hackIntoCommBarrier=true);
+    var exchanges: [BarrierSpace] unmanaged localeExchange;
+    var localBarriers: [BarrierSpace] unmanaged aBarrier(reusable=true);
 
     proc init(numTasksPerLocale: int) {
-      globalBarrier = [b in BarrierSpace] new aBarrier(numTasksPerLocale, reusable=true, hackIntoCommBarrier=true);
+      this.complete();
+      exchanges = [i in BarrierSpace] new unmanaged localeExchange(i, numLocales);
+      forall ex in exchanges do
+        ex.connect(exchanges);
+      localBarriers = [i in BarrierSpace]
+        new unmanaged aBarrier(numTasksPerLocale, reusable=true, exchanges[i]);
     }
 
     proc deinit() {
-      [b in globalBarrier] delete b;
+      [b in localBarriers] delete b;
+      [ex in exchanges] delete ex;
     }
 
     proc barrier() {
-      globalBarrier.localAccess[here.id].barrier();
+      localBarriers.localAccess[here.id].barrier();
+    }
+
+    proc notify() {
+      localBarriers.localAccess[here.id].notify();
+    }
+
+    proc wait() {
+      localBarriers.localAccess[here.id].wait();
     }
 
     proc reset(numTasksPerLocale: int) {
-      [b in globalBarrier] b.reset(numTasksPerLocale);
+      [b in localBarriers] b.reset(numTasksPerLocale);
     }
   }
 
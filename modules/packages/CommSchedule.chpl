@@ -0,0 +1,495 @@
+/*
+ * Copyright 2004-2018 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Reusable communication schedules for irregular gathers and scatters.
+
+   Iterative codes often perform the same indirect access on every
+   iteration, for example ``forall i in D do X[i] = Y[Idx[i]]`` where
+   ``Idx`` does not change.  Executed directly, each iteration issues one
+   fine-grained remote read per non-local element of ``Y``.
+
+   An :class:`IndirectSchedule` inspects the index array once and records,
+   for every pair of locales, the distinct elements one of them needs from
+   the other.  Each later :proc:`~IndirectSchedule.gather` or
+   :proc:`~IndirectSchedule.scatter` then moves exactly those elements with
+   one bulk transfer per pair of locales:
+
+   .. code-block:: chapel
+
+     use BlockDist, CommSchedule;
+
+     const D = {0..#n} dmapped Block({0..#n});
+     var Y, X: [D] real;
+     var Idx: [D] int = ...;
+
+     var sched = new owned IndirectSchedule(Y, Idx);   // inspect once
+
+     for step in 1..numSteps {
+       sched.gather(X, Y);          // X[i] = Y[Idx[i]]
+       ...
+       sched.scatterAdd(Y, X);      // Y[Idx[i]] += X[i]
+     }
+
+   The data array (``Y`` above) may be any one-dimensional distributed
+   array whose distribution supports ``idxToLocale()``, such as ``Block``
+   or ``Cyclic``.  The index array must be distributed so that its part on
+   each locale is a single domain, as with ``Block`` and ``Cyclic`` but not
+   ``BlockCyclic``.  The arrays read or
+   written element-wise (``X`` above) must be declared over the domain of
+   the index array.  A schedule may be used with any data array that has
+   the same domain and distribution as the one it was created with.
+
+   The schedule keeps buffers for every element it moves, so its memory use
+   is proportional to the size of the index array.  If the contents of the
+   index array change, a new schedule has to be created.
+*/
+module CommSchedule {
+
+  /*
+    A communication schedule for ``Data[Idx[i]]`` accesses, built from the
+    contents of ``Idx`` when the schedule is created.
+   */
+  class IndirectSchedule {
+    /* The element type of the data arrays this schedule moves. */
+    type eltType;
+
+    pragma "no doc"
+    const dataRange: range;
+    pragma "no doc"
+    var locs: [LocaleSpace] unmanaged LocIndirectSchedule(eltType);
+
+    /*
+      Inspect `Idx` and build the schedule for accesses to arrays
+      distributed like `Data`.  Every element of `Idx` must be an index of
+      `Data`.
+     */
+    proc init(const ref Data: [] ?t, const ref Idx: [] int) {
+      if Data.rank != 1 || Idx.rank != 1 then
+        compilerError("IndirectSchedule only supports one-dimensional arrays");
+      if Data.domain.stridable || Idx.domain.stridable then
+        compilerError("IndirectSchedule does not support strided arrays");
+      if !Idx.hasSingleLocalSubdomain() then
+        compilerError("IndirectSchedule requires an index array whose ",
+                      "local part is a single domain");
+
+      this.eltType = t;
+      this.dataRange = Data.domain.dim(1);
+      this.complete();
+
+      // Each locale sorts out what it needs from whom ...
+      coforall loc in Locales do on loc {
+        const ls = new unmanaged LocIndirectSchedule(eltType);
+        ls.inspect(Data, Idx);
+        locs[here.id] = ls;
+      }
+
+      // ... then fetches what everybody else needs from it ...
+      coforall loc in Locales do on loc do
+        locs[here.id].exchangeRequests(locs);
+
+      // ... and finally learns where to put values for its owners.
+      coforall loc in Locales do on loc do
+        locs[here.id].exchangeAddresses(locs);
+    }
+
+    pragma "no doc"
+    proc deinit() {
+      coforall loc in Locales do on loc do
+        delete locs[here.id];
+    }
+
+    /*
+      Set ``X[i] = Data[Idx[i]]`` for every index ``i`` of ``Idx``.
+     */
+    proc gather(ref X: [] eltType, const ref Data: [] eltType) {
+      use SegmentExchange;
+
+      checkData(Data);
+
+      // Owners pack the requested elements and put them to the requesters.
+      coforall loc in Locales do on loc {
+        const ls = locs[here.id];
+        const sendIdx = ls.sendIdx, sendBuf = ls.sendBuf,
+              sendOff = ls.sendOff, peerRecv = ls.peerRecv;
+
+        forall k in 0..#ls.nSend do
+          sendBuf[k] = Data[sendIdx[k]];
+
+        putSegments(sendBuf, sendOff, peerRecv);
+      }
+
+      // Requesters unpack, once everything has arrived.
+      coforall loc in Locales do on loc {
+        const ls = locs[here.id];
+        const lo = ls.lo, stride = ls.stride,
+              slot = ls.slot, recvBuf = ls.recvBuf;
+
+        ls.checkLocal(X);
+        forall p in 0..#ls.n do
+          X[lo+p*stride] = recvBuf[slot[p]];
+      }
+    }
+
+    /*
+      Set ``Data[Idx[i]] = X[i]`` for every index ``i`` of ``Idx``.  If
+      several elements of ``Idx`` refer to the same element of `Data`, one
+      of their values is stored.
+     */
+    proc scatter(ref Data: [] eltType, const ref X: [] eltType) {
+      doScatter(Data, X, accumulate=false);
+    }
+
+    /*
+      Add ``X[i]`` to ``Data[Idx[i]]`` for every index ``i`` of ``Idx``.
+      Contributions to the same element of `Data` are summed.
+     */
+    proc scatterAdd(ref Data: [] eltType, const ref X: [] eltType) {
+      doScatter(Data, X, accumulate=true);
+    }
+
+    pragma "no doc"
+    proc doScatter(ref Data: [] eltType, const ref X: [] eltType,
+                   param accumulate: bool) {
+      use SegmentExchange;
+
+      checkData(Data);
+
+      // Requesters combine their contributions per target element and put
+      // them to the owners.
+      coforall loc in Locales do on loc {
+        const ls = locs[here.id];
+        const lo = ls.lo, stride = ls.stride,
+              recvBuf = ls.recvBuf, recvOff = ls.recvOff,
+              slotPos = ls.slotPos, slotPosOff = ls.slotPosOff,
+              peerSend = ls.peerSend;
+
+        ls.checkLocal(X);
+        forall s in 0..#ls.nRecv {
+          const first = slotPosOff[s], last = slotPosOff[s+1] - 1;
+          if accumulate {
+            var sum: eltType;
+            for j in first..last do
+              sum += X[lo+slotPos[j]*stride];
+            recvBuf[s] = sum;
+          } else {
+            recvBuf[s] = X[lo+slotPos[last]*stride];
+          }
+        }
+
+        putSegments(recvBuf, recvOff, peerSend);
+      }
+
+      // Owners apply them.  The elements within one requester's segment
+      // are distinct, so only the segments have to be applied in turn.
+      coforall loc in Locales do on loc {
+        const ls = locs[here.id];
+        const sendIdx = ls.sendIdx, sendBuf = ls.sendBuf,
+              sendOff = ls.sendOff;
+
+        for r in 0..#numLocales {
+          forall k in sendOff[r]..sendOff[r+1]-1 {
+            if accumulate then
+              Data[sendIdx[k]] += sendBuf[k];
+            else
+              Data[sendIdx[k]] = sendBuf[k];
+          }
+        }
+      }
+    }
+
+    pragma "no doc"
+    proc checkData(const ref Data) {
+      if boundsChecking && Data.domain.dim(1) != dataRange then
+        halt("IndirectSchedule used with a data array over ",
+             Data.domain.dim(1), ", but created for ", dataRange);
+    }
+  }
+
+  //
+  // The part of an IndirectSchedule that lives on one locale.  Positions
+  // are offsets into this locale's part of the index array, which need
+  // not be dense (with Cyclic it is strided): position 'p' is index
+  // lo+p*stride.  Requests are
+  // kept in segments per peer locale:
+  //
+  //   recvIdx/recvBuf[recvOff[o]..recvOff[o+1]-1]
+  //     the distinct data indices this locale accesses on owner 'o'
+  //   sendIdx/sendBuf[sendOff[r]..sendOff[r+1]-1]
+  //     the distinct local data indices requester 'r' accesses here
+  //
+  // slot maps each position to its entry in recvBuf; slotPos/slotPosOff
+  // is the inverse, listing the positions of each recvBuf entry in order.
+  //
+  pragma "no doc"
+  class LocIndirectSchedule {
+    type eltType;
+
+    var lo, stride, n: int;
+    var nRecv, nSend: int;
+
+    var slot: c_ptr(int);
+    var slotPos: c_ptr(int);
+    var slotPosOff: c_ptr(int);
+
+    var recvOff: c_ptr(int);
+    var recvIdx: c_ptr(int);
+    var recvBuf: c_ptr(eltType);
+
+    var sendOff: c_ptr(int);
+    var sendIdx: c_ptr(int);
+    var sendBuf: c_ptr(eltType);
+
+    // Where this locale's segment starts in each peer's recvBuf/sendBuf.
+    var peerRecv: c_ptr(c_ptr(eltType));
+    var peerSend: c_ptr(c_ptr(eltType));
+
+    proc init(type eltType) {
+      this.eltType = eltType;
+    }
+
+    proc deinit() {
+      c_free(slot);
+      c_free(slotPos);
+      c_free(slotPosOff);
+      c_free(recvOff);
+      c_free(recvIdx);
+      c_free(recvBuf);
+      c_free(sendOff);
+      c_free(sendIdx);
+      c_free(sendBuf);
+      c_free(peerRecv);
+      c_free(peerSend);
+    }
+
+    proc inspect(const ref Data, const ref Idx) {
+      use SegmentExchange;
+
+      const myInds = Idx.localSubdomain().dim(1);
+
+      n = myInds.size;
+      lo = if n > 0 then myInds.first else 0;
+      stride = myInds.stride;
+
+      const inds: [0..#n] int = [p in 0..#n] Idx[lo+p*stride];
+      if boundsChecking {
+        forall i in inds do
+          if !Data.domain.member(i) then
+            halt("IndirectSchedule index ", i, " is out of bounds of ",
+                 Data.domain);
+      }
+
+      nRecv = groupByOwner(inds, Data.domain, recvOff, recvIdx);
+      recvBuf = c_malloc(eltType, max(nRecv, 1));
+
+      slot = c_malloc(int, max(n, 1));
+      forall p in 0..#n do
+        slot[p] = findSlot(recvOff, recvIdx, Data.domain, inds[p]);
+
+      slotPosOff = c_calloc(int, nRecv+1);
+      for p in 0..#n do
+        slotPosOff[slot[p]+1] += 1;
+      for s in 1..nRecv do
+        slotPosOff[s] += slotPosOff[s-1];
+
+      slotPos = c_malloc(int, max(n, 1));
+      var posFill: [0..#nRecv] int;
+      for p in 0..#n {
+        const s = slot[p];
+        slotPos[slotPosOff[s] + posFill[s]] = p;
+        posFill[s] += 1;
+      }
+    }
+
+    proc exchangeRequests(locs) {
+      use SegmentExchange;
+
+      const nl = numLocales;
+      const first = c_malloc(int, nl);
+      var peerOff, peerIdx: [0..#nl] c_ptr(int);
+
+      forall r in 0..#nl do
+        (peerOff[r], peerIdx[r]) = (locs[r].recvOff, locs[r].recvIdx);
+      nSend = fetchRequests(peerOff, peerIdx, sendOff, sendIdx, first);
+      sendBuf = c_malloc(eltType, max(nSend, 1));
+      peerRecv = c_malloc(c_ptr(eltType), nl);
+      forall r in 0..#nl do
+        peerRecv[r] = locs[r].recvBuf + first[r];
+
+      c_free(first);
+    }
+
+    proc exchangeAddresses(locs) {
+      use SegmentExchange;
+
+      const nl = numLocales;
+      const first = c_malloc(int, nl);
+      var peerOff: [0..#nl] c_ptr(int);
+
+      forall o in 0..#nl do
+        peerOff[o] = locs[o].sendOff;
+      fetchSegmentStarts(peerOff, first);
+      peerSend = c_malloc(c_ptr(eltType), nl);
+      forall o in 0..#nl do
+        peerSend[o] = locs[o].sendBuf + first[o];
+
+      c_free(first);
+    }
+
+    proc checkLocal(const ref X) {
+      if boundsChecking {
+        const myInds = X.localSubdomain().dim(1);
+        if myInds.size != n ||
+           (n > 0 && (myInds.first != lo || myInds.stride != stride)) then
+          halt("IndirectSchedule used with an array that is not ",
+               "distributed like the index array");
+      }
+    }
+  }
+
+  //
+  // Building blocks for exchanges kept in segments per peer locale, as
+  // above.  LinearAlgebra's SpMVPlan uses them too, so they live in a
+  // submodule rather than being private; 'use CommSchedule' does not
+  // bring them into scope.  A locale's requests are an 'off'/'idx' pair:
+  // idx[off[o]..off[o+1]-1] are the distinct indices it needs from
+  // locale 'o', in increasing order.
+  //
+  pragma "no doc"
+  module SegmentExchange {
+
+    use Sort;
+
+    //
+    // Sort the distinct indices in 'inds' into one segment per locale
+    // owning them in 'dom'.  Returns the number of distinct indices.
+    //
+    proc groupByOwner(const ref inds: [] int, dom, ref off: c_ptr(int),
+                      ref idx: c_ptr(int)) {
+      const nl = numLocales, n = inds.size;
+      const owner: [0..#n] int =
+        [i in inds] dom.dist.idxToLocale(i).id;
+
+      var bucketOff: [0..nl] int;
+      for o in owner do
+        bucketOff[o+1] += 1;
+      for o in 1..nl do
+        bucketOff[o] += bucketOff[o-1];
+
+      var bucket: [0..#n] int;
+      var fill = bucketOff;
+      for (i, o) in zip(inds, owner) {
+        bucket[fill[o]] = i;
+        fill[o] += 1;
+      }
+
+      var count = 0;
+      off = c_calloc(int, nl+1);
+      idx = c_malloc(int, max(n, 1));
+      for o in 0..#nl {
+        const first = bucketOff[o], last = bucketOff[o+1] - 1;
+        if first <= last {
+          sort(bucket[first..last]);
+          for k in first..last {
+            if k == first || bucket[k] != bucket[k-1] {
+              idx[count] = bucket[k];
+              count += 1;
+            }
+          }
+        }
+        off[o+1] = count;
+      }
+      return count;
+    }
+
+    //
+    // The position of index 'i' in requests built by groupByOwner().
+    //
+    proc findSlot(off: c_ptr(int), idx: c_ptr(int), dom, i: int) {
+      const o = dom.dist.idxToLocale(i).id;
+      var first = off[o], last = off[o+1] - 1;
+      while first < last {
+        const mid = (first + last) / 2;
+        if idx[mid] < i then first = mid + 1; else last = mid;
+      }
+      return first;
+    }
+
+    //
+    // Given every locale's requests, fetch the segments addressed to this
+    // one: off/idx[off[r]..off[r+1]-1] become the indices requester 'r'
+    // needs from here, and first[r] is where that segment starts in r's
+    // requests.  Returns the total number of indices.
+    //
+    // The bulk get primitive needs an addressable local destination, so
+    // the peer offsets are fetched into c_ptr scratch space.
+    //
+    proc fetchRequests(peerOff: [] c_ptr(int), peerIdx: [] c_ptr(int),
+                       ref off: c_ptr(int), ref idx: c_ptr(int),
+                       first: c_ptr(int)) {
+      const me = here.id, nl = numLocales;
+      const bounds = c_malloc(int, 2*nl);
+
+      forall r in 0..#nl do
+        __primitive("chpl_comm_array_get", bounds[2*r], r,
+                    peerOff[r][me], 2);
+
+      off = c_calloc(int, nl+1);
+      for r in 0..#nl {
+        first[r] = bounds[2*r];
+        off[r+1] = off[r] + bounds[2*r+1] - bounds[2*r];
+      }
+
+      const n = off[nl];
+      idx = c_malloc(int, max(n, 1));
+      forall r in 0..#nl {
+        const count = off[r+1] - off[r];
+        if count > 0 then
+          __primitive("chpl_comm_array_get", idx[off[r]], r,
+                      peerIdx[r][first[r]], count);
+      }
+
+      c_free(bounds);
+      return n;
+    }
+
+    //
+    // Set first[o] to where this locale's segment starts in the segments
+    // 'peerOff[o]' of each peer 'o'.
+    //
+    proc fetchSegmentStarts(peerOff: [] c_ptr(int), first: c_ptr(int)) {
+      const me = here.id;
+      forall o in 0..#numLocales do
+        __primitive("chpl_comm_array_get", first[o], o, peerOff[o][me], 1);
+    }
+
+    //
+    // Put each segment buf[off[r]..off[r+1]-1] to peerBuf[r] on locale 'r',
+    // with one bulk transfer per peer.
+    //
+    proc putSegments(buf: c_ptr(?t), off: c_ptr(int),
+                     peerBuf: c_ptr(c_ptr(t))) {
+      forall r in 0..#numLocales {
+        const count = off[r+1] - off[r];
+        if count > 0 then
+          __primitive("chpl_comm_array_put", buf[off[r]], r,
+                      peerBuf[r][0], count);
+      }
+    }
+  }
+}
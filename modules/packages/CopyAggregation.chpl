@@ -0,0 +1,385 @@
+/*
+ * Copyright 2004-2018 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Aggregated, asynchronous element-wise copies and updates.
+
+   Irregular access patterns such as ``forall i in D do A[idx[i]] = i`` on a
+   distributed array turn into one fine-grained PUT (or GET) per element.
+   The aggregators in this module instead buffer such operations in
+   per-destination-locale buffers.  When a buffer fills up, when
+   :proc:`~DstAggregator.flush()` is called, or when the aggregator goes out
+   of scope, the whole buffer is moved to the target locale with a single
+   bulk transfer and applied there by a single ``on`` statement.
+
+   Aggregators are not parallel-safe.  They are intended to be used as task
+   private variables, so that each task of a ``forall`` has its own buffers
+   which are flushed when that task completes:
+
+   .. code-block:: chapel
+
+     use BlockDist, CopyAggregation;
+
+     const D = {0..#n} dmapped Block({0..#n});
+     var A: [D] int;
+     var idx: [D] int = ...;
+
+     // Scatter: A[idx[i]] = i
+     forall i in D with (var agg: DstAggregator(int)) do
+       agg.copy(A[idx[i]], i);
+
+     // Gather: B[i] = A[idx[i]]
+     var B: [D] int;
+     forall i in D with (var agg: SrcAggregator(int)) do
+       agg.copy(B[i], A[idx[i]]);
+
+     // Histogram: H[idx[i]] += 1
+     var H: [D] atomic int;
+     forall i in D with (var agg: AtomicAddAggregator(int)) do
+       agg.add(H[idx[i]], 1);
+
+   Operations are only guaranteed to be complete after the aggregator is
+   flushed, either explicitly or when it is deinitialized.  Operations
+   targeting the current locale are performed immediately.
+
+   The number of elements buffered for each destination locale can be set
+   with the ``aggregationBufferSize`` config const.
+*/
+module CopyAggregation {
+
+  /* Number of operations buffered per destination locale before the
+     buffer is flushed. */
+  config const aggregationBufferSize = 4096;
+
+  pragma "no doc"
+  private inline proc getNodeId(const ref x) : int {
+    return __primitive("_wide_get_node", x): int;
+  }
+
+  pragma "no doc"
+  private inline proc getAddr(const ref x) : c_ptr(x.type) {
+    return __primitive("_wide_get_addr", x): c_ptr(x.type);
+  }
+
+  //
+  // Each aggregator owns one buffer per locale for each kind of data it
+  // records.  The buffers are allocated lazily, the first time an
+  // operation targets a given locale.  A copy of an aggregator starts out
+  // empty, with no buffers, so that the two never free the same buffers.
+  // Assignment is ruled out by the const bufferSize field.
+  //
+  pragma "no doc"
+  private inline proc bufferFor(ref buffers: c_ptr(c_ptr(?t)), loc: int,
+                                bufferSize: int) : c_ptr(t) {
+    if buffers == nil then
+      buffers = c_calloc(c_ptr(t), numLocales);
+    if buffers[loc] == nil then
+      buffers[loc] = c_malloc(t, bufferSize);
+    return buffers[loc];
+  }
+
+  pragma "no doc"
+  private proc freeBuffers(buffers: c_ptr(c_ptr(?t))) {
+    if buffers == nil then return;
+    for loc in 0..#numLocales do
+      if buffers[loc] != nil then c_free(buffers[loc]);
+    c_free(buffers);
+  }
+
+  /*
+    Aggregates copies into (possibly remote) destinations from local
+    values, for example ``A[idx[i]] = v`` where ``A[idx[i]]`` may be remote.
+   */
+  record DstAggregator {
+    /* The type of the elements being copied. */
+    type elemType;
+
+    pragma "no doc"
+    const bufferSize: int;
+    pragma "no doc"
+    var dstAddrs: c_ptr(c_ptr(c_ptr(elemType)));
+    pragma "no doc"
+    var vals: c_ptr(c_ptr(elemType));
+    pragma "no doc"
+    var counts: c_ptr(int);
+
+    proc init(type elemType, bufferSize: int = aggregationBufferSize) {
+      this.elemType = elemType;
+      this.bufferSize = bufferSize;
+    }
+
+    pragma "no doc"
+    proc init(const other: DstAggregator) {
+      this.elemType = other.elemType;
+      this.bufferSize = other.bufferSize;
+    }
+
+    pragma "no doc"
+    proc deinit() {
+      flush();
+      freeBuffers(dstAddrs);
+      freeBuffers(vals);
+      c_free(counts);
+    }
+
+    /*
+      Copy `srcVal` into `dst`.  The copy may not be visible until the
+      aggregator is flushed.
+     */
+    inline proc copy(ref dst: elemType, const in srcVal: elemType) {
+      const loc = getNodeId(dst);
+      if loc == here.id {
+        dst = srcVal;
+        return;
+      }
+
+      if counts == nil then counts = c_calloc(int, numLocales);
+      ref count = counts[loc];
+      bufferFor(dstAddrs, loc, bufferSize)[count] = getAddr(dst);
+      bufferFor(vals, loc, bufferSize)[count] = srcVal;
+      count += 1;
+
+      if count == bufferSize then
+        flushBuffer(loc);
+    }
+
+    /*
+      Complete all buffered copies.
+     */
+    proc flush() {
+      if counts == nil then return;
+      for loc in 0..#numLocales do
+        if counts[loc] > 0 then
+          flushBuffer(loc);
+    }
+
+    pragma "no doc"
+    proc flushBuffer(loc: int) {
+      const myLocId = here.id;
+      const n = counts[loc];
+      const addrBuf = dstAddrs[loc];
+      const valBuf = vals[loc];
+
+      on Locales[loc] {
+        var lAddrs = c_malloc(c_ptr(elemType), n);
+        var lVals = c_malloc(elemType, n);
+        __primitive("chpl_comm_array_get", lAddrs[0], myLocId, addrBuf[0], n);
+        __primitive("chpl_comm_array_get", lVals[0], myLocId, valBuf[0], n);
+        for i in 0..#n do
+          lAddrs[i].deref() = lVals[i];
+        c_free(lAddrs);
+        c_free(lVals);
+      }
+
+      counts[loc] = 0;
+    }
+  }
+
+  /*
+    Aggregates copies from (possibly remote) sources into local
+    destinations, for example ``B[i] = A[idx[i]]`` where ``A[idx[i]]`` may
+    be remote.
+   */
+  record SrcAggregator {
+    /* The type of the elements being copied. */
+    type elemType;
+
+    pragma "no doc"
+    const bufferSize: int;
+    pragma "no doc"
+    var dstAddrs: c_ptr(c_ptr(c_ptr(elemType)));
+    pragma "no doc"
+    var srcAddrs: c_ptr(c_ptr(c_ptr(elemType)));
+    pragma "no doc"
+    var vals: c_ptr(c_ptr(elemType));
+    pragma "no doc"
+    var counts: c_ptr(int);
+
+    proc init(type elemType, bufferSize: int = aggregationBufferSize) {
+      this.elemType = elemType;
+      this.bufferSize = bufferSize;
+    }
+
+    pragma "no doc"
+    proc init(const other: SrcAggregator) {
+      this.elemType = other.elemType;
+      this.bufferSize = other.bufferSize;
+    }
+
+    pragma "no doc"
+    proc deinit() {
+      flush();
+      freeBuffers(dstAddrs);
+      freeBuffers(srcAddrs);
+      freeBuffers(vals);
+      c_free(counts);
+    }
+
+    /*
+      Copy `src` into the local `dst`.  `dst` may not hold the copied value
+      until the aggregator is flushed.
+     */
+    inline proc copy(ref dst: elemType, const ref src: elemType) {
+      if getNodeId(dst) != here.id then
+        halt("SrcAggregator destination must be local");
+
+      const loc = getNodeId(src);
+      if loc == here.id {
+        dst = src;
+        return;
+      }
+
+      if counts == nil then counts = c_calloc(int, numLocales);
+      ref count = counts[loc];
+      bufferFor(dstAddrs, loc, bufferSize)[count] = getAddr(dst);
+      bufferFor(srcAddrs, loc, bufferSize)[count] = getAddr(src);
+      bufferFor(vals, loc, bufferSize);
+      count += 1;
+
+      if count == bufferSize then
+        flushBuffer(loc);
+    }
+
+    /*
+      Complete all buffered copies.
+     */
+    proc flush() {
+      if counts == nil then return;
+      for loc in 0..#numLocales do
+        if counts[loc] > 0 then
+          flushBuffer(loc);
+    }
+
+    pragma "no doc"
+    proc flushBuffer(loc: int) {
+      const myLocId = here.id;
+      const n = counts[loc];
+      const srcBuf = srcAddrs[loc];
+      const valBuf = vals[loc];
+
+      // Gather the values on the source locale and put them back into
+      // our value buffer, all under a single on-statement.
+      on Locales[loc] {
+        var lAddrs = c_malloc(c_ptr(elemType), n);
+        var lVals = c_malloc(elemType, n);
+        __primitive("chpl_comm_array_get", lAddrs[0], myLocId, srcBuf[0], n);
+        for i in 0..#n do
+          lVals[i] = lAddrs[i].deref();
+        __primitive("chpl_comm_array_put", lVals[0], myLocId, valBuf[0], n);
+        c_free(lAddrs);
+        c_free(lVals);
+      }
+
+      const dstBuf = dstAddrs[loc];
+      for i in 0..#n do
+        dstBuf[i].deref() = valBuf[i];
+
+      counts[loc] = 0;
+    }
+  }
+
+  /*
+    Aggregates atomic additions to (possibly remote) atomic variables, for
+    example ``H[idx[i]].add(1)`` where ``H[idx[i]]`` may be remote.  The
+    additions are applied with processor atomics on the target locale.
+   */
+  record AtomicAddAggregator {
+    /* The value type of the atomic variables being updated. */
+    type elemType;
+
+    pragma "no doc"
+    const bufferSize: int;
+    pragma "no doc"
+    var dstAddrs: c_ptr(c_ptr(c_ptr(atomic elemType)));
+    pragma "no doc"
+    var vals: c_ptr(c_ptr(elemType));
+    pragma "no doc"
+    var counts: c_ptr(int);
+
+    proc init(type elemType, bufferSize: int = aggregationBufferSize) {
+      this.elemType = elemType;
+      this.bufferSize = bufferSize;
+    }
+
+    pragma "no doc"
+    proc init(const other: AtomicAddAggregator) {
+      this.elemType = other.elemType;
+      this.bufferSize = other.bufferSize;
+    }
+
+    pragma "no doc"
+    proc deinit() {
+      flush();
+      freeBuffers(dstAddrs);
+      freeBuffers(vals);
+      c_free(counts);
+    }
+
+    /*
+      Atomically add `val` to `dst`.  The addition may not be visible until
+      the aggregator is flushed.
+     */
+    inline proc add(ref dst: atomic elemType, const in val: elemType) {
+      const loc = getNodeId(dst);
+      if loc == here.id {
+        dst.add(val);
+        return;
+      }
+
+      if counts == nil then counts = c_calloc(int, numLocales);
+      ref count = counts[loc];
+      bufferFor(dstAddrs, loc, bufferSize)[count] = getAddr(dst);
+      bufferFor(vals, loc, bufferSize)[count] = val;
+      count += 1;
+
+      if count == bufferSize then
+        flushBuffer(loc);
+    }
+
+    /*
+      Complete all buffered additions.
+     */
+    proc flush() {
+      if counts == nil then return;
+      for loc in 0..#numLocales do
+        if counts[loc] > 0 then
+          flushBuffer(loc);
+    }
+
+    pragma "no doc"
+    proc flushBuffer(loc: int) {
+      const myLocId = here.id;
+      const n = counts[loc];
+      const addrBuf = dstAddrs[loc];
+      const valBuf = vals[loc];
+
+      on Locales[loc] {
+        var lAddrs = c_malloc(c_ptr(atomic elemType), n);
+        var lVals = c_malloc(elemType, n);
+        __primitive("chpl_comm_array_get", lAddrs[0], myLocId, addrBuf[0], n);
+        __primitive("chpl_comm_array_get", lVals[0], myLocId, valBuf[0], n);
+        for i in 0..#n do
+          lAddrs[i].deref().add(lVals[i]);
+        c_free(lAddrs);
+        c_free(lVals);
+      }
+
+      counts[loc] = 0;
+    }
+  }
+}
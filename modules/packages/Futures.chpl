@@ -100,6 +100,20 @@ The following example demonstrate bundling of futures.
 .. literalinclude:: ../../../../test/library/packages/Futures/futures-doc-waitall.chpl
    :language: chapel
 
+Remote Futures
+--------------
+
+:proc:`asyncOn()` executes a function on another locale and returns a future
+for its result.  The remote call is issued as a non-blocking ``on``, so no
+task is created on the calling locale to wait for it; the result is written
+back into the future when the remote call completes.  This lets a single
+task keep many remote calls in flight at once.  A set of futures can be
+polled with :proc:`waitAny()`, which returns the index of a future whose
+result is ready.
+
+.. literalinclude:: ../../../../test/library/packages/Futures/futures-doc-asyncon.chpl
+   :language: chapel
+
  */
 
 module Futures {
@@ -302,6 +316,74 @@ module Futures {
     return f;
   }
 
+  /*
+    Asynchronously execute a function (taking no arguments) on locale `loc`
+    and return a :record:`Future` that will eventually hold the result of the
+    function call.
+
+    :arg loc: The locale on which to execute `taskFn`
+    :arg taskFn: A function taking no arguments
+    :returns: A future of the return type of `taskFn`
+   */
+  proc asyncOn(loc: locale, taskFn) {
+    if !canResolveMethod(taskFn, "this") then
+      compilerError("asyncOn() task function (expecting arguments) provided without arguments");
+    if !canResolveMethod(taskFn, "retType") then
+      compilerError("cannot determine return type of asyncOn() task function");
+    var f: Future(taskFn.retType);
+    f.classRef.valid = true;
+    begin on loc do f.set(taskFn());
+    return f;
+  }
+
+  /*
+    Asynchronously execute a function (taking arguments) on locale `loc`
+    and return a :record:`Future` that will eventually hold the result of the
+    function call.
+
+    :arg loc: The locale on which to execute `taskFn`
+    :arg taskFn: A function taking arguments with types matching `args...`
+    :arg args...: Arguments to `taskFn`
+    :returns: A future of the return type of `taskFn`
+   */
+  proc asyncOn(loc: locale, taskFn, args...) {
+    if !canResolveMethod(taskFn, "this", (...args)) then
+      compilerError("asyncOn() task function provided with mismatching arguments");
+    if !canResolveMethod(taskFn, "retType") then
+      compilerError("cannot determine return type of asyncOn() task function");
+    var f: Future(taskFn.retType);
+    f.classRef.valid = true;
+    begin on loc do f.set(taskFn((...args)));
+    return f;
+  }
+
+  /*
+    Wait until at least one of a set of futures is ready, and return the
+    index of a ready future.
+
+    If any of the futures is not valid, this call will
+    :proc:`~ChapelIO.halt()`.
+
+    :arg futures: An array of futures
+    :returns: The index in `futures` of a future whose result is available
+   */
+  proc waitAny(futures: [?D] ?t): D.idxType {
+    if D.size == 0 then halt("waitAny() called on an empty array of futures");
+    var ready: D.idxType;
+    var found = false;
+    while !found {
+      for i in D {
+        if futures[i].isReady() {
+          ready = i;
+          found = true;
+          break;
+        }
+      }
+      if !found then chpl_task_yield();
+    }
+    return ready;
+  }
+
   pragma "no doc"
   proc getRetTypes(arg) type {
     return (arg.retType,);
@@ -1117,6 +1117,8 @@ matrices (2D arrays).
 Sparse matrices are represented as 2D arrays domain-mapped to a sparse *layout*.
 Only the ``CS(compressRows=true)`` (CSR) layout of the
 :mod:`LayoutCS` layout module is currently supported.
+Matrix-vector multiplication additionally supports matrices distributed with
+:mod:`SparseBlockDist`; see :class:`SpMVPlan`.
 
 See the :ref:`Sparse Primer <primers-sparse>` for more information about working
 with sparse domains and arrays in Chapel.
@@ -1169,6 +1171,7 @@ A common usage of this interface might look like this:
 module Sparse {
 
   use LayoutCS;
+  use SparseBlockDist;
 
   /* Return an empty CSR domain over parent domain:
      ``{1..rows, 1..rows}``
@@ -1326,9 +1329,13 @@ module Sparse {
   private proc matMult(A: [?Adom] ?eltType, B: [?Bdom] eltType) where (isSparseArr(A) || isSparseArr(B)) {
     // matrix-vector
     if Adom.rank == 2 && Bdom.rank == 1 {
-      if !isCSArr(A) then
-        halt("Only CSR format is supported for sparse multiplication");
-      return _csrmatvecMult(A, B);
+      if isSparseBlockArr(A) {
+        return _distmatvecMult(A, B);
+      } else {
+        if !isCSArr(A) then
+          halt("Only CSR format is supported for sparse multiplication");
+        return _csrmatvecMult(A, B);
+      }
     }
     // vector-matrix
     else if Adom.rank == 1 && Bdom.rank == 2 {
@@ -1690,6 +1697,337 @@ module Sparse {
     return A;
   }
 
+  /* Distributed matrix-vector multiplication, for a ``SparseBlockDist``
+     matrix.  The result is ``Block`` distributed.
+   */
+  private proc _distmatvecMult(A: [?Adom] ?eltType, X: [?Xdom] eltType)
+    where isSparseBlockArr(A)
+  {
+    const Ydom = {Adom.dim(1)} dmapped Block({Adom.dim(1)});
+    var Y: [Ydom] eltType;
+
+    var spmv = new owned SpMVPlan(A, Xdom, Ydom);
+    spmv.multiply(Y, A, X);
+    return Y;
+  }
+
+  /*
+    A reusable plan for distributed sparse matrix-vector products
+    ``Y = A * X``, where ``A`` is distributed with ``SparseBlockDist``.
+
+    Creating the plan inspects the sparsity pattern of ``A`` once.  Each
+    locale turns its block of ``A`` into a local CSR structure, and records
+    the distinct columns its nonzeros touch (its *ghost columns*) and the
+    locales owning them in ``X``.  Each :proc:`multiply` then:
+
+    1. gathers the ghost columns of ``X`` into a buffer on each locale, with
+       one bulk transfer per pair of locales,
+    2. multiplies each local block by its ghost buffer with one task per
+       core, giving each task a range of rows holding about the same number
+       of nonzeros, and
+    3. adds the partial row sums into ``Y``, again with one bulk transfer
+       per pair of locales.
+
+    The values of ``A`` may change between multiplications, but its
+    sparsity pattern may not.  ``X`` and ``Y`` must be declared over the
+    domains the plan was created for.  They may use any one-dimensional
+    distribution supporting ``idxToLocale()``, though a ``Block``
+    distribution whose blocks line up with those of ``A`` keeps step 3
+    local.
+
+    .. code-block:: chapel
+
+      var spmv = new owned SpMVPlan(A, X.domain, Y.domain);
+
+      for step in 1..numSteps {
+        spmv.multiply(Y, A, X);     // Y = A * X
+        ...
+      }
+  */
+  class SpMVPlan {
+    /* The element type of the matrix and vectors. */
+    type eltType;
+
+    pragma "no doc"
+    const rowRange, colRange: range;
+    pragma "no doc"
+    var locs: [LocaleSpace] unmanaged LocSpMVPlan(eltType);
+
+    /*
+      Build the plan for multiplying `A` by vectors over `Xdom`, giving
+      vectors over `Ydom`.
+     */
+    proc init(A: [?Adom] ?t, Xdom: domain, Ydom: domain) {
+      if !isSparseBlockArr(A) then
+        compilerError("SpMVPlan requires a matrix distributed with SparseBlockDist");
+      if Adom.rank != 2 || Xdom.rank != 1 || Ydom.rank != 1 then
+        compilerError("Rank sizes are not 2 and 1");
+      if Xdom.dim(1) != Adom.dim(2) || Ydom.dim(1) != Adom.dim(1) then
+        halt("Mismatched shape in matrix-vector multiplication");
+
+      this.eltType = t;
+      this.rowRange = Adom.dim(1);
+      this.colRange = Adom.dim(2);
+      this.complete();
+
+      coforall loc in Locales do on loc {
+        const ls = new unmanaged LocSpMVPlan(eltType);
+        ls.inspect(A, Xdom, Ydom);
+        locs[here.id] = ls;
+      }
+
+      coforall loc in Locales do on loc do
+        locs[here.id].exchangeRequests(locs);
+
+      coforall loc in Locales do on loc do
+        locs[here.id].exchangeAddresses(locs);
+    }
+
+    pragma "no doc"
+    proc deinit() {
+      coforall loc in Locales do on loc do
+        delete locs[here.id];
+    }
+
+    /*
+      Compute ``Y = A * X``.  `A` must have the sparsity pattern the plan
+      was created with, and `Y` must not be the same array as `X`.
+     */
+    proc multiply(ref Y: [] eltType, A: [?Adom] eltType, const ref X: [] eltType) {
+      use CommSchedule.SegmentExchange;
+
+      if boundsChecking {
+        if Adom.dim(1) != rowRange || Adom.dim(2) != colRange ||
+           X.domain.dim(1) != colRange || Y.domain.dim(1) != rowRange then
+          halt("Mismatched shape in matrix-vector multiplication");
+      }
+
+      // Owners of X send each locale its ghost columns.
+      coforall loc in Locales do on loc {
+        const ls = locs[here.id];
+        const xSendIdx = ls.xSendIdx, xSendBuf = ls.xSendBuf,
+              xSendOff = ls.xSendOff, xPeer = ls.xPeer;
+
+        forall k in 0..#ls.nXSend do
+          xSendBuf[k] = X[xSendIdx[k]];
+
+        putSegments(xSendBuf, xSendOff, xPeer);
+      }
+
+      // Each locale multiplies its block and sends the partial row sums to
+      // the owners of Y.
+      coforall loc in Locales do on loc {
+        const ls = locs[here.id];
+        const partial = ls.partial, yOff = ls.yOff, yPeer = ls.yPeer;
+
+        if ls.nnz > 0 then
+          ls.localMultiply(A._value.myLocArr.myElems._value.data);
+
+        putSegments(partial, yOff, yPeer);
+      }
+
+      // Owners of Y sum the partial results.  The rows within one
+      // locale's segment are distinct, so only segments need to be
+      // applied in turn.
+      coforall loc in Locales do on loc {
+        const ls = locs[here.id];
+        const yRecvIdx = ls.yRecvIdx, yRecvBuf = ls.yRecvBuf,
+              yRecvOff = ls.yRecvOff;
+
+        forall i in Y.localSubdomain() do
+          Y[i] = 0: eltType;
+
+        for r in 0..#numLocales {
+          forall k in yRecvOff[r]..yRecvOff[r+1]-1 do
+            Y[yRecvIdx[k]] += yRecvBuf[k];
+        }
+      }
+    }
+  }
+
+  //
+  // The part of an SpMVPlan that lives on one locale.
+  //
+  // The local block is kept in CSR form over its nonempty rows: the
+  // nonzeros of row r are rowStart[r]..rowStart[r+1]-1.  colSlot maps each
+  // nonzero to its column's entry in 'ghost', and ySlot each row to its
+  // entry in 'partial'.
+  //
+  // Both exchanges keep their indices in segments per peer locale, and
+  // are set up and run with the helpers in CommSchedule.SegmentExchange:
+  //
+  //   xIdx/ghost[xOff[o]..xOff[o+1]-1]
+  //     the ghost columns this locale needs from owner 'o' of X
+  //   xSendIdx/xSendBuf[xSendOff[r]..xSendOff[r+1]-1]
+  //     the local columns of X locale 'r' needs
+  //   yIdx/partial[yOff[o]..yOff[o+1]-1]
+  //     the local rows whose partial sums go to owner 'o' of Y
+  //   yRecvIdx/yRecvBuf[yRecvOff[r]..yRecvOff[r+1]-1]
+  //     the local rows of Y locale 'r' sends partial sums for
+  //
+  pragma "no doc"
+  class LocSpMVPlan {
+    type eltType;
+
+    var nnz, nRows: int;
+    var rowStart: c_ptr(int);
+    var colSlot: c_ptr(int);
+    var ySlot: c_ptr(int);
+
+    var xOff, xIdx: c_ptr(int);
+    var ghost: c_ptr(eltType);
+    var nXSend: int;
+    var xSendOff, xSendIdx: c_ptr(int);
+    var xSendBuf: c_ptr(eltType);
+    var xPeer: c_ptr(c_ptr(eltType));
+
+    var yOff, yIdx: c_ptr(int);
+    var partial: c_ptr(eltType);
+    var nYRecv: int;
+    var yRecvOff, yRecvIdx: c_ptr(int);
+    var yRecvBuf: c_ptr(eltType);
+    var yPeer: c_ptr(c_ptr(eltType));
+
+    proc init(type eltType) {
+      this.eltType = eltType;
+    }
+
+    proc deinit() {
+      c_free(rowStart);
+      c_free(colSlot);
+      c_free(ySlot);
+      c_free(xOff);
+      c_free(xIdx);
+      c_free(ghost);
+      c_free(xSendOff);
+      c_free(xSendIdx);
+      c_free(xSendBuf);
+      c_free(xPeer);
+      c_free(yOff);
+      c_free(yIdx);
+      c_free(partial);
+      c_free(yRecvOff);
+      c_free(yRecvIdx);
+      c_free(yRecvBuf);
+      c_free(yPeer);
+    }
+
+    proc inspect(A, Xdom, Ydom) {
+      use CommSchedule.SegmentExchange;
+
+      const locA = A._value.myLocArr;
+      if locA != nil then
+        nnz = locA.locDom.mySparseBlock.numIndices;
+
+      // Both of the layouts SparseBlockDist supports (COO and CSR) store
+      // the nonzeros of a block in row-major order, so the positions of
+      // the CSR nonzeros match those of the block's values.
+      var rows, cols: [0..#nnz] int;
+      rowStart = c_malloc(int, nnz+1);
+      if nnz > 0 {
+        for ((i, j), k) in zip(locA.locDom.mySparseBlock, 0..) {
+          if k == 0 || i != rows[nRows-1] {
+            rows[nRows] = i;
+            rowStart[nRows] = k;
+            nRows += 1;
+          }
+          cols[k] = j;
+        }
+      }
+      rowStart[nRows] = nnz;
+
+      const nGhost = groupByOwner(cols, Xdom, xOff, xIdx);
+      ghost = c_malloc(eltType, max(nGhost, 1));
+      colSlot = c_malloc(int, max(nnz, 1));
+      forall k in 0..#nnz do
+        colSlot[k] = findSlot(xOff, xIdx, Xdom, cols[k]);
+
+      groupByOwner(rows[0..#nRows], Ydom, yOff, yIdx);
+      partial = c_malloc(eltType, max(nRows, 1));
+      ySlot = c_malloc(int, max(nRows, 1));
+      forall r in 0..#nRows do
+        ySlot[r] = findSlot(yOff, yIdx, Ydom, rows[r]);
+    }
+
+    proc exchangeRequests(locs) {
+      use CommSchedule.SegmentExchange;
+
+      const nl = numLocales;
+      const first = c_malloc(int, nl);
+      var peerOff, peerIdx: [0..#nl] c_ptr(int);
+
+      forall r in 0..#nl do
+        (peerOff[r], peerIdx[r]) = (locs[r].xOff, locs[r].xIdx);
+      nXSend = fetchRequests(peerOff, peerIdx, xSendOff, xSendIdx, first);
+      xSendBuf = c_malloc(eltType, max(nXSend, 1));
+      xPeer = c_malloc(c_ptr(eltType), nl);
+      forall r in 0..#nl do
+        xPeer[r] = locs[r].ghost + first[r];
+
+      forall o in 0..#nl do
+        (peerOff[o], peerIdx[o]) = (locs[o].yOff, locs[o].yIdx);
+      nYRecv = fetchRequests(peerOff, peerIdx, yRecvOff, yRecvIdx, first);
+      yRecvBuf = c_malloc(eltType, max(nYRecv, 1));
+
+      c_free(first);
+    }
+
+    proc exchangeAddresses(locs) {
+      use CommSchedule.SegmentExchange;
+
+      const nl = numLocales;
+      const first = c_malloc(int, nl);
+      var peerOff: [0..#nl] c_ptr(int);
+
+      forall o in 0..#nl do
+        peerOff[o] = locs[o].yRecvOff;
+      fetchSegmentStarts(peerOff, first);
+      yPeer = c_malloc(c_ptr(eltType), nl);
+      forall o in 0..#nl do
+        yPeer[o] = locs[o].yRecvBuf + first[o];
+
+      c_free(first);
+    }
+
+    //
+    // Multiply the local block, whose values are 'data', by the ghost
+    // columns.  The rows are split so that each task gets about the same
+    // number of nonzeros rather than the same number of rows.
+    //
+    proc localMultiply(const ref data: [] eltType) {
+      const dlo = data.domain.low;
+      const rowStart = this.rowStart, colSlot = this.colSlot,
+            ySlot = this.ySlot,
+            ghost = this.ghost, partial = this.partial;
+      const nnz = this.nnz, nRows = this.nRows;
+      const nTasks = min(if dataParTasksPerLocale > 0
+                         then dataParTasksPerLocale
+                         else here.maxTaskPar, nRows);
+
+      // The first row whose nonzeros start at or after 'k'.
+      proc rowAt(k: int) {
+        var first = 0, last = nRows;
+        while first < last {
+          const mid = (first + last) / 2;
+          if rowStart[mid] < k then first = mid + 1; else last = mid;
+        }
+        return first;
+      }
+
+      coforall t in 0..#nTasks {
+        const rlo = rowAt(t * nnz / nTasks),
+              rhi = rowAt((t+1) * nnz / nTasks) - 1;
+
+        for r in rlo..rhi {
+          var sum: eltType;
+          for k in rowStart[r]..rowStart[r+1]-1 do
+            sum += data[dlo + k] * ghost[colSlot[k]];
+          partial[ySlot[r]] = sum;
+        }
+      }
+    }
+  }
+
   //
   // Type helpers
   //
@@ -1697,6 +2035,10 @@ module Sparse {
   proc isCSArr(A: []) param { return isCSType(A.domain._value.dist.type); }
   pragma "no doc"
   proc isCSDom(D: domain) param { return isCSType(D._value.dist.type); }
+  pragma "no doc"
+  proc isSparseBlockArr(A: []) param where _to_borrowed(A._value): SparseBlockArr { return true; }
+  pragma "no doc"
+  proc isSparseBlockArr(A: []) param { return false; }
 
 } // submodule LinearAlgebra.Sparse
 
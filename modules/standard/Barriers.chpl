@@ -52,9 +52,11 @@
    "task-team" concept.  A task-team will more directly support collective
    operations such as barriers between the tasks within a team.
 
-   The current implementation is designed for correctness, but is not expected
-   to perform well at scale.  We expect performance at scale to improve as
-   this barrier implementation is optimized and as the task-team concept is
+   The default (atomic) implementation gathers and releases tasks with a
+   combining tree whose nodes each live on their own cache line, so tasks do
+   not all contend on a single counter.  Because tasks calling the barrier
+   are not numbered, each task still has to find a free slot in one of the
+   tree's leaves.  We expect this to improve as the task-team concept is
    implemented and optimized.
 */
 module Barriers {
@@ -205,8 +207,154 @@ module Barriers {
   }
 
 
+  /* An atomic counter padded out to its own cache line so that tasks
+     spinning on one counter do not contend with updates to its neighbors.
+   */
+  pragma "no doc"
+  record barrierCounter {
+    var a: chpl__processorAtomicType(int);
+    var pad: 7*int;
+  }
+
+  /* Fan-in of each node of a :class:`barrierTree`. */
+  private param barrierTreeArity = 4;
+
+  /* A combining tree used to gather the tasks of a barrier episode.
+
+     Up to `barrierTreeArity` tasks share each leaf, and each interior node
+     combines up to `barrierTreeArity` children.  The last task to arrive at
+     a node climbs to its parent; the others stop and wait for that node to
+     be released.  The task that completes the root releases its own path
+     back down, and every task that is woken releases the part of its path
+     below the node where it stopped, so wake-ups also fan out as a tree.
+
+     Arrival counts and release flags are never reset between episodes.
+     For episode `e` a node is complete once `(e+1)*need` arrivals have been
+     counted, and its waiters proceed once its release flag exceeds `e`.
+   */
+  pragma "no doc"
+  class barrierTree {
+    var numLeaves: int;
+    var nodeSpace: domain(1);
+    var arrived: [nodeSpace] barrierCounter;
+    var released: [nodeSpace] barrierCounter;
+    var need: [nodeSpace] int;
+    var parent: [nodeSpace] int;
+
+    proc init(n: int) {
+      this.complete();
+      reset(n);
+    }
+
+    /* Rebuild the tree for `n` tasks.  Must not be called while any task
+       is in the tree. */
+    proc reset(n: int) {
+      numLeaves = if n > 0 then (n + barrierTreeArity - 1) / barrierTreeArity
+                           else 0;
+      var numNodes = 0;
+      var levelSize = numLeaves;
+      while levelSize > 0 {
+        numNodes += levelSize;
+        levelSize = if levelSize == 1 then 0
+                    else (levelSize + barrierTreeArity - 1) / barrierTreeArity;
+      }
+      nodeSpace = {0..#numNodes};
+
+      for leaf in 0..#numLeaves do
+        need[leaf] = min(barrierTreeArity, n - leaf*barrierTreeArity);
+
+      // Build the interior levels, each one laid out after its children.
+      var childLo = 0, childSize = numLeaves;
+      while childSize > 1 {
+        const lo = childLo + childSize;
+        const size = (childSize + barrierTreeArity - 1) / barrierTreeArity;
+        for node in lo..#size do
+          need[node] = 0;
+        for child in 0..#childSize {
+          const node = lo + child / barrierTreeArity;
+          parent[childLo + child] = node;
+          need[node] += 1;
+        }
+        childLo = lo;
+        childSize = size;
+      }
+      if numNodes > 0 then
+        parent[numNodes-1] = -1;
+
+      for c in arrived do c.a.write(0);
+      for c in released do c.a.write(0);
+    }
+
+    /* Take a slot in some leaf for `episode`.  Tasks start at a leaf chosen
+       from their task id so that concurrent arrivals tend to spread out.
+       Returns the leaf and whether this task filled it.
+     */
+    proc claimLeaf(episode: int): (int, bool) {
+      extern proc chpl_task_getId(): chpl_taskID_t;
+      if numLeaves == 0 then
+        halt("Too many callers to barrier");
+      const start = ((chpl_task_getId(): uint) % (numLeaves: uint)): int;
+      for i in 0..#numLeaves {
+        const leaf = (start + i) % numLeaves;
+        const limit = (episode + 1) * need[leaf];
+        var cur = arrived[leaf].a.read();
+        while cur < limit {
+          if arrived[leaf].a.compareExchange(cur, cur + 1) then
+            return (leaf, cur + 1 == limit);
+          cur = arrived[leaf].a.read();
+        }
+      }
+      halt("Too many callers to barrier");
+      return (-1, false);
+    }
+
+    /* Arrive at the tree for `episode`.  Returns the leaf this task joined
+       and the node at which it stopped climbing, or -1 if this task
+       completed the root.
+     */
+    proc arrive(episode: int): (int, int) {
+      var (leaf, full) = claimLeaf(episode);
+      var node = leaf;
+      while full {
+        node = parent[node];
+        if node < 0 then break;
+        full = arrived[node].a.fetchAdd(1) + 1 == (episode + 1) * need[node];
+      }
+      return (leaf, node);
+    }
+
+    /* Wait until `node` has been released for `episode`. */
+    proc waitRelease(node: int, episode: int) {
+      while released[node].a.read() <= episode do
+        chpl_task_yield();
+    }
+
+    /* Release the nodes on the path from `leaf` up to, but not including,
+       `stop`, starting with the highest one. */
+    proc release(leaf: int, stop: int, episode: int) {
+      if leaf == stop then return;
+      release(parent[leaf], stop, episode);
+      released[leaf].a.write(episode + 1);
+    }
+  }
+
+  /* An action performed by the task that completes a barrier episode,
+     before any other task is allowed past the barrier.  AllLocalesBarriers
+     uses this to synchronize with the other locales.
+   */
+  pragma "no doc"
+  class BarrierCompletionHook {
+    proc episodeComplete() {
+    }
+  }
+
 /* A task barrier implemented using atomics. Can be used as a simple barrier
    or as a split-phase barrier.
+
+   Tasks are gathered with a :class:`barrierTree` rather than a single
+   counter, so arrivals and wake-ups are spread over many cache lines.
+   :proc:`barrier`, :proc:`notify` and the reusable part of :proc:`wait`
+   each use their own tree and their own count of completed episodes.
  */
   pragma "no doc" class aBarrier: BarrierBaseType {
     /* If true the barrier can be used multiple times.  When using this as a
@@ -217,39 +365,61 @@ module Barriers {
     pragma "no doc"
     var n: int;
     pragma "no doc"
-    var count: chpl__processorAtomicType(int);
+    var barrierArrivals: unmanaged barrierTree;
+    pragma "no doc"
+    var notifyArrivals: unmanaged barrierTree;
+    pragma "no doc"
+    var waitArrivals: unmanaged barrierTree;
+    pragma "no doc"
+    var barriers: barrierCounter;
+    pragma "no doc"
+    var notifies: barrierCounter;
     pragma "no doc"
-    var done: chpl__processorAtomicType(bool);
+    var waits: barrierCounter;
 
-    // Hack for AllLocalesBarrier
+    // Used by AllLocalesBarrier
     pragma "no doc"
-    param hackIntoCommBarrier = false;
+    var hook: unmanaged BarrierCompletionHook;
 
     /* Construct a new Barrier object.
 
        :arg n: The number of tasks involved in this barrier
      */
     proc init(n: int, param reusable: bool) {
-      this.reusable = reusable;
-      this.complete();
-      reset(n);
+      this.init(n, reusable, nil);
     }
 
-    // Hack for AllLocalesBarrier
+    // Used by AllLocalesBarrier
     pragma "no doc"
-    proc init(n: int, param reusable: bool, param hackIntoCommBarrier: bool) {
+    proc init(n: int, param reusable: bool,
+              hook: unmanaged BarrierCompletionHook) {
       this.reusable = reusable;
-      this.hackIntoCommBarrier = hackIntoCommBarrier;
+      this.barrierArrivals = new unmanaged barrierTree(0);
+      this.notifyArrivals = new unmanaged barrierTree(0);
+      this.waitArrivals = new unmanaged barrierTree(0);
+      this.hook = hook;
       this.complete();
       reset(n);
     }
 
+    pragma "no doc"
+    proc deinit() {
+      delete barrierArrivals;
+      delete notifyArrivals;
+      delete waitArrivals;
+    }
+
     pragma "no doc"
     inline proc reset(nTasks: int) {
       on this {
         n = nTasks;
-        count.write(n);
-        done.write(false);
+        barrierArrivals.reset(n);
+        notifyArrivals.reset(n);
+        if reusable then
+          waitArrivals.reset(n);
+        barriers.a.write(0);
+        notifies.a.write(0);
+        waits.a.write(0);
       }
     }
 
@@ -258,36 +428,28 @@ module Barriers {
      */
     inline proc barrier() {
       on this {
-        const myc = count.fetchSub(1);
-        if myc<=1 {
-          if hackIntoCommBarrier {
-            extern proc chpl_comm_barrier(msg: c_string);
-            chpl_comm_barrier("local barrier call".localize().c_str());
-          }
-          if done.testAndSet() then
-            halt("Too many callers to barrier()");
-          if reusable {
-            count.waitFor(n-1);
-            count.add(1);
-            done.clear();
-          }
+        const e = barriers.a.read();
+        const (leaf, stop) = barrierArrivals.arrive(e);
+        if stop < 0 {
+          if hook != nil then
+            hook.episodeComplete();
+          barriers.a.write(e + 1);
         } else {
-          done.waitFor(true);
-          if reusable {
-            count.add(1);
-            done.waitFor(false);
-          }
+          barrierArrivals.waitRelease(stop, e);
         }
+        barrierArrivals.release(leaf, stop, e);
       }
     }
 
     /* Notify the barrier that this task has reached this point. */
     inline proc notify() {
       on this {
-        const myc = count.fetchSub(1);
-        if myc<=1 {
-          if done.testAndSet() then
-            halt("Too many callers to notify()");
+        const e = notifies.a.read();
+        const (leaf, stop) = notifyArrivals.arrive(e);
+        if stop < 0 {
+          if !reusable && hook != nil then
+            hook.episodeComplete();
+          notifies.a.write(e + 1);
         }
       }
     }
@@ -299,12 +461,21 @@ module Barriers {
      */
     inline proc wait() {
       on this {
-        done.waitFor(true);
+        // The completed wait count can't advance until this task arrives,
+        // so it identifies the episode this task notified in.
+        const e = waits.a.read();
+        while notifies.a.read() <= e do
+          chpl_task_yield();
         if reusable {
-          const myc = count.fetchAdd(1);
-          if myc == n-1 then
-            done.clear();
-          done.waitFor(false);
+          const (leaf, stop) = waitArrivals.arrive(e);
+          if stop < 0 {
+            if hook != nil then
+              hook.episodeComplete();
+            waits.a.write(e + 1);
+          } else {
+            waitArrivals.waitRelease(stop, e);
+          }
+          waitArrivals.release(leaf, stop, e);
         }
       }
     }
@@ -312,7 +483,7 @@ module Barriers {
     /* Return `true` if `n` tasks have called :proc:`notify`
      */
     inline proc check(): bool {
-      return done.read();
+      return notifies.a.read() > waits.a.read();
     }
   }
 
@@ -137,6 +137,43 @@
   was executed on locale 0, and a remote get and a remote put were
   executed on locale 1.
 
+  **Counting Communication Operations by Source Line**
+
+  The aggregate counts say how much communication a program does, but
+  not where it comes from.  For that, communication can also be counted
+  per call site: each remote GET, PUT and execute_on is attributed to
+  the source line that caused it and to the locale it went to.  For
+  each such site the count of operations, the number of bytes moved,
+  and a histogram of how long the initiating task waited for each
+  operation are kept.  This is done like this::
+
+    startCommSiteDiagnostics();
+    // between start/stop calls, count comm ops initiated on any locale
+    stopCommSiteDiagnostics();
+    // report the counts, most frequent sites first
+    printCommSiteDiagnostics();
+
+  Using the example program above with these calls in place of the
+  aggregate ones, executing on two locales prints something like this::
+
+    0: comm sites: 1
+    0: t.chpl:5: execute_on to 1: 1 ops, 48 bytes, latency mean 63.117 us, p50 <= 65.536 us, p99 <= 65.536 us
+    1: comm sites: 2
+    1: t.chpl:6: get from 0: 1 ops, 8 bytes, latency mean 4.030 us, p50 <= 4.096 us, p99 <= 4.096 us
+    1: t.chpl:6: put to 0: 1 ops, 8 bytes, latency mean 3.544 us, p50 <= 4.096 us, p99 <= 4.096 us
+
+  The latency percentiles are upper bounds, since the histogram buckets
+  are powers of two nanoseconds.  As with the aggregate counts, there
+  are ``Here`` versions of these procedures that work only on the
+  calling locale, and :proc:`resetCommSiteDiagnostics` clears the
+  counts.
+
+  Per-site counting can also cover a whole run without changing the
+  program, by setting the environment variable
+  ``CHPL_RT_COMM_SITE_DIAGNOSTICS`` to ``true``.  Each locale then
+  counts from before module initialization and prints its report when
+  the program exits.
+
   **Studying Communication During Module Initialization**
 
   It is hard for a programmer to determine exactly what happens during
@@ -348,6 +385,86 @@ module CommDiagnostics
   }
 
 
+  private extern proc chpl_startCommSiteDiagnosticsHere();
+
+  private extern proc chpl_stopCommSiteDiagnosticsHere();
+
+  private extern proc chpl_resetCommSiteDiagnosticsHere();
+
+  private extern proc chpl_printCommSiteDiagnosticsHere();
+
+  /*
+    Start counting communication operations by call site across the
+    whole program.
+   */
+  proc startCommSiteDiagnostics() {
+    // Start the calling locale last, so the on-statements used to start
+    // the others are not counted.
+    for loc in Locales do if loc != here then on loc do
+      startCommSiteDiagnosticsHere();
+    startCommSiteDiagnosticsHere();
+  }
+
+  /*
+    Stop counting communication operations by call site across the
+    whole program.
+   */
+  proc stopCommSiteDiagnostics() {
+    // Stop the calling locale first, for the same reason as above.
+    stopCommSiteDiagnosticsHere();
+    for loc in Locales do if loc != here then on loc do
+      stopCommSiteDiagnosticsHere();
+  }
+
+  /*
+    Start counting communication operations by call site on this locale.
+   */
+  proc startCommSiteDiagnosticsHere() {
+    chpl_startCommSiteDiagnosticsHere();
+  }
+
+  /*
+    Stop counting communication operations by call site on this locale.
+   */
+  proc stopCommSiteDiagnosticsHere() {
+    chpl_stopCommSiteDiagnosticsHere();
+  }
+
+  /*
+    Reset the per-site communication counts across the whole program.
+   */
+  proc resetCommSiteDiagnostics() {
+    for loc in Locales do on loc do
+      resetCommSiteDiagnosticsHere();
+  }
+
+  /*
+    Reset the per-site communication counts on the calling locale.
+   */
+  inline proc resetCommSiteDiagnosticsHere() {
+    chpl_resetCommSiteDiagnosticsHere();
+  }
+
+  /*
+    Print the per-site communication counts of every locale, one
+    locale after another, each sorted by decreasing count.
+   */
+  proc printCommSiteDiagnostics() {
+    for loc in Locales do on loc do
+      printCommSiteDiagnosticsHere();
+  }
+
+  /*
+    Print the per-site communication counts of the calling locale,
+    sorted by decreasing count.  Each line gives the locale, source
+    location, operation and remote locale, then the number of
+    operations, the bytes they moved, and the mean, median and 99th
+    percentile time the initiating task waited.
+   */
+  proc printCommSiteDiagnosticsHere() {
+    chpl_printCommSiteDiagnosticsHere();
+  }
+
   /*
     If this is set, on-the-fly reporting of communication operations
     will be turned on before any module initialization begins and
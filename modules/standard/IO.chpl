@@ -884,6 +884,9 @@ private extern proc qio_file_sync(f:qio_file_ptr_t):syserr;
 private extern proc qio_channel_end_offset_unlocked(ch:qio_channel_ptr_t):int(64);
 private extern proc qio_file_get_style(f:qio_file_ptr_t, ref style:iostyle);
 private extern proc qio_file_length(f:qio_file_ptr_t, ref len:int(64)):syserr;
+private extern proc qio_err_to_int(a:syserr):int(32);
+private extern proc qio_file_pread_bytes(f:qio_file_ptr_t, ptr:c_void_ptr, len:int(64), offset:int(64)):syserr;
+private extern proc qio_file_pwrite_bytes(f:qio_file_ptr_t, ptr:c_void_ptr, len:int(64), offset:int(64)):syserr;
 
 pragma "no prototype" // FIXME
 private extern proc qio_channel_create(ref ch:qio_channel_ptr_t, file:qio_file_ptr_t, hints:c_int, readable:c_int, writeable:c_int, start:int(64), end:int(64), const ref style:iostyle):syserr;
@@ -1511,6 +1514,238 @@ proc file.length():int(64) throws {
   return len;
 }
 
+/*
+
+Write the elements of the rectangular array `arr` to the file at `path` in
+their native binary representation, in row-major order and with no header
+or padding.  Any existing contents of the file are replaced.
+
+The array is written in parallel.  Each locale that owns part of `arr`
+opens the file itself and writes its own elements directly to their
+positions in it, using several tasks for large local portions.  For a
+distributed array, `path` must therefore name the same file on every
+locale, for example one on a shared file system.
+
+:arg path: the file to write
+:arg arr: the array to write.  Its element type must be a plain-old-data
+          type and its domain must not be strided.
+:arg direct: if true, write the page-aligned part of each region with
+             ``O_DIRECT``, bypassing the operating system's page cache.
+             This is worthwhile only for very large arrays.
+
+:throws SystemError: Thrown if the file could not be opened or written.
+ */
+proc writeBinary(path:string, const ref arr:[] ?t, direct:bool = false) throws {
+  var f = open(path, iomode.cw);
+  f.close();
+  binaryArrayIO(true, path, arr, direct);
+}
+
+/*
+
+Read the elements of the rectangular array `arr` from the file at `path`,
+as written by :proc:`writeBinary`.  The file must contain at least as many
+bytes as the array occupies.  Like :proc:`writeBinary`, the elements owned
+by each locale are read in parallel by that locale.
+
+:arg path: the file to read
+:arg arr: the array to read into.  Its element type must be a
+          plain-old-data type and its domain must not be strided.
+:arg direct: if true, read the page-aligned part of each region with
+             ``O_DIRECT``, bypassing the operating system's page cache.
+
+:throws SystemError: Thrown if the file could not be opened or read, or
+                     if it is too short.
+ */
+proc readBinary(path:string, ref arr:[] ?t, direct:bool = false) throws {
+  binaryArrayIO(false, path, arr, direct);
+}
+
+// Regions smaller than this are read or written by a single task.
+private param binaryArrayIOMinChunk = 16 * 1024 * 1024;
+// O_DIRECT transfers must be aligned to the device's logical block size;
+// a page is a safe choice for that.
+private param binaryArrayIODirectAlign = 4096;
+
+//
+// Every locale owning part of 'arr' opens 'path' and moves its local
+// subdomains to or from the file.  A local subdomain is made of "runs":
+// stretches of indices that are contiguous both in the file (row-major
+// order over the whole domain) and in the locale's row-major storage.
+// The runs, or chunks of them when there are few, are spread over tasks.
+// Local subdomains that are strided in their innermost dimension have no
+// such runs; those are moved a row at a time instead.
+//
+private proc binaryArrayIO(param writing:bool, path:string,
+                           const ref arr:[] ?t, direct:bool) throws {
+  param fnName = if writing then "writeBinary" else "readBinary";
+  if !isRectangularArr(arr) then
+    compilerError(fnName + "() requires a rectangular array");
+  if arr.domain.stridable then
+    compilerError(fnName + "() does not support strided arrays");
+  if chpl__isArrayView(arr._value) then
+    compilerError(fnName + "() does not support array views");
+  if !isPODType(t) then
+    compilerError(fnName + "() requires a plain-old-data element type");
+
+  param rank = arr.rank;
+  const whole = arr.domain;
+  const eltSize = c_sizeof(t):int;
+
+  // Distance, in elements, between consecutive indices of each dimension.
+  var fileStride: rank*int;
+  fileStride(rank) = 1;
+  for param i in 1..rank-1 by -1 do
+    fileStride(i) = fileStride(i+1) * whole.dim(i+1).size;
+
+  proc fileOffset(idx) {
+    var pos = 0;
+    for param i in 1..rank do
+      pos += (idx(i) - whole.dim(i).low):int * fileStride(i);
+    return pos * eltSize;
+  }
+
+  // Errors are recorded here rather than thrown from the parallel loops
+  // below, so that the caller sees a single SystemError.
+  var firstErr: atomic int;
+  proc noteError(err:syserr) {
+    if err then firstErr.compareExchange(0, qio_err_to_int(err));
+  }
+
+  proc transfer(f:file, df:file, ptr:c_void_ptr, len:int, offset:int) {
+    proc move(f:file, ptr:c_void_ptr, len:int, offset:int) {
+      if len <= 0 then return;
+      noteError(if writing
+                then qio_file_pwrite_bytes(f._file_internal, ptr, len, offset)
+                else qio_file_pread_bytes(f._file_internal, ptr, len, offset));
+    }
+
+    // With O_DIRECT, the buffer address and file offset must both be
+    // aligned.  They move together, so only regions where they are
+    // equally misaligned have an aligned middle part.
+    param blk = binaryArrayIODirectAlign;
+    const addr = ptr:c_uintptr:int;
+    if direct && (addr - offset) % blk == 0 {
+      const head = min(len, (blk - offset % blk) % blk);
+      const body = (len - head) / blk * blk;
+      const bytes = ptr:c_ptr(uint(8));
+      move(f, ptr, head, offset);
+      move(df, (bytes + head):c_void_ptr, body, offset + head);
+      move(f, (bytes + head + body):c_void_ptr, len - head - body,
+           offset + head + body);
+    } else {
+      move(f, ptr, len, offset);
+    }
+  }
+
+  coforall loc in arr.targetLocales() do on loc {
+    const mode = if writing then iomode.rw else iomode.r;
+    var f, df: file;
+    try {
+      f = open(path, mode);
+      if direct then df = open(path, mode, hints=QIO_HINT_DIRECT);
+    } catch e: SystemError {
+      noteError(e.err);
+    }
+
+    if firstErr.read() == 0 then for d in arr.localSubdomains() {
+      if d.size == 0 then continue;
+
+      // Distributions such as Cyclic own every n-th index, so 'd' may be
+      // strided.  As long as its innermost dimension is not, its rows are
+      // still contiguous in the file and are moved as runs further down.
+      var unitStride: rank*bool;
+      for param i in 1..rank do
+        unitStride(i) = !d.stridable || d.dim(i).stride == 1;
+
+      if !unitStride(rank) {
+        // The elements of a row are spread over several locales.  To read
+        // a row, fetch the stretch of the file between this locale's first
+        // and last element of it with one pread() and pick out those
+        // elements.  To write it, the locale owning its first element
+        // gathers the whole row and writes it with one pwrite(); the other
+        // owners leave it alone.
+        const inner = d.dim(rank);
+        forall r in 0..#(d.size / inner.size) {
+          var idx: rank*whole.idxType;
+          var q = r;
+          for param i in 1..rank-1 by -1 {
+            idx(i) = d.dim(i).orderToIndex(q % d.dim(i).size);
+            q /= d.dim(i).size;
+          }
+
+          if writing {
+            if inner.member(whole.dim(rank).low) {
+              var rowDims: rank*range(whole.idxType);
+              for param i in 1..rank-1 do rowDims(i) = idx(i)..idx(i);
+              rowDims(rank) = whole.dim(rank);
+              const rowDom: domain(rank, whole.idxType) = rowDims;
+              var row: [rowDom] t = arr[rowDom];
+              idx(rank) = whole.dim(rank).low;
+              transfer(f, df, c_ptrTo(row):c_void_ptr, rowDom.size * eltSize,
+                       fileOffset(idx));
+            }
+          } else {
+            var span: [inner.alignedLow..inner.alignedHigh] t;
+            idx(rank) = inner.alignedLow;
+            transfer(f, df, c_ptrTo(span):c_void_ptr, span.size * eltSize,
+                     fileOffset(idx));
+            const base = c_ptrTo(arr._value.dsiAccess(idx));
+            for (j, m) in zip(inner, 0..) do base[m] = span[j];
+          }
+        }
+        continue;
+      }
+
+      // Find the outermost dimension 'k' of the runs: every dimension
+      // after it is covered in full by 'd', and 'k' itself has unit stride.
+      var k = rank;
+      while k > 1 && d.dim(k) == whole.dim(k) && unitStride(k-1) do k -= 1;
+
+      var runLen = d.dim(k).size * fileStride(k);
+      var numRuns = 1;
+      for param i in 1..rank do
+        if i < k then numRuns *= d.dim(i).size;
+
+      const maxTasks = if dataParTasksPerLocale == 0 then here.maxTaskPar
+                       else dataParTasksPerLocale;
+      const chunksPerRun =
+        if numRuns >= maxTasks then 1
+        else max(1, min(maxTasks / numRuns,
+                        runLen * eltSize / binaryArrayIOMinChunk));
+
+      forall w in 0..#(numRuns * chunksPerRun) {
+        // Index of the first element of this run.
+        var idx: rank*whole.idxType;
+        var r = w / chunksPerRun;
+        for param i in 1..rank by -1 {
+          if i < k {
+            idx(i) = d.dim(i).orderToIndex(r % d.dim(i).size);
+            r /= d.dim(i).size;
+          } else {
+            idx(i) = d.dim(i).low;
+          }
+        }
+
+        const (lo, hi) = _computeBlock(runLen, chunksPerRun,
+                                       w % chunksPerRun, runLen-1);
+        // Go through dsiAccess() to get a reference to the element itself,
+        // even though 'arr' is passed by const ref.
+        const base = c_ptrTo(arr._value.dsiAccess(idx)):c_ptr(uint(8));
+        transfer(f, df, (base + lo * eltSize):c_void_ptr, (hi-lo+1) * eltSize,
+                 fileOffset(idx) + lo * eltSize);
+      }
+    }
+
+    if !is_c_nil(df._file_internal) then df.close();
+    if !is_c_nil(f._file_internal) then f.close();
+  }
+
+  if firstErr.read() != 0 then
+    throw SystemError.fromSyserr(firstErr.read(),
+                                 "in " + fnName + " with path " + path);
+}
+
 // these strings are here (vs in _modestring)
 // in an attempt to avoid string copies, leaks,
 // and unnecessary allocations.
@@ -65,6 +65,15 @@
     If during execution the amount of allocated memory exceeds this
     limit on any locale, halt the program with a message saying so.
 
+  ``memSampleInterval``: `uint`:
+    If the value is greater than 0 (zero), enable memory tracking in
+    sampling mode, recording about one allocation per this many bytes
+    allocated instead of every allocation.  An allocation of at least
+    this size is always recorded.  The statistics and the per-type
+    reports are then estimates, scaled up from the recorded
+    allocations.  This makes memory tracking cheap enough to leave
+    enabled for long-running programs.
+
   The following two config variables do not enable memory tracking;
   they only modify how it is done.
 
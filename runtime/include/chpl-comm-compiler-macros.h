@@ -23,6 +23,7 @@
 #ifndef LAUNCHER
 
 #include "chpl-comm.h"
+#include "chpl-comm-site-diags.h"
 #include "chpl-mem.h"
 #include "error.h"
 #include "chpl-wide-ptr-fns.h"
@@ -51,14 +52,18 @@ void chpl_gen_comm_get(void *addr, c_nodeid_t node, void* raddr,
     chpl_memcpy(addr, raddr, size);
 #ifdef HAS_CHPL_CACHE_FNS
   } else if( chpl_cache_enabled() ) {
+    uint64_t t0 = chpl_comm_site_diags_start();
     chpl_cache_comm_get(addr, node, raddr, size, typeIndex, commID, ln, fn);
+    chpl_comm_site_diags_end(t0, chpl_comm_site_get, node, size, ln, fn);
 #endif
   } else {
+    uint64_t t0 = chpl_comm_site_diags_start();
 #ifdef CHPL_TASK_COMM_GET
     chpl_task_comm_get(addr, node, raddr, size, typeIndex, commID, ln, fn);
 #else
     chpl_comm_get(addr, node, raddr, size, typeIndex, commID, ln, fn);
 #endif
+    chpl_comm_site_diags_end(t0, chpl_comm_site_get, node, size, ln, fn);
   }
 }
 
@@ -98,14 +103,18 @@ void chpl_gen_comm_put(void* addr, c_nodeid_t node, void* raddr,
     chpl_memcpy(raddr, addr, size);
 #ifdef HAS_CHPL_CACHE_FNS
   } else if( chpl_cache_enabled() ) {
+    uint64_t t0 = chpl_comm_site_diags_start();
     chpl_cache_comm_put(addr, node, raddr, size, typeIndex, commID, ln, fn);
+    chpl_comm_site_diags_end(t0, chpl_comm_site_put, node, size, ln, fn);
 #endif
   } else {
+    uint64_t t0 = chpl_comm_site_diags_start();
 #ifdef CHPL_TASK_COMM_PUT
     chpl_task_comm_put(addr, node, raddr, size, typeIndex, commID, ln, fn);
 #else
     chpl_comm_put(addr, node, raddr, size, typeIndex, commID, ln, fn);
 #endif
+    chpl_comm_site_diags_end(t0, chpl_comm_site_put, node, size, ln, fn);
   }
 }
 
@@ -115,6 +124,7 @@ void chpl_gen_comm_get_strd(void *addr, void *dststr, c_nodeid_t node, void *rad
                        size_t elemSize, int32_t typeIndex,
                        int32_t commID, int ln, int32_t fn)
 {
+  uint64_t t0 = chpl_comm_site_diags_start();
   if( 0 ) {
 #ifdef HAS_CHPL_CACHE_FNS
   } else if( chpl_cache_enabled() ) {
@@ -127,6 +137,11 @@ void chpl_gen_comm_get_strd(void *addr, void *dststr, c_nodeid_t node, void *rad
   chpl_comm_get_strd(addr, dststr, node, raddr, srcstr, count, strlevels, elemSize, typeIndex, commID, ln, fn);
 #endif
   }
+  if (t0 != 0)
+    chpl_comm_site_diags_end(t0, chpl_comm_site_get_strd, node,
+                             chpl_comm_site_diags_strd_size(elemSize, count,
+                                                            strlevels),
+                             ln, fn);
 }
 
 static inline
@@ -135,6 +150,7 @@ void chpl_gen_comm_put_strd(void *addr, void *dststr, c_nodeid_t node, void *rad
                        size_t elemSize, int32_t typeIndex,
                        int32_t commID, int ln, int32_t fn)
 {
+  uint64_t t0 = chpl_comm_site_diags_start();
   if( 0 ) {
 #ifdef HAS_CHPL_CACHE_FNS
   } else if( chpl_cache_enabled() ) {
@@ -147,6 +163,51 @@ void chpl_gen_comm_put_strd(void *addr, void *dststr, c_nodeid_t node, void *rad
   chpl_comm_put_strd(addr, dststr, node, raddr, srcstr, count, strlevels, elemSize, typeIndex, commID, ln, fn);
 #endif
   }
+  if (t0 != 0)
+    chpl_comm_site_diags_end(t0, chpl_comm_site_put_strd, node,
+                             chpl_comm_site_diags_strd_size(elemSize, count,
+                                                            strlevels),
+                             ln, fn);
+}
+
+//
+// Remote executions started by "on" statements.  These add the source
+// location of the "on" to the runtime calls, for comm site diagnostics.
+//
+static inline
+void chpl_gen_comm_execute_on(c_nodeid_t node, c_sublocid_t subloc,
+                              chpl_fn_int_t fid,
+                              chpl_comm_on_bundle_t *arg, size_t arg_size,
+                              int ln, int32_t fn)
+{
+  uint64_t t0 = chpl_comm_site_diags_start();
+  chpl_comm_execute_on(node, subloc, fid, arg, arg_size);
+  chpl_comm_site_diags_end(t0, chpl_comm_site_execute_on, node, arg_size,
+                           ln, fn);
+}
+
+static inline
+void chpl_gen_comm_execute_on_fast(c_nodeid_t node, c_sublocid_t subloc,
+                                   chpl_fn_int_t fid,
+                                   chpl_comm_on_bundle_t *arg, size_t arg_size,
+                                   int ln, int32_t fn)
+{
+  uint64_t t0 = chpl_comm_site_diags_start();
+  chpl_comm_execute_on_fast(node, subloc, fid, arg, arg_size);
+  chpl_comm_site_diags_end(t0, chpl_comm_site_execute_on_fast, node, arg_size,
+                           ln, fn);
+}
+
+static inline
+void chpl_gen_comm_execute_on_nb(c_nodeid_t node, c_sublocid_t subloc,
+                                 chpl_fn_int_t fid,
+                                 chpl_comm_on_bundle_t *arg, size_t arg_size,
+                                 int ln, int32_t fn)
+{
+  uint64_t t0 = chpl_comm_site_diags_start();
+  chpl_comm_execute_on_nb(node, subloc, fid, arg, arg_size);
+  chpl_comm_site_diags_end(t0, chpl_comm_site_execute_on_nb, node, arg_size,
+                           ln, fn);
 }
 
 // Returns true if the given node ID matches the ID of the currently node,
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2004-2018 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _chpl_comm_site_diags_h_
+#define _chpl_comm_site_diags_h_
+#ifndef LAUNCHER
+
+#include <stdint.h>
+#include <stddef.h>
+#include <time.h>
+#include "chpltypes.h"
+#include "chpl-comm-locales.h"
+
+//
+// Per-call-site communication diagnostics.
+//
+// While enabled, each remote operation started from generated code
+// (through the chpl_gen_comm_* interface) is attributed to the source
+// line that caused it.  For each (line, operation, remote locale) the
+// calling locale keeps a count, the number of bytes moved, and a log2
+// histogram of how long the initiating task waited.  This works the
+// same way over every comm layer, because it sits above them.
+//
+// With the remote data cache enabled, the counts are of remote
+// accesses requested by the program, some of which the cache may
+// satisfy without communicating.
+//
+
+typedef enum {
+  chpl_comm_site_get,
+  chpl_comm_site_put,
+  chpl_comm_site_get_strd,
+  chpl_comm_site_put_strd,
+  chpl_comm_site_execute_on,
+  chpl_comm_site_execute_on_fast,
+  chpl_comm_site_execute_on_nb,
+  chpl_comm_site_num_kinds
+} chpl_comm_site_kind_t;
+
+// set via chpl_startCommSiteDiagnosticsHere()
+extern int chpl_comm_site_diagnostics;
+
+//
+// Called once on each locale during runtime initialization.  If
+// CHPL_RT_COMM_SITE_DIAGNOSTICS is true, turns per-site counting on
+// here and has chpl_comm_site_diags_exit() print the report.
+//
+void chpl_comm_site_diags_init(void);
+void chpl_comm_site_diags_exit(void);
+
+void chpl_comm_site_diags_record(chpl_comm_site_kind_t kind,
+                                 c_nodeid_t node, size_t size,
+                                 uint64_t start_ns, int ln, int32_t fn);
+
+static inline
+uint64_t chpl_comm_site_diags_now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+//
+// Generated-code wrappers bracket a remote operation with these.  The
+// start returns 0 if counting is off, and then the end does nothing.
+//
+static inline
+uint64_t chpl_comm_site_diags_start(void) {
+  return chpl_comm_site_diagnostics ? chpl_comm_site_diags_now() : 0;
+}
+
+static inline
+void chpl_comm_site_diags_end(uint64_t start_ns, chpl_comm_site_kind_t kind,
+                              c_nodeid_t node, size_t size,
+                              int ln, int32_t fn) {
+  if (start_ns != 0)
+    chpl_comm_site_diags_record(kind, node, size, start_ns, ln, fn);
+}
+
+static inline
+size_t chpl_comm_site_diags_strd_size(size_t elemSize, void* count,
+                                      int32_t strlevels) {
+  size_t size = elemSize;
+  int32_t i;
+  for (i = 0; i <= strlevels; i++)
+    size *= ((size_t*) count)[i];
+  return size;
+}
+
+void chpl_startCommSiteDiagnosticsHere(void);
+void chpl_stopCommSiteDiagnosticsHere(void);
+void chpl_resetCommSiteDiagnosticsHere(void);
+void chpl_printCommSiteDiagnosticsHere(void);
+
+#endif // LAUNCHER
+#endif // _chpl_comm_site_diags_h_
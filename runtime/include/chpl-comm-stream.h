@@ -0,0 +1,95 @@
+/*
+ * Copyright 2004-2018 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _chpl_comm_stream_h_
+#define _chpl_comm_stream_h_
+
+#ifndef LAUNCHER
+
+#include <stdint.h>
+#include "chpltypes.h"
+#include "chpl-comm.h"
+
+//
+// Bulk prefetch of remote array elements that a loop reads in order.
+//
+// The compiler (see prefetchRemoteArrayReads) turns a loop that reads
+// elements first..first+count-1 of a remote _ddata one per iteration
+// into
+//
+//   s = chpl_comm_stream_start(node, data, eltSize, first, count, ...);
+//   for (...)
+//     ... chpl_comm_stream_base(s, data, i)[i] ...
+//   chpl_comm_stream_finish(s);
+//
+// The elements are fetched in strips with chpl_comm_get_nb(), with the
+// next strip in flight while the current one is read.  When the data is
+// local no stream is created and chpl_comm_stream_base() returns the
+// data pointer itself.
+//
+
+typedef struct {
+  c_nodeid_t node;
+  char* raddr;                    // remote address of element 0
+  size_t eltSize;
+  int64_t first;                  // elements read are [first, last]
+  int64_t last;
+  int64_t strip;                  // elements per buffer
+
+  char* base;                     // buffer 'cur', shifted to element 0
+  int64_t lo;                     // elements held by buffer 'cur'
+  int64_t hi;                     //   are [lo, hi)
+
+  int cur;
+  char* buf[2];
+  int64_t bufLo[2];
+  int64_t bufHi[2];
+  chpl_comm_nb_handle_t pending[2];
+
+  int32_t typeIndex;
+  int32_t commID;
+  int ln;
+  int32_t fn;
+} chpl_comm_stream_t;
+
+void* chpl_comm_stream_start(c_nodeid_t node, void* raddr, size_t eltSize,
+                             int64_t first, int64_t count, int32_t typeIndex,
+                             int32_t commID, int ln, int32_t fn);
+
+void chpl_comm_stream_advance(chpl_comm_stream_t* s, int64_t idx);
+
+// Returns a pointer p such that p[idx] is a local copy of element idx.
+static inline
+void* chpl_comm_stream_base(void* stream, void* raddr, int64_t idx) {
+  chpl_comm_stream_t* s = (chpl_comm_stream_t*) stream;
+
+  if (s == NULL)
+    return raddr;
+
+  if (idx < s->lo || idx >= s->hi)
+    chpl_comm_stream_advance(s, idx);
+
+  return s->base;
+}
+
+void chpl_comm_stream_finish(void* stream);
+
+#endif // LAUNCHER
+
+#endif // _chpl_comm_stream_h_
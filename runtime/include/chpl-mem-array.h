@@ -32,6 +32,23 @@
 #include "error.h"
 
 
+//
+// Placement of array memory that is not bound to a particular sublocale.
+// If chpl_mem_array_localize is set (CHPL_RT_LOCALIZE_ARRAYS), the pages
+// of such arrays are spread across the NUMA domains in contiguous blocks,
+// in the same order that parallel iteration over the array divides it
+// among tasks.  If chpl_mem_array_hugepages is set (CHPL_RT_ARRAY_HUGEPAGES),
+// they are advised to use transparent huge pages.  Neither applies to
+// arrays smaller than CHPL_MEM_ARRAY_PLACEMENT_MIN_SIZE.
+//
+extern chpl_bool chpl_mem_array_localize;
+extern chpl_bool chpl_mem_array_hugepages;
+
+void chpl_mem_array_adviseHugePages(void* p, size_t size);
+
+#define CHPL_MEM_ARRAY_PLACEMENT_MIN_SIZE ((size_t) 4 << 20)
+
+
 static inline
 chpl_bool chpl_mem_size_justifies_comm_alloc(size_t size) {
   //
@@ -68,6 +85,12 @@ void* chpl_mem_array_alloc(size_t nmemb, size_t eltSize, c_sublocid_t subloc,
     //
     chpl_bool do_localize;
 
+    if (chpl_mem_array_localize
+        && !isActualSublocID(subloc)
+        && size >= CHPL_MEM_ARRAY_PLACEMENT_MIN_SIZE) {
+      subloc = c_sublocid_all;
+    }
+
     p = NULL;
     *callAgain = false;
     if (chpl_mem_size_justifies_comm_alloc(size)) {
@@ -85,9 +108,18 @@ void* chpl_mem_array_alloc(size_t nmemb, size_t eltSize, c_sublocid_t subloc,
       do_localize = (subloc == c_sublocid_all) ? true : false;
     }
 
+    if (chpl_mem_array_hugepages
+        && !*callAgain
+        && size >= CHPL_MEM_ARRAY_PLACEMENT_MIN_SIZE) {
+      chpl_mem_array_adviseHugePages(p, size);
+    }
+
     if (do_localize) {
       if (isActualSublocID(subloc)) {
         chpl_topo_setMemLocality(p, size, true, subloc);
+      } else if (chpl_mem_array_localize
+                 && size >= CHPL_MEM_ARRAY_PLACEMENT_MIN_SIZE) {
+        chpl_topo_setMemSubchunkLocality(p, size, true, NULL);
       }
     }
   } else {
@@ -85,6 +85,8 @@
   m(OS_LAYER_TMP_DATA,    "OS layer temporary data",                  true ), \
   m(GMP,                  "gmp data",                                 true ), \
   m(GETS_PUTS_STRIDES,    "put_strd/get_strd array of strides",       true ), \
+  m(COMM_STREAM_BUF,      "loop prefetch stream buffer",              true ), \
+  m(TASK_ARENA,           "task arena chunk",                         true ), \
   m(NUM,                  "*** this must be the last entry ***",      true )
 
 
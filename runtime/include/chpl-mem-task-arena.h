@@ -0,0 +1,146 @@
+/*
+ * Copyright 2004-2018 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ * 
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ * 
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef _chpl_mem_task_arena_H_
+#define _chpl_mem_task_arena_H_
+
+#ifndef LAUNCHER
+
+#include <stddef.h>
+#include <stdint.h>
+#include "chpl-mem.h"
+#include "chpl-mem-task-decls.h"
+#include "chpl-tasks.h"
+#include "chplmemtrack.h"
+#include "chpltypes.h"
+
+
+//
+// Task arenas.
+//
+// With --task-arenas the compiler allocates iterator classes with
+// chpl_mem_task_alloc() and frees them with chpl_mem_task_free().
+// Small requests are carved out of chunks owned by the running task,
+// rather than going to the shared heap.  Freeing the most recent live
+// allocation gives its space back, along with that of any allocations
+// under it that were already freed, which covers the usual patterns of
+// nested and zippered loops.  Other frees of arena memory just mark it,
+// and all the task's chunks are released when it ends.  Requests that are too big,
+// or that would grow the arena past CHPL_MEM_TASK_ARENA_MAX_CHUNKS
+// chunks, or that are made while memory tracking is on, go to
+// chpl_mem_alloc() as usual, and chpl_mem_task_free() recognizes and
+// frees those.
+//
+// Arena memory must not outlive the task that allocated it, nor be
+// freed by another task.
+//
+#define CHPL_MEM_TASK_ARENA_CHUNK_SIZE ((size_t) 16 << 10)
+#define CHPL_MEM_TASK_ARENA_MAX_CHUNKS 16
+#define CHPL_MEM_TASK_ARENA_MAX_ALLOC  ((size_t) 1 << 10)
+
+// Each allocation is preceded by a header holding the previous value
+// of 'last', so that LIFO frees can unwind, and a flag saying whether
+// it has been freed out of order, so that they can unwind past it.
+#define CHPL_MEM_TASK_ARENA_HDR_SIZE   ((size_t) 16)
+
+typedef struct {
+  char* prev;
+  size_t freed;
+} chpl_mem_taskArenaHdr_t;
+
+typedef struct chpl_mem_taskArenaChunk_s {
+  struct chpl_mem_taskArenaChunk_s* next;
+  char* end;
+} chpl_mem_taskArenaChunk_t;
+
+// Chunk headers are padded to the same size, to keep allocations
+// 16-byte aligned.
+#define CHPL_MEM_TASK_ARENA_CHUNK_DATA(c) \
+  ((char*) (c) + CHPL_MEM_TASK_ARENA_HDR_SIZE)
+
+void* chpl_mem_task_allocSlow(chpl_mem_taskPrvData_t* a, size_t size,
+                              chpl_mem_descInt_t description,
+                              int32_t lineno, int32_t filename);
+void chpl_mem_task_freeSlow(chpl_mem_taskPrvData_t* a, void* p,
+                            int32_t lineno, int32_t filename);
+
+//
+// Called by the tasking layer when a task ends.
+//
+void chpl_mem_task_release(void);
+
+
+static inline
+void* chpl_mem_task_alloc(size_t size, chpl_mem_descInt_t description,
+                          int32_t lineno, int32_t filename) {
+  chpl_mem_taskPrvData_t* a;
+  size_t need;
+  char* hdr;
+
+  if (size > CHPL_MEM_TASK_ARENA_MAX_ALLOC || chpl_memTrack)
+    return chpl_mem_alloc(size, description, lineno, filename);
+
+  a = &chpl_task_getPrvData()->mem_data;
+  need = CHPL_MEM_TASK_ARENA_HDR_SIZE
+         + ((size + CHPL_MEM_TASK_ARENA_HDR_SIZE - 1)
+            & ~(CHPL_MEM_TASK_ARENA_HDR_SIZE - 1));
+  if (a->chunks == NULL || need > (size_t) (a->chunks->end - a->top))
+    return chpl_mem_task_allocSlow(a, size, description, lineno, filename);
+
+  hdr = a->top;
+  ((chpl_mem_taskArenaHdr_t*) hdr)->prev = a->last;
+  ((chpl_mem_taskArenaHdr_t*) hdr)->freed = 0;
+  a->last = hdr;
+  a->top = hdr + need;
+  return hdr + CHPL_MEM_TASK_ARENA_HDR_SIZE;
+}
+
+static inline
+void chpl_mem_task_free(void* p, int32_t lineno, int32_t filename) {
+  chpl_mem_taskPrvData_t* a;
+  char* hdr;
+
+  if (p == NULL)
+    return;
+
+  a = &chpl_task_getPrvData()->mem_data;
+  if (a->chunks == NULL) {
+    chpl_mem_free(p, lineno, filename);
+    return;
+  }
+
+  hdr = (char*) p - CHPL_MEM_TASK_ARENA_HDR_SIZE;
+  if (hdr == a->last) {
+    do {
+      a->last = ((chpl_mem_taskArenaHdr_t*) hdr)->prev;
+      if (hdr >= CHPL_MEM_TASK_ARENA_CHUNK_DATA(a->chunks)
+          && hdr < a->chunks->end)
+        a->top = hdr;
+      hdr = a->last;
+    } while (hdr != NULL && ((chpl_mem_taskArenaHdr_t*) hdr)->freed);
+    return;
+  }
+
+  chpl_mem_task_freeSlow(a, p, lineno, filename);
+}
+
+#endif // LAUNCHER
+
+#endif
@@ -0,0 +1,35 @@
+/*
+ * Copyright 2004-2018 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ * 
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ * 
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef _chpl_mem_task_decls_h_
+#define _chpl_mem_task_decls_h_
+
+struct chpl_mem_taskArenaChunk_s;
+
+// This is the type of the task private data used by task arenas
+// (see chpl-mem-task-arena.h).
+typedef struct {
+  struct chpl_mem_taskArenaChunk_s* chunks; // newest first
+  char* top;            // next free byte in the newest chunk
+  char* last;           // header of the newest live allocation
+  int numChunks;
+} chpl_mem_taskPrvData_t;
+
+#endif
@@ -27,11 +27,20 @@ void chpl_privatization_init(void);
 
 void chpl_newPrivatizedClass(void*, int64_t);
 
+// Privatized objects live in fixed-size chunks that are allocated the
+// first time one of their pids is used and never move afterwards, so
+// neither adding nor looking up an object takes a lock.  The directory
+// of chunks is sized for 2^30 pids.
+#define CHPL_PRIVATIZATION_CHUNK_BITS 12
+#define CHPL_PRIVATIZATION_CHUNK_SIZE (1 << CHPL_PRIVATIZATION_CHUNK_BITS)
+#define CHPL_PRIVATIZATION_MAX_CHUNKS (1 << 18)
+
 // Implementation is here for performance: getPrivatizedClass can be called
 // frequently, so putting it in a header allows the backend to fully optimize.
-extern void** chpl_privateObjects;
+extern void** chpl_privateObjects[CHPL_PRIVATIZATION_MAX_CHUNKS];
 static inline void* chpl_getPrivatizedClass(int64_t i) {
-  return chpl_privateObjects[i];
+  return chpl_privateObjects[i >> CHPL_PRIVATIZATION_CHUNK_BITS]
+                            [i & (CHPL_PRIVATIZATION_CHUNK_SIZE - 1)];
 }
 
 void chpl_clearPrivatizedClass(int64_t);
@@ -0,0 +1,44 @@
+/*
+ * Copyright 2004-2018 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _chpl_sample_prof_h_
+#define _chpl_sample_prof_h_
+#ifndef LAUNCHER
+
+//
+// Task-aware sampling profiler.
+//
+// When the sampleProfile config const is true, each locale takes
+// SIGPROF samples of its native stack at sampleProfileHz per second of
+// CPU time.  Each sample also records which task was running: its ID,
+// the source line that created it, and its requested sublocale, as
+// captured by the tasking layer's begin/end callbacks.  At exit the
+// generated-C functions on the sampled stacks are mapped back to their
+// Chapel names and declaration lines, and the samples are written in
+// the folded-stack format that flame graph tools read.
+//
+
+//
+// Called on every locale from the pre-user-code hook, and at exit.
+//
+void chpl_sample_prof_init(void);
+void chpl_sample_prof_exit(void);
+
+#endif // LAUNCHER
+#endif // _chpl_sample_prof_h_
@@ -22,6 +22,8 @@
 
 // This header file provides chpl_comm_taskPrvData_t
 #include "chpl-comm-task-decls.h"
+// This header file provides chpl_mem_taskPrvData_t
+#include "chpl-mem-task-decls.h"
 
 // Type for Chapel-managed task private data
 // to be copied to new tasks.
@@ -33,6 +35,7 @@ typedef struct {
 // The type for runtime-managed task private data
 typedef struct {
   chpl_comm_taskPrvData_t comm_data;
+  chpl_mem_taskPrvData_t mem_data;
 } chpl_task_prvData_t;
 
 #endif
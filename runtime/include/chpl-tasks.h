@@ -62,6 +62,12 @@ void      chpl_sync_waitFullAndLock(chpl_sync_aux_t *,
                                        int32_t, int32_t);
 void      chpl_sync_waitEmptyAndLock(chpl_sync_aux_t *,
                                         int32_t, int32_t);
+// Like the above, but give up after the given number of seconds.  These
+// return true with the lock held, or false (and unlocked) on timeout.
+chpl_bool chpl_sync_waitFullAndLockTimeout(chpl_sync_aux_t *, double,
+                                           int32_t, int32_t);
+chpl_bool chpl_sync_waitEmptyAndLockTimeout(chpl_sync_aux_t *, double,
+                                            int32_t, int32_t);
 void      chpl_sync_markAndSignalFull(chpl_sync_aux_t *);     // and unlock
 void      chpl_sync_markAndSignalEmpty(chpl_sync_aux_t *);    // and unlock
 chpl_bool chpl_sync_isFull(void *, chpl_sync_aux_t *);
@@ -160,6 +166,23 @@ void chpl_task_addToTaskList(
          chpl_bool,          // is begin{} stmt?  (vs. cobegin or coforall)
          int,                // line at which function begins
          int32_t);           // name of file containing function
+
+//
+// Add a coforall task team to a task list in one operation.  All the
+// tasks in the team run the same function on copies of the same
+// argument, differing only in their team index, 0..num_tasks-1, which
+// each task can retrieve with chpl_task_getTeamIndex().
+//
+void chpl_task_addTeamToTaskList(
+         chpl_fn_int_t,      // function to call for each task
+         chpl_task_bundle_t*,// argument shared by the team
+         size_t,             // length of the argument
+         int64_t,            // number of tasks in the team
+         c_sublocid_t,       // desired sublocale
+         void**,             // task list
+         c_nodeid_t,         // locale (node) where task list resides
+         int,                // line at which function begins
+         int32_t);           // name of file containing function
 void chpl_task_executeTasksInList(void**);
 
 //
@@ -248,7 +271,8 @@ char* chpl_task_idToString(
 void chpl_task_yield(void);
 
 //
-// Suspend.
+// Suspend.  Sleeping tasks are parked on the timer wheel (see
+// chpl-timer-wheel.h) rather than occupying a run queue.
 //
 void chpl_task_sleep(double);
 
@@ -285,6 +309,22 @@ chpl_task_ChapelData_t* chpl_task_getChapelData(void)
   return chpl_task_getBundleChapelData(prv);
 }
 
+//
+// Get and set the current task's index within its coforall task team.
+// Setting it is only needed when a team runs serially in its parent.
+//
+static inline
+int64_t chpl_task_getTeamIndex(void)
+{
+  return chpl_task_getPrvBundle()->team_index;
+}
+
+static inline
+void chpl_task_setTeamIndex(int64_t idx)
+{
+  chpl_task_getPrvBundle()->team_index = idx;
+}
+
 
 //
 // Can this tasking layer support remote caching?
@@ -316,6 +356,22 @@ uint32_t chpl_task_getMaxPar(void);
 //
 c_sublocid_t chpl_task_getNumSublocales(void);
 
+//
+// Returns the number of NUMA domains across which the tasking layer
+// places tasks that are created without a specific sublocale, or 1 if
+// it doesn't place such tasks by NUMA domain.
+//
+int32_t chpl_task_getNumNumaDomains(void);
+
+//
+// Sets a NUMA placement hint for the tasks the calling task creates
+// from now on.  Tasks created without a specific sublocale will
+// preferably run on NUMA domain (hint % chpl_task_getNumNumaDomains()).
+// Passing c_sublocid_any removes the hint.  Tasking layers that don't
+// place tasks by NUMA domain ignore this.
+//
+void chpl_task_setNumaHint(c_sublocid_t);
+
 //
 // returns the value of the call stack size limit being used in
 // practice; the value returned may potentially differ from one locale
@@ -375,6 +431,22 @@ size_t chpl_task_getEnvCallStackSize(void);
 //
 size_t chpl_task_getDefaultCallStackSize(void);
 
+//
+// Support for timed waits that have to poll for their condition.  Get
+// a deadline for a wait of the given number of seconds, then call
+// chpl_task_waitBackoff() each time the condition isn't met, passing
+// the number of previous calls.  It yields for the first few attempts
+// and then sleeps for progressively longer (but bounded) intervals,
+// and returns false once the deadline has passed.  Also, a polling
+// implementation of chpl_sync_wait*AndLockTimeout() built on these,
+// for tasking layers that can't do better.
+// These are common to all tasking implementations and so are
+// implemented in runtime/src/chpl-tasks.c.
+//
+double    chpl_task_waitDeadline(double);
+chpl_bool chpl_task_waitBackoff(double, int32_t);
+chpl_bool chpl_sync_pollAndLockTimeout(chpl_sync_aux_t *, chpl_bool, double);
+
 //
 // These are service functions provided to the runtime by the module
 // code.
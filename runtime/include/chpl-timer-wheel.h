@@ -0,0 +1,73 @@
+/*
+ * Copyright 2004-2018 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ * 
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ * 
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _chpl_timer_wheel_h_
+#define _chpl_timer_wheel_h_
+#ifndef LAUNCHER
+
+#include <stdint.h>
+#include "chpltypes.h"
+
+//
+// Per-locale hierarchical timer wheel.
+//
+// Tasking layers use this to park sleeping and time-limited waiting
+// tasks off the run queues.  A caller supplies an entry (typically on
+// its own stack) and a wake function; when the timeout expires the wake
+// function is called exactly once, with the wheel lock held, either by
+// the dedicated timer thread or by an idle worker that polls the wheel.
+// Wake functions must therefore be short and must not touch the wheel.
+// The entry must stay live until its wake function has been called.
+//
+// Timeouts have a resolution of one tick (CHPL_TIMER_WHEEL_TICK_NS) and
+// never fire early.
+//
+
+#define CHPL_TIMER_WHEEL_TICK_NS 1000000   // 1 ms
+
+typedef void (*chpl_timer_wheel_fn_t)(void*);
+
+typedef struct chpl_timer_wheel_entry_s {
+  struct chpl_timer_wheel_entry_s* next;
+  struct chpl_timer_wheel_entry_s* prev;
+  uint64_t expires;                     // tick at which to wake
+  chpl_timer_wheel_fn_t wake;
+  void* arg;
+} chpl_timer_wheel_entry_t;
+
+//
+// Arm 'e' to call wake(arg) after 'secs' seconds.
+//
+void chpl_timer_wheel_add(chpl_timer_wheel_entry_t* e, double secs,
+                          chpl_timer_wheel_fn_t wake, void* arg);
+
+//
+// Fire any expired entries, if nobody else is doing so right now.  Idle
+// workers call this so wakeups don't have to wait on the timer thread.
+//
+void chpl_timer_wheel_poll(void);
+
+//
+// Block the calling thread (not just the task) for 'secs' seconds.
+// This is the sleep for threads that have nothing else to run.
+//
+void chpl_timer_wheel_sleep(double secs);
+
+#endif // LAUNCHER
+#endif // _chpl_timer_wheel_h_
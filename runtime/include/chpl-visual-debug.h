@@ -32,6 +32,58 @@
 extern int chpl_vdebug_fd;    // fd of output file, 0 => not gathering data
 extern int chpl_vdebug;       // Should we generate debug data
 
+//
+// Events are logged as fixed-size binary records.  Each thread fills
+// chunks of records without locking, and a per-locale drain thread
+// appends full chunks to the locale's .bin file.  The text file next to
+// it holds only the header, name tables, clock samples and End record.
+//
+// chplvis (tools/chplvis/DataModel.h) has a copy of these definitions;
+// the two must be kept in sync.
+//
+
+typedef enum {
+  chpl_vdebug_kind_task = 1,     // task created
+  chpl_vdebug_kind_begin,        // task began running
+  chpl_vdebug_kind_end,          // task ended
+  chpl_vdebug_kind_put,
+  chpl_vdebug_kind_get,
+  chpl_vdebug_kind_put_nb,
+  chpl_vdebug_kind_get_nb,
+  chpl_vdebug_kind_put_strd,
+  chpl_vdebug_kind_get_strd,
+  chpl_vdebug_kind_fork,         // executeOn
+  chpl_vdebug_kind_fork_nb,      // executeOn_nb
+  chpl_vdebug_kind_fork_fast,    // executeOn_fast
+  chpl_vdebug_kind_mark,         // task is part of VisualDebug itself
+  chpl_vdebug_kind_tag,
+  chpl_vdebug_kind_pause
+} chpl_vdebug_kind_t;
+
+//
+// One event.  Field use by kind:
+//   task:      addr = new task id, aux = fid, aux2 = is_executeOn
+//   begin/end: task = the task beginning or ending
+//   comm:      addr/raddr = local/remote address, size = length,
+//              aux = element size, aux2 = commID
+//   fork:      addr = arg, size = arg size, aux = fid, aux2 = sublocale
+//   tag/pause: addr/raddr = user/system CPU time in usec, aux = tag number
+//
+typedef struct {
+  uint64_t time;      // chpl_vdebug_clock() ticks
+  uint64_t task;      // task logging the event
+  uint64_t addr;
+  uint64_t raddr;
+  uint64_t size;
+  uint16_t kind;      // chpl_vdebug_kind_t
+  uint16_t pad;
+  int32_t  rnode;     // remote node for comm and fork events
+  int32_t  aux;
+  int32_t  aux2;
+  int32_t  lineno;
+  int32_t  filename;
+} chpl_vdebug_rec_t;
+
 // Linux and MacOS don't do a single write.  We require a single write.
 extern int chpl_dprintf(int fd, const char * format, ...)
 #ifdef __GNUC__
@@ -20,6 +20,10 @@
 #ifndef _chpl_comm_impl_h_
 #define _chpl_comm_impl_h_
 
+#include <stdint.h>
+
+#include "chpltypes.h"
+
 //
 // This is the comm layer sub-interface for dynamic allocation and
 // registration of memory.
@@ -28,4 +32,69 @@
     chpl_comm_impl_regMemHeapInfo(start_p, size_p)
 void chpl_comm_impl_regMemHeapInfo(void** start_p, size_t* size_p);
 
+//
+// Network atomic operations.
+//
+// GASNet has no remote atomic operations of its own, so these are
+// done by sending an active message to the target node, where the
+// handler does the operation using processor atomics and replies
+// with the result.  The interface is the same as for the ugni comm
+// layer; see runtime/include/comm/ugni/chpl-comm-impl.h for the
+// descriptions of the individual operations.
+//
+#define DECL_CHPL_COMM_ATOMIC_PUT(type)                                 \
+        void chpl_comm_atomic_put_ ## type                              \
+            (void* desired, int32_t locale, void* object,               \
+             int ln, int32_t fn);
+#define DECL_CHPL_COMM_ATOMIC_GET(type)                                 \
+        void chpl_comm_atomic_get_ ## type                              \
+            (void* result, int32_t locale, void* object,                \
+             int ln, int32_t fn);
+#define DECL_CHPL_COMM_ATOMIC_XCHG(type)                                \
+        void chpl_comm_atomic_xchg_ ## type                             \
+            (void* desired, int32_t locale, void* object,               \
+             void* result,                                              \
+             int ln, int32_t fn);
+#define DECL_CHPL_COMM_ATOMIC_CMPXCHG(type)                             \
+        void chpl_comm_atomic_cmpxchg_ ## type                          \
+            (void* expected, void* desired,                             \
+             int32_t locale, void* object, chpl_bool32* result,         \
+             int ln, int32_t fn);
+#define DECL_CHPL_COMM_ATOMIC_NONFETCH_BINARY(op, type)                 \
+        void chpl_comm_atomic_ ## op ## _ ## type                       \
+                (void* operand, int32_t locale, void* object,           \
+                 int ln, int32_t fn);
+#define DECL_CHPL_COMM_ATOMIC_FETCH_BINARY(op, type)                    \
+        void chpl_comm_atomic_fetch_ ## op ## _ ## type                 \
+                (void* operand, int32_t locale, void* object,           \
+                 void* result,                                          \
+                 int ln, int32_t fn);
+#define DECL_CHPL_COMM_ATOMIC_BINARY(op, type)                          \
+        DECL_CHPL_COMM_ATOMIC_NONFETCH_BINARY(op, type)                 \
+        DECL_CHPL_COMM_ATOMIC_FETCH_BINARY(op, type)
+
+#define DECL_CHPL_COMM_ATOMIC_ALL_TYPES(type)                           \
+        DECL_CHPL_COMM_ATOMIC_PUT(type)                                 \
+        DECL_CHPL_COMM_ATOMIC_GET(type)                                 \
+        DECL_CHPL_COMM_ATOMIC_XCHG(type)                                \
+        DECL_CHPL_COMM_ATOMIC_CMPXCHG(type)                             \
+        DECL_CHPL_COMM_ATOMIC_BINARY(add, type)                         \
+        DECL_CHPL_COMM_ATOMIC_BINARY(sub, type)
+
+#define DECL_CHPL_COMM_ATOMIC_INT_TYPES(type)                           \
+        DECL_CHPL_COMM_ATOMIC_ALL_TYPES(type)                           \
+        DECL_CHPL_COMM_ATOMIC_BINARY(and, type)                         \
+        DECL_CHPL_COMM_ATOMIC_BINARY(or, type)                          \
+        DECL_CHPL_COMM_ATOMIC_BINARY(xor, type)
+
+DECL_CHPL_COMM_ATOMIC_INT_TYPES(int32)
+DECL_CHPL_COMM_ATOMIC_INT_TYPES(int64)
+DECL_CHPL_COMM_ATOMIC_INT_TYPES(uint32)
+DECL_CHPL_COMM_ATOMIC_INT_TYPES(uint64)
+DECL_CHPL_COMM_ATOMIC_ALL_TYPES(real32)
+DECL_CHPL_COMM_ATOMIC_ALL_TYPES(real64)
+
+#undef DECL_CHPL_COMM_ATOMIC_INT_TYPES
+#undef DECL_CHPL_COMM_ATOMIC_ALL_TYPES
+
 #endif // _chpl_comm_impl_h_
@@ -547,6 +547,12 @@ qioerr qio_writev(qio_file_t* file, qbuffer_t* buf, qbuffer_iter_t start, qbuffe
 qioerr qio_preadv(qio_file_t* file, qbuffer_t* buf, qbuffer_iter_t start, qbuffer_iter_t end, int64_t seek_to_offset, ssize_t* num_read);
 qioerr qio_pwritev(qio_file_t* file, qbuffer_t* buf, qbuffer_iter_t start, qbuffer_iter_t end, int64_t seek_to_offset, ssize_t* num_written);
 
+// Read or write len bytes between ptr and the file at offset, without
+// going through a channel. Short transfers are continued until all of the
+// bytes have been moved; reading past the end of the file returns EEOF.
+qioerr qio_file_pread_bytes(qio_file_t* file, void* ptr, int64_t len, int64_t offset);
+qioerr qio_file_pwrite_bytes(qio_file_t* file, const void* ptr, int64_t len, int64_t offset);
+
 // if fp is not null, fd is ignored; if fp is null, we use fd.
 // the QIO file takes ownership of fp or fd, closing it when the QIO file is closed.
 qioerr qio_file_init(qio_file_t** file_out, FILE* fp, fd_t fd, qio_hint_t iohints, const qio_style_t* style, int usefilestar);
@@ -42,6 +42,7 @@
 #include "chpl-atomics.h"
 #include "chpl-bitops.h"
 #include "chpl-comm.h"
+#include "chpl-comm-stream.h"
 #include "chpldirent.h"
 #include "chplexit.h"
 #include "chpl-external-array.h"
@@ -54,6 +55,7 @@
 #include "chpl-linefile-support.h"
 #include "chpl-mem.h"
 #include "chpl-mem-array.h"
+#include "chpl-mem-task-arena.h"
 #include "chplmemtrack.h"
 #include "chpl-prefetch.h"
 #include "chpl-privatization.h"
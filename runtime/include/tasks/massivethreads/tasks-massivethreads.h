@@ -60,6 +60,7 @@ typedef struct {
   chpl_fn_int_t requested_fid;
   chpl_fn_p requested_fn;
   chpl_taskID_t id;
+  int64_t team_index;
   chpl_task_ChapelData_t state;
   //chpl_task_prvData_t prv;
 } chpl_task_bundle_t;
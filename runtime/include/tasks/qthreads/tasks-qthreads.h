@@ -68,6 +68,16 @@ typedef struct {
     syncvar_t signal_empty;
 } chpl_sync_aux_t;
 
+//
+// Non-blocking forms of the native FEB operations, used for the timed
+// sync variable operations.  Qthreads builds these but does not declare
+// them in qthread.h.  They return QTHREAD_SUCCESS if the operation was
+// done and QTHREAD_OPFAIL if the FEB was not in the needed state.
+//
+int qthread_readFE_nb(aligned_t* dest, const aligned_t* src);
+int qthread_readFF_nb(aligned_t* dest, const aligned_t* src);
+int qthread_writeEF_nb(aligned_t* dest, const aligned_t* src);
+
 //
 // Task private data
 //
@@ -90,6 +100,7 @@ typedef struct {
   chpl_fn_int_t requested_fid;
   chpl_fn_p requested_fn;
   chpl_taskID_t id;
+  int64_t team_index;
   chpl_task_ChapelData_t state;
 } chpl_task_bundle_t;
 
@@ -100,6 +111,8 @@ typedef struct chpl_qthread_tls_s {
   // That would reduce the size of the task local storage,
   // but increase the size of executeOn bundles.
   chpl_task_prvData_t prvdata;
+  /* NUMA placement hint for the tasks this one creates */
+  c_sublocid_t numa_hint;
   /* Reports */
   int     lock_filename;
   int     lock_lineno;
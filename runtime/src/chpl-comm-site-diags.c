@@ -0,0 +1,336 @@
+/*
+ * Copyright 2004-2018 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Per-call-site communication diagnostics
+//
+
+#include "chplrt.h"
+
+#include "chpl-comm.h"
+#include "chpl-comm-site-diags.h"
+#include "chpl-env.h"
+#include "chpl-linefile-support.h"
+#include "chpl-mem-sys.h"
+#include "chpl-tasks.h"
+#include "error.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int chpl_comm_site_diagnostics = 0;
+
+static int report_at_exit = 0;
+
+//
+// Latency histogram: bucket b counts waits of [2^b, 2^(b+1)) ns, with
+// everything under 2 ns in bucket 0 and everything over ~4 s in the
+// last one.
+//
+#define NUM_BUCKETS 32
+
+typedef struct {
+  uint64_t count;              // 0 means the slot is empty
+  uint64_t bytes;
+  uint64_t total_ns;
+  uint64_t hist[NUM_BUCKETS];
+  int32_t ln;
+  int32_t fn;
+  c_nodeid_t node;
+  chpl_comm_site_kind_t kind;
+} site_t;
+
+//
+// Open-addressed hash tables of sites, keyed on (kind, node, ln, fn).
+// A table doubles when half full, so probe sequences stay short.
+//
+// So that tasks recording at the same time rarely wait on each other,
+// there is one table per shard, each with its own lock, and a task
+// always records into the shard its ID hashes to.  The same site may
+// then be in several shards; the report merges them.
+//
+#define NUM_SITE_SHARDS 16
+
+typedef struct {
+  chpl_sync_aux_t lock;
+  site_t* sites;
+  size_t size;                 // number of slots, a power of 2
+  size_t used;
+} site_shard_t;
+
+static site_shard_t shards[NUM_SITE_SHARDS];
+
+static inline
+size_t site_hash(chpl_comm_site_kind_t kind, c_nodeid_t node,
+                 int32_t ln, int32_t fn) {
+  uint64_t h = ((uint64_t) (uint32_t) fn << 32) | (uint32_t) ln;
+  h ^= ((uint64_t) node << 8) | (uint64_t) kind;
+  h *= 0x9e3779b97f4a7c15ULL;
+  return (size_t) (h >> 32);
+}
+
+static
+site_t* find_site(site_t* tbl, size_t size, chpl_comm_site_kind_t kind,
+                  c_nodeid_t node, int32_t ln, int32_t fn) {
+  size_t i = site_hash(kind, node, ln, fn) & (size - 1);
+  while (tbl[i].count != 0
+         && (tbl[i].kind != kind || tbl[i].node != node
+             || tbl[i].ln != ln || tbl[i].fn != fn))
+    i = (i + 1) & (size - 1);
+  return &tbl[i];
+}
+
+static
+void grow_sites(site_shard_t* shard) {
+  size_t new_size = (shard->size == 0) ? 256 : 2 * shard->size;
+  site_t* new_sites;
+  size_t i;
+
+  if ((new_sites = sys_calloc(new_size, sizeof(site_t))) == NULL)
+    chpl_internal_error("cannot allocate comm site diagnostics table");
+
+  for (i = 0; i < shard->size; i++) {
+    const site_t* s = &shard->sites[i];
+    if (s->count != 0)
+      *find_site(new_sites, new_size, s->kind, s->node, s->ln, s->fn) = *s;
+  }
+
+  sys_free(shard->sites);
+  shard->sites = new_sites;
+  shard->size = new_size;
+}
+
+static inline
+site_shard_t* my_shard(void) {
+  uint64_t h = (uint64_t) chpl_task_getId() * 0x9e3779b97f4a7c15ULL;
+  return &shards[(h >> 32) % NUM_SITE_SHARDS];
+}
+
+static inline
+int hist_bucket(uint64_t ns) {
+  int b = 0;
+  while (ns > 1 && b < NUM_BUCKETS - 1) {
+    ns >>= 1;
+    b++;
+  }
+  return b;
+}
+
+void chpl_comm_site_diags_record(chpl_comm_site_kind_t kind,
+                                 c_nodeid_t node, size_t size,
+                                 uint64_t start_ns, int ln, int32_t fn) {
+  uint64_t ns = chpl_comm_site_diags_now() - start_ns;
+  site_shard_t* shard = my_shard();
+  site_t* s;
+
+  chpl_sync_lock(&shard->lock);
+
+  if (2 * (shard->used + 1) > shard->size)
+    grow_sites(shard);
+
+  s = find_site(shard->sites, shard->size, kind, node, ln, fn);
+  if (s->count == 0) {
+    s->kind = kind;
+    s->node = node;
+    s->ln = ln;
+    s->fn = fn;
+    shard->used++;
+  }
+  s->count++;
+  s->bytes += size;
+  s->total_ns += ns;
+  s->hist[hist_bucket(ns)]++;
+
+  chpl_sync_unlock(&shard->lock);
+}
+
+
+void chpl_comm_site_diags_init(void) {
+  int i;
+  for (i = 0; i < NUM_SITE_SHARDS; i++)
+    chpl_sync_initAux(&shards[i].lock);
+  if (chpl_env_rt_get_bool("COMM_SITE_DIAGNOSTICS", false)) {
+    report_at_exit = 1;
+    chpl_comm_site_diagnostics = 1;
+  }
+}
+
+void chpl_comm_site_diags_exit(void) {
+  if (report_at_exit) {
+    chpl_comm_site_diagnostics = 0;
+    chpl_printCommSiteDiagnosticsHere();
+  }
+}
+
+
+void chpl_startCommSiteDiagnosticsHere(void) {
+  chpl_comm_site_diagnostics = 1;
+}
+
+void chpl_stopCommSiteDiagnosticsHere(void) {
+  chpl_comm_site_diagnostics = 0;
+}
+
+void chpl_resetCommSiteDiagnosticsHere(void) {
+  int i;
+  for (i = 0; i < NUM_SITE_SHARDS; i++) {
+    site_shard_t* shard = &shards[i];
+    chpl_sync_lock(&shard->lock);
+    if (shard->sites != NULL)
+      memset(shard->sites, 0, shard->size * sizeof(site_t));
+    shard->used = 0;
+    chpl_sync_unlock(&shard->lock);
+  }
+}
+
+
+static const char* kind_name(chpl_comm_site_kind_t kind) {
+  switch (kind) {
+  case chpl_comm_site_get:             return "get from";
+  case chpl_comm_site_put:             return "put to";
+  case chpl_comm_site_get_strd:        return "strided get from";
+  case chpl_comm_site_put_strd:        return "strided put to";
+  case chpl_comm_site_execute_on:      return "execute_on to";
+  case chpl_comm_site_execute_on_fast: return "execute_on_fast to";
+  case chpl_comm_site_execute_on_nb:   return "execute_on_nb to";
+  default:                             return "unknown op with";
+  }
+}
+
+//
+// Most frequent sites first; ties in source order.
+//
+static int site_cmp(const void* v1, const void* v2) {
+  const site_t* s1 = (const site_t*) v1;
+  const site_t* s2 = (const site_t*) v2;
+  int c;
+
+  if (s1->count != s2->count)
+    return (s1->count > s2->count) ? -1 : 1;
+  if ((c = strcmp(chpl_lookupFilename(s1->fn),
+                  chpl_lookupFilename(s2->fn))) != 0)
+    return c;
+  if (s1->ln != s2->ln)
+    return (s1->ln < s2->ln) ? -1 : 1;
+  if (s1->kind != s2->kind)
+    return (s1->kind < s2->kind) ? -1 : 1;
+  if (s1->node != s2->node)
+    return (s1->node < s2->node) ? -1 : 1;
+  return 0;
+}
+
+//
+// Upper bound, in usec, of the histogram bucket holding percentile p.
+//
+static double hist_percentile(const site_t* s, double p) {
+  uint64_t want = (uint64_t) (p * s->count + 0.5);
+  uint64_t seen = 0;
+  int b;
+
+  if (want == 0)
+    want = 1;
+  for (b = 0; b < NUM_BUCKETS - 1; b++) {
+    seen += s->hist[b];
+    if (seen >= want)
+      break;
+  }
+  return (double) ((uint64_t) 1 << (b + 1)) / 1000.0;
+}
+
+//
+// Merge the shards' tables into one with an entry per site.  All the
+// shards are locked throughout, so that none grows while we merge.
+//
+static site_t* merge_shards(size_t* merged_size) {
+  site_t* merged;
+  size_t size = 256;
+  size_t total = 0;
+  size_t i, j;
+  int b;
+
+  for (i = 0; i < NUM_SITE_SHARDS; i++) {
+    chpl_sync_lock(&shards[i].lock);
+    total += shards[i].used;
+  }
+  while (size < 2 * total)
+    size *= 2;
+
+  if ((merged = sys_calloc(size, sizeof(site_t))) == NULL)
+    chpl_internal_error("cannot allocate comm site diagnostics report");
+
+  for (i = 0; i < NUM_SITE_SHARDS; i++) {
+    site_shard_t* shard = &shards[i];
+    for (j = 0; j < shard->size; j++) {
+      const site_t* s = &shard->sites[j];
+      site_t* m;
+
+      if (s->count == 0)
+        continue;
+      m = find_site(merged, size, s->kind, s->node, s->ln, s->fn);
+      if (m->count == 0) {
+        *m = *s;
+      } else {
+        m->count += s->count;
+        m->bytes += s->bytes;
+        m->total_ns += s->total_ns;
+        for (b = 0; b < NUM_BUCKETS; b++)
+          m->hist[b] += s->hist[b];
+      }
+    }
+  }
+
+  for (i = NUM_SITE_SHARDS; i > 0; i--)
+    chpl_sync_unlock(&shards[i - 1].lock);
+
+  *merged_size = size;
+  return merged;
+}
+
+void chpl_printCommSiteDiagnosticsHere(void) {
+  site_t* sorted;
+  size_t size;
+  size_t n = 0;
+  size_t i;
+
+  sorted = merge_shards(&size);
+  for (i = 0; i < size; i++) {
+    if (sorted[i].count != 0)
+      sorted[n++] = sorted[i];
+  }
+
+  qsort(sorted, n, sizeof(site_t), site_cmp);
+
+  printf("%d: comm sites: %zu\n", (int) chpl_nodeID, n);
+  for (i = 0; i < n; i++) {
+    const site_t* s = &sorted[i];
+    const char* fname = chpl_lookupFilename(s->fn);
+    printf("%d: %s:%d: %s %d: %" PRIu64 " ops, %" PRIu64 " bytes, "
+           "latency mean %.3f us, p50 <= %.3f us, p99 <= %.3f us\n",
+           (int) chpl_nodeID, (fname[0] == '\0') ? "<unknown>" : fname,
+           (int) s->ln,
+           kind_name(s->kind), (int) s->node, s->count, s->bytes,
+           (double) s->total_ns / s->count / 1000.0,
+           hist_percentile(s, 0.50), hist_percentile(s, 0.99));
+  }
+  fflush(stdout);
+
+  sys_free(sorted);
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright 2004-2018 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "chplrt.h"
+#include "chpl-comm-stream.h"
+#include "chpl-comm.h"
+#include "chpl-mem.h"
+#include "chpl-mem-consistency.h"
+#include "error.h"
+
+// Size of each of the two strip buffers.  Large enough to amortize the
+// per-GET overhead, small enough to stay in cache while it is read.
+#define STREAM_STRIP_BYTES (64 * 1024)
+
+// Wait for the GET into a buffer, if any, to finish.  Waiting may free
+// the handle, so it must not be waited on again.
+static void stream_wait(chpl_comm_stream_t* s, int which) {
+  if (s->pending[which] != NULL) {
+    chpl_comm_wait_nb_some(&s->pending[which], 1);
+    s->pending[which] = NULL;
+  }
+}
+
+static void stream_fetch(chpl_comm_stream_t* s, int which, int64_t lo) {
+  int64_t hi = lo + s->strip;
+
+  if (hi > s->last + 1)
+    hi = s->last + 1;
+
+  // Don't overwrite a buffer a GET may still be writing into.
+  stream_wait(s, which);
+
+  s->bufLo[which] = lo;
+  s->bufHi[which] = hi;
+  s->pending[which] =
+    chpl_comm_get_nb(s->buf[which], s->node,
+                     s->raddr + lo * (int64_t) s->eltSize,
+                     (hi - lo) * s->eltSize,
+                     s->typeIndex, s->commID, s->ln, s->fn);
+}
+
+void* chpl_comm_stream_start(c_nodeid_t node, void* raddr, size_t eltSize,
+                             int64_t first, int64_t count, int32_t typeIndex,
+                             int32_t commID, int ln, int32_t fn) {
+  chpl_comm_stream_t* s;
+
+  if (node == chpl_nodeID || count <= 0)
+    return NULL;
+
+  // Our own earlier writes to the data may still be buffered in the
+  // remote cache; make sure the GETs below see them.
+  chpl_rmem_consist_release(ln, fn);
+
+  s = (chpl_comm_stream_t*) chpl_mem_alloc(sizeof(*s),
+                                           CHPL_RT_MD_COMM_STREAM_BUF,
+                                           ln, fn);
+  s->node = node;
+  s->raddr = (char*) raddr;
+  s->eltSize = eltSize;
+  s->first = first;
+  s->last = first + count - 1;
+  s->strip = STREAM_STRIP_BYTES / eltSize;
+  if (s->strip < 1)
+    s->strip = 1;
+  if (s->strip > count)
+    s->strip = count;
+
+  s->typeIndex = typeIndex;
+  s->commID = commID;
+  s->ln = ln;
+  s->fn = fn;
+
+  s->base = NULL;
+  s->lo = 0;
+  s->hi = 0;
+  s->cur = 0;
+  s->pending[0] = NULL;
+  s->pending[1] = NULL;
+
+  s->buf[0] = chpl_mem_alloc(s->strip * eltSize, CHPL_RT_MD_COMM_STREAM_BUF,
+                             ln, fn);
+  s->buf[1] = NULL;
+  stream_fetch(s, 0, first);
+
+  if (count > s->strip) {
+    s->buf[1] = chpl_mem_alloc(s->strip * eltSize,
+                               CHPL_RT_MD_COMM_STREAM_BUF, ln, fn);
+    stream_fetch(s, 1, first + s->strip);
+  } else {
+    s->bufLo[1] = s->bufHi[1] = 0;
+  }
+
+  return s;
+}
+
+//
+// Make the strip holding 'idx' current.  Loops read the elements in
+// order, so this is normally the strip already in flight in the other
+// buffer; once it is current, start fetching the strip after it into
+// the buffer we just finished with.
+//
+void chpl_comm_stream_advance(chpl_comm_stream_t* s, int64_t idx) {
+  int which;
+
+  if (idx < s->first || idx > s->last)
+    chpl_internal_error("stream index out of prefetched range");
+
+  if (s->bufLo[0] <= idx && idx < s->bufHi[0])
+    which = 0;
+  else if (s->buf[1] != NULL && s->bufLo[1] <= idx && idx < s->bufHi[1])
+    which = 1;
+  else {
+    which = (s->buf[1] != NULL) ? 1 - s->cur : 0;
+    stream_fetch(s, which, idx);
+  }
+
+  stream_wait(s, which);
+
+  s->cur = which;
+  s->lo = s->bufLo[which];
+  s->hi = s->bufHi[which];
+  s->base = s->buf[which] - s->lo * (int64_t) s->eltSize;
+
+  if (s->buf[1] != NULL && s->hi <= s->last &&
+      s->bufLo[1 - which] != s->hi)
+    stream_fetch(s, 1 - which, s->hi);
+}
+
+void chpl_comm_stream_finish(void* stream) {
+  chpl_comm_stream_t* s = (chpl_comm_stream_t*) stream;
+  int i;
+
+  if (s == NULL)
+    return;
+
+  for (i = 0; i < 2; i++) {
+    if (s->buf[i] != NULL) {
+      stream_wait(s, i);
+      chpl_mem_free(s->buf[i], s->ln, s->fn);
+    }
+  }
+
+  chpl_mem_free(s, s->ln, s->fn);
+}
@@ -24,12 +24,14 @@
 #include "chplcast.h"
 #include "chplcgfns.h"
 #include "chpl-comm.h"
+#include "chpl-comm-site-diags.h"
 #include "chplexit.h"
 #include "chplio.h"
 #include "chpl-init.h"
 #include "chpl-mem.h"
 #include "chplmemtrack.h"
 #include "chpl-privatization.h"
+#include "chpl-sample-prof.h"
 #include "chpl-tasks.h"
 #include "chpl-topo.h"
 #include "chpl-linefile-support.h"
@@ -104,6 +106,11 @@ void chpl_rt_preUserCodeHook(void) {
   //
   chpl_setMemFlags();
 
+  //
+  // Start sample profiling, if requested.
+  //
+  chpl_sample_prof_init();
+
   chpl_comm_barrier("pre-user-code hook end");
 }
 
@@ -188,6 +195,8 @@ void chpl_rt_init(int argc, char* argv[]) {
   //
   chpl_task_init();
 
+  chpl_comm_site_diags_init();
+
   // Initialize privatization, needs to happen before hitting module init
   chpl_privatization_init();
 
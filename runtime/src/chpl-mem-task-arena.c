@@ -0,0 +1,83 @@
+/*
+ * Copyright 2004-2018 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ * 
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ * 
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+//
+// Task arenas (see chpl-mem-task-arena.h)
+//
+#include "chplrt.h"
+
+#include "chpl-mem.h"
+#include "chpl-mem-task-arena.h"
+#include "chpl-tasks.h"
+#include "chpltypes.h"
+
+#include <string.h>
+
+
+void* chpl_mem_task_allocSlow(chpl_mem_taskPrvData_t* a, size_t size,
+                              chpl_mem_descInt_t description,
+                              int32_t lineno, int32_t filename) {
+  chpl_mem_taskArenaChunk_t* c;
+
+  if (a->numChunks >= CHPL_MEM_TASK_ARENA_MAX_CHUNKS)
+    return chpl_mem_alloc(size, description, lineno, filename);
+
+  c = (chpl_mem_taskArenaChunk_t*)
+      chpl_mem_alloc(CHPL_MEM_TASK_ARENA_CHUNK_SIZE, CHPL_RT_MD_TASK_ARENA,
+                     lineno, filename);
+  c->next = a->chunks;
+  c->end = (char*) c + CHPL_MEM_TASK_ARENA_CHUNK_SIZE;
+  a->chunks = c;
+  a->top = CHPL_MEM_TASK_ARENA_CHUNK_DATA(c);
+  a->numChunks++;
+
+  // A fresh chunk always has room for an allowed request.
+  return chpl_mem_task_alloc(size, description, lineno, filename);
+}
+
+
+void chpl_mem_task_freeSlow(chpl_mem_taskPrvData_t* a, void* p,
+                            int32_t lineno, int32_t filename) {
+  chpl_mem_taskArenaChunk_t* c;
+
+  // Arena memory that isn't on top is reclaimed once everything above
+  // it has been freed.
+  for (c = a->chunks; c != NULL; c = c->next) {
+    if ((char*) p >= CHPL_MEM_TASK_ARENA_CHUNK_DATA(c) && (char*) p < c->end) {
+      ((chpl_mem_taskArenaHdr_t*) ((char*) p - CHPL_MEM_TASK_ARENA_HDR_SIZE))
+        ->freed = 1;
+      return;
+    }
+  }
+
+  chpl_mem_free(p, lineno, filename);
+}
+
+
+void chpl_mem_task_release(void) {
+  chpl_mem_taskPrvData_t* a = &chpl_task_getPrvData()->mem_data;
+  chpl_mem_taskArenaChunk_t* c;
+
+  while ((c = a->chunks) != NULL) {
+    a->chunks = c->next;
+    chpl_mem_free(c, 0, 0);
+  }
+  memset(a, 0, sizeof(*a));
+}
@@ -22,16 +22,25 @@
 //
 #include "chplrt.h"
 
+#include "chpl-env.h"
 #include "chpl-mem.h"
+#include "chpl-mem-array.h"
 #include "chpltypes.h"
 #include "error.h"
 #include "chplsys.h"
 
+#include <sys/mman.h>
+
 static int heapInitialized = 0;
 
+chpl_bool chpl_mem_array_localize = false;
+chpl_bool chpl_mem_array_hugepages = false;
+
 
 void chpl_mem_init(void) {
   chpl_mem_layerInit();
+  chpl_mem_array_localize = chpl_env_rt_get_bool("LOCALIZE_ARRAYS", false);
+  chpl_mem_array_hugepages = chpl_env_rt_get_bool("ARRAY_HUGEPAGES", false);
   heapInitialized = 1;
 }
 
@@ -45,6 +54,23 @@ int chpl_mem_inited(void) {
   return heapInitialized;
 }
 
+//
+// Ask the OS to back the whole pages within [p, p+size) with transparent
+// huge pages.  This is only advice, so failures are ignored.
+//
+void chpl_mem_array_adviseHugePages(void* p, size_t size) {
+#ifdef MADV_HUGEPAGE
+  const size_t pgSize = chpl_getSysPageSize();
+  const uintptr_t lo = ((uintptr_t) p + pgSize - 1) & ~(pgSize - 1);
+  const uintptr_t hi = ((uintptr_t) p + size) & ~(pgSize - 1);
+
+  if (hi > lo) {
+    (void) madvise((void*) lo, hi - lo, MADV_HUGEPAGE);
+  }
+#endif
+}
+
+
 int chpl_posix_memalign_check_valid(size_t alignment) {
   size_t tmp;
   int power;
@@ -19,71 +19,77 @@
 
 #include "chplrt.h"
 #include "chpl-privatization.h"
+#include "chpl-atomics.h"
 #include "chpl-mem.h"
 #include "chpl-tasks.h"
+#include "error.h"
 
-static int64_t chpl_capPrivateObjects = 0;
+// Only taken to allocate a new chunk, once every CHUNK_SIZE pids.
 static chpl_sync_aux_t privatizationSync;
 
-void** chpl_privateObjects = NULL;
+void** chpl_privateObjects[CHPL_PRIVATIZATION_MAX_CHUNKS];
 
 void chpl_privatization_init(void) {
     chpl_sync_initAux(&privatizationSync);
 }
 
-static inline int64_t max(int64_t a, int64_t b) {
-  return a > b ? a : b;
+static void** getChunk(int64_t chunk) {
+  void** objects = chpl_privateObjects[chunk];
+
+  if (objects != NULL) {
+    // Pairs with the release fence below, so the chunk's zeroed contents
+    // are visible before it is used.
+    atomic_thread_fence(memory_order_acquire);
+    return objects;
+  }
+
+  chpl_sync_lock(&privatizationSync);
+
+  objects = chpl_privateObjects[chunk];
+  if (objects == NULL) {
+    objects = chpl_mem_allocManyZero(CHPL_PRIVATIZATION_CHUNK_SIZE,
+                                     sizeof(void*),
+                                     CHPL_RT_MD_COMM_PRV_OBJ_ARRAY, 0, 0);
+    atomic_thread_fence(memory_order_release);
+    chpl_privateObjects[chunk] = objects;
+  }
+
+  chpl_sync_unlock(&privatizationSync);
+
+  return objects;
 }
 
 // Note that this function can be called in parallel and more notably it can be
 // called with non-monotonic pid's. e.g. this may be called with pid 27, and
-// then pid 2, so it has to ensure that the privatized array has at least pid+1
-// elements. Be __very__ careful if you have to update it.
+// then pid 2. Each pid is only ever set by one task, and chunks never move
+// once allocated, so storing into an existing chunk needs no lock.
 void chpl_newPrivatizedClass(void* v, int64_t pid) {
-  chpl_sync_lock(&privatizationSync);
+  int64_t chunk = pid >> CHPL_PRIVATIZATION_CHUNK_BITS;
 
-  // initialize array to a default size
-  if (chpl_privateObjects == NULL) {
-    chpl_capPrivateObjects = 2*max(pid, 4);
-    chpl_privateObjects =
-        chpl_mem_allocManyZero(chpl_capPrivateObjects, sizeof(void *),
-                           CHPL_RT_MD_COMM_PRV_OBJ_ARRAY, 0, 0);
-  } else {
-    // if we're out of space, double (or more) the array size
-    if (pid >= chpl_capPrivateObjects) {
-      void** tmp;
-      int64_t oldCap;
-
-      oldCap = chpl_capPrivateObjects;
-      chpl_capPrivateObjects = 2*max(pid, oldCap);
-
-      tmp = chpl_mem_allocManyZero(chpl_capPrivateObjects, sizeof(void *),
-                                   CHPL_RT_MD_COMM_PRV_OBJ_ARRAY, 0, 0);
-      chpl_memcpy((void*)tmp, (void*)chpl_privateObjects, (oldCap)*sizeof(void*));
-      chpl_privateObjects = tmp;
-      // purposely leak old copies of chpl_privateObject to avoid the need to
-      // lock chpl_getPrivatizedClass; TODO: fix with lock free data structure
-    }
-  }
-  chpl_privateObjects[pid] = v;
+  if (pid < 0 || chunk >= CHPL_PRIVATIZATION_MAX_CHUNKS)
+    chpl_internal_error("too many privatized objects");
 
-  chpl_sync_unlock(&privatizationSync);
+  getChunk(chunk)[pid & (CHPL_PRIVATIZATION_CHUNK_SIZE - 1)] = v;
 }
 
 void chpl_clearPrivatizedClass(int64_t i) {
-  chpl_sync_lock(&privatizationSync);
-  chpl_privateObjects[i] = NULL;
-  chpl_sync_unlock(&privatizationSync);
+  void** objects = chpl_privateObjects[i >> CHPL_PRIVATIZATION_CHUNK_BITS];
+
+  if (objects != NULL)
+    objects[i & (CHPL_PRIVATIZATION_CHUNK_SIZE - 1)] = NULL;
 }
 
 // Used to check for leaks of privatized classes
 int64_t chpl_numPrivatizedClasses(void) {
   int64_t ret = 0;
-  chpl_sync_lock(&privatizationSync);
-  for (int64_t i = 0; i < chpl_capPrivateObjects; i++) {
-    if (chpl_privateObjects[i])
-      ret++;
+  for (int64_t chunk = 0; chunk < CHPL_PRIVATIZATION_MAX_CHUNKS; chunk++) {
+    void** objects = chpl_privateObjects[chunk];
+    if (objects == NULL)
+      continue;
+    for (int64_t i = 0; i < CHPL_PRIVATIZATION_CHUNK_SIZE; i++) {
+      if (objects[i])
+        ret++;
+    }
   }
-  chpl_sync_unlock(&privatizationSync);
   return ret;
 }
@@ -0,0 +1,673 @@
+/*
+ * Copyright 2004-2018 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Task-aware sampling profiler
+//
+
+#define _GNU_SOURCE  // for dl_iterate_phdr()
+
+#include "chplrt.h"
+
+#include "chplcgfns.h"
+#include "chpl-comm.h"
+#include "chpl-linefile-support.h"
+#include "chpl-mem-sys.h"
+#include "chpl-sample-prof.h"
+#include "chpl-tasks.h"
+#include "chpl-tasks-callbacks.h"
+#include "chpl-thread-local-storage.h"
+#include "error.h"
+
+#include <errno.h>
+#include <execinfo.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <elf.h>
+#include <link.h>
+#endif
+
+//
+// This is in the modules, in SampleProfiling.chpl.
+//
+extern void chpl_sampleProf_returnConfigVals(chpl_bool* sampleProfile,
+                                             int64_t* sampleProfileHz,
+                                             chpl_bool* sampleProfileByTask,
+                                             c_string* sampleProfileFile);
+
+//
+// We can only attribute samples to tasks if a signal handler can read
+// thread-local storage directly.
+//
+#ifdef CHPL_TLS
+
+//
+// What we know about the task a thread is running, from the tasking
+// layer's begin callback.
+//
+typedef struct {
+  uint64_t id;
+  chpl_fn_int_t fid;
+  int32_t filename;
+  int lineno;
+  int is_executeOn;
+  c_sublocid_t subloc;
+} task_info_t;
+
+//
+// Tasking layers may run a task inline in another one on the same
+// thread (fifo does this while waiting for a coforall or cobegin), so
+// each thread keeps a short stack of the tasks it is running.  Deeper
+// nesting than this is attributed to the innermost task we recorded.
+//
+#define MAX_TASK_NEST 8
+
+static CHPL_TLS task_info_t task_stack[MAX_TASK_NEST];
+static CHPL_TLS int task_depth;
+static CHPL_TLS int is_main_thread;
+
+//
+// Samples go into a buffer allocated up front, since the signal
+// handler can't allocate.  When it is full, further samples are only
+// counted.
+//
+#define MAX_STACK_DEPTH 48
+#define MAX_SAMPLES     (1 << 15)
+
+typedef struct {
+  volatile int ready;
+  int depth;
+  int is_main;
+  task_info_t task;
+  void* pcs[MAX_STACK_DEPTH];
+} sample_t;
+
+static sample_t* samples = NULL;
+static volatile uint64_t num_samples = 0;
+static volatile int sampling = 0;
+
+static int by_task = 0;
+static char* profile_file = NULL;
+
+
+static void task_begin_cb(const chpl_task_cb_info_t* info) {
+  if (task_depth < MAX_TASK_NEST) {
+    task_info_t* t = &task_stack[task_depth];
+    t->id = info->iu.full.id;
+    t->fid = info->iu.full.fid;
+    t->filename = info->iu.full.filename;
+    t->lineno = info->iu.full.lineno;
+    t->is_executeOn = info->iu.full.is_executeOn;
+    t->subloc = chpl_task_getRequestedSubloc();
+  }
+  // The handler must not see the new depth before the entry is filled.
+  __sync_synchronize();
+  task_depth++;
+}
+
+static void task_end_cb(const chpl_task_cb_info_t* info) {
+  if (task_depth > 0)
+    task_depth--;
+}
+
+
+static void sigprof_handler(int sig) {
+  int saved_errno = errno;
+  uint64_t i;
+  sample_t* s;
+
+  if (!sampling)
+    return;
+
+  if ((i = __sync_fetch_and_add(&num_samples, 1)) >= MAX_SAMPLES) {
+    errno = saved_errno;
+    return;
+  }
+
+  s = &samples[i];
+  s->depth = backtrace(s->pcs, MAX_STACK_DEPTH);
+  s->is_main = is_main_thread;
+  if (task_depth > 0)
+    s->task = task_stack[(task_depth < MAX_TASK_NEST)
+                         ? task_depth - 1 : MAX_TASK_NEST - 1];
+  else
+    memset(&s->task, 0, sizeof(s->task));
+  __sync_synchronize();
+  s->ready = 1;
+
+  errno = saved_errno;
+}
+
+
+void chpl_sample_prof_init(void) {
+  chpl_bool enabled = false;
+  int64_t hz = 0;
+  chpl_bool byTask = false;
+  c_string file = NULL;
+  struct sigaction act;
+  struct itimerval itv;
+  void* dummy[1];
+
+  chpl_sampleProf_returnConfigVals(&enabled, &hz, &byTask, &file);
+  if (!enabled)
+    return;
+
+  if (hz <= 0 || hz > 1000000)
+    chpl_error("sampleProfileHz must be between 1 and 1000000", 0, 0);
+
+  //
+  // The running task is kept in thread-local storage, which is only
+  // right if each task stays on one thread from start to finish.  That
+  // is true of fifo, but with other tasking layers a task that blocks
+  // may resume on another thread, so separating samples by task ID
+  // would mix up the tasks.
+  //
+  if (byTask && strcmp(CHPL_TASKS, "fifo") != 0) {
+    char msg[128];
+    snprintf(msg, sizeof(msg),
+             "sampleProfileByTask is not supported with CHPL_TASKS=%s",
+             CHPL_TASKS);
+    chpl_error(msg, 0, 0);
+  }
+
+  if (chpl_sizeSymTable == 0 && chpl_nodeID == 0)
+    chpl_warning("program was not compiled with --sample-profile; "
+                 "samples will show generated C function names", 0, 0);
+
+  by_task = byTask;
+  if (file == NULL || file[0] == '\0')
+    file = "chpl-profile.folded";
+  if ((profile_file = sys_malloc(strlen(file) + 1)) == NULL)
+    chpl_internal_error("cannot allocate sample profile file name");
+  strcpy(profile_file, file);
+
+  if ((samples = sys_calloc(MAX_SAMPLES, sizeof(sample_t))) == NULL)
+    chpl_internal_error("cannot allocate sample profile buffer");
+
+  if (chpl_task_install_callback(chpl_task_cb_event_kind_begin,
+                                 chpl_task_cb_info_kind_full,
+                                 task_begin_cb) != 0
+      || chpl_task_install_callback(chpl_task_cb_event_kind_end,
+                                    chpl_task_cb_info_kind_id_only,
+                                    task_end_cb) != 0)
+    chpl_internal_error("cannot install sample profiling task callbacks");
+
+  // The first backtrace() may load libgcc, which can't be done safely
+  // inside a signal handler, so get that out of the way now.
+  (void) backtrace(dummy, 1);
+
+  is_main_thread = 1;
+
+  memset(&act, 0, sizeof(act));
+  act.sa_handler = sigprof_handler;
+  act.sa_flags = SA_RESTART;
+  sigemptyset(&act.sa_mask);
+  if (sigaction(SIGPROF, &act, NULL) != 0)
+    chpl_internal_error("cannot install SIGPROF handler");
+
+  sampling = 1;
+
+  itv.it_interval.tv_sec = hz == 1 ? 1 : 0;
+  itv.it_interval.tv_usec = hz == 1 ? 0 : 1000000 / hz;
+  itv.it_value = itv.it_interval;
+  if (setitimer(ITIMER_PROF, &itv, NULL) != 0)
+    chpl_internal_error("cannot start sample profiling timer");
+}
+
+
+//
+// Symbolization.  Sampled PCs are first mapped to the native function
+// containing them, using the executable's own symbol table, and then
+// native names of generated functions are mapped to Chapel names and
+// declaration lines, using the table the compiler emits for that.
+//
+typedef struct {
+  uintptr_t addr;
+  size_t size;
+  const char* name;
+} exe_sym_t;
+
+static exe_sym_t* exe_syms = NULL;
+static size_t num_exe_syms = 0;
+
+static int* chpl_fun_order = NULL;  // chpl_funSymTable indices, by cname
+static int num_chpl_funs = 0;
+
+#ifdef __linux__
+
+static void* exe_map = NULL;
+static size_t exe_map_size = 0;
+static uintptr_t exe_bias = 0;
+
+static int exe_sym_cmp(const void* v1, const void* v2) {
+  const exe_sym_t* s1 = (const exe_sym_t*) v1;
+  const exe_sym_t* s2 = (const exe_sym_t*) v2;
+  return (s1->addr < s2->addr) ? -1 : (s1->addr > s2->addr) ? 1 : 0;
+}
+
+static int get_exe_bias(struct dl_phdr_info* info, size_t size, void* data) {
+  // The executable is always the first object reported.
+  *(uintptr_t*) data = (uintptr_t) info->dlpi_addr;
+  return 1;
+}
+
+static void load_exe_syms(void) {
+  struct stat st;
+  ElfW(Ehdr)* eh;
+  ElfW(Shdr)* sh;
+  ElfW(Shdr)* symsh = NULL;
+  ElfW(Sym)* syms;
+  const char* strtab;
+  size_t n, i;
+  int fd;
+
+  if ((fd = open("/proc/self/exe", O_RDONLY)) < 0)
+    return;
+  if (fstat(fd, &st) != 0
+      || (exe_map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0))
+         == MAP_FAILED) {
+    exe_map = NULL;
+    close(fd);
+    return;
+  }
+  close(fd);
+  exe_map_size = st.st_size;
+
+  eh = (ElfW(Ehdr)*) exe_map;
+  if (memcmp(eh->e_ident, ELFMAG, SELFMAG) != 0 || eh->e_shoff == 0)
+    return;
+
+  // Prefer the full symbol table; the dynamic one lacks static functions.
+  sh = (ElfW(Shdr)*) ((char*) exe_map + eh->e_shoff);
+  for (i = 0; i < eh->e_shnum; i++) {
+    if (sh[i].sh_type == SHT_SYMTAB
+        || (sh[i].sh_type == SHT_DYNSYM && symsh == NULL))
+      symsh = &sh[i];
+  }
+  if (symsh == NULL)
+    return;
+
+  syms = (ElfW(Sym)*) ((char*) exe_map + symsh->sh_offset);
+  strtab = (const char*) exe_map + sh[symsh->sh_link].sh_offset;
+  n = symsh->sh_size / sizeof(ElfW(Sym));
+
+  if ((exe_syms = sys_malloc(n * sizeof(exe_sym_t))) == NULL)
+    chpl_internal_error("cannot allocate sample profile symbol table");
+  for (i = 0; i < n; i++) {
+    if (ELF64_ST_TYPE(syms[i].st_info) == STT_FUNC && syms[i].st_value != 0) {
+      exe_syms[num_exe_syms].addr = (uintptr_t) syms[i].st_value;
+      exe_syms[num_exe_syms].size = (size_t) syms[i].st_size;
+      exe_syms[num_exe_syms].name = strtab + syms[i].st_name;
+      num_exe_syms++;
+    }
+  }
+  qsort(exe_syms, num_exe_syms, sizeof(exe_sym_t), exe_sym_cmp);
+
+  dl_iterate_phdr(get_exe_bias, &exe_bias);
+}
+
+static void unload_exe_syms(void) {
+  sys_free(exe_syms);
+  exe_syms = NULL;
+  num_exe_syms = 0;
+  if (exe_map != NULL)
+    munmap(exe_map, exe_map_size);
+  exe_map = NULL;
+}
+
+static const exe_sym_t* find_exe_sym(uintptr_t pc) {
+  size_t lo = 0, hi = num_exe_syms;
+
+  if (pc < exe_bias)
+    return NULL;
+  pc -= exe_bias;
+
+  // find the last symbol starting at or before pc
+  while (lo < hi) {
+    size_t mid = (lo + hi) / 2;
+    if (exe_syms[mid].addr <= pc)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  if (lo == 0)
+    return NULL;
+  if (exe_syms[lo - 1].size != 0
+      && pc >= exe_syms[lo - 1].addr + exe_syms[lo - 1].size)
+    return NULL;
+  return &exe_syms[lo - 1];
+}
+
+//
+// For PCs outside the executable, all we report is the shared object.
+//
+typedef struct {
+  uintptr_t pc;
+  const char* name;
+} find_obj_t;
+
+static int find_obj_cb(struct dl_phdr_info* info, size_t size, void* data) {
+  find_obj_t* f = (find_obj_t*) data;
+  int i;
+
+  for (i = 0; i < info->dlpi_phnum; i++) {
+    const ElfW(Phdr)* ph = &info->dlpi_phdr[i];
+    uintptr_t start = (uintptr_t) info->dlpi_addr + ph->p_vaddr;
+    if (ph->p_type == PT_LOAD
+        && f->pc >= start && f->pc < start + ph->p_memsz) {
+      f->name = info->dlpi_name;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static const char* find_obj(uintptr_t pc) {
+  find_obj_t f = { pc, NULL };
+  const char* slash;
+
+  dl_iterate_phdr(find_obj_cb, &f);
+  if (f.name == NULL || f.name[0] == '\0')
+    return NULL;
+  return ((slash = strrchr(f.name, '/')) != NULL) ? slash + 1 : f.name;
+}
+
+#else // __linux__
+
+static void load_exe_syms(void) { }
+static void unload_exe_syms(void) { }
+static const exe_sym_t* find_exe_sym(uintptr_t pc) { return NULL; }
+static const char* find_obj(uintptr_t pc) { return NULL; }
+
+#endif // __linux__
+
+static int chpl_fun_cmp(const void* v1, const void* v2) {
+  return strcmp(chpl_funSymTable[*(const int*) v1],
+                chpl_funSymTable[*(const int*) v2]);
+}
+
+static void load_chpl_funs(void) {
+  int t;
+
+  if ((chpl_fun_order = sys_malloc((chpl_sizeSymTable / 2 + 1)
+                                   * sizeof(int))) == NULL)
+    chpl_internal_error("cannot allocate sample profile symbol table");
+  for (t = 0; t < chpl_sizeSymTable; t += 2)
+    chpl_fun_order[num_chpl_funs++] = t;
+  qsort(chpl_fun_order, num_chpl_funs, sizeof(int), chpl_fun_cmp);
+}
+
+static int find_chpl_fun(const char* cname) {
+  int lo = 0, hi = num_chpl_funs;
+
+  while (lo < hi) {
+    int mid = (lo + hi) / 2;
+    int c = strcmp(cname, chpl_funSymTable[chpl_fun_order[mid]]);
+    if (c == 0)
+      return chpl_fun_order[mid];
+    if (c < 0)
+      hi = mid;
+    else
+      lo = mid + 1;
+  }
+  return -1;
+}
+
+//
+// Describe the frame at pc in buf.  Returns true if it is a Chapel
+// function.
+//
+static int describe_frame(uintptr_t pc, char* buf, size_t len) {
+  const exe_sym_t* sym;
+  const char* name;
+  int t;
+
+  if ((sym = find_exe_sym(pc)) != NULL) {
+    name = sym->name;
+    if ((t = find_chpl_fun(name)) >= 0) {
+      snprintf(buf, len, "%s (%s:%d)", chpl_funSymTable[t + 1],
+               chpl_lookupFilename(chpl_filenumSymTable[t]),
+               chpl_filenumSymTable[t + 1]);
+      return 1;
+    }
+    snprintf(buf, len, "%s", name);
+  } else if ((name = find_obj(pc)) != NULL) {
+    snprintf(buf, len, "[%s]", name);
+  } else {
+    snprintf(buf, len, "[0x%" PRIxPTR "]", pc);
+  }
+  return 0;
+}
+
+
+//
+// backtrace() in the handler sees the handler itself and the signal
+// return trampoline before the interrupted frame.
+//
+#define SKIP_FRAMES 2
+
+#define MAX_LINE 8192
+
+static void append(char* line, size_t* pos, const char* frame) {
+  size_t n = strlen(frame);
+  if (*pos + n + 2 >= MAX_LINE)
+    return;
+  if (*pos > 0)
+    line[(*pos)++] = ';';
+  memcpy(line + *pos, frame, n);
+  *pos += n;
+  line[*pos] = '\0';
+}
+
+//
+// Render one sample as a folded stack, outermost frame first.  The
+// root is the task: where it was created, then optionally its ID and
+// its sublocale.  Below that come the Chapel functions on the stack,
+// and then whatever non-Chapel code the innermost of those called.
+// Frames outside the task's own function are dropped: they are the
+// scheduler and thread startup, or whatever task the tasking layer
+// ran this one inline in.
+//
+static char* fold_sample(const sample_t* s) {
+  char line[MAX_LINE];
+  char frame[512];
+  int is_chpl[MAX_STACK_DEPTH];
+  int outer = -1, inner = -1;
+  int depth = s->depth;
+  size_t pos = 0;
+  int i;
+
+  line[0] = '\0';
+  if (s->task.lineno == 0 && s->task.id == 0) {
+    append(line, &pos, s->is_main ? "<main task>" : "<no task>");
+  } else {
+    // Tasks for remote on-statements don't know where they came from.
+    const char* fname = chpl_lookupFilename(s->task.filename);
+    if (s->task.lineno == 0 || fname[0] == '\0')
+      snprintf(frame, sizeof(frame), "%s",
+               s->task.is_executeOn ? "on" : "task");
+    else
+      snprintf(frame, sizeof(frame), "%s %s:%d",
+               s->task.is_executeOn ? "on" : "task", fname, s->task.lineno);
+    append(line, &pos, frame);
+    if (by_task) {
+      snprintf(frame, sizeof(frame), "task id %" PRIu64, s->task.id);
+      append(line, &pos, frame);
+    }
+    if (isActualSublocID(s->task.subloc)) {
+      snprintf(frame, sizeof(frame), "sublocale %d", (int) s->task.subloc);
+      append(line, &pos, frame);
+    }
+  }
+
+  if (s->task.lineno != 0 || s->task.id != 0) {
+    const exe_sym_t* task_sym =
+      find_exe_sym((uintptr_t) chpl_ftable[s->task.fid]);
+    for (i = SKIP_FRAMES; i < depth && task_sym != NULL; i++) {
+      uintptr_t pc = (uintptr_t) s->pcs[i] - ((i > SKIP_FRAMES) ? 1 : 0);
+      if (find_exe_sym(pc) == task_sym)
+        depth = i + 1;
+    }
+  }
+
+  for (i = SKIP_FRAMES; i < depth; i++) {
+    // Frames other than the interrupted one hold return addresses,
+    // which may belong to the next function if the call was last.
+    uintptr_t pc = (uintptr_t) s->pcs[i] - ((i > SKIP_FRAMES) ? 1 : 0);
+    if ((is_chpl[i] = describe_frame(pc, frame, sizeof(frame)))) {
+      if (inner < 0)
+        inner = i;
+      outer = i;
+    }
+  }
+
+  if (outer < 0) {
+    if (depth > SKIP_FRAMES) {
+      describe_frame((uintptr_t) s->pcs[SKIP_FRAMES], frame, sizeof(frame));
+      append(line, &pos, frame);
+    }
+  } else {
+    for (i = outer; i >= SKIP_FRAMES; i--) {
+      if (is_chpl[i] || i < inner) {
+        uintptr_t pc = (uintptr_t) s->pcs[i] - ((i > SKIP_FRAMES) ? 1 : 0);
+        describe_frame(pc, frame, sizeof(frame));
+        append(line, &pos, frame);
+      }
+    }
+  }
+
+  return strdup(line);
+}
+
+static int str_cmp(const void* v1, const void* v2) {
+  return strcmp(*(char* const*) v1, *(char* const*) v2);
+}
+
+static void write_profile(void) {
+  uint64_t n = num_samples;
+  uint64_t dropped = 0;
+  char** lines;
+  char* filename;
+  FILE* f;
+  uint64_t i, j, m = 0;
+
+  if (n > MAX_SAMPLES) {
+    dropped = n - MAX_SAMPLES;
+    n = MAX_SAMPLES;
+  }
+
+  load_exe_syms();
+  load_chpl_funs();
+
+  if ((lines = sys_malloc((n + 1) * sizeof(char*))) == NULL)
+    chpl_internal_error("cannot allocate sample profile report");
+  for (i = 0; i < n; i++) {
+    if (samples[i].ready)
+      lines[m++] = fold_sample(&samples[i]);
+  }
+  qsort(lines, m, sizeof(char*), str_cmp);
+
+  if (chpl_numNodes == 1) {
+    filename = profile_file;
+  } else {
+    filename = sys_malloc(strlen(profile_file) + 24);
+    sprintf(filename, "%s.%" FORMAT_c_nodeid_t, profile_file, chpl_nodeID);
+  }
+
+  if ((f = fopen(filename, "w")) == NULL) {
+    char msg[256];
+    snprintf(msg, sizeof(msg), "cannot open sample profile file %s: %s",
+             filename, strerror(errno));
+    chpl_warning(msg, 0, 0);
+  } else {
+    for (i = 0; i < m; i = j) {
+      for (j = i + 1; j < m && strcmp(lines[i], lines[j]) == 0; j++)
+        ;
+      fprintf(f, "%s %" PRIu64 "\n", lines[i], j - i);
+    }
+    fclose(f);
+  }
+
+  if (dropped > 0) {
+    char msg[256];
+    snprintf(msg, sizeof(msg), "sample profile buffer filled; "
+             "%" PRIu64 " samples on locale %d were dropped",
+             dropped, (int) chpl_nodeID);
+    chpl_warning(msg, 0, 0);
+  }
+
+  for (i = 0; i < m; i++)
+    free(lines[i]);
+  sys_free(lines);
+  if (filename != profile_file)
+    sys_free(filename);
+  sys_free(chpl_fun_order);
+  chpl_fun_order = NULL;
+  num_chpl_funs = 0;
+  unload_exe_syms();
+}
+
+
+void chpl_sample_prof_exit(void) {
+  struct itimerval itv;
+
+  if (!sampling)
+    return;
+
+  memset(&itv, 0, sizeof(itv));
+  (void) setitimer(ITIMER_PROF, &itv, NULL);
+  sampling = 0;
+
+  write_profile();
+
+  chpl_task_uninstall_callback(chpl_task_cb_event_kind_begin, task_begin_cb);
+  chpl_task_uninstall_callback(chpl_task_cb_event_kind_end, task_end_cb);
+
+  // The sample buffer is left alone, in case a handler that started
+  // before we stopped the timer is still filling in its sample.
+  sys_free(profile_file);
+  profile_file = NULL;
+}
+
+#else // CHPL_TLS
+
+void chpl_sample_prof_init(void) {
+  chpl_bool enabled = false;
+  int64_t hz = 0;
+  chpl_bool byTask = false;
+  c_string file = NULL;
+
+  chpl_sampleProf_returnConfigVals(&enabled, &hz, &byTask, &file);
+  if (enabled && chpl_nodeID == 0)
+    chpl_warning("sample profiling is not supported on this platform", 0, 0);
+}
+
+void chpl_sample_prof_exit(void) { }
+
+#endif // CHPL_TLS
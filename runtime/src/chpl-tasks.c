@@ -33,6 +33,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/resource.h>
+#include <time.h>
 #include <unistd.h>
 
 
@@ -207,3 +208,57 @@ size_t chpl_task_getDefaultCallStackSize(void)
 
   return deflt;
 }
+
+
+#define WAIT_BACKOFF_YIELDS    16
+#define WAIT_BACKOFF_MIN_SLEEP 1.0e-3
+#define WAIT_BACKOFF_MAX_SHIFT 4          // so sleeps top out at 16 ms
+
+static double wait_now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double) ts.tv_sec + (double) ts.tv_nsec * 1.0e-9;
+}
+
+
+double chpl_task_waitDeadline(double secs) {
+  return wait_now() + ((secs > 0) ? secs : 0);
+}
+
+
+chpl_bool chpl_task_waitBackoff(double deadline, int32_t attempt) {
+  double remaining = deadline - wait_now();
+  double nap;
+  int32_t shift;
+
+  if (remaining <= 0)
+    return false;
+
+  if (attempt < WAIT_BACKOFF_YIELDS) {
+    chpl_task_yield();
+    return true;
+  }
+
+  shift = attempt - WAIT_BACKOFF_YIELDS;
+  if (shift > WAIT_BACKOFF_MAX_SHIFT)
+    shift = WAIT_BACKOFF_MAX_SHIFT;
+  nap = WAIT_BACKOFF_MIN_SLEEP * (double) (1 << shift);
+  chpl_task_sleep((nap < remaining) ? nap : remaining);
+  return true;
+}
+
+
+chpl_bool chpl_sync_pollAndLockTimeout(chpl_sync_aux_t* s,
+                                       chpl_bool want_full, double secs) {
+  const double deadline = chpl_task_waitDeadline(secs);
+  int32_t attempt = 0;
+
+  chpl_sync_lock(s);
+  while (chpl_sync_isFull(NULL, s) != want_full) {
+    chpl_sync_unlock(s);
+    if (!chpl_task_waitBackoff(deadline, attempt++))
+      return false;
+    chpl_sync_lock(s);
+  }
+  return true;
+}
@@ -0,0 +1,293 @@
+/*
+ * Copyright 2004-2018 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ * 
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ * 
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Hierarchical timer wheel for sleeping and timed-waiting tasks.
+//
+// Level 0 has one slot per tick; each higher level has one slot per
+// full turn of the level below it.  An entry goes into the lowest level
+// whose span covers its timeout.  Each time a level wraps, the matching
+// slot of the next level up is emptied and its entries are re-placed
+// ("cascaded") into lower levels, so an entry moves at most once per
+// level and arming, firing, and cascading are all O(1) per entry.
+//
+// Entries further out than the whole wheel can represent (~4.6 hours at
+// the default tick) are parked in the top level and re-placed each time
+// that slot cascades until they come within range.
+//
+
+#include "chplrt.h"
+#include "chpl-timer-wheel.h"
+#include "error.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <sys/time.h>
+#include <time.h>
+
+#define WHEEL_BITS   6
+#define WHEEL_SLOTS  (1 << WHEEL_BITS)
+#define WHEEL_MASK   ((uint64_t) WHEEL_SLOTS - 1)
+#define WHEEL_LEVELS 4
+#define WHEEL_SPAN   ((uint64_t) 1 << (WHEEL_BITS * WHEEL_LEVELS))
+
+#define LEVEL_SHIFT(level) (WHEEL_BITS * (level))
+
+static pthread_mutex_t wheel_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  wheel_cond = PTHREAD_COND_INITIALIZER;
+
+static chpl_timer_wheel_entry_t* wheel[WHEEL_LEVELS][WHEEL_SLOTS];
+static uint64_t cur_tick;        // next tick to process; earlier ones are done
+static uint64_t next_wake_tick;  // when the timer thread will look next
+static chpl_bool timer_thread_running = false;
+
+// Read without the lock as a hint by chpl_timer_wheel_poll().
+static volatile int64_t num_armed = 0;
+
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000 + (uint64_t) ts.tv_nsec;
+}
+
+static inline uint64_t now_tick(void) {
+  return now_ns() / CHPL_TIMER_WHEEL_TICK_NS;
+}
+
+
+static void place(chpl_timer_wheel_entry_t* e) {
+  uint64_t when = e->expires;
+  uint64_t delta = when - cur_tick;
+  chpl_timer_wheel_entry_t** head;
+  int level;
+
+  if (delta >= WHEEL_SPAN) {
+    when = cur_tick + WHEEL_SPAN - 1;
+    delta = WHEEL_SPAN - 1;
+  }
+
+  for (level = 0; level < WHEEL_LEVELS - 1; level++) {
+    if (delta < ((uint64_t) 1 << LEVEL_SHIFT(level + 1)))
+      break;
+  }
+
+  head = &wheel[level][(when >> LEVEL_SHIFT(level)) & WHEEL_MASK];
+  e->prev = NULL;
+  e->next = *head;
+  if (*head != NULL)
+    (*head)->prev = e;
+  *head = e;
+}
+
+
+static void cascade(int level, uint64_t slot) {
+  chpl_timer_wheel_entry_t* e = wheel[level][slot];
+  wheel[level][slot] = NULL;
+  while (e != NULL) {
+    chpl_timer_wheel_entry_t* next = e->next;
+    place(e);
+    e = next;
+  }
+}
+
+
+//
+// Process tick cur_tick: cascade whatever levels wrap here, then wake
+// everything in the current level 0 slot.
+//
+static void run_tick(void) {
+  const uint64_t t = cur_tick;
+  chpl_timer_wheel_entry_t* e;
+  int level;
+
+  for (level = 1; level < WHEEL_LEVELS; level++) {
+    if ((t & (((uint64_t) 1 << LEVEL_SHIFT(level)) - 1)) != 0)
+      break;
+    cascade(level, (t >> LEVEL_SHIFT(level)) & WHEEL_MASK);
+  }
+
+  e = wheel[0][t & WHEEL_MASK];
+  wheel[0][t & WHEEL_MASK] = NULL;
+  cur_tick = t + 1;
+
+  while (e != NULL) {
+    // The entry may be gone as soon as it has been woken.
+    chpl_timer_wheel_entry_t* next = e->next;
+    num_armed--;
+    e->wake(e->arg);
+    e = next;
+  }
+}
+
+
+static void advance_to(uint64_t now) {
+  while (cur_tick <= now && num_armed > 0)
+    run_tick();
+  if (num_armed == 0 && cur_tick <= now)
+    cur_tick = now + 1;
+}
+
+
+//
+// The earliest tick at which there could be something to do: the next
+// occupied level 0 slot, or the next level 0 wrap if there's a cascade.
+//
+static uint64_t next_event_tick(void) {
+  const uint64_t wrap = (cur_tick | WHEEL_MASK) + 1;
+  uint64_t t;
+
+  for (t = cur_tick; t < wrap; t++) {
+    if (wheel[0][t & WHEEL_MASK] != NULL)
+      return t;
+  }
+  return wrap;
+}
+
+
+static void* timer_thread(void* unused) {
+  pthread_mutex_lock(&wheel_lock);
+
+  while (true) {
+    advance_to(now_tick());
+
+    if (num_armed == 0) {
+      next_wake_tick = UINT64_MAX;
+      pthread_cond_wait(&wheel_cond, &wheel_lock);
+    } else {
+      //
+      // pthread_cond_timedwait() wants a wall-clock deadline, but the
+      // wheel runs on the monotonic clock, so convert the remaining
+      // interval rather than the absolute time.
+      //
+      uint64_t wait_ns;
+      uint64_t ns;
+      struct timeval tv;
+      struct timespec deadline;
+
+      next_wake_tick = next_event_tick();
+      ns = now_ns();
+      wait_ns = next_wake_tick * CHPL_TIMER_WHEEL_TICK_NS;
+      wait_ns = (wait_ns > ns) ? wait_ns - ns : 0;
+
+      gettimeofday(&tv, NULL);
+      ns = (uint64_t) tv.tv_usec * 1000 + wait_ns;
+      deadline.tv_sec = tv.tv_sec + (time_t) (ns / 1000000000);
+      deadline.tv_nsec = (long) (ns % 1000000000);
+      (void) pthread_cond_timedwait(&wheel_cond, &wheel_lock, &deadline);
+    }
+  }
+
+  return NULL;
+}
+
+
+static void start_timer_thread(void) {
+  pthread_attr_t attr;
+  pthread_t thread;
+
+  if (pthread_attr_init(&attr) != 0
+      || pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED) != 0
+      || pthread_create(&thread, &attr, timer_thread, NULL) != 0)
+    chpl_internal_error("cannot create timer wheel thread");
+  (void) pthread_attr_destroy(&attr);
+  timer_thread_running = true;
+}
+
+
+void chpl_timer_wheel_add(chpl_timer_wheel_entry_t* e, double secs,
+                          chpl_timer_wheel_fn_t wake, void* arg) {
+  const double max_ticks = (double) ((uint64_t) 1 << 62);
+  double dticks;
+  uint64_t now;
+
+  //
+  // Round up, and add one for the partial tick we're already in, so
+  // that we never wake early.
+  //
+  dticks = ceil(secs * (1.0e9 / CHPL_TIMER_WHEEL_TICK_NS));
+  if (!(dticks > 0))
+    dticks = 0;
+  else if (dticks > max_ticks)
+    dticks = max_ticks;
+
+  e->wake = wake;
+  e->arg = arg;
+
+  pthread_mutex_lock(&wheel_lock);
+
+  now = now_tick();
+  if (num_armed == 0)
+    cur_tick = now + 1;
+  e->expires = now + (uint64_t) dticks + 1;
+  place(e);
+  num_armed++;
+
+  if (!timer_thread_running)
+    start_timer_thread();
+  else if (e->expires < next_wake_tick)
+    pthread_cond_signal(&wheel_cond);
+
+  pthread_mutex_unlock(&wheel_lock);
+}
+
+
+void chpl_timer_wheel_poll(void) {
+  if (num_armed == 0)
+    return;
+  if (pthread_mutex_trylock(&wheel_lock) != 0)
+    return;
+  advance_to(now_tick());
+  pthread_mutex_unlock(&wheel_lock);
+}
+
+
+typedef struct {
+  pthread_mutex_t lock;
+  pthread_cond_t  cond;
+  chpl_bool       done;
+} thread_sleeper_t;
+
+static void wake_thread_sleeper(void* arg) {
+  thread_sleeper_t* s = (thread_sleeper_t*) arg;
+  pthread_mutex_lock(&s->lock);
+  s->done = true;
+  pthread_cond_signal(&s->cond);
+  pthread_mutex_unlock(&s->lock);
+}
+
+void chpl_timer_wheel_sleep(double secs) {
+  thread_sleeper_t s;
+  chpl_timer_wheel_entry_t e;
+
+  pthread_mutex_init(&s.lock, NULL);
+  pthread_cond_init(&s.cond, NULL);
+  s.done = false;
+
+  chpl_timer_wheel_add(&e, secs, wake_thread_sleeper, &s);
+
+  pthread_mutex_lock(&s.lock);
+  while (!s.done)
+    pthread_cond_wait(&s.cond, &s.lock);
+  pthread_mutex_unlock(&s.lock);
+
+  pthread_cond_destroy(&s.cond);
+  pthread_mutex_destroy(&s.lock);
+}
@@ -20,14 +20,31 @@
 //
 // Visual Debug Support file
 //
+// Events are logged into fixed-size binary records (chpl_vdebug_rec_t).
+// Each thread appends to its own chunk of records without taking any
+// lock.  When a chunk fills, it is pushed onto a lock-free list of full
+// chunks, and a drain thread on each locale writes those chunks to the
+// locale's .bin file in the background.  Stopping drains the full
+// chunks and then the partial chunk of every thread.  The number of
+// chunks on a locale is capped; when they are all waiting to be written
+// a thread waits briefly for one and, failing that, drops its record.
+// The text file reports how many records were dropped.  Records are
+// stamped with chpl_vdebug_clock() ticks.  The text file records the
+// clock and the time of day at start and stop so readers can convert
+// ticks to times.
+//
 
 #include "chpl-visual-debug.h"
 #include "chplrt.h"
+#include "chpl-atomics.h"
 #include "chpl-comm.h"
+#include "chpl-env.h"
+#include "chpl-mem-sys.h"
 #include "chpl-tasks.h"
 #include "chpl-tasks-callbacks.h"
 #include "chpl-comm-callbacks.h"
 #include "chpl-linefile-support.h"
+#include "chpl-thread-local-storage.h"
 #include <stdint.h>
 #include <string.h>
 #include <unistd.h>
@@ -35,11 +52,16 @@
 #include <stdarg.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <pthread.h>
+#include <time.h>
 #include <sys/types.h>
 #include <sys/time.h>
 #include <sys/stat.h>
 #include <sys/resource.h>
 #include <sys/param.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
 
 #include "chplcgfns.h"
 
@@ -64,10 +86,10 @@ static void cb_comm_executeOn_fast(const chpl_comm_cb_info_t *info);
 int chpl_vdebug_fd = -1;
 int chpl_vdebug = 0;
 
-#define TID_STRING(buff, tid) (chpl_task_idToString(buff, CHPL_TASK_ID_STRING_MAX_LEN, tid))
+// fd of the binary event file, -1 => not open
+static int vdebug_bin_fd = -1;
 
-#define VDEBUG_GETPUT_FORMAT_NAMES "kind tv srcNodeID dstNodeID commTaskID addr raddr elemSize typeIndex length commID lineNumber fileno"
-#define VDEBUG_GETPUT_FORMAT_STRING "%s: %lld.%06ld %d %d %s %#lx %#lx %zd %d %zd %d %d %d\n"
+#define TID_STRING(buff, tid) (chpl_task_idToString(buff, CHPL_TASK_ID_STRING_MAX_LEN, tid))
 
 int chpl_dprintf (int fd, const char * format, ...) {
   char buffer[2048]; 
@@ -86,12 +108,319 @@ int chpl_dprintf (int fd, const char * format, ...) {
   return -1;
 }
 
+
+//
+// Timestamps.  On x86 this is the time stamp counter, which is cheap to
+// read and (on the processors we care about) runs at a constant rate and
+// is synchronized across cores.  Elsewhere it is CLOCK_MONOTONIC in ns.
+//
+static inline uint64_t chpl_vdebug_clock(void) {
+#if defined(__x86_64__) || defined(__i386__)
+  return (uint64_t) __rdtsc();
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000 + (uint64_t) ts.tv_nsec;
+#endif
+}
+
+
+//
+// Record buffers
+//
+
+#define VDEBUG_CHUNK_RECS 1024
+
+typedef struct vdebug_chunk_s {
+  struct vdebug_chunk_s* next;     // on the full or free list
+  atomic_uint_least64_t n;         // records filled, published by owner
+  uint64_t flushed;                // records written, drain thread only
+  chpl_vdebug_rec_t recs[VDEBUG_CHUNK_RECS];
+} vdebug_chunk_t;
+
+typedef struct vdebug_thread_s {
+  struct vdebug_thread_s* next;    // all threads that have logged events
+  vdebug_chunk_t* cur;             // chunk this thread is filling
+} vdebug_thread_t;
+
+CHPL_TLS_DECL_INIT(vdebug_thread_t*, vdebug_my_thread);
+static chpl_bool vdebug_tls_ready = false;
+
+// Threads are added once, under the lock, and never removed.
+static pthread_mutex_t vdebug_threads_lock = PTHREAD_MUTEX_INITIALIZER;
+static vdebug_thread_t* vdebug_threads = NULL;
+
+// Full chunks: pushed by any thread, taken all at once by the drainer.
+static atomic_uintptr_t vdebug_full;
+
+// Chunks that have been written and can be refilled.
+static pthread_mutex_t vdebug_free_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  vdebug_free_cond = PTHREAD_COND_INITIALIZER;
+static vdebug_chunk_t* vdebug_free = NULL;
+
+// At most vdebug_max_chunks chunks are ever allocated, set from
+// CHPL_RT_VDEBUG_MAX_CHUNKS.  A thread needing a chunk when none is
+// free waits up to VDEBUG_CHUNK_WAIT_NS for the drain thread to free
+// one, and otherwise drops the record it was about to log.
+#define VDEBUG_DEFAULT_MAX_CHUNKS 1024
+#define VDEBUG_CHUNK_WAIT_NS (1000 * 1000)
+static size_t vdebug_max_chunks = VDEBUG_DEFAULT_MAX_CHUNKS;
+static size_t vdebug_num_chunks = 0;   // under vdebug_free_lock
+static atomic_uint_least64_t vdebug_dropped;
+
+// Drain thread
+static pthread_mutex_t vdebug_drain_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  vdebug_drain_cond = PTHREAD_COND_INITIALIZER;
+static chpl_bool vdebug_drain_stop = false;
+static chpl_bool vdebug_drain_running = false;
+static pthread_t vdebug_drain_thread;
+
+
+static void deadline_after(struct timespec* deadline, long ns) {
+  clock_gettime(CLOCK_REALTIME, deadline);
+  deadline->tv_nsec += ns;
+  if (deadline->tv_nsec >= 1000000000) {
+    deadline->tv_sec += 1;
+    deadline->tv_nsec -= 1000000000;
+  }
+}
+
+static vdebug_chunk_t* get_free_chunk(void) {
+  vdebug_chunk_t* c;
+  chpl_bool alloc = false;
+
+  pthread_mutex_lock(&vdebug_free_lock);
+  if (vdebug_free == NULL && vdebug_num_chunks >= vdebug_max_chunks
+      && vdebug_drain_running) {
+    struct timespec deadline;
+    deadline_after(&deadline, VDEBUG_CHUNK_WAIT_NS);
+    while (vdebug_free == NULL) {
+      if (pthread_cond_timedwait(&vdebug_free_cond, &vdebug_free_lock,
+                                 &deadline) == ETIMEDOUT)
+        break;
+    }
+  }
+  c = vdebug_free;
+  if (c != NULL) {
+    vdebug_free = c->next;
+  } else if (vdebug_num_chunks < vdebug_max_chunks) {
+    vdebug_num_chunks++;
+    alloc = true;
+  }
+  pthread_mutex_unlock(&vdebug_free_lock);
+
+  if (alloc) {
+    // Allocated outside the Chapel allocator so that tracing does not
+    // show up in memory tracking.
+    c = (vdebug_chunk_t*) sys_malloc(sizeof(*c));
+    if (c == NULL) {
+      pthread_mutex_lock(&vdebug_free_lock);
+      vdebug_num_chunks--;
+      pthread_mutex_unlock(&vdebug_free_lock);
+      return NULL;
+    }
+    atomic_init_uint_least64_t(&c->n, 0);
+  }
+  if (c == NULL)
+    return NULL;
+  atomic_store_uint_least64_t(&c->n, 0);
+  c->flushed = 0;
+  c->next = NULL;
+  return c;
+}
+
+static void put_free_chunk(vdebug_chunk_t* c) {
+  pthread_mutex_lock(&vdebug_free_lock);
+  c->next = vdebug_free;
+  vdebug_free = c;
+  pthread_cond_signal(&vdebug_free_cond);
+  pthread_mutex_unlock(&vdebug_free_lock);
+}
+
+static void push_full_chunk(vdebug_chunk_t* c) {
+  uintptr_t head;
+  do {
+    head = atomic_load_uintptr_t(&vdebug_full);
+    c->next = (vdebug_chunk_t*) head;
+  } while (!atomic_compare_exchange_strong_uintptr_t(&vdebug_full, head,
+                                                     (uintptr_t) c));
+  pthread_cond_signal(&vdebug_drain_cond);
+}
+
+static vdebug_thread_t* register_thread(void) {
+  vdebug_thread_t* t = (vdebug_thread_t*) sys_malloc(sizeof(*t));
+  if (t == NULL)
+    return NULL;
+  t->cur = NULL;
+  pthread_mutex_lock(&vdebug_threads_lock);
+  t->next = vdebug_threads;
+  vdebug_threads = t;
+  pthread_mutex_unlock(&vdebug_threads_lock);
+  CHPL_TLS_SET(vdebug_my_thread, t);
+  return t;
+}
+
+//
+// Claim the next record for the calling thread and fill in the fields
+// every event has.  The caller fills in the rest and then calls
+// commit_rec().  Returns NULL, counting the record as dropped, if no
+// chunk could be had for it.
+//
+static inline chpl_vdebug_rec_t* new_rec(chpl_vdebug_kind_t kind,
+                                         vdebug_chunk_t** chunk) {
+  vdebug_thread_t* t = (vdebug_thread_t*) CHPL_TLS_GET(vdebug_my_thread);
+  vdebug_chunk_t* c;
+  chpl_vdebug_rec_t* r;
+  uint64_t n;
+
+  if (t == NULL && (t = register_thread()) == NULL) {
+    (void) atomic_fetch_add_uint_least64_t(&vdebug_dropped, 1);
+    return NULL;
+  }
+  c = t->cur;
+  if (c == NULL
+      || (n = atomic_load_explicit_uint_least64_t(&c->n, memory_order_relaxed))
+         == VDEBUG_CHUNK_RECS) {
+    if (c != NULL)
+      push_full_chunk(c);
+    if ((c = t->cur = get_free_chunk()) == NULL) {
+      (void) atomic_fetch_add_uint_least64_t(&vdebug_dropped, 1);
+      return NULL;
+    }
+    n = 0;
+  }
+
+  r = &c->recs[n];
+  memset(r, 0, sizeof(*r));
+  r->time = chpl_vdebug_clock();
+  r->task = (uint64_t) chpl_task_getId();
+  r->kind = (uint16_t) kind;
+  *chunk = c;
+  return r;
+}
+
+static inline void commit_rec(vdebug_chunk_t* c) {
+  uint64_t n = atomic_load_explicit_uint_least64_t(&c->n,
+                                                   memory_order_relaxed);
+  atomic_store_explicit_uint_least64_t(&c->n, n + 1, memory_order_release);
+}
+
+
+//
+// Write the records of chunk c not yet written.
+//
+static void write_chunk(vdebug_chunk_t* c) {
+  uint64_t n = atomic_load_explicit_uint_least64_t(&c->n,
+                                                   memory_order_acquire);
+  const char* p = (const char*) &c->recs[c->flushed];
+  size_t len = (n - c->flushed) * sizeof(chpl_vdebug_rec_t);
+
+  while (len > 0) {
+    ssize_t wrv = write(vdebug_bin_fd, p, len);
+    if (wrv < 0) {
+      if (errno == EINTR)
+        continue;
+      break;
+    }
+    p += wrv;
+    len -= wrv;
+  }
+  c->flushed = n;
+}
+
+// Write and recycle every chunk on the full list.  Drain thread only.
+static void drain_full_chunks(void) {
+  vdebug_chunk_t* c;
+  vdebug_chunk_t* rev = NULL;
+
+  c = (vdebug_chunk_t*) atomic_exchange_uintptr_t(&vdebug_full, 0);
+
+  // The list is newest-first; write in the order the chunks filled.
+  while (c != NULL) {
+    vdebug_chunk_t* next = c->next;
+    c->next = rev;
+    rev = c;
+    c = next;
+  }
+  while (rev != NULL) {
+    vdebug_chunk_t* next = rev->next;
+    write_chunk(rev);
+    put_free_chunk(rev);
+    rev = next;
+  }
+}
+
+static void* drain_thread(void* arg) {
+  pthread_mutex_lock(&vdebug_drain_lock);
+  while (!vdebug_drain_stop) {
+    struct timespec deadline;
+    pthread_mutex_unlock(&vdebug_drain_lock);
+    drain_full_chunks();
+    pthread_mutex_lock(&vdebug_drain_lock);
+    if (vdebug_drain_stop
+        || atomic_load_uintptr_t(&vdebug_full) != 0)
+      continue;
+    // Full chunks signal us, but don't rely on not missing a signal.
+    deadline_after(&deadline, 10 * 1000 * 1000);
+    (void) pthread_cond_timedwait(&vdebug_drain_cond, &vdebug_drain_lock,
+                                  &deadline);
+  }
+  pthread_mutex_unlock(&vdebug_drain_lock);
+  return NULL;
+}
+
+static void start_drain_thread(void) {
+  vdebug_drain_stop = false;
+  vdebug_drain_running =
+    (pthread_create(&vdebug_drain_thread, NULL, drain_thread, NULL) == 0);
+}
+
+//
+// Stop the drain thread and write everything still buffered.  Callbacks
+// have already been uninstalled, so only a callback that was in progress
+// can still be adding a record; it is picked up if it commits in time.
+//
+static void stop_drain_thread(void) {
+  vdebug_thread_t* t;
+
+  if (vdebug_drain_running) {
+    pthread_mutex_lock(&vdebug_drain_lock);
+    vdebug_drain_stop = true;
+    pthread_cond_signal(&vdebug_drain_cond);
+    pthread_mutex_unlock(&vdebug_drain_lock);
+    (void) pthread_join(vdebug_drain_thread, NULL);
+    vdebug_drain_running = false;
+  }
+
+  drain_full_chunks();
+
+  pthread_mutex_lock(&vdebug_threads_lock);
+  for (t = vdebug_threads; t != NULL; t = t->next) {
+    if (t->cur != NULL)
+      write_chunk(t->cur);
+  }
+  pthread_mutex_unlock(&vdebug_threads_lock);
+}
+
+
+static void close_files (void) {
+  if (vdebug_bin_fd >= 0) {
+    close (vdebug_bin_fd);
+    vdebug_bin_fd = -1;
+  }
+  if (chpl_vdebug_fd >= 0) {
+    close (chpl_vdebug_fd);
+    chpl_vdebug_fd = -1;
+  }
+}
+
 static int chpl_make_vdebug_file (const char *rootname) {
     char fname[MAXPATHLEN]; 
     struct stat sb;
 
     chpl_vdebug = 0;
     chpl_vdebug_fd = -1;
+    vdebug_bin_fd = -1;
 
     // Make sure the directory is made.
     if (mkdir (rootname,0777) < 0) {
@@ -114,12 +443,37 @@ static int chpl_make_vdebug_file (const char *rootname) {
       return -1;
     }
 
+    snprintf (fname, sizeof (fname), "%s/%s-%d.bin", rootname, rootname,
+              chpl_nodeID);
+    vdebug_bin_fd = open (fname, O_WRONLY|O_CREAT|O_TRUNC|O_APPEND, 0666);
+    if (vdebug_bin_fd < 0) {
+      fprintf (stderr, "Visual Debug failed to open %s: %s\n",
+               fname, strerror (errno));
+      close_files ();
+      return -1;
+    }
+
     return 0;
 }
 
+// Record>  Clock: ticks time.sec
+//
+// A sample of chpl_vdebug_clock() and the time of day taken together.
+// There is one after the header and one before End; readers use the
+// pair to convert record times to times of day.
+
+static void write_clock_sample (void) {
+  struct timeval tv;
+  uint64_t ticks = chpl_vdebug_clock();
+  (void) gettimeofday (&tv, NULL);
+  chpl_dprintf (chpl_vdebug_fd, "Clock: %llu %lld.%06ld\n",
+                (unsigned long long) ticks,
+                (long long) tv.tv_sec, (long) tv.tv_usec);
+}
+
 // Record>  ChplVdebug: ver # nid # tid # seq time.sec user.time system.time 
 //
-//  Ver # -- version number, currently 1.1
+//  Ver # -- version number, currently 2.0
 //  nid # -- nodeID
 //  tid # -- taskID
 //  seq time.sec -- unique number for this run
@@ -132,13 +486,25 @@ void chpl_vdebug_start (const char *fileroot, double now) {
   char buff[CHPL_TASK_ID_STRING_MAX_LEN];
   (void) gettimeofday (&tv, NULL);
 
-  install_callbacks();
-
   chpl_vdebug = 0;
 
   // Close any open files.
   if (chpl_vdebug_fd >= 0)
     chpl_vdebug_stop ();
+
+  if (!vdebug_tls_ready) {
+    CHPL_TLS_INIT(vdebug_my_thread);
+    atomic_init_uintptr_t(&vdebug_full, 0);
+    atomic_init_uint_least64_t(&vdebug_dropped, 0);
+    vdebug_max_chunks = chpl_env_rt_get_size("VDEBUG_MAX_CHUNKS",
+                                             VDEBUG_DEFAULT_MAX_CHUNKS);
+    if (vdebug_max_chunks < 1)
+      vdebug_max_chunks = 1;
+    vdebug_tls_ready = true;
+  }
+  atomic_store_uint_least64_t(&vdebug_dropped, 0);
+
+  install_callbacks();
     
   // Initial call, open file and write initialization information
   
@@ -146,8 +512,10 @@ void chpl_vdebug_start (const char *fileroot, double now) {
   rootname = (fileroot == NULL || fileroot[0] == 0) ? ".Vdebug" : fileroot; 
   
   // In case of an error, just return
-  if (chpl_make_vdebug_file (rootname) < 0)
+  if (chpl_make_vdebug_file (rootname) < 0) {
+    uninstall_callbacks();
     return;
+  }
   
   // Write initial information to the file, including resource time
   if ( getrusage (RUSAGE_SELF, &ru) < 0) {
@@ -157,11 +525,14 @@ void chpl_vdebug_start (const char *fileroot, double now) {
     ru.ru_stime.tv_usec = 0;
   }
   chpl_dprintf (chpl_vdebug_fd,
-                "ChplVdebug: ver 1.3 nodes %d nid %d tid %s seq %.3lf %lld.%06ld %ld.%06ld %ld.%06ld \n",
+                "ChplVdebug: ver 2.0 nodes %d nid %d tid %s seq %.3lf %lld.%06ld %ld.%06ld %ld.%06ld \n",
                 chpl_numNodes, chpl_nodeID, TID_STRING(buff, startTask), now,
                 (long long) tv.tv_sec, (long) tv.tv_usec,
                 (long) ru.ru_utime.tv_sec, (long) ru.ru_utime.tv_usec,
                 (long) ru.ru_stime.tv_sec, (long) ru.ru_stime.tv_usec  );
+  chpl_dprintf (chpl_vdebug_fd, "Records: %d\n",
+                (int) sizeof(chpl_vdebug_rec_t));
+  write_clock_sample ();
 
   // Dump directory names, file names and function names
   if (chpl_nodeID == 0) {
@@ -191,6 +562,8 @@ void chpl_vdebug_start (const char *fileroot, double now) {
                     chpl_finfo[ix].lineno, chpl_finfo[ix].fileno,
                     chpl_finfo[ix].name);
   }
+
+  start_drain_thread ();
   
   chpl_vdebug = 1;
 }
@@ -211,6 +584,13 @@ void chpl_vdebug_stop (void) {
 
   // Now log the stop
   if (chpl_vdebug_fd >= 0) {
+    uint64_t dropped;
+    stop_drain_thread ();
+    write_clock_sample ();
+    dropped = atomic_load_uint_least64_t(&vdebug_dropped);
+    if (dropped > 0)
+      chpl_dprintf (chpl_vdebug_fd, "Dropped: %llu\n",
+                    (unsigned long long) dropped);
     (void) gettimeofday (&tv, NULL);
     if ( getrusage (RUSAGE_SELF, &ru) < 0) {
       ru.ru_utime.tv_sec = 0;
@@ -224,279 +604,196 @@ void chpl_vdebug_stop (void) {
                   (long) ru.ru_utime.tv_sec, (long) ru.ru_utime.tv_usec,
                   (long) ru.ru_stime.tv_sec, (long) ru.ru_stime.tv_usec,
                   chpl_nodeID, TID_STRING(buff, stopTask));
-    close (chpl_vdebug_fd);
+    close_files ();
   }
 }
 
-// Record>  VdbMark: time.sec nodeId taskId
+// Record>  mark: task
 //
-// This marks taskID as being a xxxVdebug() call.   Any executeOns or tasks
+// This marks the task as being a xxxVdebug() call.   Any executeOns or tasks
 // started by this task and descendants of this task are related to
 // the xxxVdebug() call and chplvis should ignore them.
 
 void chpl_vdebug_mark (void) {
-  struct timeval tv;
-  chpl_taskID_t tagTask = chpl_task_getId();
-  char buff[CHPL_TASK_ID_STRING_MAX_LEN];
-  (void) gettimeofday (&tv, NULL);
-  chpl_dprintf (chpl_vdebug_fd, "VdbMark: %lld.%06ld %d %s\n",
-                (long long) tv.tv_sec, (long) tv.tv_usec, chpl_nodeID, TID_STRING(buff, tagTask) );
+  vdebug_chunk_t* c;
+  chpl_vdebug_rec_t* r;
+
+  if (chpl_vdebug_fd < 0)
+    return;
+  if ((r = new_rec(chpl_vdebug_kind_mark, &c)) == NULL)
+    return;
+  commit_rec(c);
 }
 
 // Record>  tname: tag# tagname
+//
+// Tag names go to the text file; they are not ordered with the events.
 
 void chpl_vdebug_tagname (const char* tagname, int tagno) {
   chpl_dprintf (chpl_vdebug_fd, "tname: %d %s\n", tagno, tagname);
 }
 
-// Record>  Tag: time.sec user.time sys.time nodeId taskId tag# 
-
-void chpl_vdebug_tag (int tagno) {
+static void log_tag (chpl_vdebug_kind_t kind, int tagno) {
   struct rusage ru;
-  struct timeval tv;
-  
-  chpl_taskID_t tagTask = chpl_task_getId();
-  char buff[CHPL_TASK_ID_STRING_MAX_LEN];
+  vdebug_chunk_t* c;
+  chpl_vdebug_rec_t* r;
 
-  (void) gettimeofday (&tv, NULL);
   if ( getrusage (RUSAGE_SELF, &ru) < 0) {
     ru.ru_utime.tv_sec = 0;
     ru.ru_utime.tv_usec = 0;
     ru.ru_stime.tv_sec = 0;
     ru.ru_stime.tv_usec = 0;
   }
-  chpl_dprintf (chpl_vdebug_fd, "Tag: %lld.%06ld %ld.%06ld %ld.%06ld %d %s %d\n",
-                (long long) tv.tv_sec, (long) tv.tv_usec,
-                (long) ru.ru_utime.tv_sec, (long) ru.ru_utime.tv_usec,
-                (long) ru.ru_stime.tv_sec, (long) ru.ru_stime.tv_usec,
-                chpl_nodeID, TID_STRING(buff, tagTask), tagno);
+  if ((r = new_rec(kind, &c)) == NULL)
+    return;
+  r->addr = (uint64_t) ru.ru_utime.tv_sec * 1000000 + ru.ru_utime.tv_usec;
+  r->raddr = (uint64_t) ru.ru_stime.tv_sec * 1000000 + ru.ru_stime.tv_usec;
+  r->aux = tagno;
+  commit_rec(c);
+}
+
+// Record>  tag: user.time sys.time tag#
+
+void chpl_vdebug_tag (int tagno) {
+  if (chpl_vdebug_fd < 0)
+    return;
+  log_tag (chpl_vdebug_kind_tag, tagno);
   chpl_vdebug = 1;
 }
 
-// Record>  Pause: time.sec user.time sys.time nodeId taskId tag#
+// Record>  pause: user.time sys.time tag#
 
 void chpl_vdebug_pause (int tagno) {
-  struct rusage ru;
-  struct timeval tv;
-  chpl_taskID_t pauseTask = chpl_task_getId();
-  char buff[CHPL_TASK_ID_STRING_MAX_LEN];
-
   if (chpl_vdebug_fd >=0 && chpl_vdebug == 1) {
-    (void) gettimeofday (&tv, NULL);
-    if ( getrusage (RUSAGE_SELF, &ru) < 0) {
-      ru.ru_utime.tv_sec = 0;
-      ru.ru_utime.tv_usec = 0;
-      ru.ru_stime.tv_sec = 0;
-      ru.ru_stime.tv_usec = 0;
-    }
-    chpl_dprintf (chpl_vdebug_fd, "Pause: %lld.%06ld %ld.%06ld %ld.%06ld %d %s %d\n",
-                  (long long) tv.tv_sec, (long) tv.tv_usec,
-                  (long) ru.ru_utime.tv_sec, (long) ru.ru_utime.tv_usec,
-                  (long) ru.ru_stime.tv_sec, (long) ru.ru_stime.tv_usec,
-                  chpl_nodeID, TID_STRING(buff, pauseTask), tagno);
+    log_tag (chpl_vdebug_kind_pause, tagno);
     chpl_vdebug = 0;
   }
 }
 
 // Routines to log data ... put here so other places can
 // just call this code to get things logged.
-// FIXME: the size argument (size_t) is being cast to int here. chplvis needs
-//        to be updated to take in size_t. The elemsize field is no longer
-//        relevant as well.
 
-// Record>  nb_put: time.sec srcNodeId dstNodeId commTaskId addr raddr elemsize 
-//                  typeIndex length lineNumber fileName
+// Record>  put, get, put_nb, get_nb: addr raddr elemsize length commID
+//                                    lineNumber fileName
 //
+// For gets, data flows from the remote node to this one.
 
-void cb_comm_put_nb (const chpl_comm_cb_info_t *info) {
-  if (chpl_vdebug) {
-    struct timeval tv;
-    const struct chpl_comm_info_comm *cm = &info->iu.comm;
-    chpl_taskID_t commTask = chpl_task_getId();
-    char buff[CHPL_TASK_ID_STRING_MAX_LEN];
-    (void) gettimeofday (&tv, NULL);
-    chpl_dprintf (chpl_vdebug_fd, 
-                  VDEBUG_GETPUT_FORMAT_STRING, "nb_put",
-                  (long long) tv.tv_sec, (long) tv.tv_usec,  info->localNodeID,
-                  info->remoteNodeID, TID_STRING(buff, commTask), (unsigned long) cm->addr,
-                  (unsigned long) cm->raddr, (size_t)1, cm->typeIndex, cm->size,
-                  cm->commID, cm->lineno, cm->filename);
-  }
+static inline void log_comm (chpl_vdebug_kind_t kind,
+                             const chpl_comm_cb_info_t *info) {
+  const struct chpl_comm_info_comm *cm = &info->iu.comm;
+  vdebug_chunk_t* c;
+  chpl_vdebug_rec_t* r;
+
+  if ((r = new_rec(kind, &c)) == NULL)
+    return;
+  r->rnode = info->remoteNodeID;
+  r->addr = (uint64_t) (uintptr_t) cm->addr;
+  r->raddr = (uint64_t) (uintptr_t) cm->raddr;
+  r->size = cm->size;
+  r->aux = 1;
+  r->aux2 = cm->commID;
+  r->lineno = cm->lineno;
+  r->filename = cm->filename;
+  commit_rec(c);
 }
 
-// Record>  nb_get: time.sec dstNodeId srcNodeId commTaskId addr raddr elemsize 
-//                  typeIndex length lineNumber fileName
-//
-// Note: dstNodeId is node requesting Get
+void cb_comm_put_nb (const chpl_comm_cb_info_t *info) {
+  if (chpl_vdebug)
+    log_comm (chpl_vdebug_kind_put_nb, info);
+}
 
 void cb_comm_get_nb (const chpl_comm_cb_info_t *info) {
-  if (chpl_vdebug) {
-    struct timeval tv;
-    const struct chpl_comm_info_comm *cm = &info->iu.comm;
-    chpl_taskID_t commTask = chpl_task_getId();
-    char buff[CHPL_TASK_ID_STRING_MAX_LEN];
-    (void) gettimeofday (&tv, NULL);
-    chpl_dprintf (chpl_vdebug_fd,
-                  VDEBUG_GETPUT_FORMAT_STRING, "nb_get",
-                  (long long) tv.tv_sec, (long) tv.tv_usec,  info->localNodeID,
-                  info->remoteNodeID, TID_STRING(buff, commTask), (unsigned long) cm->addr,
-                  (unsigned long) cm->raddr, (size_t)1, cm->typeIndex, cm->size,
-                  cm->commID, cm->lineno, cm->filename);
-  }
+  if (chpl_vdebug)
+    log_comm (chpl_vdebug_kind_get_nb, info);
 }
 
-// Record>  put: time.sec srcNodeId dstNodeId commTaskId addr raddr elemsize 
-//               typeIndex length lineNumber fileName
-
-
 void cb_comm_put (const chpl_comm_cb_info_t *info) {
-  if (chpl_vdebug) {
-    struct timeval tv;
-    const struct chpl_comm_info_comm *cm = &info->iu.comm;
-    chpl_taskID_t commTask = chpl_task_getId();
-    char buff[CHPL_TASK_ID_STRING_MAX_LEN];
-    (void) gettimeofday (&tv, NULL);
-    chpl_dprintf (chpl_vdebug_fd,
-                  VDEBUG_GETPUT_FORMAT_STRING, "put",
-                  (long long) tv.tv_sec, (long) tv.tv_usec, info->localNodeID,
-                  info->remoteNodeID, TID_STRING(buff, commTask), (unsigned long) cm->addr,
-                  (unsigned long) cm->raddr, (size_t)1, cm->typeIndex, cm->size,
-                  cm->commID, cm->lineno, cm->filename);
-  }
+  if (chpl_vdebug)
+    log_comm (chpl_vdebug_kind_put, info);
 }
 
-// Record>  get: time.sec dstNodeId srcNodeId commTaskId addr raddr elemsize 
-//               typeIndex length lineNumber fileName
-//
-// Note:  dstNodeId is for the node making the request
-
 void cb_comm_get (const chpl_comm_cb_info_t *info) {
-  if (chpl_vdebug) {
-    struct timeval tv;
-    const struct chpl_comm_info_comm *cm = &info->iu.comm;
-    chpl_taskID_t commTask = chpl_task_getId();
-    char buff[CHPL_TASK_ID_STRING_MAX_LEN];
-    (void) gettimeofday (&tv, NULL);
-    chpl_dprintf (chpl_vdebug_fd,
-                  VDEBUG_GETPUT_FORMAT_STRING, "get",
-                  (long long) tv.tv_sec, (long) tv.tv_usec,  info->localNodeID,
-                  info->remoteNodeID, TID_STRING(buff, commTask), (unsigned long) cm->addr,
-                  (unsigned long) cm->raddr, (size_t)1, cm->typeIndex, cm->size,
-                  cm->commID, cm->lineno, cm->filename);
-  }
+  if (chpl_vdebug)
+    log_comm (chpl_vdebug_kind_get, info);
 }
 
-// Record>  st_put: time.sec srcNodeId dstNodeId commTaskId addr raddr elemsize 
-//                  typeIndex length lineNumber fileName
-
-void cb_comm_put_strd (const chpl_comm_cb_info_t *info) {
-    if (chpl_vdebug) {
-    struct timeval tv;
-    size_t length;
-    const struct chpl_comm_info_comm_strd *cm = &info->iu.comm_strd;
-    chpl_taskID_t commTask = chpl_task_getId();
-    char buff[CHPL_TASK_ID_STRING_MAX_LEN];
-    (void) gettimeofday (&tv, NULL);
+// Record>  put_strd, get_strd: addr raddr elemsize length commID
+//                              lineNumber fileName
+//
+// length is the number of elements; addr is always the local address.
 
-    length = 1;
-    for (int32_t i = 0; i < cm->stridelevels; i++) {
-      length *= cm->count[i];
-    }
+static inline void log_comm_strd (chpl_vdebug_kind_t kind,
+                                  const chpl_comm_cb_info_t *info) {
+  const struct chpl_comm_info_comm_strd *cm = &info->iu.comm_strd;
+  vdebug_chunk_t* c;
+  chpl_vdebug_rec_t* r;
+  size_t length = 1;
 
-    chpl_dprintf (chpl_vdebug_fd,
-                  VDEBUG_GETPUT_FORMAT_STRING, "st_put",
-                  (long long) tv.tv_sec, (long) tv.tv_usec,  info->localNodeID, 
-                  info->remoteNodeID, TID_STRING(buff, commTask),
-                  (unsigned long) cm->srcaddr, (unsigned long) cm->dstaddr, cm->elemSize,
-                  cm->typeIndex, length, cm->commID, cm->lineno, cm->filename);
-    // printout srcstrides and dststrides and stridelevels and count?
+  for (int32_t i = 0; i < cm->stridelevels; i++) {
+    length *= cm->count[i];
   }
 
+  if ((r = new_rec(kind, &c)) == NULL)
+    return;
+  r->rnode = info->remoteNodeID;
+  if (kind == chpl_vdebug_kind_put_strd) {
+    r->addr = (uint64_t) (uintptr_t) cm->srcaddr;
+    r->raddr = (uint64_t) (uintptr_t) cm->dstaddr;
+  } else {
+    r->addr = (uint64_t) (uintptr_t) cm->dstaddr;
+    r->raddr = (uint64_t) (uintptr_t) cm->srcaddr;
+  }
+  r->size = length;
+  r->aux = (int32_t) cm->elemSize;
+  r->aux2 = cm->commID;
+  r->lineno = cm->lineno;
+  r->filename = cm->filename;
+  commit_rec(c);
 }
 
-// Record>  st_get: time.sec dstNodeId srcNodeId commTaskId addr raddr elemsize 
-//                  typeIndex length lineNumber fileName
-//
-// Note:  dstNode is node making request for get
+void cb_comm_put_strd (const chpl_comm_cb_info_t *info) {
+  if (chpl_vdebug)
+    log_comm_strd (chpl_vdebug_kind_put_strd, info);
+}
 
 void cb_comm_get_strd (const chpl_comm_cb_info_t *info) {
-  if (chpl_vdebug) {
-    struct timeval tv;
-    size_t length;
-    const struct chpl_comm_info_comm_strd *cm = &info->iu.comm_strd;
-    chpl_taskID_t commTask = chpl_task_getId();
-    char buff[CHPL_TASK_ID_STRING_MAX_LEN];
-    (void) gettimeofday (&tv, NULL);
-
-    length = 1;
-    for (int32_t i = 0; i < cm->stridelevels; i++) {
-      length *= cm->count[i];
-    }
-
-    chpl_dprintf (chpl_vdebug_fd,
-                  VDEBUG_GETPUT_FORMAT_STRING, "st_get",
-                  (long long) tv.tv_sec, (long) tv.tv_usec, info->localNodeID,
-                  info->remoteNodeID, TID_STRING(buff, commTask),
-                  (unsigned long) cm->dstaddr, (unsigned long) cm->srcaddr, cm->elemSize,
-                  cm->typeIndex, length, cm->commID, cm->lineno, cm->filename);
-    // print out the srcstrides and dststrides and stridelevels and count?
-  }
+  if (chpl_vdebug)
+    log_comm_strd (chpl_vdebug_kind_get_strd, info);
 }
 
-// Record>  fork: time.sec nodeId forkNodeId subLoc funcId arg argSize forkTaskId
+// Record>  fork, fork_nb, fork_fast: arg argSize funcId subLoc
 
-void cb_comm_executeOn (const chpl_comm_cb_info_t *info) {
+static inline void log_fork (chpl_vdebug_kind_t kind,
+                             const chpl_comm_cb_info_t *info) {
+  const struct chpl_comm_info_comm_executeOn *cm = &info->iu.executeOn;
+  vdebug_chunk_t* c;
+  chpl_vdebug_rec_t* r;
 
-  // Visual Debug Support
-  if (chpl_vdebug) {
-    const struct chpl_comm_info_comm_executeOn *cm = &info->iu.executeOn;
-    chpl_taskID_t executeOnTask = chpl_task_getId();
-    char buff[CHPL_TASK_ID_STRING_MAX_LEN];
-    struct timeval tv;
-    (void) gettimeofday (&tv, NULL);
-    chpl_dprintf (chpl_vdebug_fd,
-                  "fork: %lld.%06ld %d %d %d %d %#lx %zd %s \n",
-                  (long long) tv.tv_sec, (long) tv.tv_usec, info->localNodeID,
-                  info->remoteNodeID, cm->subloc, cm->fid, (unsigned long) cm->arg,
-                  cm->arg_size, TID_STRING(buff, executeOnTask));
-  }
+  if ((r = new_rec(kind, &c)) == NULL)
+    return;
+  r->rnode = info->remoteNodeID;
+  r->addr = (uint64_t) (uintptr_t) cm->arg;
+  r->size = cm->arg_size;
+  r->aux = cm->fid;
+  r->aux2 = cm->subloc;
+  commit_rec(c);
 }
 
-// Record>  fork_nb: time.sec nodeId forkNodeId subLoc funcId arg argSize forkTaskId
-
-
-void  cb_comm_executeOn_nb (const chpl_comm_cb_info_t *info) {
-  if (chpl_vdebug) {
-    const struct chpl_comm_info_comm_executeOn *cm = &info->iu.executeOn;
-    chpl_taskID_t executeOnTask = chpl_task_getId();
-    char buff[CHPL_TASK_ID_STRING_MAX_LEN];
-    struct timeval tv;
-    (void) gettimeofday (&tv, NULL);
-    chpl_dprintf (chpl_vdebug_fd, "fork_nb: %lld.%06ld %d %d %d %d %#lx %zd %s\n",
-                  (long long) tv.tv_sec, (long) tv.tv_usec, info->localNodeID,
-                  info->remoteNodeID, cm->subloc, cm->fid, (unsigned long) cm->arg, 
-                  cm->arg_size, TID_STRING(buff, executeOnTask));
-  }
+void cb_comm_executeOn (const chpl_comm_cb_info_t *info) {
+  if (chpl_vdebug)
+    log_fork (chpl_vdebug_kind_fork, info);
 }
 
-// Record>  f_fork: time.sec nodeId forkNodeId subLoc funcId arg argSize forkTaskId
+void cb_comm_executeOn_nb (const chpl_comm_cb_info_t *info) {
+  if (chpl_vdebug)
+    log_fork (chpl_vdebug_kind_fork_nb, info);
+}
 
 void cb_comm_executeOn_fast (const chpl_comm_cb_info_t *info) {
-  if (chpl_vdebug) {
-    const struct chpl_comm_info_comm_executeOn *cm = &info->iu.executeOn;
-    chpl_taskID_t executeOnTask = chpl_task_getId();
-    char buff[CHPL_TASK_ID_STRING_MAX_LEN];
-    struct timeval tv;
-    (void) gettimeofday (&tv, NULL);
-    chpl_dprintf (chpl_vdebug_fd,
-                  "f_executeOn: %lld.%06ld %d %d %d %d %#lx %zd %s\n",
-                  (long long) tv.tv_sec, (long) tv.tv_usec, info->localNodeID,
-                  info->remoteNodeID, cm->subloc, cm->fid, (unsigned long)cm->arg, 
-                  cm->arg_size, TID_STRING(buff, executeOnTask));
-  }
+  if (chpl_vdebug)
+    log_fork (chpl_vdebug_kind_fork_fast, info);
 }
 
-
 // Task layer callbacks
 
 int install_callbacks (void) {
@@ -592,53 +889,47 @@ int uninstall_callbacks (void) {
   return rv;
 }
 
-// Record>  task: time.sec nodeId taskId parentTaskId On/Local lineNum srcName fid
+// Record>  task: newTaskId On/Local lineNum srcName fid
+//
+// The record's task is the parent.
 
 void cb_task_create (const chpl_task_cb_info_t *info) {
-  struct timeval tv;
+  vdebug_chunk_t* c;
+  chpl_vdebug_rec_t* r;
+
   if (!chpl_vdebug) return;
-  if (chpl_vdebug_fd >= 0) {
-    chpl_taskID_t taskId = chpl_task_getId();
-    char buff[CHPL_TASK_ID_STRING_MAX_LEN];
-    //printf ("taskCB: event: %d, node %d proc %s task id: %llu, new task id: %llu\n",
-    //         (int)info->event_kind, (int)info->nodeID,
-    //        (info->iu.full.is_executeOn ? "O" : "L"), taskId, info->iu.full.id);
-    (void)gettimeofday(&tv, NULL);
-    chpl_dprintf (chpl_vdebug_fd, "task: %lld.%06ld %lld %ld %s %s %ld %d %d\n",
-                  (long long) tv.tv_sec, (long) tv.tv_usec,
-                  (long long) info->nodeID, (long int) info->iu.full.id,
-                  TID_STRING(buff, taskId),
-                  (info->iu.full.is_executeOn ? "O" : "L"),
-                  (long int) info->iu.full.lineno,
-                  info->iu.full.filename,
-                  info->iu.full.fid);
-   }
+  if ((r = new_rec(chpl_vdebug_kind_task, &c)) == NULL)
+    return;
+  r->addr = info->iu.full.id;
+  r->aux = info->iu.full.fid;
+  r->aux2 = info->iu.full.is_executeOn;
+  r->lineno = info->iu.full.lineno;
+  r->filename = info->iu.full.filename;
+  commit_rec(c);
 }
 
-// Record>  Btask: time.sec nodeId taskId
+// Record>  begin: the record's task is the task beginning
 
 void cb_task_begin (const chpl_task_cb_info_t *info) {
-  struct timeval tv;
+  vdebug_chunk_t* c;
+  chpl_vdebug_rec_t* r;
+
   if (!chpl_vdebug) return;
-  if (chpl_vdebug_fd >= 0) {
-    (void)gettimeofday(&tv, NULL);
-    chpl_dprintf (chpl_vdebug_fd, "Btask: %lld.%06ld %lld %lu\n",
-                  (long long) tv.tv_sec, (long) tv.tv_usec,
-                  (long long) info->nodeID, (unsigned long) info->iu.full.id);
- 
-  }
+  if ((r = new_rec(chpl_vdebug_kind_begin, &c)) == NULL)
+    return;
+  r->task = info->iu.full.id;
+  commit_rec(c);
 }
 
-// Record>  Etask: time.sec nodeId taskId
+// Record>  end: the record's task is the task ending
 
 void cb_task_end (const chpl_task_cb_info_t *info) {
-  struct timeval tv;
+  vdebug_chunk_t* c;
+  chpl_vdebug_rec_t* r;
+
   if (!chpl_vdebug) return;
-  if (chpl_vdebug_fd >= 0) {
-    (void)gettimeofday(&tv, NULL);
-    chpl_dprintf (chpl_vdebug_fd, "Etask: %lld.%06ld %lld %lu\n",
-                  (long long) tv.tv_sec, (long) tv.tv_usec,
-                  (long long) info->nodeID, (unsigned long) info->iu.id_only.id);
- 
-  }
+  if ((r = new_rec(chpl_vdebug_kind_end, &c)) == NULL)
+    return;
+  r->task = info->iu.id_only.id;
+  commit_rec(c);
 }
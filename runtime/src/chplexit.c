@@ -21,9 +21,11 @@
 
 #include "chpl_rt_utils_static.h"
 #include "chpl-comm.h"
+#include "chpl-comm-site-diags.h"
 #include "chplexit.h"
 #include "chpl-mem.h"
 #include "chplmemtrack.h"
+#include "chpl-sample-prof.h"
 #include "chpl-topo.h"
 #include "gdb.h"
 
@@ -38,6 +40,8 @@ static void chpl_exit_common(int status, int all) {
   }
   chpl_comm_pre_task_exit(all);
   if (all) {
+    chpl_comm_site_diags_exit();
+    chpl_sample_prof_exit();
     chpl_task_exit();
     chpl_reportMemInfo();
   }
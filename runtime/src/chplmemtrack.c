@@ -35,6 +35,7 @@
 
 #include <assert.h>
 #include <pthread.h>
+#include <stddef.h>
 #include <string.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -57,6 +58,7 @@ extern void chpl_memTracking_returnConfigVals(chpl_bool* memTrack,
                                               chpl_bool* memLeaks,
                                               size_t* memMax,
                                               size_t* memThreshold,
+                                              size_t* memSampleInterval,
                                               c_string* memLog,
                                               c_string* memLeaksLog);
 
@@ -78,10 +80,34 @@ static int hashSizes[NUM_HASH_SIZE_INDICES] = { 1543, 3079, 6151, 12289, 24593,
                                                 196613, 393241, 786433, 1572869, 3145739,
                                                 6291469, 12582917, 25165843, 50331653,
                                                 100663319, 201326611, 402653189, 805306457 };
-static int hashSizeIndex = 0;
-static int hashSize = 0;
 
-static memTableEntry** memTable = NULL;
+//
+// The memory table uses lock striping: it is split into shards by
+// address, each with its own hash table and mutex, so that concurrent
+// allocations and frees rarely contend for the same lock and a resize
+// only stops the world for one shard.  Operations on a shard are still
+// serialized by its mutex; nothing here is lock free.  Freed table
+// entries go onto a per-shard free list and are reused, rather than
+// being returned to the system allocator.
+//
+#define NUM_MEMTABLE_SHARDS 64
+#define MEMTABLE_ENTRY_CHUNK 256
+
+typedef struct {
+  pthread_mutex_t lock;
+  memTableEntry** table;
+  int hashSizeIndex;
+  int hashSize;
+  size_t numEntries;
+  memTableEntry* freeEntries;
+  size_t totalMem;          /* memory currently allocated in this shard */
+  size_t totalAllocated;    /* memory allocated in this shard */
+  size_t totalFreed;        /* memory freed in this shard */
+  ptrdiff_t unfoldedMem;    /* change in totalMem not yet in foldedMem */
+  size_t sampleByteCount;   /* bytes allocated, for sampling */
+} memTableShard;
+
+static memTableShard memShards[NUM_MEMTABLE_SHARDS];
 
 static _Bool memStats = false;
 static _Bool memLeaksByType = false;
@@ -89,15 +115,28 @@ static c_string memLeaksByDesc = "";
 static _Bool memLeaks = false;
 static size_t memMax = 0;
 static size_t memThreshold = 0;
+static size_t memSampleInterval = 0;
 static c_string memLog = NULL;
 static FILE* memLogFile = NULL;
 static c_string memLeaksLog = NULL;
 
-static size_t totalMem = 0;       /* total memory currently allocated */
+//
+// The statistics are kept per shard, under the shard lock, and summed
+// when they are reported.  When sampling, they are estimates based on
+// the sampled allocations.
+//
+// The only global ones are foldedMem and maxMem, which are needed to
+// track the maximum simultaneous allocation.  A shard folds its change
+// in memory use into foldedMem with a compiler atomic builtin once the
+// change reaches MEMSTAT_FOLD_BYTES, or on every change when memMax is
+// set so that the limit is checked exactly.  So maxMem can miss a peak
+// by up to NUM_MEMTABLE_SHARDS*MEMSTAT_FOLD_BYTES; when it is reported
+// it is raised to at least the current total.
+//
+#define MEMSTAT_FOLD_BYTES (64 * 1024)
+
+static size_t foldedMem = 0;      /* sum of the folded shard totals */
 static size_t maxMem = 0;         /* maximum total memory during run  */
-static size_t totalAllocated = 0; /* total memory allocated */
-static size_t totalFreed = 0;     /* total memory freed */
-static size_t totalEntries = 0;     /* number of entries in hash table */
 
 
 // We can't use a sync var for concurrency control here.  The Qthreads
@@ -107,23 +146,40 @@ static size_t totalEntries = 0;     /* number of entries in hash table */
 // the tasking layer is shut down, ends up trying to create a qthread in
 // the terminated Qthreads library.  Chaos results.  We also cannot use
 // an atomic var, because with CHPL_ATOMICS=locks those are implemented
-// by means of sync vars.  So, we use a pthread mutex.  Note that this
-// is only safe if we cannot switch tasks on a pthread while holding the
+// by means of sync vars.  So, we use pthread mutexes.  Note that this
+// is only safe if we cannot switch tasks on a pthread while holding a
 // mutex and then try to lock it recursively.  Currently that is the
-// case, since we do not yield while holding the mutex.
+// case, since we do not yield while holding a mutex.
 // 
-static pthread_mutex_t memTrack_lockVar = PTHREAD_MUTEX_INITIALIZER;
+static inline
+memTableShard* memTrack_shard(void* memAlloc) {
+  uintptr_t p = (uintptr_t) memAlloc;
+  return &memShards[((p >> 4) ^ (p >> 16)) % NUM_MEMTABLE_SHARDS];
+}
+
+static inline
+void memTrack_lock(memTableShard* shard) {
+  (void) pthread_mutex_lock(&shard->lock);
+}
 
 static inline
-void memTrack_lock(void) {
-  (void) pthread_mutex_lock(&memTrack_lockVar);
+void memTrack_unlock(memTableShard* shard) {
+  (void) pthread_mutex_unlock(&shard->lock);
 }
 
 static inline
-void memTrack_unlock(void) {
-  (void) pthread_mutex_unlock(&memTrack_lockVar);
+void memTrack_lockAll(void) {
+  int i;
+  for (i = 0; i < NUM_MEMTABLE_SHARDS; i++)
+    memTrack_lock(&memShards[i]);
 }
 
+static inline
+void memTrack_unlockAll(void) {
+  int i;
+  for (i = NUM_MEMTABLE_SHARDS - 1; i >= 0; i--)
+    memTrack_unlock(&memShards[i]);
+}
 
 
 void chpl_setMemFlags(void) {
@@ -151,6 +207,7 @@ void chpl_setMemFlags(void) {
                                     &memLeaks,
                                     &memMax,
                                     &memThreshold,
+                                    &memSampleInterval,
                                     &memLog,
                                     &memLeaksLog);
 
@@ -160,6 +217,7 @@ void chpl_setMemFlags(void) {
       || (memLeaksByDesc && strcmp(memLeaksByDesc, ""))
       || memLeaks
       || memMax > 0
+      || memSampleInterval > 0
       || memLeaksLog != NULL) {
     chpl_memTrack = true;
   }
@@ -178,9 +236,21 @@ void chpl_setMemFlags(void) {
   }
 
   if (chpl_memTrack) {
-    hashSizeIndex = 0;
-    hashSize = hashSizes[hashSizeIndex];
-    memTable = sys_calloc(hashSize, sizeof(memTableEntry*));
+    int i;
+    for (i = 0; i < NUM_MEMTABLE_SHARDS; i++) {
+      memTableShard* shard = &memShards[i];
+      (void) pthread_mutex_init(&shard->lock, NULL);
+      shard->hashSizeIndex = 0;
+      shard->hashSize = hashSizes[shard->hashSizeIndex];
+      shard->table = sys_calloc(shard->hashSize, sizeof(memTableEntry*));
+      shard->numEntries = 0;
+      shard->freeEntries = NULL;
+      shard->totalMem = 0;
+      shard->totalAllocated = 0;
+      shard->totalFreed = 0;
+      shard->unfoldedMem = 0;
+      shard->sampleByteCount = 0;
+    }
   }
 }
 
@@ -197,37 +267,115 @@ static unsigned hash(void* memAlloc, int hashSize) {
 }
 
 
-static void increaseMemStat(size_t chunk, int32_t lineno, int32_t filename) {
-  totalMem += chunk;
-  totalAllocated += chunk;
-  if (memMax && (totalMem > memMax)) {
+//
+// When sampling, an allocation is tracked if the running count of
+// allocated bytes crosses a multiple of memSampleInterval during it,
+// so that an allocation of size s is tracked with probability
+// min(1, s/memSampleInterval).  A tracked allocation then stands for
+// max(s, memSampleInterval) bytes and max(1, memSampleInterval/s)
+// allocations.  These are 1 and s when not sampling.
+//
+// The running count is kept per shard, so concurrent allocations at
+// different addresses do not all update the same counter.
+//
+static inline
+_Bool sampleAlloc(memTableShard* shard, size_t chunk) {
+  size_t prev;
+
+  if (memSampleInterval == 0 || chunk >= memSampleInterval)
+    return true;
+  prev = __sync_fetch_and_add(&shard->sampleByteCount, chunk);
+  return (prev / memSampleInterval) != ((prev + chunk) / memSampleInterval);
+}
+
+static inline
+size_t entryBytes(memTableEntry* me) {
+  size_t chunk = me->number * me->size;
+  return (chunk < memSampleInterval) ? memSampleInterval : chunk;
+}
+
+static inline
+size_t entryCount(memTableEntry* me) {
+  size_t chunk = me->number * me->size;
+  return (chunk > 0 && chunk < memSampleInterval)
+         ? memSampleInterval / chunk : 1;
+}
+
+
+static void increaseMemStat(memTableShard* shard, size_t chunk,
+                            int32_t lineno, int32_t filename) {
+  size_t newTotal, oldMax;
+
+  shard->totalMem += chunk;
+  shard->totalAllocated += chunk;
+  shard->unfoldedMem += chunk;
+  if (memMax == 0 && shard->unfoldedMem < MEMSTAT_FOLD_BYTES)
+    return;
+
+  newTotal = __sync_add_and_fetch(&foldedMem, (size_t) shard->unfoldedMem);
+  shard->unfoldedMem = 0;
+  if (memMax && (newTotal > memMax)) {
     chpl_error("Exceeded memory limit", lineno, filename);
   }
-  if (totalMem > maxMem)
-    maxMem = totalMem;
+  while (newTotal > (oldMax = maxMem)
+         && !__sync_bool_compare_and_swap(&maxMem, oldMax, newTotal))
+    ;
 }
 
 
-static void decreaseMemStat(size_t chunk) {
-  totalMem -= chunk; // > totalMem ? 0 : totalMem - chunk;
-  totalFreed += chunk;
+static void decreaseMemStat(memTableShard* shard, size_t chunk) {
+  shard->totalMem -= chunk;
+  shard->totalFreed += chunk;
+  shard->unfoldedMem -= chunk;
+  if (memMax == 0 && shard->unfoldedMem > -MEMSTAT_FOLD_BYTES)
+    return;
+
+  (void) __sync_add_and_fetch(&foldedMem, (size_t) shard->unfoldedMem);
+  shard->unfoldedMem = 0;
+}
+
+
+//
+// Sum the per-shard statistics.  The shards are read without taking
+// their locks, so the result may be slightly stale.
+//
+typedef struct {
+  size_t totalMem;
+  size_t maxMem;
+  size_t totalAllocated;
+  size_t totalFreed;
+} memStatTotals;
+
+static void sumMemStats(memTableShard* shards, size_t peak,
+                        memStatTotals* totals) {
+  int i;
+
+  totals->totalMem = 0;
+  totals->totalAllocated = 0;
+  totals->totalFreed = 0;
+  for (i = 0; i < NUM_MEMTABLE_SHARDS; i++) {
+    totals->totalMem += shards[i].totalMem;
+    totals->totalAllocated += shards[i].totalAllocated;
+    totals->totalFreed += shards[i].totalFreed;
+  }
+  totals->maxMem = (peak > totals->totalMem) ? peak : totals->totalMem;
 }
 
 
 static void
-resizeTable(int direction) {
+resizeTable(memTableShard* shard, int direction) {
   memTableEntry** newMemTable = NULL;
   int newHashSizeIndex, newHashSize, newHashValue;
   int i;
   memTableEntry* me;
   memTableEntry* next;
 
-  newHashSizeIndex = hashSizeIndex + direction;
+  newHashSizeIndex = shard->hashSizeIndex + direction;
   newHashSize = hashSizes[newHashSizeIndex];
   newMemTable = sys_calloc(newHashSize, sizeof(memTableEntry*));
 
-  for (i = 0; i < hashSize; i++) {
-    for (me = memTable[i]; me != NULL; me = next) {
+  for (i = 0; i < shard->hashSize; i++) {
+    for (me = shard->table[i]; me != NULL; me = next) {
       next = me->nextInBucket;
       newHashValue = hash(me->memAlloc, newHashSize);
       me->nextInBucket = newMemTable[newHashValue];
@@ -235,54 +383,87 @@ resizeTable(int direction) {
     }
   }
 
-  sys_free(memTable);
-  memTable = newMemTable;
-  hashSize = newHashSize;
-  hashSizeIndex = newHashSizeIndex;
+  sys_free(shard->table);
+  shard->table = newMemTable;
+  shard->hashSize = newHashSize;
+  shard->hashSizeIndex = newHashSizeIndex;
 }
 
-static void addMemTableEntry(void *memAlloc, size_t number, size_t size,
+static memTableEntry* allocMemTableEntry(memTableShard* shard,
+                                         int32_t lineno, int32_t filename) {
+  memTableEntry* memEntry;
+
+  if (shard->freeEntries == NULL) {
+    int i;
+    memTableEntry* chunk;
+
+    //
+    // These are never given back to the system allocator.  The table
+    // lives until the program ends.
+    //
+    chunk = (memTableEntry*) sys_malloc(MEMTABLE_ENTRY_CHUNK
+                                        * sizeof(memTableEntry));
+    if (!chunk) {
+      chpl_error("memtrack fault: out of memory allocating memtrack table",
+                 lineno, filename);
+    }
+    for (i = 0; i < MEMTABLE_ENTRY_CHUNK; i++) {
+      chunk[i].nextInBucket = shard->freeEntries;
+      shard->freeEntries = &chunk[i];
+    }
+  }
+
+  memEntry = shard->freeEntries;
+  shard->freeEntries = memEntry->nextInBucket;
+  return memEntry;
+}
+
+static void freeMemTableEntry(memTableShard* shard, memTableEntry* memEntry) {
+  memEntry->nextInBucket = shard->freeEntries;
+  shard->freeEntries = memEntry;
+}
+
+static void addMemTableEntry(memTableShard* shard,
+                             void *memAlloc, size_t number, size_t size,
                              chpl_mem_descInt_t description, int32_t lineno,
                              int32_t filename) {
   unsigned hashValue;
   memTableEntry* memEntry;
 
-  if ((totalEntries+1)*2 > hashSize && hashSizeIndex < NUM_HASH_SIZE_INDICES-1)
-    resizeTable(1);
+  if ((shard->numEntries+1)*2 > shard->hashSize
+      && shard->hashSizeIndex < NUM_HASH_SIZE_INDICES-1)
+    resizeTable(shard, 1);
 
-  memEntry = (memTableEntry*) sys_calloc(1, sizeof(memTableEntry));
-  if (!memEntry) {
-    chpl_error("memtrack fault: out of memory allocating memtrack table",
-               lineno, filename);
-  }
+  memEntry = allocMemTableEntry(shard, lineno, filename);
 
-  hashValue = hash(memAlloc, hashSize);
-  memEntry->nextInBucket = memTable[hashValue];
-  memTable[hashValue] = memEntry;
+  hashValue = hash(memAlloc, shard->hashSize);
+  memEntry->nextInBucket = shard->table[hashValue];
+  shard->table[hashValue] = memEntry;
   memEntry->description = description;
   memEntry->memAlloc = memAlloc;
   memEntry->lineno = lineno;
   memEntry->filename = filename;
   memEntry->number = number;
   memEntry->size = size;
-  increaseMemStat(number*size, lineno, filename);
-  totalEntries += 1;
+  increaseMemStat(shard, entryBytes(memEntry), lineno, filename);
+  shard->numEntries += 1;
 }
 
 
-static memTableEntry* removeMemTableEntry(void* address) {
-  unsigned hashValue = hash(address, hashSize);
-  memTableEntry* thisBucketEntry = memTable[hashValue];
+static memTableEntry* removeMemTableEntry(memTableShard* shard,
+                                          void* address) {
+  unsigned hashValue = hash(address, shard->hashSize);
+  memTableEntry* thisBucketEntry = shard->table[hashValue];
   memTableEntry* deletedBucket = NULL;
 
   if (!thisBucketEntry)
     return NULL;
 
   if (thisBucketEntry->memAlloc == address) {
-    memTable[hashValue] = thisBucketEntry->nextInBucket;
+    shard->table[hashValue] = thisBucketEntry->nextInBucket;
     deletedBucket = thisBucketEntry;
   } else {
-    for (thisBucketEntry = memTable[hashValue];
+    for (thisBucketEntry = shard->table[hashValue];
          thisBucketEntry != NULL;
          thisBucketEntry = thisBucketEntry->nextInBucket) {
 
@@ -295,10 +476,10 @@ static memTableEntry* removeMemTableEntry(void* address) {
     }
   }
   if (deletedBucket) {
-    decreaseMemStat(deletedBucket->number * deletedBucket->size);
-    totalEntries -= 1;
-    if (totalEntries*8 < hashSize && hashSizeIndex > 0)
-      resizeTable(-1);
+    decreaseMemStat(shard, entryBytes(deletedBucket));
+    shard->numEntries -= 1;
+    if (shard->numEntries*8 < shard->hashSize && shard->hashSizeIndex > 0)
+      resizeTable(shard, -1);
   }
   return deletedBucket;
 }
@@ -311,7 +492,11 @@ uint64_t chpl_memoryUsed(int32_t lineno, int32_t filename) {
     return 0;
   }
 
-  return (uint64_t)totalMem;
+  {
+    memStatTotals totals;
+    sumMemStats(memShards, maxMem, &totals);
+    return (uint64_t)totals.totalMem;
+  }
 }
 
 
@@ -322,18 +507,21 @@ void chpl_printMemAllocStats(int32_t lineno, int32_t filename) {
     return;
   }
 
-  memTrack_lock();
   fprintf(memLogFile, "=================\n");
   fprintf(memLogFile, "Memory Statistics\n");
   if (chpl_numNodes == 1) {
+    memStatTotals totals;
+    sumMemStats(memShards, maxMem, &totals);
     fprintf(memLogFile, "==============================================================\n");
-    fprintf(memLogFile, "Current Allocated Memory               %zd\n", totalMem);
-    fprintf(memLogFile, "Maximum Simultaneous Allocated Memory  %zd\n", maxMem);
-    fprintf(memLogFile, "Total Allocated Memory                 %zd\n", totalAllocated);
-    fprintf(memLogFile, "Total Freed Memory                     %zd\n", totalFreed);
+    fprintf(memLogFile, "Current Allocated Memory               %zd\n", totals.totalMem);
+    fprintf(memLogFile, "Maximum Simultaneous Allocated Memory  %zd\n", totals.maxMem);
+    fprintf(memLogFile, "Total Allocated Memory                 %zd\n", totals.totalAllocated);
+    fprintf(memLogFile, "Total Freed Memory                     %zd\n", totals.totalFreed);
     fprintf(memLogFile, "==============================================================\n");
   } else {
     int i;
+    memTableShard* shards;
+    shards = sys_malloc(NUM_MEMTABLE_SHARDS * sizeof(memTableShard));
     fprintf(memLogFile, "==============================================================\n");
     fprintf(memLogFile, "Locale\n");
     fprintf(memLogFile, "           Current Allocated Memory\n");
@@ -342,16 +530,18 @@ void chpl_printMemAllocStats(int32_t lineno, int32_t filename) {
     fprintf(memLogFile, "                                            Total Freed Memory\n");
     fprintf(memLogFile, "==============================================================\n");
     for (i = 0; i < chpl_numNodes; i++) {
-      static size_t m1, m2, m3, m4;
-      chpl_gen_comm_get(&m1, i, &totalMem,       sizeof(size_t), -1 /* broke for hetero */, CHPL_COMM_UNKNOWN_ID, lineno, filename);
-      chpl_gen_comm_get(&m2, i, &maxMem,         sizeof(size_t), -1 /* broke for hetero */, CHPL_COMM_UNKNOWN_ID, lineno, filename);
-      chpl_gen_comm_get(&m3, i, &totalAllocated, sizeof(size_t), -1 /* broke for hetero */, CHPL_COMM_UNKNOWN_ID, lineno, filename);
-      chpl_gen_comm_get(&m4, i, &totalFreed,     sizeof(size_t), -1 /* broke for hetero */, CHPL_COMM_UNKNOWN_ID, lineno, filename);
-      fprintf(memLogFile, "%-9d  %-9zu  %-9zu  %-9zu  %-9zu\n", i, m1, m2, m3, m4);
+      static size_t peak;
+      memStatTotals totals;
+      chpl_gen_comm_get(shards, i, memShards, NUM_MEMTABLE_SHARDS * sizeof(memTableShard), -1 /* broke for hetero */, CHPL_COMM_UNKNOWN_ID, lineno, filename);
+      chpl_gen_comm_get(&peak,  i, &maxMem,   sizeof(size_t), -1 /* broke for hetero */, CHPL_COMM_UNKNOWN_ID, lineno, filename);
+      sumMemStats(shards, peak, &totals);
+      fprintf(memLogFile, "%-9d  %-9zu  %-9zu  %-9zu  %-9zu\n", i,
+              totals.totalMem, totals.maxMem, totals.totalAllocated,
+              totals.totalFreed);
     }
+    sys_free(shards);
     fprintf(memLogFile, "==============================================================\n");
   }
-  memTrack_unlock();
 }
 
 
@@ -365,7 +555,7 @@ static void printMemAllocsByType(_Bool forLeaks,
                                  int32_t lineno, int32_t filename) {
   size_t* table;
   memTableEntry* me;
-  int i;
+  int i, s;
   const int numberWidth   = 9;
   const int numEntries = CHPL_RT_MD_NUM+chpl_mem_numDescs;
 
@@ -378,13 +568,18 @@ static void printMemAllocsByType(_Bool forLeaks,
 
   table = (size_t*)sys_calloc(numEntries, 3*sizeof(size_t));
 
-  for (i = 0; i < hashSize; i++) {
-    for (me = memTable[i]; me != NULL; me = me->nextInBucket) {
-      table[3*me->description] += me->number*me->size;
-      table[3*me->description+1] += 1;
-      table[3*me->description+2] = me->description;
+  memTrack_lockAll();
+  for (s = 0; s < NUM_MEMTABLE_SHARDS; s++) {
+    memTableShard* shard = &memShards[s];
+    for (i = 0; i < shard->hashSize; i++) {
+      for (me = shard->table[i]; me != NULL; me = me->nextInBucket) {
+        table[3*me->description] += entryBytes(me);
+        table[3*me->description+1] += entryCount(me);
+        table[3*me->description+2] = me->description;
+      }
     }
   }
+  memTrack_unlockAll();
 
   qsort(table, numEntries, 3*sizeof(size_t), memTableEntryCmp);
 
@@ -447,8 +642,8 @@ void chpl_printMemAllocsByDesc(const char* descString, int64_t threshold,
 
 
 static int descCmp(const void* p1, const void* p2) {
-  memTableEntry* m1 = *(memTableEntry**)p1;
-  memTableEntry* m2 = *(memTableEntry**)p2;
+  const memTableEntry* m1 = (const memTableEntry*)p1;
+  const memTableEntry* m2 = (const memTableEntry*)p2;
   c_string m1Filename;
   c_string m2Filename;
 
@@ -484,9 +679,9 @@ printMemAllocs(chpl_mem_descInt_t description, int64_t threshold,
 
   memTableEntry* memEntry;
   c_string memEntryFilename;
-  int n, i;
+  int n, i, s;
   char* loc;
-  memTableEntry** table;
+  memTableEntry* table;
 
   if (!chpl_memTrack) {
     chpl_warning("invalid call to printMemAllocs(); rerun with --memTrack",
@@ -494,25 +689,57 @@ printMemAllocs(chpl_mem_descInt_t description, int64_t threshold,
     return;
   }
 
+  // Copy the matching entries out under the shard locks, so that no
+  // lock is held while sorting and writing the report.
+  memTrack_lockAll();
+
   n = 0;
   filenameWidth = strlen("Allocated Memory (Bytes)");
-  for (i = 0; i < hashSize; i++) {
-    for (memEntry = memTable[i]; memEntry != NULL; memEntry = memEntry->nextInBucket) {
-      size_t chunk = memEntry->number * memEntry->size;
-      if (chunk < threshold)
-        continue;
-      if (description != -1 && memEntry->description != description)
-        continue;
-      n += 1;
-      if (memEntry->filename) {
-        memEntryFilename = chpl_lookupFilename(memEntry->filename);
-        filenameLength = strlen(memEntryFilename);
-        if (filenameLength > filenameWidth)
-          filenameWidth = filenameLength;
+  for (s = 0; s < NUM_MEMTABLE_SHARDS; s++) {
+    memTableShard* shard = &memShards[s];
+    for (i = 0; i < shard->hashSize; i++) {
+      for (memEntry = shard->table[i]; memEntry != NULL; memEntry = memEntry->nextInBucket) {
+        size_t chunk = memEntry->number * memEntry->size;
+        if (chunk < threshold)
+          continue;
+        if (description != -1 && memEntry->description != description)
+          continue;
+        n += 1;
+        if (memEntry->filename) {
+          memEntryFilename = chpl_lookupFilename(memEntry->filename);
+          filenameLength = strlen(memEntryFilename);
+          if (filenameLength > filenameWidth)
+            filenameWidth = filenameLength;
+        }
       }
     }
   }
 
+  table = (memTableEntry*)sys_malloc(n*sizeof(memTableEntry));
+  if (!table) {
+    memTrack_unlockAll();
+    chpl_error("out of memory printing memory table", lineno, filename);
+  }
+
+  n = 0;
+  for (s = 0; s < NUM_MEMTABLE_SHARDS; s++) {
+    memTableShard* shard = &memShards[s];
+    for (i = 0; i < shard->hashSize; i++) {
+      for (memEntry = shard->table[i]; memEntry != NULL; memEntry = memEntry->nextInBucket) {
+        size_t chunk = memEntry->number * memEntry->size;
+        if (chunk < threshold)
+          continue;
+        if (description != -1 && memEntry->description != description)
+          continue;
+        table[n++] = *memEntry;
+      }
+    }
+  }
+
+  memTrack_unlockAll();
+
+  loc = (char*)sys_malloc((filenameWidth+numberWidth+1)*sizeof(char));
+
   totalWidth = filenameWidth+numberWidth*4+descWidth+20;
   for (i = 0; i < totalWidth; i++)
     fprintf(memLogFile, "=");
@@ -528,27 +755,10 @@ printMemAllocs(chpl_mem_descInt_t description, int64_t threshold,
     fprintf(memLogFile, "=");
   fprintf(memLogFile, "\n");
 
-  table = (memTableEntry**)sys_malloc(n*sizeof(memTableEntry*));
-  if (!table)
-    chpl_error("out of memory printing memory table", lineno, filename);
-
-  n = 0;
-  for (i = 0; i < hashSize; i++) {
-    for (memEntry = memTable[i]; memEntry != NULL; memEntry = memEntry->nextInBucket) {
-      size_t chunk = memEntry->number * memEntry->size;
-      if (chunk < threshold)
-        continue;
-      if (description != -1 && memEntry->description != description)
-        continue;
-      table[n++] = memEntry;
-    }
-  }
-  qsort(table, n, sizeof(memTableEntry*), descCmp);
-
-  loc = (char*)sys_malloc((filenameWidth+numberWidth+1)*sizeof(char));
+  qsort(table, n, sizeof(memTableEntry), descCmp);
 
   for (i = 0; i < n; i++) {
-    memEntry = table[i];
+    memEntry = &table[i];
     if (memEntry->filename) {
       memEntryFilename = chpl_lookupFilename(memEntry->filename);
       sprintf(loc, "%s:%" PRId32, memEntryFilename, memEntry->lineno);
@@ -609,9 +819,13 @@ void chpl_track_malloc(void* memAlloc, size_t number, size_t size,
                        int32_t lineno, int32_t filename) {
   if (number * size > memThreshold) {
     if (chpl_memTrack && chpl_mem_descTrack(description)) {
-      memTrack_lock();
-      addMemTableEntry(memAlloc, number, size, description, lineno, filename);
-      memTrack_unlock();
+      memTableShard* shard = memTrack_shard(memAlloc);
+      if (sampleAlloc(shard, number * size)) {
+        memTrack_lock(shard);
+        addMemTableEntry(shard, memAlloc, number, size, description,
+                         lineno, filename);
+        memTrack_unlock(shard);
+      }
     }
     if (chpl_verbose_mem) {
       fprintf(memLogFile, "%" FORMAT_c_nodeid_t ": %s:%" PRId32
@@ -627,8 +841,9 @@ void chpl_track_malloc(void* memAlloc, size_t number, size_t size,
 void chpl_track_free(void* memAlloc, int32_t lineno, int32_t filename) {
   memTableEntry* memEntry = NULL;
   if (chpl_memTrack) {
-    memTrack_lock();
-    memEntry = removeMemTableEntry(memAlloc);
+    memTableShard* shard = memTrack_shard(memAlloc);
+    memTrack_lock(shard);
+    memEntry = removeMemTableEntry(shard, memAlloc);
     if (memEntry) {
       if (chpl_verbose_mem) {
         fprintf(memLogFile, "%" FORMAT_c_nodeid_t ": %s:%" PRId32
@@ -637,9 +852,9 @@ void chpl_track_free(void* memAlloc, int32_t lineno, int32_t filename) {
                 lineno, memEntry->number * memEntry->size,
                 chpl_mem_descString(memEntry->description), memAlloc);
       }
-      sys_free(memEntry);
+      freeMemTableEntry(shard, memEntry);
     }
-    memTrack_unlock();
+    memTrack_unlock(shard);
   } else if (chpl_verbose_mem && !memEntry) {
     fprintf(memLogFile, "%" FORMAT_c_nodeid_t ": %s:%" PRId32 ": free at %p\n",
             chpl_nodeID, (filename ? chpl_lookupFilename(filename) : "--"),
@@ -653,14 +868,13 @@ void chpl_track_realloc_pre(void* memAlloc, size_t size,
                          int32_t lineno, int32_t filename) {
   memTableEntry* memEntry = NULL;
 
-  if (chpl_memTrack && size > memThreshold) {
-    memTrack_lock();
-    if (memAlloc) {
-      memEntry = removeMemTableEntry(memAlloc);
-      if (memEntry)
-        sys_free(memEntry);
-    }
-    memTrack_unlock();
+  if (chpl_memTrack && size > memThreshold && memAlloc) {
+    memTableShard* shard = memTrack_shard(memAlloc);
+    memTrack_lock(shard);
+    memEntry = removeMemTableEntry(shard, memAlloc);
+    if (memEntry)
+      freeMemTableEntry(shard, memEntry);
+    memTrack_unlock(shard);
   }
 }
 
@@ -671,9 +885,13 @@ void chpl_track_realloc_post(void* moreMemAlloc,
                          int32_t lineno, int32_t filename) {
   if (size > memThreshold) {
     if (chpl_memTrack && chpl_mem_descTrack(description)) {
-      memTrack_lock();
-      addMemTableEntry(moreMemAlloc, 1, size, description, lineno, filename);
-      memTrack_unlock();
+      memTableShard* shard = memTrack_shard(moreMemAlloc);
+      if (sampleAlloc(shard, size)) {
+        memTrack_lock(shard);
+        addMemTableEntry(shard, moreMemAlloc, 1, size, description,
+                         lineno, filename);
+        memTrack_unlock(shard);
+      }
     }
     if (chpl_verbose_mem) {
       fprintf(memLogFile, "%" FORMAT_c_nodeid_t ": %s:%" PRId32
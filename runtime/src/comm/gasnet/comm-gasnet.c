@@ -229,6 +229,56 @@ typedef struct {
   size_t size; // number of bytes.
 } xfer_info_t;
 
+//
+// Network atomics.  GASNet has no remote atomic operations, so we do
+// them in an AM handler on the target node, using processor atomics.
+// The handler always replies, whether or not there is a result, so
+// that a remote AMO is complete when its initiator returns.
+//
+typedef enum {
+  amo_put_32,
+  amo_put_64,
+  amo_get_32,
+  amo_get_64,
+  amo_xchg_32,
+  amo_xchg_64,
+  amo_cmpxchg_32,
+  amo_cmpxchg_64,
+  amo_and_i32,
+  amo_and_i64,
+  amo_or_i32,
+  amo_or_i64,
+  amo_xor_i32,
+  amo_xor_i64,
+  amo_add_i32,
+  amo_add_i64,
+  amo_add_r32,
+  amo_add_r64
+} amo_cmd_t;
+
+typedef union {
+  int_least32_t i32;
+  int_least64_t i64;
+  float         r32;
+  double        r64;
+} amo_data_t;
+
+typedef struct {
+  void*      ack;   // acknowledgement object, on the initiator
+  void*      res;   // result address, on the initiator (may be NULL)
+  void*      obj;   // target object, on the handler's node
+  amo_cmd_t  cmd;
+  amo_data_t opnd1;
+  amo_data_t opnd2;
+} amo_info_t;
+
+typedef struct {
+  void*      ack;   // acknowledgement object, on the initiator
+  void*      res;   // result address, on the initiator (may be NULL)
+  size_t     res_size;
+  amo_data_t res_val;
+} amo_reply_t;
+
 
 //
 // AM functions
@@ -252,7 +302,9 @@ typedef enum {
   SHUTDOWN,             // tell nodes to get ready for shutdown
   BCAST_SEGINFO,        // broadcast for segment info table
   DO_REPLY_PUT,         // do a PUT here from another locale
-  DO_COPY_PAYLOAD       // copy AM payload to another address
+  DO_COPY_PAYLOAD,      // copy AM payload to another address
+  AMO,                  // do an atomic operation here for another locale
+  AMO_REPLY             // return the result of an AMO to its initiator
 } AM_handler_function_idx_t;
 
 static void AM_fork_fast(gasnet_token_t token, void* buf, size_t nbytes) {
@@ -485,8 +537,8 @@ static void AM_fork_nb_large(gasnet_token_t token, void* buf, size_t nbytes) {
                            f->hdr.subloc, chpl_nullTaskID);
 }
 
-static void AM_signal(gasnet_token_t token, gasnet_handlerarg_t a0, gasnet_handlerarg_t a1) {
-  done_t* done = (done_t*) get_ptr_from_args(a0, a1);
+static inline
+void signal_done_obj(done_t* done) {
   uint_least32_t prev;
   prev = atomic_fetch_add_explicit_uint_least32_t(&done->count, 1,
                                                   memory_order_seq_cst);
@@ -494,14 +546,13 @@ static void AM_signal(gasnet_token_t token, gasnet_handlerarg_t a0, gasnet_handl
     done->flag = 1;
 }
 
+static void AM_signal(gasnet_token_t token, gasnet_handlerarg_t a0, gasnet_handlerarg_t a1) {
+  signal_done_obj((done_t*) get_ptr_from_args(a0, a1));
+}
+
 static void AM_signal_long(gasnet_token_t token, void *buf, size_t nbytes,
                            gasnet_handlerarg_t a0, gasnet_handlerarg_t a1) {
-  done_t* done = (done_t*) get_ptr_from_args(a0, a1);
-  uint_least32_t prev;
-  prev = atomic_fetch_add_explicit_uint_least32_t(&done->count, 1,
-                                                  memory_order_seq_cst);
-  if (prev + 1 == done->target)
-    done->flag = 1;
+  signal_done_obj((done_t*) get_ptr_from_args(a0, a1));
 }
 
 static void AM_priv_bcast(gasnet_token_t token, void* buf, size_t nbytes) {
@@ -588,6 +639,180 @@ void AM_copy_payload(gasnet_token_t token, void* buf, size_t nbytes,
   GASNET_Safe(gasnet_AMReplyShort2(token, SIGNAL, ack0, ack1));
 }
 
+//
+// Do an atomic operation on the processor.  The result, if there is
+// one and res is non-NULL, is stored in *res and its size returned.
+//
+static
+size_t do_amo_on_cpu(amo_cmd_t cmd, void* res,
+                     void* obj, void* opnd1, void* opnd2) {
+  size_t res_size = 0;
+
+#define CPU_INT_ARITH_AMO(_o, _t)                                       \
+  do {                                                                  \
+    if (res == NULL) {                                                  \
+      (void) atomic_fetch_##_o##_##_t((atomic_##_t*) obj,               \
+                                      *(_t*) opnd1);                    \
+    } else {                                                            \
+      *(_t*) res = atomic_fetch_##_o##_##_t((atomic_##_t*) obj,         \
+                                            *(_t*) opnd1);              \
+      res_size = sizeof(_t);                                            \
+    }                                                                   \
+  } while (0)
+
+#define CPU_REAL_ADD_AMO(_r, _t)                                        \
+  do {                                                                  \
+    _t expected;                                                        \
+    _t desired;                                                         \
+    _r sum;                                                             \
+    chpl_bool32 done;                                                   \
+                                                                        \
+    do {                                                                \
+      expected = atomic_load_##_t((atomic_##_t*) obj);                  \
+      memcpy(&sum, &expected, sizeof(sum));                             \
+      sum += *(_r*) opnd1;                                              \
+      memcpy(&desired, &sum, sizeof(desired));                          \
+      done = atomic_compare_exchange_strong_##_t((atomic_##_t*) obj,    \
+                                                 expected, desired);    \
+    } while (!done);                                                    \
+                                                                        \
+    if (res != NULL) {                                                  \
+      memcpy(res, &expected, sizeof(expected));                         \
+      res_size = sizeof(expected);                                      \
+    }                                                                   \
+  } while (0)
+
+  switch (cmd) {
+  case amo_put_32:
+    atomic_store_int_least32_t((atomic_int_least32_t*) obj,
+                               *(int_least32_t*) opnd1);
+    break;
+
+  case amo_put_64:
+    atomic_store_int_least64_t((atomic_int_least64_t*) obj,
+                               *(int_least64_t*) opnd1);
+    break;
+
+  case amo_get_32:
+    *(int_least32_t*) res =
+      atomic_load_int_least32_t((atomic_int_least32_t*) obj);
+    res_size = sizeof(int_least32_t);
+    break;
+
+  case amo_get_64:
+    *(int_least64_t*) res =
+      atomic_load_int_least64_t((atomic_int_least64_t*) obj);
+    res_size = sizeof(int_least64_t);
+    break;
+
+  case amo_xchg_32:
+    *(int_least32_t*) res =
+      atomic_exchange_int_least32_t((atomic_int_least32_t*) obj,
+                                    *(int_least32_t*) opnd1);
+    res_size = sizeof(int_least32_t);
+    break;
+
+  case amo_xchg_64:
+    *(int_least64_t*) res =
+      atomic_exchange_int_least64_t((atomic_int_least64_t*) obj,
+                                    *(int_least64_t*) opnd1);
+    res_size = sizeof(int_least64_t);
+    break;
+
+  case amo_cmpxchg_32:
+    *(chpl_bool32*) res =
+      atomic_compare_exchange_strong_int_least32_t
+        ((atomic_int_least32_t*) obj,
+         *(int_least32_t*) opnd1, *(int_least32_t*) opnd2);
+    res_size = sizeof(chpl_bool32);
+    break;
+
+  case amo_cmpxchg_64:
+    *(chpl_bool32*) res =
+      atomic_compare_exchange_strong_int_least64_t
+        ((atomic_int_least64_t*) obj,
+         *(int_least64_t*) opnd1, *(int_least64_t*) opnd2);
+    res_size = sizeof(chpl_bool32);
+    break;
+
+  case amo_and_i32:
+    CPU_INT_ARITH_AMO(and, int_least32_t);
+    break;
+
+  case amo_and_i64:
+    CPU_INT_ARITH_AMO(and, int_least64_t);
+    break;
+
+  case amo_or_i32:
+    CPU_INT_ARITH_AMO(or, int_least32_t);
+    break;
+
+  case amo_or_i64:
+    CPU_INT_ARITH_AMO(or, int_least64_t);
+    break;
+
+  case amo_xor_i32:
+    CPU_INT_ARITH_AMO(xor, int_least32_t);
+    break;
+
+  case amo_xor_i64:
+    CPU_INT_ARITH_AMO(xor, int_least64_t);
+    break;
+
+  case amo_add_i32:
+    CPU_INT_ARITH_AMO(add, int_least32_t);
+    break;
+
+  case amo_add_i64:
+    CPU_INT_ARITH_AMO(add, int_least64_t);
+    break;
+
+  case amo_add_r32:
+    CPU_REAL_ADD_AMO(float, int_least32_t);
+    break;
+
+  case amo_add_r64:
+    CPU_REAL_ADD_AMO(double, int_least64_t);
+    break;
+
+  default:
+    chpl_internal_error("unsupported AMO command");
+  }
+
+  return res_size;
+
+#undef CPU_INT_ARITH_AMO
+#undef CPU_REAL_ADD_AMO
+}
+
+//
+// Do an atomic operation requested by another locale.  This runs in
+// the handler, which is safe because processor atomics never block.
+//
+static void AM_amo(gasnet_token_t token, void* buf, size_t nbytes) {
+  amo_info_t* a = buf;
+  amo_reply_t r;
+
+  assert(nbytes == sizeof(amo_info_t));
+
+  r.ack = a->ack;
+  r.res = a->res;
+  r.res_size = do_amo_on_cpu(a->cmd, (a->res == NULL) ? NULL : &r.res_val,
+                             a->obj, &a->opnd1, &a->opnd2);
+
+  GASNET_Safe(gasnet_AMReplyMedium0(token, AMO_REPLY, &r, sizeof(r)));
+}
+
+static void AM_amo_reply(gasnet_token_t token, void* buf, size_t nbytes) {
+  amo_reply_t* r = buf;
+
+  assert(nbytes == sizeof(amo_reply_t));
+
+  if (r->res != NULL)
+    memcpy(r->res, &r->res_val, r->res_size);
+  signal_done_obj((done_t*) r->ack);
+}
+
 static gasnet_handlerentry_t ftable[] = {
   {FORK,          AM_fork},
   {FORK_SMALL,    AM_fork_small},
@@ -606,7 +831,9 @@ static gasnet_handlerentry_t ftable[] = {
   {SHUTDOWN,      AM_shutdown},
   {BCAST_SEGINFO, AM_bcast_seginfo},
   {DO_REPLY_PUT,  AM_reply_put},
-  {DO_COPY_PAYLOAD, AM_copy_payload}
+  {DO_COPY_PAYLOAD, AM_copy_payload},
+  {AMO,           AM_amo},
+  {AMO_REPLY,     AM_amo_reply}
 };
 
 //
@@ -1592,6 +1819,131 @@ void  execute_on_common(c_nodeid_t node, c_sublocid_t subloc,
     wait_done_obj(&done);
 }
 
+//
+// Network atomics interface.  Operations on the calling node are done
+// directly on the processor, which is coherent with the handler-side
+// processor AMOs other nodes cause to be done here.
+//
+static
+void do_amo(amo_cmd_t cmd, void* res, c_nodeid_t node, void* obj,
+            void* opnd1, void* opnd2, size_t opnd_size,
+            int ln, int32_t fn) {
+  amo_info_t info;
+  done_t done;
+
+  if (node == chpl_nodeID) {
+    (void) do_amo_on_cpu(cmd, res, obj, opnd1, opnd2);
+    return;
+  }
+
+  if (chpl_verbose_comm && !chpl_comm_no_debug_private)
+    printf("%d: %s:%d: remote AMO on %d\n", chpl_nodeID,
+           chpl_lookupFilename(fn), ln, node);
+
+  init_done_obj(&done, 1);
+
+  info.ack = &done;
+  info.res = res;
+  info.obj = obj;
+  info.cmd = cmd;
+  if (opnd1 != NULL)
+    memcpy(&info.opnd1, opnd1, opnd_size);
+  if (opnd2 != NULL)
+    memcpy(&info.opnd2, opnd2, opnd_size);
+
+  GASNET_Safe(gasnet_AMRequestMedium0(node, AMO, &info, sizeof(info)));
+
+  wait_done_obj(&done);
+}
+
+#define DEFINE_CHPL_COMM_ATOMIC_PUT(_f, _c, _t)                         \
+  void chpl_comm_atomic_put_##_f                                        \
+         (void* desired, int32_t loc, void* obj,                        \
+          int ln, int32_t fn) {                                         \
+    do_amo(_c, NULL, loc, obj, desired, NULL, sizeof(_t), ln, fn);      \
+  }
+
+#define DEFINE_CHPL_COMM_ATOMIC_GET(_f, _c, _t)                         \
+  void chpl_comm_atomic_get_##_f                                        \
+         (void* result, int32_t loc, void* obj,                         \
+          int ln, int32_t fn) {                                         \
+    do_amo(_c, result, loc, obj, NULL, NULL, sizeof(_t), ln, fn);       \
+  }
+
+#define DEFINE_CHPL_COMM_ATOMIC_XCHG(_f, _c, _t)                        \
+  void chpl_comm_atomic_xchg_##_f                                       \
+         (void* desired, int32_t loc, void* obj, void* result,          \
+          int ln, int32_t fn) {                                         \
+    do_amo(_c, result, loc, obj, desired, NULL, sizeof(_t), ln, fn);    \
+  }
+
+#define DEFINE_CHPL_COMM_ATOMIC_CMPXCHG(_f, _c, _t)                     \
+  void chpl_comm_atomic_cmpxchg_##_f                                    \
+         (void* expected, void* desired, int32_t loc, void* obj,        \
+          chpl_bool32* result, int ln, int32_t fn) {                    \
+    do_amo(_c, result, loc, obj, expected, desired, sizeof(_t),         \
+           ln, fn);                                                     \
+  }
+
+#define DEFINE_CHPL_COMM_ATOMIC_BINARY(_o, _f, _c, _t)                  \
+  void chpl_comm_atomic_##_o##_##_f                                     \
+         (void* operand, int32_t loc, void* obj,                        \
+          int ln, int32_t fn) {                                         \
+    do_amo(_c, NULL, loc, obj, operand, NULL, sizeof(_t), ln, fn);      \
+  }                                                                     \
+  void chpl_comm_atomic_fetch_##_o##_##_f                               \
+         (void* operand, int32_t loc, void* obj, void* result,          \
+          int ln, int32_t fn) {                                         \
+    do_amo(_c, result, loc, obj, operand, NULL, sizeof(_t), ln, fn);    \
+  }
+
+//
+// Subtraction is addition of the negated operand.
+//
+#define DEFINE_CHPL_COMM_ATOMIC_SUB(_f, _c, _t)                         \
+  void chpl_comm_atomic_sub_##_f                                        \
+         (void* operand, int32_t loc, void* obj,                        \
+          int ln, int32_t fn) {                                         \
+    _t nopnd = -*(_t*) operand;                                         \
+    do_amo(_c, NULL, loc, obj, &nopnd, NULL, sizeof(_t), ln, fn);       \
+  }                                                                     \
+  void chpl_comm_atomic_fetch_sub_##_f                                  \
+         (void* operand, int32_t loc, void* obj, void* result,          \
+          int ln, int32_t fn) {                                         \
+    _t nopnd = -*(_t*) operand;                                         \
+    do_amo(_c, result, loc, obj, &nopnd, NULL, sizeof(_t), ln, fn);     \
+  }
+
+#define DEFINE_CHPL_COMM_ATOMIC_ALL_TYPES(_f, _s, _a, _t)               \
+  DEFINE_CHPL_COMM_ATOMIC_PUT(_f, amo_put_##_s, _t)                     \
+  DEFINE_CHPL_COMM_ATOMIC_GET(_f, amo_get_##_s, _t)                     \
+  DEFINE_CHPL_COMM_ATOMIC_XCHG(_f, amo_xchg_##_s, _t)                   \
+  DEFINE_CHPL_COMM_ATOMIC_CMPXCHG(_f, amo_cmpxchg_##_s, _t)             \
+  DEFINE_CHPL_COMM_ATOMIC_BINARY(add, _f, amo_add_##_a, _t)             \
+  DEFINE_CHPL_COMM_ATOMIC_SUB(_f, amo_add_##_a, _t)
+
+#define DEFINE_CHPL_COMM_ATOMIC_INT_TYPES(_f, _s, _t)                   \
+  DEFINE_CHPL_COMM_ATOMIC_ALL_TYPES(_f, _s, i##_s, _t)                  \
+  DEFINE_CHPL_COMM_ATOMIC_BINARY(and, _f, amo_and_i##_s, _t)            \
+  DEFINE_CHPL_COMM_ATOMIC_BINARY(or, _f, amo_or_i##_s, _t)              \
+  DEFINE_CHPL_COMM_ATOMIC_BINARY(xor, _f, amo_xor_i##_s, _t)
+
+DEFINE_CHPL_COMM_ATOMIC_INT_TYPES(int32, 32, int32_t)
+DEFINE_CHPL_COMM_ATOMIC_INT_TYPES(int64, 64, int64_t)
+DEFINE_CHPL_COMM_ATOMIC_INT_TYPES(uint32, 32, uint32_t)
+DEFINE_CHPL_COMM_ATOMIC_INT_TYPES(uint64, 64, uint64_t)
+DEFINE_CHPL_COMM_ATOMIC_ALL_TYPES(real32, 32, r32, float)
+DEFINE_CHPL_COMM_ATOMIC_ALL_TYPES(real64, 64, r64, double)
+
+#undef DEFINE_CHPL_COMM_ATOMIC_PUT
+#undef DEFINE_CHPL_COMM_ATOMIC_GET
+#undef DEFINE_CHPL_COMM_ATOMIC_XCHG
+#undef DEFINE_CHPL_COMM_ATOMIC_CMPXCHG
+#undef DEFINE_CHPL_COMM_ATOMIC_BINARY
+#undef DEFINE_CHPL_COMM_ATOMIC_SUB
+#undef DEFINE_CHPL_COMM_ATOMIC_ALL_TYPES
+#undef DEFINE_CHPL_COMM_ATOMIC_INT_TYPES
+
 ////GASNET - introduce locale-int size
 ////GASNET - is caller in chpl_comm_on_bundle_t redundant? active message can determine this.
 void  chpl_comm_execute_on(c_nodeid_t node, c_sublocid_t subloc,
@@ -96,6 +96,7 @@ struct ofi_stuff {
 //
 
 void chpl_comm_ofi_put_get_init(struct ofi_stuff*);
+void chpl_comm_ofi_put_get_progress(void);
 
 //
 // Active Messages (executeOn)
@@ -42,22 +42,67 @@
 #include "comm-ofi-internal.h"
 
 static struct ofi_stuff* ofi = NULL;
+
+//
+// Each thread uses its own TX/RX context.  Indices are handed out
+// round-robin the first time a thread does a PUT or GET, so as long
+// as there are no more threads than contexts (the context counts are
+// based on the comm concurrency, which defaults to the number of
+// CPUs) no two threads share a context and there's no contention.
+// Using the task ID instead could put two threads on one context.
+//
+static atomic_uint_least32_t next_sep_index;
+static __thread int sep_index = -1;
+
 void chpl_comm_ofi_put_get_init(struct ofi_stuff* _ofi) {
   if (ofi == NULL) {
     ofi = _ofi;
+    atomic_init_uint_least32_t(&next_sep_index, 0);
   } else {
     chpl_warning("ofi put/get already initialized.  Ignoring", 0, 0);
   }
 }
 
-static __thread int sep_index = -1;
 static inline int get_sep_index(int num_ctxs) {
   if (sep_index == -1) {
-    sep_index = chpl_task_getId() % num_ctxs;
+    sep_index = atomic_fetch_add_uint_least32_t(&next_sep_index, 1)
+                % num_ctxs;
   }
   return sep_index;
 }
 
+//
+// With FI_PROGRESS_MANUAL the provider only moves data for a context
+// when someone reads its CQ, so drain the calling thread's TX and RX
+// CQs.  There are no outstanding nb handles to retire yet (remote PUTs
+// and GETs aren't implemented), so the completions are just discarded.
+//
+static void drain_cq(struct fid_cq* cq) {
+  struct fi_cq_entry cqes[16];
+  struct fi_cq_err_entry cqerr = {0};
+  ssize_t num_read;
+
+  do {
+    num_read = fi_cq_read(cq, cqes, sizeof(cqes) / sizeof(cqes[0]));
+  } while (num_read > 0);
+
+  if (num_read == -FI_EAVAIL) {
+    (void) fi_cq_readerr(cq, &cqerr, 0);
+    chpl_internal_error(fi_strerror(cqerr.err));
+  } else if (num_read != -FI_EAGAIN) {
+    chpl_internal_error(fi_strerror(-num_read));
+  }
+}
+
+void chpl_comm_ofi_put_get_progress(void) {
+  if (ofi == NULL) {
+    return;
+  }
+
+  drain_cq(ofi->tx_cq[get_sep_index(ofi->num_tx_ctx)]);
+  drain_cq(ofi->rx_cq[get_sep_index(ofi->num_rx_ctx)]);
+}
+
 // Consider making the contexts and cqs thread local variables
 static inline struct fid_ep* get_rx_ep(void);
 static inline struct fid_ep* get_tx_ep(void);
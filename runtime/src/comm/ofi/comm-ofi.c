@@ -35,6 +35,7 @@
 
 // Don't get warning macros for chpl_comm_get etc
 #include "chpl-comm-no-warning-macros.h"
+#include "chpl-env.h"
 
 #include <pthread.h>
 #include <errno.h>
@@ -51,13 +52,16 @@
 // Progress thread support
 //
 
-// same as ofi.num_am_ctx, for now
-#define num_progress_threads 1
+// Each progress thread services its own AM receive context, so this
+// is the same as ofi.num_am_ctx.  It is set by the environment variable
+// CHPL_RT_COMM_OFI_NUM_PROGRESS_THREADS (default 1), and reduced if the
+// provider doesn't have enough endpoint contexts.
+static int num_progress_threads;
 struct progress_thread_info {
   int id;
 };
 
-static struct progress_thread_info pti[num_progress_threads];
+static struct progress_thread_info* pti;
 
 static void progress_thread(void *);
 
@@ -105,6 +109,7 @@ int chpl_comm_run_in_gdb(int argc, char* argv[], int gdbArgnum, int* status) {
 }
 
 static int get_comm_concurrency(void);
+static int get_num_progress_threads(void);
 static void libfabric_init(void);
 
 void chpl_comm_post_task_init(void) {
@@ -114,11 +119,17 @@ void chpl_comm_post_task_init(void) {
     // return;
   }
 
+  num_progress_threads = get_num_progress_threads();
   libfabric_init();
+  num_progress_threads = ofi.num_am_ctx;
   chpl_comm_ofi_put_get_init(&ofi);
   chpl_comm_ofi_am_init(&ofi);
 
   if (num_progress_threads > 0) {
+    pti = (struct progress_thread_info*)
+            chpl_mem_allocMany(num_progress_threads, sizeof(pti[0]),
+                               CHPL_RT_MD_COMM_PER_LOC_INFO, 0, 0);
+
     // Start progress thread(s).  Don't proceed from here until at
     // least one is running.
     CALL_CHECK_ZERO(pthread_mutex_lock(&progress_thread_entEx_cond_mutex));
@@ -174,6 +185,18 @@ static int get_comm_concurrency() {
   return 1;
 }
 
+static int get_num_progress_threads() {
+  int val;
+
+  val = (int) chpl_env_rt_get_int("COMM_OFI_NUM_PROGRESS_THREADS", 1);
+  if (val < 1) {
+    chpl_warning("CHPL_RT_COMM_OFI_NUM_PROGRESS_THREADS < 1, using 1", 0, 0);
+    val = 1;
+  }
+
+  return val;
+}
+
 static void libfabric_init_addrvec(int, int);
 
 static void libfabric_init() {
@@ -247,12 +270,26 @@ static void libfabric_init() {
 #endif
   }
 
-  ofi.num_am_ctx = 1; // Would we ever want more?
-
   max_tx_ctx = info->domain_attr->max_ep_tx_ctx;
   max_rx_ctx = info->domain_attr->max_ep_rx_ctx;
   comm_concurrency = get_comm_concurrency();
 
+  //
+  // One AM context per progress thread, but leave at least one of
+  // each kind of context for PUTs and GETs.
+  //
+  ofi.num_am_ctx = num_progress_threads;
+  if (ofi.num_am_ctx > max_tx_ctx - 1)
+    ofi.num_am_ctx = max_tx_ctx - 1;
+  if (ofi.num_am_ctx > max_rx_ctx - 1)
+    ofi.num_am_ctx = max_rx_ctx - 1;
+  if (ofi.num_am_ctx < num_progress_threads) {
+    if (ofi.num_am_ctx < 1)
+      chpl_internal_error("provider has too few endpoint contexts");
+    chpl_warning("not enough endpoint contexts for all requested "
+                 "progress threads, using fewer", 0, 0);
+  }
+
   ofi.num_tx_ctx = comm_concurrency+ofi.num_am_ctx > max_tx_ctx ?
     max_tx_ctx-ofi.num_am_ctx : comm_concurrency;
   ofi.num_rx_ctx = comm_concurrency+ofi.num_am_ctx > max_rx_ctx ?
@@ -527,6 +564,7 @@ static void exit_all(int status) {
   chpl_mem_free(ofi.am_tx_cq, 0, 0);
   chpl_mem_free(ofi.am_rx_ep, 0, 0);
   chpl_mem_free(ofi.am_rx_cq, 0, 0);
+  chpl_mem_free(pti, 0, 0);
 
   chpl_comm_ofi_oob_fini();
 
@@ -538,9 +576,15 @@ static void exit_any(int status) {
   // Should we tear down the progress thread?
 }
 
-int chpl_comm_numPollingTasks(void) { return 1; }
+int chpl_comm_numPollingTasks(void) { return num_progress_threads; }
 
-void chpl_comm_make_progress(void) { }
+//
+// The progress threads own the AM contexts, so a task asking for
+// progress only needs to push along its own PUT/GET contexts.
+//
+void chpl_comm_make_progress(void) {
+  chpl_comm_ofi_put_get_progress();
+}
 
 // In comm-ofi-am.c
 void chpl_comm_ofi_am_handler(struct fi_cq_data_entry* cqe);
@@ -410,6 +410,62 @@ error:
   return err;
 }
 
+static
+qioerr qio_file_pio_bytes(qio_file_t* file, int writing, void* ptr, int64_t len, int64_t offset)
+{
+  struct iovec iov;
+  ssize_t num_moved;
+  qioerr err = 0;
+
+  STARTING_SLOW_SYSCALL;
+
+  while( len > 0 ) {
+    iov.iov_base = ptr;
+    iov.iov_len = len;
+    num_moved = 0;
+
+    if (file->fd != -1) {
+      if( writing )
+        err = qio_int_to_err(sys_pwritev(file->fd, &iov, 1, offset, &num_moved));
+      else
+        err = qio_int_to_err(sys_preadv(file->fd, &iov, 1, offset, &num_moved));
+    } else if (file->fsfns) {
+      if( writing ) {
+        if( file->fsfns->pwritev ) {
+          err = file->fsfns->pwritev(file->file_info, &iov, 1, offset, &num_moved, file->fs_info);
+        } else QIO_GET_CONSTANT_ERROR(err, ENOSYS, "missing pwritev");
+      } else {
+        if( file->fsfns->preadv ) {
+          err = file->fsfns->preadv(file->file_info, &iov, 1, offset, &num_moved, file->fs_info);
+        } else QIO_GET_CONSTANT_ERROR(err, ENOSYS, "missing preadv");
+      }
+    } else {
+      QIO_GET_CONSTANT_ERROR(err, ENOSYS, "no fd or plugin");
+    }
+
+    if( !err && num_moved == 0 ) err = QIO_EEOF;
+    if( err ) break;
+
+    ptr = (char*) ptr + num_moved;
+    len -= num_moved;
+    offset += num_moved;
+  }
+
+  DONE_SLOW_SYSCALL;
+
+  return err;
+}
+
+qioerr qio_file_pread_bytes(qio_file_t* file, void* ptr, int64_t len, int64_t offset)
+{
+  return qio_file_pio_bytes(file, 0, ptr, len, offset);
+}
+
+qioerr qio_file_pwrite_bytes(qio_file_t* file, const void* ptr, int64_t len, int64_t offset)
+{
+  return qio_file_pio_bytes(file, 1, (void*) ptr, len, offset);
+}
+
 qioerr qio_recv(fd_t sockfd, qbuffer_t* buf, qbuffer_iter_t start, qbuffer_iter_t end, int flags,
               sys_sockaddr_t* src_addr_out, /* can be NULL */
               void* ancillary_out, socklen_t* ancillary_len_inout, /* can be NULL */
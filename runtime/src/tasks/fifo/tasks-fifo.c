@@ -25,11 +25,14 @@
 #include "chpl_rt_utils_static.h"
 #include "chplcgfns.h"
 #include "chpl-comm.h"
+#include "chpl-env.h"
 #include "chplexit.h"
 #include "chpl-locale-model.h"
 #include "chpl-mem.h"
+#include "chpl-mem-task-arena.h"
 #include "chpl-tasks.h"
 #include "chpl-tasks-callbacks-internal.h"
+#include "chpl-timer-wheel.h"
 #include "chpl-topo.h"
 #include "chpl-linefile-support.h"
 #include "error.h"
@@ -60,6 +63,8 @@ typedef struct task_pool_struct {
   task_pool_p      list_prev;
   task_pool_p      next;         // double-link pointers for pool
   task_pool_p      prev;
+  int              pool_idx;     // which pool we're in (see task_pools)
+  c_sublocid_t     numa_hint;    // NUMA placement hint for our children
 
   chpl_task_prvDataImpl_t chpl_data;
 
@@ -80,21 +85,36 @@ typedef struct lockReport {
 typedef struct {
   task_pool_p   ptask;
   lockReport_t* lockRprt;
+  int           numa_domain;     // NUMA domain we're pinned to, or -1
 } thread_private_data_t;
 
 
+//
+// The task pool is split into one FIFO queue per NUMA domain, for the
+// tasks that have been given a NUMA placement hint, plus a shared queue
+// for everything else.  A thread takes tasks from its own domain's
+// queue first, then from the shared queue, and only then from the
+// queues of other domains.  All queues are protected by threading_lock.
+//
+typedef struct {
+  volatile task_pool_p head;
+  volatile task_pool_p tail;
+} task_queue_t;
+
+
 static chpl_bool        initialized = false;
 
 static chpl_thread_mutex_t threading_lock;     // critical section lock
 static chpl_thread_mutex_t extra_task_lock;    // critical section lock
 static chpl_thread_mutex_t task_id_lock;       // critical section lock
 static chpl_thread_mutex_t task_list_lock;     // critical section lock
-static volatile task_pool_p
-                           task_pool_head;     // head of task pool
-static volatile task_pool_p
-                           task_pool_tail;     // tail of task pool
+static task_queue_t*       task_pools;         // per-NUMA-domain + shared
+static int                 num_numa_domains;   // number of per-domain pools
+static int                 shared_pool_idx;    // == num_numa_domains
+static chpl_bool           numa_placement;     // pin threads, honor hints?
+static int                 next_thread_domain; // for round-robin pinning
 
-static int                 queued_task_cnt;    // number of tasks in task pool
+static volatile int        queued_task_cnt;    // number of tasks in task pool
 static int64_t             extra_task_cnt;     // number of tasks being run by
                                                //   threads occupied already
 static int                 blocked_thread_cnt; // number of threads that
@@ -137,10 +157,13 @@ static void                    check_for_deadlock(void);
 static void                    thread_begin(void*);
 static void                    thread_end(void);
 static void                    maybe_add_thread(void);
+static int                     pool_idx_for_hint(c_sublocid_t);
+static task_pool_p             pick_task(int);
 static task_pool_p             add_to_task_pool(chpl_fn_int_t, chpl_fn_p,
                                                 chpl_task_bundle_t*, size_t,
                                                 chpl_bool, task_pool_p*,
-                                                chpl_bool, int, int32_t);
+                                                chpl_bool, c_sublocid_t,
+                                                int, int32_t);
 
 //
 // Condition variable methods
@@ -233,6 +256,53 @@ void chpl_sync_waitEmptyAndLock(chpl_sync_aux_t *s,
   sync_wait_and_lock(s, false, lineno, filename);
 }
 
+//
+// Timed waits always block on the condition variable, so that a waiter
+// that won't be woken for a long time isn't spinning all the while.
+// They don't participate in deadlock detection since they will return
+// eventually whether or not anyone fills or empties the variable.
+//
+static chpl_bool sync_wait_and_lock_timeout(chpl_sync_aux_t *s,
+                                            chpl_bool want_full,
+                                            double secs) {
+  struct timeval deadline;
+
+  gettimeofday(&deadline, NULL);
+  if (secs > 0) {
+    deadline.tv_usec += (suseconds_t) lround((secs - trunc(secs)) * 1.0e6);
+    if (deadline.tv_usec >= 1000000) {
+      deadline.tv_sec++;
+      deadline.tv_usec -= 1000000;
+    }
+    deadline.tv_sec += (time_t) trunc(secs);
+  }
+
+  chpl_thread_mutexLock(&s->lock);
+
+  while (s->is_full != want_full) {
+    if (chpl_thread_sync_suspend(s, &deadline)
+        && s->is_full != want_full) {
+      chpl_thread_mutexUnlock(&s->lock);
+      return false;
+    }
+  }
+
+  if (blockreport)
+    progress_cnt++;
+
+  return true;
+}
+
+chpl_bool chpl_sync_waitFullAndLockTimeout(chpl_sync_aux_t *s, double secs,
+                                           int32_t lineno, int32_t filename) {
+  return sync_wait_and_lock_timeout(s, true, secs);
+}
+
+chpl_bool chpl_sync_waitEmptyAndLockTimeout(chpl_sync_aux_t *s, double secs,
+                                            int32_t lineno, int32_t filename) {
+  return sync_wait_and_lock_timeout(s, false, secs);
+}
+
 static chpl_bool chpl_thread_sync_suspend(chpl_sync_aux_t *s,
                                    struct timeval *deadline) {
   chpl_thread_condvar_t* cond;
@@ -313,6 +383,8 @@ static void setup_main_thread_private_data(void)
   tp->ptask = (task_pool_p) chpl_mem_calloc(1, sizeof(task_pool_t),
                                             CHPL_RT_MD_TASK_POOL_DESC,
                                             0, 0);
+  tp->ptask->numa_hint = c_sublocid_any;
+  tp->numa_domain = -1;
 
   tp->ptask->bundle.is_executeOn    = false;
   tp->ptask->bundle.lineno          = 0;
@@ -337,7 +409,23 @@ void chpl_task_init(void) {
   blocked_thread_cnt = 0;
   idle_thread_cnt = 0;
   extra_task_cnt = 0;
-  task_pool_head = task_pool_tail = NULL;
+
+  //
+  // If CHPL_RT_NUMA_TASK_PLACEMENT is set and there is more than one
+  // NUMA domain, pin worker threads to domains round-robin and honor
+  // task placement hints.
+  //
+  num_numa_domains = chpl_topo_getNumNumaDomains();
+  numa_placement = (num_numa_domains > 1
+                    && chpl_env_rt_get_bool("NUMA_TASK_PLACEMENT", false));
+  if (!numa_placement)
+    num_numa_domains = 1;
+  shared_pool_idx = num_numa_domains;
+  next_thread_domain = 0;
+  task_pools = (task_queue_t*) chpl_mem_calloc(num_numa_domains + 1,
+                                               sizeof(task_queue_t),
+                                               CHPL_RT_MD_TASK_POOL_DESC,
+                                               0, 0);
 
   chpl_thread_init(thread_begin, thread_end);
 
@@ -501,6 +589,8 @@ static void comm_task_wrapper(void* arg) {
   tp->ptask = (task_pool_p) chpl_mem_calloc(1, sizeof(task_pool_t),
                                             CHPL_RT_MD_TASK_POOL_DESC,
                                             0, 0);
+  tp->ptask->numa_hint = c_sublocid_any;
+  tp->numa_domain = -1;
 
   tp->ptask->bundle.is_executeOn    = false;
   tp->ptask->bundle.lineno          = 0;
@@ -521,17 +611,19 @@ static void comm_task_wrapper(void* arg) {
 //
 static inline
 void enqueue_task(task_pool_p ptask, task_pool_p* p_task_list_head) {
+  task_queue_t* pool = &task_pools[ptask->pool_idx];
+
   queued_task_cnt++;
 
   //
   // Add to pool.
   //
-  if (task_pool_tail)
-    task_pool_tail->next = ptask;
+  if (pool->tail)
+    pool->tail->next = ptask;
   else
-    task_pool_head = ptask;
-  ptask->prev = task_pool_tail;
-  task_pool_tail = ptask;
+    pool->head = ptask;
+  ptask->prev = pool->tail;
+  pool->tail = ptask;
 
   //
   // Add to list, if any.
@@ -552,21 +644,23 @@ void enqueue_task(task_pool_p ptask, task_pool_p* p_task_list_head) {
 
 static inline
 void dequeue_task(task_pool_p ptask) {
+  task_queue_t* pool = &task_pools[ptask->pool_idx];
+
   assert(queued_task_cnt > 0);
   queued_task_cnt--;
 
   //
   // Remove from pool.
   //
-  if (ptask == task_pool_head) {
-    if ((task_pool_head = task_pool_head->next) == NULL)
-      task_pool_tail = NULL;
+  if (ptask == pool->head) {
+    if ((pool->head = pool->head->next) == NULL)
+      pool->tail = NULL;
     else
-      task_pool_head->prev = NULL;
+      pool->head->prev = NULL;
   }
   else {
     if ((ptask->prev->next = ptask->next) == NULL)
-      task_pool_tail = ptask->prev;
+      pool->tail = ptask->prev;
     else
       ptask->next->prev = ptask->prev;
   }
@@ -601,7 +695,8 @@ void chpl_task_addToTaskList(chpl_fn_int_t fid,
   if (task_list_locale == chpl_nodeID) {
     (void) add_to_task_pool(fid, chpl_ftable[fid], arg, arg_size,
                             false, (task_pool_p*) p_task_list_void,
-                            is_begin_stmt, lineno, filename);
+                            is_begin_stmt, get_current_ptask()->numa_hint,
+                            lineno, filename);
 
   }
   else {
@@ -612,7 +707,43 @@ void chpl_task_addToTaskList(chpl_fn_int_t fid,
     //
     assert(is_begin_stmt);
     (void) add_to_task_pool(fid, chpl_ftable[fid], arg, arg_size,
-                            false, NULL, true, 0, CHPL_FILE_IDX_UNKNOWN);
+                            false, NULL, true, c_sublocid_any,
+                            0, CHPL_FILE_IDX_UNKNOWN);
+  }
+
+  // end critical section
+  chpl_thread_mutexUnlock(&threading_lock);
+}
+
+
+void chpl_task_addTeamToTaskList(chpl_fn_int_t fid,
+                                 chpl_task_bundle_t* arg, size_t arg_size,
+                                 int64_t num_tasks,
+                                 c_sublocid_t subloc,
+                                 void** p_task_list_void,
+                                 int32_t task_list_locale,
+                                 int lineno,
+                                 int32_t filename) {
+  chpl_fn_p fp = chpl_ftable[fid];
+  c_sublocid_t numa_hint;
+  int64_t i;
+
+  assert(subloc == c_sublocid_any);
+  assert(task_list_locale == chpl_nodeID);
+
+  if (num_tasks <= 0)
+    return;
+
+  numa_hint = get_current_ptask()->numa_hint;
+
+  // begin critical section; the whole team goes in under one acquisition
+  chpl_thread_mutexLock(&threading_lock);
+
+  for (i = 0; i < num_tasks; i++) {
+    arg->team_index = i;
+    (void) add_to_task_pool(fid, fp, arg, arg_size,
+                            false, (task_pool_p*) p_task_list_void,
+                            false, numa_hint, lineno, filename);
   }
 
   // end critical section
@@ -624,19 +755,40 @@ void chpl_task_executeTasksInList(void** p_task_list_void) {
   task_pool_p* p_task_list_head = (task_pool_p*) p_task_list_void;
   task_pool_p curr_ptask;
   task_pool_p child_ptask;
+  int my_pool_idx;
 
   // Note: this function needs to tolerate an empty task
   // list. That will happen for coforalls inside a serial block, say.
 
   curr_ptask = get_current_ptask();
+  my_pool_idx = get_thread_private_data()->numa_domain;
+  if (my_pool_idx < 0)
+    my_pool_idx = shared_pool_idx;
 
   while (*p_task_list_head != NULL) {
     chpl_fn_p task_to_run_fun = NULL;
+    chpl_bool leftForOthers = false;
 
     // begin critical section
     chpl_thread_mutexLock(&threading_lock);
 
-    if ((child_ptask = *p_task_list_head) != NULL) {
+    //
+    // Run the tasks placed on our NUMA domain (or not placed at all)
+    // ourselves.  Leave those placed on other domains for the threads
+    // pinned there, as long as there are enough idle threads to pick
+    // up everything that's queued.
+    //
+    for (child_ptask = *p_task_list_head;
+         child_ptask != NULL;
+         child_ptask = child_ptask->list_next) {
+      if (child_ptask->pool_idx == my_pool_idx
+          || child_ptask->pool_idx == shared_pool_idx
+          || queued_task_cnt > idle_thread_cnt)
+        break;
+      leftForOthers = true;
+    }
+
+    if (child_ptask != NULL) {
       task_to_run_fun = child_ptask->bundle.requested_fn;
       dequeue_task(child_ptask);
     }
@@ -644,8 +796,11 @@ void chpl_task_executeTasksInList(void** p_task_list_void) {
     // end critical section
     chpl_thread_mutexUnlock(&threading_lock);
 
-    if (task_to_run_fun == NULL)
+    if (task_to_run_fun == NULL) {
+      if (leftForOthers)
+        break;
       continue;
+    }
 
     set_current_ptask(child_ptask);
 
@@ -676,6 +831,8 @@ void chpl_task_executeTasksInList(void** p_task_list_void) {
 
     (*task_to_run_fun)(&child_ptask->bundle);
 
+    chpl_mem_task_release();
+
     chpl_task_do_callbacks(chpl_task_cb_event_kind_end,
                            child_ptask->bundle.requested_fid,
                            child_ptask->bundle.filename,
@@ -722,7 +879,7 @@ void taskCallBody(chpl_fn_int_t fid, chpl_fn_p fp,
   chpl_thread_mutexLock(&threading_lock);
 
   (void) add_to_task_pool(fid, fp, arg, arg_size, true,
-                          NULL, false, lineno, filename);
+                          NULL, false, c_sublocid_any, lineno, filename);
 
   // end critical section
   chpl_thread_mutexUnlock(&threading_lock);
@@ -787,28 +944,17 @@ void chpl_task_yield(void) {
 }
 
 
+//
+// A fifo task owns its thread, so a sleeping task simply blocks its
+// thread until the timer wheel wakes it, rather than yield-polling the
+// clock.
+//
 void chpl_task_sleep(double secs) {
-  struct timeval deadline;
-  struct timeval now;
-
-  //
-  // Figure out when this task can proceed again, and until then, keep
-  // yielding.
-  //
-  gettimeofday(&deadline, NULL);
-  deadline.tv_usec += (suseconds_t) lround((secs - trunc(secs)) * 1.0e6);
-  if (deadline.tv_usec > 1000000) {
-    deadline.tv_sec++;
-    deadline.tv_usec -= 1000000;
-  }
-  deadline.tv_sec += (time_t) trunc(secs);
-
-  do {
+  if (secs <= 0) {
     chpl_task_yield();
-    gettimeofday(&now, NULL);
-  } while (now.tv_sec < deadline.tv_sec
-           || (now.tv_sec == deadline.tv_sec
-               && now.tv_usec < deadline.tv_usec));
+    return;
+  }
+  chpl_timer_wheel_sleep(secs);
 }
 
 uint32_t chpl_task_getMaxPar(void) {
@@ -846,6 +992,16 @@ size_t chpl_task_getCallStackSize(void) {
   return chpl_thread_getCallStackSize();
 }
 
+int32_t chpl_task_getNumNumaDomains(void) {
+  return num_numa_domains;
+}
+
+void chpl_task_setNumaHint(c_sublocid_t numa_hint) {
+  task_pool_p ptask = get_current_ptask();
+  if (ptask)
+    ptask->numa_hint = numa_hint;
+}
+
 uint32_t chpl_task_getNumQueuedTasks(void) {
   return queued_task_cnt;
 }
@@ -952,17 +1108,21 @@ static void report_locked_threads(void) {
 // pending tasks and those that are running.
 //
 static void report_all_tasks(void) {
-  task_pool_p pendingTask = task_pool_head;
+  task_pool_p pendingTask;
+  int i;
 
   printf("Task report\n");
   printf("--------------------------------\n");
 
   // print out pending tasks
   printf("Pending tasks:\n");
-  while (pendingTask != NULL) {
-    printf("- %s:%d\n", chpl_lookupFilename(pendingTask->bundle.filename),
-           pendingTask->bundle.lineno);
-    pendingTask = pendingTask->next;
+  for (i = 0; i <= shared_pool_idx; i++) {
+    pendingTask = task_pools[i].head;
+    while (pendingTask != NULL) {
+      printf("- %s:%d\n", chpl_lookupFilename(pendingTask->bundle.filename),
+             pendingTask->bundle.lineno);
+      pendingTask = pendingTask->next;
+    }
   }
   printf("\n");
 
@@ -1128,6 +1288,21 @@ thread_begin(void* ptask_void) {
   if (blockreport)
     initializeLockReportForThread();
 
+  //
+  // Spread the worker threads across the NUMA domains round-robin, and
+  // pin each one to its domain.
+  //
+  if (numa_placement) {
+    chpl_thread_mutexLock(&threading_lock);
+    tp->numa_domain = next_thread_domain;
+    next_thread_domain = (next_thread_domain + 1) % num_numa_domains;
+    chpl_thread_mutexUnlock(&threading_lock);
+    chpl_topo_setThreadLocality(tp->numa_domain);
+  }
+  else {
+    tp->numa_domain = -1;
+  }
+
   while (true) {
     //
     // wait for a task to be present in the task pool
@@ -1143,28 +1318,30 @@ thread_begin(void* ptask_void) {
     // that were waiting on the signal, but since there was a performance
     // impact from keeping it as a hybrid as opposed to merely yielding,
     // it was decided that we would return to the simple yield case.
-    while (!task_pool_head) {
+    while (queued_task_cnt == 0) {
       if (set_block_loc(0, CHPL_FILE_IDX_IDLE_TASK)) {
         // all other tasks appear to be blocked
         struct timeval deadline, now;
         gettimeofday(&deadline, NULL);
         deadline.tv_sec += 1;
         do {
+          chpl_timer_wheel_poll();
           chpl_thread_yield();
-          if (!task_pool_head)
+          if (queued_task_cnt == 0)
             gettimeofday(&now, NULL);
-        } while (!task_pool_head
+        } while (queued_task_cnt == 0
                  && (now.tv_sec < deadline.tv_sec
                      || (now.tv_sec == deadline.tv_sec
                          && now.tv_usec < deadline.tv_usec)));
-        if (!task_pool_head) {
+        if (queued_task_cnt == 0) {
           check_for_deadlock();
         }
       }
       else {
         do {
+          chpl_timer_wheel_poll();
           chpl_thread_yield();
-        } while (!task_pool_head);
+        } while (queued_task_cnt == 0);
       }
 
       unset_block_loc();
@@ -1175,7 +1352,7 @@ thread_begin(void* ptask_void) {
     // there's something still there.
     //
     chpl_thread_mutexLock(&threading_lock);
-    if (!task_pool_head) {
+    if (queued_task_cnt == 0) {
       chpl_thread_mutexUnlock(&threading_lock);
       continue;
     }
@@ -1192,7 +1369,7 @@ thread_begin(void* ptask_void) {
     // (structure in ChapelRuntime that keeps track of currently running tasks
     // for task-reports on deadlock or Ctrl+C).
     //
-    ptask = task_pool_head;
+    ptask = pick_task(tp->numa_domain);
     idle_thread_cnt--;
 
     dequeue_task(ptask);
@@ -1217,6 +1394,8 @@ thread_begin(void* ptask_void) {
 
     (ptask->bundle.requested_fn)(&ptask->bundle);
 
+    chpl_mem_task_release();
+
     chpl_task_do_callbacks(chpl_task_cb_event_kind_end,
                            ptask->bundle.requested_fid,
                            ptask->bundle.filename,
@@ -1297,6 +1476,43 @@ static void maybe_add_thread(void) {
 }
 
 
+//
+// Which pool a task with the given NUMA placement hint goes into.
+//
+static inline
+int pool_idx_for_hint(c_sublocid_t numa_hint) {
+  if (!numa_placement || numa_hint < 0)
+    return shared_pool_idx;
+  return numa_hint % num_numa_domains;
+}
+
+
+//
+// Find the task a thread pinned to the given NUMA domain (or -1, if
+// it isn't pinned) should run next: the oldest one placed on its own
+// domain, else the oldest unplaced one, else one placed elsewhere.
+// assumes threading_lock has already been acquired and that the pool
+// is not empty!
+//
+static inline
+task_pool_p pick_task(int numa_domain) {
+  int i;
+
+  if (numa_domain >= 0 && task_pools[numa_domain].head != NULL)
+    return task_pools[numa_domain].head;
+  if (task_pools[shared_pool_idx].head != NULL)
+    return task_pools[shared_pool_idx].head;
+  for (i = 1; i <= num_numa_domains; i++) {
+    int d = (numa_domain + i) % num_numa_domains;
+    if (task_pools[d].head != NULL)
+      return task_pools[d].head;
+  }
+
+  assert(false);
+  return NULL;
+}
+
+
 // create a task from the given function pointer and arguments
 // and append it to the end of the task pool
 // assumes threading_lock has already been acquired!
@@ -1306,6 +1522,7 @@ task_pool_p add_to_task_pool(chpl_fn_int_t fid, chpl_fn_p fp,
                              chpl_bool is_executeOn,
                              task_pool_p* p_task_list_head,
                              chpl_bool is_begin_stmt,
+                             c_sublocid_t numa_hint,
                              int lineno, int32_t filename) {
 
 
@@ -1329,6 +1546,8 @@ task_pool_p add_to_task_pool(chpl_fn_int_t fid, chpl_fn_p fp,
   ptask->list_prev              = NULL;
   ptask->next                   = NULL;
   ptask->prev                   = NULL;
+  ptask->pool_idx               = pool_idx_for_hint(numa_hint);
+  ptask->numa_hint              = c_sublocid_any;
   ptask->chpl_data              = pv;
   ptask->bundle.is_executeOn    = is_executeOn;
   ptask->bundle.lineno          = lineno;
@@ -304,6 +304,16 @@ void chpl_sync_waitEmptyAndLock(chpl_sync_aux_t * s,
   return_from_();
 }
 
+chpl_bool chpl_sync_waitFullAndLockTimeout(chpl_sync_aux_t * s, double secs,
+                                           int32_t lineno, int32_t filename) {
+  return chpl_sync_pollAndLockTimeout(s, true, secs);
+}
+
+chpl_bool chpl_sync_waitEmptyAndLockTimeout(chpl_sync_aux_t * s, double secs,
+                                            int32_t lineno, int32_t filename) {
+  return chpl_sync_pollAndLockTimeout(s, false, secs);
+}
+
 void chpl_sync_markAndSignalFull(chpl_sync_aux_t * s) {
   enter_();
   myth_felock_mark_and_signal(s->felock, 1);
@@ -519,6 +529,26 @@ void chpl_task_addToTaskList(
   return_from_();
 }
 
+void chpl_task_addTeamToTaskList(
+         chpl_fn_int_t fid,      // function to call for each task
+         chpl_task_bundle_t* arg, size_t arg_size,
+         int64_t num_tasks,         // number of tasks in the team
+         c_sublocid_t subloc,       // desired sublocale
+         void** p_task_list_void,             // task list
+         c_nodeid_t task_list_locale,         // locale (node) where task list resides
+         int lineno,                // line at which function begins
+         int32_t filename) { // name of file containing function
+  int64_t i;
+  enter_();
+  for (i = 0; i < num_tasks; i++) {
+    arg->team_index = i;
+    myth_chpl_create(/* is_executeOn = */ false,
+                     lineno, filename,
+                     subloc, fid, get_next_task_id(), arg, arg_size);
+  }
+  return_from_();
+}
+
 void chpl_task_executeTasksInList(void** p_task_list_void) {
   enter_();
   return_from_();
@@ -716,6 +746,14 @@ c_sublocid_t chpl_task_getNumSublocales(void) {
   return 0;
 }
 
+int32_t chpl_task_getNumNumaDomains(void) {
+  return 1;
+}
+
+void chpl_task_setNumaHint(c_sublocid_t numa_hint) {
+  // nothing to do
+}
+
 //
 // returns the value of the call stack size limit being used in
 // practice; the value returned may potentially differ from one locale
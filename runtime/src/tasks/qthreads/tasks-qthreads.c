@@ -39,18 +39,20 @@
 #include "error.h"
 #include "chplcgfns.h"
 #include "chpl-comm.h"
+#include "chpl-env.h"
 #include "chplexit.h"
 #include "chpl-locale-model.h"
 #include "chpl-mem.h"
+#include "chpl-mem-task-arena.h"
 #include "chplsys.h"
 #include "chpl-linefile-support.h"
 #include "chpl-tasks.h"
 #include "chpl-tasks-callbacks-internal.h"
+#include "chpl-timer-wheel.h"
 #include "chpl-topo.h"
 #include "tasks-qthreads.h"
 
 #include "qthread.h"
-#include "qthread/qtimer.h"
 #include "qthread-chapel.h"
 
 #include <assert.h>
@@ -145,6 +147,15 @@ struct chpl_task_list {
 
 static aligned_t next_task_id = 1;
 
+//
+// NUMA placement of hinted tasks.  Qthreads binds its shepherds in
+// topology order, so the shepherds for NUMA domain d are the ones in
+// [d*num_sheps/num_numa_domains, (d+1)*num_sheps/num_numa_domains).
+// Hinted tasks are spread round-robin across those.
+//
+static int32_t num_numa_domains = 1;
+static aligned_t numa_next_shep = 0;
+
 pthread_t chpl_qthread_process_pthread;
 pthread_t chpl_qthread_comm_pthread;
 
@@ -168,11 +179,13 @@ chpl_task_bundle_t chpl_qthread_comm_task_bundle = {
 
 chpl_qthread_tls_t chpl_qthread_process_tls = {
                                .bundle = &chpl_qthread_process_bundle,
+                               .numa_hint = c_sublocid_any,
                                .lock_filename = 0,
                                .lock_lineno = 0 };
 
 chpl_qthread_tls_t chpl_qthread_comm_task_tls = {
                                .bundle = &chpl_qthread_comm_task_bundle,
+                               .numa_hint = c_sublocid_any,
                                .lock_filename = 0,
                                .lock_lineno = 0 };
 
@@ -273,6 +286,32 @@ void chpl_sync_waitEmptyAndLock(chpl_sync_aux_t *s,
     }
 }
 
+//
+// A timed waiter can't block on the shared signal syncvar, because a
+// wakeup forced at its deadline could be consumed by some other waiter
+// instead.  So it polls, parking itself on the timer wheel between
+// checks.
+//
+chpl_bool chpl_sync_waitFullAndLockTimeout(chpl_sync_aux_t *s,
+                                           double           secs,
+                                           int32_t          lineno,
+                                           int32_t         filename)
+{
+    PROFILE_INCR(profile_sync_waitFullAndLock, 1);
+
+    return chpl_sync_pollAndLockTimeout(s, true, secs);
+}
+
+chpl_bool chpl_sync_waitEmptyAndLockTimeout(chpl_sync_aux_t *s,
+                                            double           secs,
+                                            int32_t          lineno,
+                                            int32_t         filename)
+{
+    PROFILE_INCR(profile_sync_waitEmptyAndLock, 1);
+
+    return chpl_sync_pollAndLockTimeout(s, false, secs);
+}
+
 void chpl_sync_markAndSignalFull(chpl_sync_aux_t *s)         // and unlock
 {
     PROFILE_INCR(profile_sync_markAndSignalFull, 1);
@@ -723,6 +762,14 @@ void chpl_task_init(void)
     // the number of threads qthreads creates beforehand
     assert(0 == commMaxThreads || qthread_num_workers() < commMaxThreads);
 
+    // Place hinted tasks by NUMA domain only if that was asked for and
+    // each domain has at least one shepherd of its own.
+    num_numa_domains = chpl_topo_getNumNumaDomains();
+    if (num_numa_domains < 1
+        || num_numa_domains > (int32_t) qthread_num_shepherds()
+        || !chpl_env_rt_get_bool("NUMA_TASK_PLACEMENT", false))
+        num_numa_domains = 1;
+
     if (blockreport || taskreport) {
         if (signal(SIGINT, SIGINT_handler) == SIG_ERR) {
             perror("Could not register SIGINT handler");
@@ -777,7 +824,8 @@ static aligned_t main_wrapper(void *arg)
     chpl_qthread_tls_t         *tls = chpl_qthread_get_tasklocal();
     main_wrapper_bundle_t *m_bundle = (main_wrapper_bundle_t*) arg;
     chpl_task_bundle_t      *bundle = &m_bundle->arg;
-    chpl_qthread_tls_t         pv = {.bundle = bundle};
+    chpl_qthread_tls_t         pv = {.bundle = bundle,
+                                     .numa_hint = c_sublocid_any};
 
     *tls = pv;
 
@@ -785,6 +833,8 @@ static aligned_t main_wrapper(void *arg)
 
     (m_bundle->chpl_main)();
 
+    chpl_mem_task_release();
+
     wrap_callbacks(chpl_task_cb_event_kind_end, bundle);
 
     return 0;
@@ -795,7 +845,8 @@ static aligned_t chapel_wrapper(void *arg)
 {
     chpl_qthread_tls_t    *tls = chpl_qthread_get_tasklocal();
     chpl_task_bundle_t *bundle = (chpl_task_bundle_t*) arg;
-    chpl_qthread_tls_t      pv = {.bundle = bundle};
+    chpl_qthread_tls_t      pv = {.bundle = bundle,
+                                  .numa_hint = c_sublocid_any};
 
     *tls = pv;
 
@@ -803,6 +854,8 @@ static aligned_t chapel_wrapper(void *arg)
 
     (bundle->requested_fn)(arg);
 
+    chpl_mem_task_release();
+
     wrap_callbacks(chpl_task_cb_event_kind_end, bundle);
 
     return 0;
@@ -866,6 +919,17 @@ int chpl_task_createCommTask(chpl_fn_p fn,
                           NULL, comm_task_wrapper, &wrapper_info);
 }
 
+static inline c_sublocid_t numa_hint_to_shepherd(c_sublocid_t numa_hint)
+{
+    int32_t num_sheps = (int32_t) qthread_num_shepherds();
+    int32_t d = numa_hint % num_numa_domains;
+    int32_t lo = d * num_sheps / num_numa_domains;
+    int32_t hi = (d + 1) * num_sheps / num_numa_domains;
+
+    return (c_sublocid_t)
+           (lo + (int32_t) (qthread_incr(&numa_next_shep, 1) % (hi - lo)));
+}
+
 void chpl_task_addToTaskList(chpl_fn_int_t       fid,
                              chpl_task_bundle_t *arg,
                              size_t              arg_size,
@@ -895,6 +959,13 @@ void chpl_task_addToTaskList(chpl_fn_int_t       fid,
 
     wrap_callbacks(chpl_task_cb_event_kind_create, arg);
 
+    if (execution_subloc == c_sublocid_any && num_numa_domains > 1) {
+        chpl_qthread_tls_t *tls = chpl_qthread_get_tasklocal();
+        if (tls != NULL && tls->numa_hint >= 0) {
+            execution_subloc = numa_hint_to_shepherd(tls->numa_hint);
+        }
+    }
+
     if (execution_subloc == c_sublocid_any) {
         qthread_fork_copyargs(chapel_wrapper, arg, arg_size, NULL);
     } else {
@@ -903,6 +974,71 @@ void chpl_task_addToTaskList(chpl_fn_int_t       fid,
     }
 }
 
+void chpl_task_addTeamToTaskList(chpl_fn_int_t       fid,
+                                 chpl_task_bundle_t *arg,
+                                 size_t              arg_size,
+                                 int64_t             num_tasks,
+                                 c_sublocid_t        full_subloc,
+                                 void              **task_list,
+                                 int32_t             task_list_locale,
+                                 int                 lineno,
+                                 int32_t             filename)
+{
+    chpl_fn_p requested_fn = chpl_ftable[fid];
+    qthread_shepherd_id_t num_sheps = qthread_num_shepherds();
+    qthread_shepherd_id_t shep;
+    int64_t i;
+
+    assert(isActualSublocID(full_subloc) || full_subloc == c_sublocid_any);
+
+    PROFILE_INCR(profile_task_addToTaskList,num_tasks);
+
+    if (num_tasks <= 0)
+        return;
+
+    c_sublocid_t execution_subloc =
+      chpl_localeModel_sublocToExecutionSubloc(full_subloc);
+
+    if (execution_subloc == c_sublocid_any && num_numa_domains > 1) {
+        chpl_qthread_tls_t *tls = chpl_qthread_get_tasklocal();
+        if (tls != NULL && tls->numa_hint >= 0) {
+            execution_subloc = numa_hint_to_shepherd(tls->numa_hint);
+        }
+    }
+
+    // The header is the same for every task in the team; only the team
+    // index changes from one copy of the bundle to the next.
+    arg->is_executeOn      = false;
+    arg->requestedSubloc   = full_subloc;
+    arg->requested_fid     = fid;
+    arg->requested_fn      = requested_fn;
+    arg->lineno            = lineno;
+    arg->filename          = filename;
+    arg->id                = chpl_nullTaskID;
+
+    // Without a placement request, deal the team out round-robin over the
+    // shepherds starting with our own, rather than leaving each fork to
+    // pick a shepherd on its own.
+    if (execution_subloc == c_sublocid_any) {
+        shep = qthread_shep();
+        if (shep == NO_SHEPHERD)
+            shep = 0;
+    } else {
+        shep = (qthread_shepherd_id_t) execution_subloc;
+    }
+
+    for (i = 0; i < num_tasks; i++) {
+        arg->team_index = i;
+
+        wrap_callbacks(chpl_task_cb_event_kind_create, arg);
+
+        qthread_fork_copyargs_to(chapel_wrapper, arg, arg_size, NULL, shep);
+
+        if (execution_subloc == c_sublocid_any && ++shep == num_sheps)
+            shep = 0;
+    }
+}
+
 void chpl_task_executeTasksInList(void **task_list)
 {
     PROFILE_INCR(profile_task_executeTasksInList,1);
@@ -1009,38 +1145,39 @@ char* chpl_task_idToString(char* buff, size_t size, chpl_taskID_t id) {
     return NULL;
 }
 
-void chpl_task_sleep(double secs)
+typedef struct {
+    syncvar_t         wakeup;
+    volatile int      done;
+} sleeping_task_t;
+
+static void wake_sleeping_task(void *arg)
 {
-    if (qthread_shep() == NO_SHEPHERD) {
-        struct timeval deadline;
-        struct timeval now;
+    sleeping_task_t *st = (sleeping_task_t *) arg;
+
+    qthread_syncvar_fill(&st->wakeup);
+    st->done = 1;
+}
 
+void chpl_task_sleep(double secs)
+{
+    if (secs <= 0) {
+        chpl_task_yield();
+    } else if (qthread_shep() == NO_SHEPHERD) {
+        chpl_timer_wheel_sleep(secs);
+    } else {
         //
-        // Figure out when this task can proceed again, and until then, keep
-        // yielding.
+        // Park the task on a private syncvar, off the run queue, until
+        // the timer wheel fills it.  The fill may still be touching the
+        // syncvar after we have been woken, so wait for the wake function
+        // to finish before letting it go out of scope.
         //
-        gettimeofday(&deadline, NULL);
-        deadline.tv_usec += (suseconds_t) lround((secs - trunc(secs)) * 1.0e6);
-        if (deadline.tv_usec > 1000000) {
-            deadline.tv_sec++;
-            deadline.tv_usec -= 1000000;
-        }
-        deadline.tv_sec += (time_t) trunc(secs);
-
-        do {
-            chpl_task_yield();
-            gettimeofday(&now, NULL);
-        } while (now.tv_sec < deadline.tv_sec
-                 || (now.tv_sec == deadline.tv_sec
-                     && now.tv_usec < deadline.tv_usec));
-    } else {
-        qtimer_t t = qtimer_create();
-        qtimer_start(t);
-        do {
+        sleeping_task_t          st = { SYNCVAR_EMPTY_INITIALIZER, 0 };
+        chpl_timer_wheel_entry_t timer;
+
+        chpl_timer_wheel_add(&timer, secs, wake_sleeping_task, &st);
+        qthread_syncvar_readFE(NULL, &st.wakeup);
+        while (st.done == 0)
             qthread_yield();
-            qtimer_stop(t);
-        } while (qtimer_secs(t) < secs);
-        qtimer_destroy(t);
     }
 }
 
@@ -1054,6 +1191,19 @@ uint32_t chpl_task_getMaxPar(void) {
     return (uint32_t) qthread_num_workers();
 }
 
+int32_t chpl_task_getNumNumaDomains(void)
+{
+    return num_numa_domains;
+}
+
+void chpl_task_setNumaHint(c_sublocid_t numa_hint)
+{
+    chpl_qthread_tls_t *tls = chpl_qthread_get_tasklocal();
+
+    if (tls != NULL)
+        tls->numa_hint = numa_hint;
+}
+
 c_sublocid_t chpl_task_getNumSublocales(void)
 {
     // FIXME: What we really want here is the number of NUMA
@@ -0,0 +1,35 @@
+// With a single record buffer per locale, most of the task events are
+// dropped.  Check that the program still runs and that every event was
+// either written or counted as dropped.
+
+use VisualDebug;
+use FileSystem;
+
+config const numTasks = 2000;
+
+var x: atomic int;
+
+startVdebug("DROPvis");
+sync {
+  for i in 1..numTasks do
+    begin x.add(1);
+}
+stopVdebug();
+
+writeln("x = ", x.read());
+
+var written, dropped: int;
+{
+  var f = open("DROPvis/DROPvis-0.bin", iomode.r);
+  written = f.length() / 64;
+  f.close();
+  var r = open("DROPvis/DROPvis-0", iomode.r).reader();
+  for line in r.lines() do
+    if line.startsWith("Dropped: ") then
+      dropped = line[10..].strip(): int;
+  r.close();
+}
+writeln("dropped events: ", dropped > 0);
+writeln("all events accounted for: ", written + dropped >= 3 * numTasks);
+
+rmTree("DROPvis");
@@ -0,0 +1,45 @@
+// Privatize objects of different types with a single walk of the locale
+// tree, and check that each locale can find its copies by pid.
+
+class Counter {
+  var start: int;
+  var pid = -1;
+
+  proc dsiGetPrivatizeData() return start;
+
+  proc dsiPrivatize(privatizeData) {
+    return new unmanaged Counter(privatizeData + here.id);
+  }
+}
+
+class Label {
+  var name: string;
+  var pid = -1;
+
+  proc dsiGetPrivatizeData() return name;
+
+  proc dsiPrivatize(privatizeData) {
+    return new unmanaged Label(privatizeData + " on " + here.id);
+  }
+}
+
+var c = new unmanaged Counter(100);
+var l = new unmanaged Label("label");
+
+const (cpid, lpid) = _newPrivatizedClasses(c, l);
+
+writeln(c.pid == cpid, " ", l.pid == lpid, " ", lpid - cpid);
+
+for loc in Locales do on loc {
+  const myC = chpl_getPrivatizedCopy(c.type, cpid);
+  const myL = chpl_getPrivatizedCopy(l.type, lpid);
+
+  writeln(here.id, ": ", myC.start, " ", myL.name, " ",
+          myC.pid == cpid, " ", myL.pid == lpid);
+}
+
+_freePrivatizedClass(cpid, c);
+_freePrivatizedClass(lpid, l);
+
+delete c;
+delete l;
@@ -0,0 +1,43 @@
+use BlockDist;
+
+config const n = 100, m = 37;
+
+const fname = "parallel-binary.bin";
+
+// Row-major order of a local 2D array.
+{
+  var A: [1..n, 1..m] int = [(i,j) in {1..n, 1..m}] i*1000 + j;
+  writeBinary(fname, A);
+
+  var B: [0..#n*m] int;
+  readBinary(fname, B);
+  writeln("local 2D: ", && reduce [k in B.domain] B[k] == A[k/m+1, k%m+1]);
+}
+
+// A Block-distributed array round-trips through a local one.
+{
+  const D = {1..n, 1..m} dmapped Block({1..n, 1..m});
+  var A: [D] real = [(i,j) in D] i + j/100.0;
+  writeBinary(fname, A);
+
+  var L: [1..n, 1..m] real;
+  readBinary(fname, L);
+  writeln("block to local: ", && reduce (L == A));
+
+  var B: [D] real;
+  readBinary(fname, B, direct=true);
+  writeln("block to block: ", && reduce (B == A));
+}
+
+// Reading more than the file holds is an error.
+{
+  var C: [1..n*m+1] real;
+  try {
+    readBinary(fname, C);
+    writeln("short read not detected");
+  } catch e: SystemError {
+    writeln("short read: ", e.err == EEOF);
+  } catch {
+    writeln("unexpected error");
+  }
+}
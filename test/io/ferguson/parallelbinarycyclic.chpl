@@ -0,0 +1,54 @@
+use BlockDist, CyclicDist;
+
+config const n = 100, m = 37;
+
+const fname = "parallel-binary-cyclic.bin";
+
+// Cyclic local subdomains are strided; their elements must still land
+// at their row-major positions in the file.
+{
+  const D = {1..n, 1..m} dmapped Cyclic(startIdx=(1,1));
+  var A: [D] int = [(i,j) in D] i*1000 + j;
+  writeBinary(fname, A);
+
+  var L: [1..n, 1..m] int;
+  readBinary(fname, L);
+  writeln("cyclic to local: ", && reduce (L == A));
+
+  const BD = {1..n, 1..m} dmapped Block({1..n, 1..m});
+  var B: [BD] int;
+  readBinary(fname, B);
+  writeln("cyclic to block: ", && reduce (B == A));
+
+  var C: [D] int;
+  readBinary(fname, C, direct=true);
+  writeln("cyclic to cyclic: ", && reduce (C == A));
+}
+
+// Locales in a single column: the local subdomains are strided only in
+// their outer dimension, so their rows are still contiguous in the file.
+{
+  const targets = reshape(Locales, {0..#numLocales, 0..0});
+  const D = {1..n, 1..m} dmapped Cyclic(startIdx=(1,1), targetLocales=targets);
+  var A: [D] int = [(i,j) in D] i*1000 + j;
+  writeBinary(fname, A);
+
+  var L: [1..n, 1..m] int;
+  readBinary(fname, L);
+  writeln("column cyclic to local: ", && reduce (L == A));
+
+  var C: [D] int;
+  readBinary(fname, C);
+  writeln("column cyclic to cyclic: ", && reduce (C == A));
+}
+
+// 1D, with an index range that does not start at the cyclic start.
+{
+  const D = {3..n+2} dmapped Cyclic(startIdx=1);
+  var A: [D] real = [i in D] i / 4.0;
+  writeBinary(fname, A);
+
+  var L: [0..#n] real;
+  readBinary(fname, L);
+  writeln("cyclic 1D: ", && reduce [k in L.domain] L[k] == (k+3) / 4.0);
+}
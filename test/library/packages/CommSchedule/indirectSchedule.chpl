@@ -0,0 +1,55 @@
+use BlockDist, CyclicDist, CommSchedule;
+
+config const n = 10000;
+
+const D = {0..#n} dmapped Block({0..#n});
+
+// An index pattern with repeats and with most targets on another locale
+var Idx: [D] int;
+forall i in D do Idx[i] = (i * 7919) % (n / 2);
+
+var Y: [D] int;
+forall i in D do Y[i] = 2*i;
+
+var sched = new owned IndirectSchedule(Y, Idx);
+
+// Gather, repeated with changing data
+var X: [D] int;
+for it in 1..3 {
+  Y += 1;
+  sched.gather(X, Y);
+  writeln("gather ", it, ": ", && reduce [i in D] X[i] == Y[Idx[i]]);
+}
+
+// Scatter with duplicate targets: any one of the values may be stored
+var Z: [D] int = -1;
+sched.scatter(Z, Idx);
+writeln("scatter: ", && reduce [i in D] Z[Idx[i]] == Idx[i]);
+
+// Accumulating scatter
+var H: [D] int;
+var ones: [D] int = 1;
+sched.scatterAdd(H, ones);
+sched.scatterAdd(H, ones);
+writeln("scatterAdd: ", + reduce H == 2*n, " ", H[0] == 2 * (+ reduce (Idx == 0)));
+
+// Data distributed cyclically, indices in Block
+const C = {0..#n} dmapped Cyclic(startIdx=0);
+var W: [C] real;
+forall i in C do W[i] = i / 2.0;
+var csched = new owned IndirectSchedule(W, Idx);
+var R: [D] real;
+csched.gather(R, W);
+writeln("cyclic gather: ", && reduce [i in D] R[i] == Idx[i] / 2.0);
+
+// Indices distributed cyclically, so each locale's part is strided
+var CIdx: [C] int;
+forall i in C do CIdx[i] = (i * 7919) % (n / 2);
+var isched = new owned IndirectSchedule(Y, CIdx);
+var CX: [C] int;
+isched.gather(CX, Y);
+writeln("cyclic index gather: ", && reduce [i in C] CX[i] == Y[CIdx[i]]);
+var CH: [D] int;
+var cones: [C] int = 1;
+isched.scatterAdd(CH, cones);
+writeln("cyclic index scatterAdd: ", + reduce CH == n);
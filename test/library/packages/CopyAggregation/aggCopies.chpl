@@ -0,0 +1,42 @@
+// Copying an aggregator gives an empty aggregator with its own buffers,
+// so both can be used and deinitialized independently.
+
+use BlockDist, CopyAggregation;
+
+config const n = 100;
+
+const D = {0..#n} dmapped Block({0..#n});
+var A, B: [D] int;
+var H: [D] atomic int;
+
+proc useDst(in agg: DstAggregator(int), i: int) {
+  agg.copy(A[n-1-i], i);
+}
+
+{
+  var a1 = new DstAggregator(int);
+  for i in 0..#n/2 do a1.copy(A[n-1-i], i);
+  var a2 = a1;                            // copy after use
+  for i in n/2..n-1 do a2.copy(A[n-1-i], i);
+  useDst(a1, 0);
+}
+writeln(&& reduce [i in D] A[i] == n-1-i);
+
+{
+  // The destinations of a SrcAggregator must be local.
+  const myInds = D.localSubdomain(), mid = myInds.low + myInds.size/2;
+  var s1 = new SrcAggregator(int);
+  for i in myInds.low..mid-1 do s1.copy(B[i], A[n-1-i]);
+  var s2 = s1;
+  for i in mid..myInds.high do s2.copy(B[i], A[n-1-i]);
+}
+writeln(&& reduce [i in D.localSubdomain()] B[i] == i);
+
+{
+  var h1 = new AtomicAddAggregator(int);
+  for i in D do h1.add(H[i], 1);
+  var h2 = h1;
+  for i in D do h2.add(H[i], 2);
+  forall i in D with (in h1) do h1.add(H[i], 4);
+}
+writeln(&& reduce [i in D] H[i].read() == 7);
@@ -0,0 +1,47 @@
+use BlockDist, CopyAggregation;
+
+config const n = 10000;
+
+const D = {0..#n} dmapped Block({0..#n});
+
+// A permutation that sends most indices to another locale
+var idx: [D] int;
+forall i in D do idx[i] = (i * 7919) % n;
+
+// Scatter through a DstAggregator
+var A: [D] int;
+forall i in D with (var agg: DstAggregator(int)) do
+  agg.copy(A[idx[i]], i);
+
+var scatterOk = true;
+forall i in D with (&& reduce scatterOk) do
+  scatterOk &&= (A[idx[i]] == i);
+writeln("scatter: ", scatterOk);
+
+// Gather through a SrcAggregator
+var B: [D] int;
+forall i in D with (var agg: SrcAggregator(int)) do
+  agg.copy(B[i], A[idx[i]]);
+
+var gatherOk = true;
+forall i in D with (&& reduce gatherOk) do
+  gatherOk &&= (B[i] == i);
+writeln("gather: ", gatherOk);
+
+// Histogram through an AtomicAddAggregator
+var H: [D] atomic int;
+forall i in D with (var agg: AtomicAddAggregator(int)) do
+  agg.add(H[i % 10], 1);
+
+writeln("histogram: ", + reduce [i in 0..#10] H[i].read());
+
+// Explicit flushes with a small buffer size
+var C: [D] int;
+{
+  var agg = new DstAggregator(int, bufferSize=3);
+  for i in D {
+    agg.copy(C[idx[i]], i+1);
+    if i % 17 == 0 then agg.flush();
+  }
+}
+writeln("small buffers: ", + reduce C == (n * (n+1)) / 2);
@@ -0,0 +1,17 @@
+use Futures;
+
+config const n = 100;
+
+// Keep one remote call per element in flight from a single task.
+var F: [1..n] Future(int);
+for i in 1..n do
+  F[i] = asyncOn(Locales[i % numLocales],
+                 lambda(x: int) { return x * x + here.id; }, i);
+
+const first = waitAny(F);
+writeln(F[first].isReady()); // prints true
+
+var sum = 0;
+for f in F do
+  sum += f.get();
+writeln(sum == + reduce [i in 1..n] (i * i + i % numLocales));
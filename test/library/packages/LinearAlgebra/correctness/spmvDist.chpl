@@ -0,0 +1,41 @@
+use BlockDist, LayoutCS;
+use LinearAlgebra.Sparse;
+
+config const n = 1000;
+config type sparseLayoutType = DefaultDist;
+
+const ParentDom = {1..n, 1..n} dmapped Block({1..n, 1..n},
+    sparseLayoutType=sparseLayoutType);
+
+// Tridiagonal, plus a band of long-range couplings and some empty rows
+var SD: sparse subdomain(ParentDom);
+var inds: [1..0] 2*int;
+for i in 1..n {
+  if i % 10 == 0 then continue;
+  for j in max(1, i-1)..min(n, i+1) do inds.push_back((i, j));
+  inds.push_back((i, (i * 37) % n + 1));
+}
+SD.bulkAdd(inds, dataSorted=false, isUnique=false);
+
+var A: [SD] real;
+forall (i, j) in SD do A[i, j] = i + j;
+
+const VecDom = {1..n} dmapped Block({1..n});
+var X: [VecDom] real;
+forall i in VecDom do X[i] = (i % 7) - 3;
+
+// Reference product, computed serially
+var expected: [1..n] real;
+for (i, j) in SD do expected[i] += A[i, j] * X[j];
+
+var Y = dot(A, X);
+writeln("dot: ", && reduce [i in 1..n] Y[i] == expected[i]);
+
+// Repeated products through a plan, with changing values
+var spmv = new owned SpMVPlan(A, VecDom, VecDom);
+var Z: [VecDom] real = 42.0;
+A *= 2;
+spmv.multiply(Z, A, X);
+writeln("plan: ", && reduce [i in 1..n] Z[i] == 2 * expected[i]);
+spmv.multiply(Z, A, X);
+writeln("again: ", && reduce [i in 1..n] Z[i] == 2 * expected[i]);
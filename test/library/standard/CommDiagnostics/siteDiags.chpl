@@ -0,0 +1,22 @@
+use CommDiagnostics;
+
+var A: [1..10] int;
+
+startCommSiteDiagnostics();
+on Locales[numLocales-1] {
+  for i in 1..10 do
+    A[i] = i;
+  var sum = 0;
+  for i in 1..10 do
+    sum += A[i];
+  A[1] = sum;
+}
+stopCommSiteDiagnostics();
+
+printCommSiteDiagnostics();
+writeln(A);
+
+// Counting has stopped, so this adds nothing.
+on Locales[numLocales-1] do A[2] = 0;
+resetCommSiteDiagnostics();
+printCommSiteDiagnostics();
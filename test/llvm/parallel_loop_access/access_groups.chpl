@@ -0,0 +1,27 @@
+// Check that accesses in an order independent loop are put in an access
+// group, which the loop names in llvm.loop.parallel_accesses, and that
+// they still refer to the loop with llvm.mem.parallel_loop_access, which
+// is what LLVMs before 8 go by.  The loop id must have no other entries;
+// in particular no llvm.loop.vectorize.enable, which would make the loop
+// vectorizer override its cost model.
+proc loop (A, B, n) {
+  // CHECK-LABEL: void @loop
+  for i in vectorizeOnly(1..n) {
+    // CHECK: store {{.*}}!llvm.mem.parallel_loop_access ![[LOOP:[0-9]+]]
+    // CHECK-SAME: !llvm.access.group ![[GROUP:[0-9]+]]
+    A[i] = 3*B[i];
+  }
+  // CHECK: br {{.*}}!llvm.loop ![[LOOP]]
+}
+
+// CHECK-DAG: ![[LOOP]] = distinct !{![[LOOP]], ![[ACCESSES:[0-9]+]]}
+// CHECK-DAG: ![[ACCESSES]] = !{!"llvm.loop.parallel_accesses", ![[GROUP]]}
+// CHECK-DAG: ![[GROUP]] = distinct !{}
+
+config const n = 1000;
+
+var A : [1..n] int(32);
+var B : [1..n] int(32);
+
+loop(A, B, n);
+writeln("Sum of A is ", + reduce A);
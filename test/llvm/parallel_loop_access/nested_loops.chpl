@@ -0,0 +1,41 @@
+proc inner_body() {}
+
+// Check that accesses in an order independent loop nested in another one
+// refer to both loops, so that the outer loop stays parallel too.  Both
+// llvm.mem.parallel_loop_access and llvm.access.group name a list of the
+// outer loop's entry followed by the inner one's.
+proc loop (A, C, D, n) {
+  // CHECK-LABEL: void @loop
+  for i in vectorizeOnly(1..n) {
+    // CHECK: store {{.*}}!llvm.mem.parallel_loop_access ![[OUTERLOOP:[0-9]+]]
+    // CHECK-SAME: !llvm.access.group ![[OUTERGROUP:[0-9]+]]
+    A[i] = 3*i;
+    for j in vectorizeOnly(1..n) {
+      // CHECK: inner_body
+      inner_body();
+      // CHECK: store {{.*}}!llvm.mem.parallel_loop_access ![[LOOPS:[0-9]+]]
+      // CHECK-SAME: !llvm.access.group ![[GROUPS:[0-9]+]]
+      C[i,j] = 3*D[i,j];
+    }
+    // CHECK: br {{.*}}!llvm.loop ![[INNERLOOP:[0-9]+]]
+  }
+  // CHECK: br {{.*}}!llvm.loop ![[OUTERLOOP]]
+}
+
+// CHECK-DAG: ![[OUTERGROUP]] = distinct !{}
+// CHECK-DAG: ![[OUTERLOOP]] = distinct !{![[OUTERLOOP]], ![[OUTERACC:[0-9]+]]}
+// CHECK-DAG: ![[OUTERACC]] = !{!"llvm.loop.parallel_accesses", ![[OUTERGROUP]]}
+// CHECK-DAG: ![[INNERLOOP]] = distinct !{![[INNERLOOP]], ![[INNERACC:[0-9]+]]}
+// CHECK-DAG: ![[INNERACC]] = !{!"llvm.loop.parallel_accesses", ![[INNERGROUP:[0-9]+]]}
+// CHECK-DAG: ![[INNERGROUP]] = distinct !{}
+// CHECK-DAG: ![[LOOPS]] = !{![[OUTERLOOP]], ![[INNERLOOP]]}
+// CHECK-DAG: ![[GROUPS]] = !{![[OUTERGROUP]], ![[INNERGROUP]]}
+
+config const n = 100;
+
+var A : [1..n] int;
+var C : [1..n,1..n] int;
+var D : [1..n,1..n] int;
+
+loop(A, C, D, n);
+writeln("Sum of C is ", + reduce C);
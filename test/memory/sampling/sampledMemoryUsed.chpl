@@ -0,0 +1,19 @@
+// With --memSampleInterval, memoryUsed() is an estimate based on the
+// sampled allocations.  Check that it is close to the real amount.
+use Memory;
+
+config const n = 100000,
+             size = 48;
+
+var ptrs: [1..n] c_ptr(uint(8));
+
+const before = memoryUsed();
+for i in 1..n do
+  ptrs[i] = c_malloc(uint(8), size);
+
+const used = (memoryUsed() - before): real;
+const expected = (n * size): real;
+writeln(abs(used - expected) / expected < 0.05);
+
+for p in ptrs do
+  c_free(p);
@@ -0,0 +1,45 @@
+use CommDiagnostics;
+
+config const n = 100000;
+
+proc sum(const ref A: [] int) {
+  var s = 0;
+  for i in 1..n do s += A[i];
+  return s;
+}
+
+proc dot(const ref A: [] int, const ref B: [] int) {
+  var s = 0;
+  for i in 2..n do s += A[i-1] * B[i];
+  return s;
+}
+
+proc fill(ref A: [] int) {
+  for i in 1..n do A[i] = A[i] + 1;
+}
+
+proc report(name: string, result) {
+  const d = getCommDiagnostics()[0];
+  writeln(name, ": ", result, ", one GET per element: ", d.get >= n);
+}
+
+on Locales[numLocales-1] {
+  var A, B: [1..n] int = 1;
+
+  on Locales[0] {
+    resetCommDiagnostics();
+    startCommDiagnostics();
+    const s = sum(A);
+    stopCommDiagnostics();
+    report("sum", s);
+
+    resetCommDiagnostics();
+    startCommDiagnostics();
+    const d = dot(A, B);
+    stopCommDiagnostics();
+    report("dot", d);
+
+    fill(A);
+    writeln("after fill: ", sum(A));
+  }
+}
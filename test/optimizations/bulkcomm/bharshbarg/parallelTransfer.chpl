@@ -0,0 +1,41 @@
+//
+// Bulk transfers that are large enough to be split across several tasks.
+// The execopts lower bulkTransferParMinBytes so that small arrays are split
+// into many chunks.
+//
+
+proc check(name, A, B) {
+  writeln(name, ": ", if && reduce (A == B) then "OK" else "FAILED");
+}
+
+proc main() {
+  const n = 1000;
+
+  {
+    var A, B : [1..n] int;
+    B = [i in 1..n] i;
+    A = B;
+    check("contiguous", A, B);
+  }
+
+  {
+    var A : [1..n] real;
+    var B : [0..#2*n] real = [i in 0..#2*n] i;
+    A = B[n/2..#n];
+    check("slice", A, B[n/2..#n]);
+  }
+
+  {
+    var A, B : [1..50, 1..40] int;
+    B = [(i,j) in B.domain] i*100 + j;
+    A[1..50, 1..20] = B[1..50, 1..40 by 2];
+    check("strided", A[1..50, 1..20], B[1..50, 1..40 by 2]);
+  }
+
+  {
+    var A, B : [1..20, 1..30, 1..10] int;
+    B = [(i,j,k) in B.domain] (i*100 + j)*100 + k;
+    A[1..20 by 2, .., 1..5] = B[11..20, .., 6..10];
+    check("strided 3D", A[1..20 by 2, .., 1..5], B[11..20, .., 6..10]);
+  }
+}
@@ -0,0 +1,38 @@
+// Copies of a Shared that cannot outlive the original should not
+// update its reference count.
+class C { var x: int; }
+
+proc sum(const in s: Shared(C), n: int) {
+  var total = 0;
+  for i in 1..n {
+    const c = s;            // elided: s is the function's own copy
+    total += c.x;
+  }
+  return total;
+}
+
+proc main() {
+  var s = new Shared(new C(5));
+  var t: atomic int;
+
+  for i in 1..10 {
+    const c = s;            // elided
+    t.add(c.x);
+  }
+
+  coforall i in 1..4 do    // elided
+    t.add(s.x);
+
+  cobegin {                 // elided
+    t.add(s.x);
+    t.add(s.x);
+  }
+
+  var r = s;                // not elided: r is modified below
+  r = new Shared(new C(1));
+  t.add(r.x);
+
+  writeln(t.read());
+  writeln(sum(s, 3));
+  writeln(s.x);
+}
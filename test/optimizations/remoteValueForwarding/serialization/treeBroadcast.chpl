@@ -0,0 +1,26 @@
+// Global consts are broadcast down a tree of locales; make sure every
+// locale, including those more than one level down, gets its own copy.
+
+const s = "a string broadcast to every locale";
+
+record R {
+  var x : int;
+
+  proc chpl__serialize() {
+    return x;
+  }
+
+  proc type chpl__deserialize(data) {
+    return new R(data);
+  }
+}
+
+const r = new R(42);
+
+var ok : [LocaleSpace] bool;
+coforall loc in Locales do on loc {
+  ok[here.id] = s == "a string broadcast to every locale" &&
+                s.locale == here &&
+                r.x == 42;
+}
+writeln(&& reduce ok);
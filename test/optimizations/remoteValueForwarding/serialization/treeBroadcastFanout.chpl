@@ -0,0 +1,4 @@
+// The serialized-global broadcast tree needs a fanout of at least 1.
+
+const s = "a string broadcast to every locale";
+writeln(s);
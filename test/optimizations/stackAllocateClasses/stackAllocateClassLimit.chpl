@@ -0,0 +1,43 @@
+// Class instances over --stack-allocate-class-limit bytes stay on the
+// heap even when they don't escape.
+
+class Small {
+  var x, y: real;
+}
+
+class Large {
+  var a: 16*real;
+}
+
+// Small on its own, but the parent's fields count too.
+class Base {
+  var b: 7*real;
+}
+
+class LargeChild: Base {
+  var x, z: real;
+}
+
+proc useSmall(i: int) {
+  var c = new unmanaged Small(i, i);
+  const r = c.x + c.y;
+  delete c;
+  return r;
+}
+
+proc useLarge(i: int) {
+  var c = new unmanaged Large();
+  c.a(1) = i;
+  const r = c.a(1);
+  delete c;
+  return r;
+}
+
+proc useLargeChild(i: int) {
+  var c = new unmanaged LargeChild(x=i, z=i);
+  const r = c.x + c.z;
+  delete c;
+  return r;
+}
+
+writeln(useSmall(1), " ", useLarge(2), " ", useLargeChild(3));
@@ -0,0 +1,70 @@
+// Class instances that don't escape are allocated on the stack.
+
+class Point {
+  var x, y: real;
+  proc norm2() return x*x + y*y;
+}
+
+config const n = 10;
+
+// Deleted before returning: stack allocated.
+proc scratch(i: int) {
+  var p = new unmanaged Point(i, i+1);
+  const r = p.norm2();
+  delete p;
+  return r;
+}
+
+// Returned: heap allocated.
+proc make(i: int) {
+  return new unmanaged Point(i, i);
+}
+
+// Stored in a global: heap allocated.
+var saved: unmanaged Point;
+proc save(i: int) {
+  saved = new unmanaged Point(i, i);
+}
+
+// Kept past its loop iteration: heap allocated.
+proc keep() {
+  var last: unmanaged Point;
+  for i in 1..n {
+    var p = new unmanaged Point(i, i);
+    if i == 1 then last = p;
+  }
+  return last.x;
+}
+
+// Recursive iterators can't be inlined, so each level is an iterator
+// class.  The outermost one stays on the stack.
+iter tree(lo: int, hi: int): int {
+  if lo == hi {
+    yield lo;
+  } else {
+    const mid = (lo + hi) / 2;
+    for i in tree(lo, mid) do yield i;
+    for i in tree(mid+1, hi) do yield i;
+  }
+}
+
+proc sumTree(m: int) {
+  var s = 0;
+  for i in tree(1, m) do s += i;
+  return s;
+}
+
+var s = 0.0;
+for i in 1..n do s += scratch(i);
+writeln(s);
+
+const q = make(3);
+writeln(q.norm2());
+delete q;
+
+save(4);
+writeln(saved.norm2());
+delete saved;
+
+writeln(keep());
+writeln(sumTree(n));
@@ -0,0 +1,44 @@
+// Iterator classes allocated in per-task arenas (--task-arenas).
+
+config const n = 1000;
+
+// Recursive iterators can't be inlined, so each level gets a class.
+iter tree(lo: int, hi: int): int {
+  if hi - lo < 4 {
+    for i in lo..hi do yield i;
+  } else {
+    const mid = (lo + hi) / 2;
+    for i in tree(lo, mid) do yield i;
+    for i in tree(mid+1, hi) do yield i;
+  }
+}
+
+// Zippered loops free their iterators in an order that isn't LIFO.
+proc zipSum(m: int) {
+  var sum = 0;
+  for (i, j) in zip(tree(1, m), tree(m+1, 2*m)) do
+    sum += j - i;
+  return sum;
+}
+
+var total = 0;
+for i in tree(1, n) do total += i;
+writeln(total == n*(n+1)/2);
+
+// Enough work per task to need more than one chunk, were nothing
+// reclaimed.
+var sums: [0..#8] int;
+coforall t in 0..#8 with (ref sums) {
+  for r in 1..200 do
+    sums[t] += zipSum(r % 50 + 1);
+}
+writeln(+ reduce sums);
+
+// Tasks that outnumber the workers reuse their arenas after release.
+var counts: [1..100] int;
+forall k in 1..100 {
+  var c = 0;
+  for i in tree(1, k) do c += 1;
+  counts[k] = c;
+}
+writeln(&& reduce [k in 1..100] counts[k] == k);
@@ -0,0 +1,4 @@
+// massivethreads shares one private data block among all of its tasks,
+// so --task-arenas should be turned off there with a warning.
+
+writeln(CHPL_TASK_ARENAS);
@@ -0,0 +1,50 @@
+// Coforalls over bounded ranges are launched as a single task team.
+// Check that every task sees its own index, and that task intents and
+// nesting behave as they do for per-iteration task creation.
+
+config const n = 10;
+
+var hits: [1..3*n] atomic int;
+
+// strided and offset ranges
+coforall i in 1..3*n by 3 do hits[i].add(1);
+coforall i in 0..#n do hits[3*n-i].add(1);
+coforall i in 1..3*n by -7 do hits[i].add(1);
+
+var total = 0;
+for i in 1..3*n do total += hits[i].read();
+writeln("hits: ", total);
+
+// empty team
+coforall i in 1..0 do writeln("unreachable");
+writeln("empty team ok");
+
+// each task gets its own copy for 'in' intents
+var copies: atomic int;
+record R {
+  var x: int;
+  proc deinit() { copies.add(1); }
+}
+
+var r = new R(5);
+var sum: atomic int;
+coforall i in 1..4 with (in r) {
+  r.x += i;
+  sum.add(r.x);
+}
+writeln("in-intent sum: ", sum.read(), " copies: ", copies.read(), " r.x: ", r.x);
+
+// nested teams, and teams run in the parent when serial
+var grid: [1..3, 1..4] int;
+coforall i in 1..3 with (ref grid) do
+  coforall j in 1..4 with (ref grid) do
+    grid[i, j] = 10*i + j;
+writeln(grid);
+
+serial {
+  var s: [1..4] int;
+  coforall i in 1..4 with (ref s) do
+    coforall j in 1..2 with (ref s) do
+      s[i] += j;
+  writeln(s);
+}
@@ -0,0 +1,31 @@
+use AllLocalesBarriers;
+
+config const numTrips = 50;
+const numTasksPerLocale = 3;
+
+var arrived: [LocaleSpace] atomic int;
+var errors: atomic int;
+
+proc totalArrived() {
+  var total = 0;
+  for a in arrived do total += a.read();
+  return total;
+}
+
+allLocalesBarrier.reset(numTasksPerLocale);
+
+coforall loc in Locales do on loc {
+  coforall tid in 1..numTasksPerLocale {
+    for trip in 0..#numTrips {
+      arrived[here.id].add(1);
+      allLocalesBarrier.notify();
+      allLocalesBarrier.wait();
+      if totalArrived() < (trip+1)*numLocales*numTasksPerLocale then
+        errors.add(1);
+      allLocalesBarrier.barrier();
+    }
+  }
+}
+
+writeln("errors: ", errors.read());
+writeln("arrived: ", totalArrived() == numTrips*numLocales*numTasksPerLocale);
@@ -0,0 +1,32 @@
+use AllLocalesBarriers, BlockDist;
+
+// Each round every locale writes its slot, then checks that it sees
+// every other locale's write from the same round once the barrier is
+// done.  Then check the episode count and flags of the barrier itself.
+config const numRounds = 100;
+
+const Space = LocaleSpace dmapped Block(LocaleSpace);
+var A: [Space] int;
+
+coforall loc in Locales with (ref A) do on loc {
+  for round in 1..numRounds {
+    A[here.id] = round;
+    allLocalesBarrier.barrier();
+    for i in LocaleSpace do
+      if A[i] != round then
+        writeln("locale ", here.id, " round ", round,
+                ": saw ", A[i], " from locale ", i);
+    allLocalesBarrier.barrier();
+  }
+}
+
+for ex in allLocalesBarrier.exchanges do on ex {
+  if ex.episodes != 2 * numRounds then
+    writeln("locale ", here.id, ": ", ex.episodes, " episodes");
+  for r in 0..#ex.numRounds do
+    if ex.flags[r].a.read() != ex.episodes then
+      writeln("locale ", here.id, " round ", r, ": flag ",
+              ex.flags[r].a.read());
+}
+
+writeln("done");
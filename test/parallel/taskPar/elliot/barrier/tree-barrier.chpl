@@ -0,0 +1,40 @@
+use Barriers;
+
+// Exercise the combining tree with task counts that leave partially filled
+// leaves and interior nodes, reusing each barrier many times.
+config const numTrips = 200;
+
+proc testBarrier(numTasks: int) {
+  var b = new Barrier(numTasks);
+  var arrived: atomic int;
+  var errors: atomic int;
+  coforall tid in 0..#numTasks with (ref b) {
+    for trip in 0..#numTrips {
+      arrived.add(1);
+      b.barrier();
+      if arrived.read() != (trip+1)*numTasks then errors.add(1);
+      b.barrier();
+    }
+  }
+  writeln("barrier ", numTasks, ": ", errors.read(), " errors");
+}
+
+proc testSplitPhase(numTasks: int) {
+  var b = new Barrier(numTasks);
+  var arrived: atomic int;
+  var errors: atomic int;
+  coforall tid in 0..#numTasks with (ref b) {
+    for trip in 0..#numTrips {
+      arrived.add(1);
+      b.notify();
+      b.wait();
+      if arrived.read() < (trip+1)*numTasks then errors.add(1);
+    }
+  }
+  writeln("split-phase ", numTasks, ": ", errors.read(), " errors");
+}
+
+for n in [1, 3, 4, 5, 17, 70] {
+  testBarrier(n);
+  testSplitPhase(n);
+}
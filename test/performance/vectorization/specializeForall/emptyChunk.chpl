@@ -0,0 +1,22 @@
+// A specialized loop computes its trip count as 'end - lead', which
+// can overflow when a follower gets an empty chunk.  It must not run.
+config const lo = 100: int(8), hi = -100: int(8);
+
+var A, B: [-128:int(8)..127:int(8)] real;
+
+iter emptyChunk() {
+  yield 0;
+}
+
+iter emptyChunk(param tag: iterKind) where tag == iterKind.leader {
+  yield (lo..hi,);
+}
+
+iter emptyChunk(param tag: iterKind, followThis)
+    where tag == iterKind.follower {
+  for i in followThis(1) do yield i;
+}
+
+forall (i, a, b) in zip(emptyChunk(), A, B) do
+  a = b + 1.0;
+writeln(+ reduce A);
@@ -0,0 +1,32 @@
+config const n = 1000;
+const alpha = 3.0;
+
+var A, B, C: [1..n] real;
+B = 1.0;
+C = 2.0;
+
+// zippered follower over contiguous arrays
+forall (a, b, c) in zip(A, B, C) do
+  a = b + alpha*c;
+writeln(+ reduce A);
+
+// the index itself is used in the body
+forall i in 1..n with (ref A) do
+  A[i] = B[i] * i;
+writeln(+ reduce A);
+
+// arrays with different index sets
+var D: [0..#n] real;
+forall (d, a) in zip(D, A) do
+  d = a + 1.0;
+writeln(D[0], " ", D[n-1]);
+
+// aliased arrays
+forall (a1, a2) in zip(A, A) do
+  a1 = a2 * 2.0;
+writeln(+ reduce A);
+
+// strided loops are not specialized
+forall i in 1..n by 2 with (ref A) do
+  A[i] = 0.0;
+writeln(+ reduce A);
@@ -0,0 +1,39 @@
+// Large arrays whose memory is spread across NUMA domains, or not, must
+// hold the same values.  A is well over the 4 MiB placement threshold and
+// B is under it.  With localization on, the pages of A must also lie on
+// the NUMA domains in order, one contiguous block per domain.  Where the
+// topology layer cannot tell where a page lives, that check is skipped.
+
+config const localize = true;
+config const n = 1 << 20;
+
+// Normally set from CHPL_RT_LOCALIZE_ARRAYS at startup; set it here so that
+// both settings can be tested from a single program.
+extern var chpl_mem_array_localize: bool;
+chpl_mem_array_localize = localize;
+
+extern proc chpl_topo_getNumNumaDomains(): c_int;
+extern proc chpl_topo_getMemLocality(p: c_void_ptr): chpl_sublocID_t;
+extern const c_sublocid_any: chpl_sublocID_t;
+
+var A: [1..n] real;
+forall i in A.domain do A[i] = i;
+
+var B: [1..n] int(8);
+B = 1;
+
+writeln(+ reduce A == n * (n + 1) / 2.0);
+writeln(+ reduce (B: int) == n);
+
+// Look at the page in the middle of each domain's block of A.
+var placed = true;
+const numDomains = chpl_topo_getNumNumaDomains();
+if localize && numDomains > 1 {
+  for d in 0..#numDomains {
+    const i = 1 + (2 * d + 1) * n / (2 * numDomains);
+    const loc = chpl_topo_getMemLocality(c_ptrTo(A[i]):c_void_ptr);
+    if loc != c_sublocid_any && loc != d then
+      placed = false;
+  }
+}
+writeln(placed);
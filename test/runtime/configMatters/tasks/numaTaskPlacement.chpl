@@ -0,0 +1,31 @@
+// Foralls, reductions and bulk copies over local arrays must give the
+// same results whether or not the tasking layer places their tasks by
+// NUMA domain (CHPL_RT_NUMA_TASK_PLACEMENT).  With placement off the
+// tasking layer must not split tasks over NUMA domains at all.
+// numaTaskPlacementOff.chpl runs this with placement off.
+
+config const placement = true;
+config const n = 1 << 20;
+
+extern proc chpl_task_getNumNumaDomains(): int(32);
+extern proc chpl_topo_getNumNumaDomains(): c_int;
+
+const numDomains = chpl_task_getNumNumaDomains();
+if placement then
+  writeln(numDomains >= 1 && numDomains <= chpl_topo_getNumNumaDomains());
+else
+  writeln(numDomains == 1);
+
+var A, B: [1..n] real;
+forall i in A.domain do A[i] = i;
+forall (b, a) in zip(B, A) do b = 2 * a;
+writeln(+ reduce B == n * (n + 1.0));
+
+var C: [1..n] real;
+C = B;
+writeln(&& reduce (C == B));
+
+var count: atomic int;
+coforall t in 1..here.maxTaskPar do
+  count.add(1);
+writeln(count.read() == here.maxTaskPar);
@@ -0,0 +1,2 @@
+// Run numaTaskPlacement.chpl with CHPL_RT_NUMA_TASK_PLACEMENT off.
+use numaTaskPlacement;
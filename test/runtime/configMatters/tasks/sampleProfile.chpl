@@ -0,0 +1,20 @@
+// Run with the sampling profiler on, and check that samples inside
+// spin() are attributed to the coforall tasks that called it.
+
+use Time;
+
+// Burn about the given number of seconds of CPU time.
+proc spin(secs: real) {
+  var t: Timer;
+  var x = 0;
+  t.start();
+  while t.elapsed() < secs do
+    x += 1;
+  return x;
+}
+
+var total = 0;
+coforall i in 1..2 with (+ reduce total) do
+  total += spin(0.5);
+
+writeln(total > 0);
@@ -0,0 +1,4 @@
+// Per-task sampling profiles rely on tasks staying on one thread, so
+// they should be refused when the tasking layer can move them.
+
+writeln("should not get here");
@@ -0,0 +1,69 @@
+// Sleeps and timed sync/atomic waits, which park tasks on the runtime's
+// timer wheel.  Check that timeouts never fire early, and that a wait
+// satisfied before its deadline reports success.
+
+use Time;
+
+config const numSleepers = 100;
+config const nap = 0.2;
+
+proc elapsedAtLeast(t: Timer, secs: real) {
+  return t.elapsed() >= secs;
+}
+
+// Lots of concurrent sleepers
+{
+  var t: Timer;
+  t.start();
+  coforall i in 1..numSleepers do sleep(nap);
+  t.stop();
+  writeln("sleepers: ", elapsedAtLeast(t, nap));
+}
+
+// Sync var timeouts
+{
+  var s: sync int;
+  var v: int;
+  var t: Timer;
+
+  t.start();
+  const got = s.readFE(nap, v);
+  t.stop();
+  writeln("readFE on empty: ", got, " ", elapsedAtLeast(t, nap));
+
+  s = 5;
+  t.clear(); t.start();
+  const wrote = s.writeEF(6, nap);
+  t.stop();
+  writeln("writeEF on full: ", wrote, " ", elapsedAtLeast(t, nap));
+
+  writeln("readFF on full: ", s.readFF(nap, v), " ", v);
+  writeln("readFE on full: ", s.readFE(nap, v), " ", v);
+  writeln("writeEF on empty: ", s.writeEF(7, nap), " ", s.readXX());
+  s.reset();
+
+  cobegin with (ref v) {
+    writeln("readFE filled later: ", s.readFE(10.0, v), " ", v);
+    { sleep(nap); s = 8; }
+  }
+}
+
+// Atomic timeouts
+{
+  var a: atomic int;
+  var b: atomic bool;
+  var t: Timer;
+
+  t.start();
+  const got = a.waitFor(1, nap);
+  t.stop();
+  writeln("waitFor unset: ", got, " ", elapsedAtLeast(t, nap));
+
+  cobegin {
+    writeln("waitFor set later: ", b.waitFor(true, 10.0));
+    { sleep(nap); b.write(true); }
+  }
+
+  a.write(2);
+  writeln("waitFor already set: ", a.waitFor(2, 0.0));
+}
@@ -0,0 +1,94 @@
+// Remote atomic operations from every locale on variables owned by every
+// other locale.  With CHPL_NETWORK_ATOMICS=gasnet each of these is an
+// active message handled on the owning locale.
+
+config const n = 100;
+
+proc test(type t) {
+  var A: [LocaleSpace] atomic t;
+  var F: [LocaleSpace] atomic t;
+
+  // Every locale adds 1..n to every other locale's element, some with
+  // fetchAdd and some with add, then takes 1..n away again with sub.
+  coforall loc in Locales do on loc {
+    for i in 1..n {
+      for j in LocaleSpace {
+        if i % 2 == 0 then A[j].add(i:t);
+        else F[j].write(A[j].fetchAdd(i:t));
+      }
+    }
+  }
+  const total = (numLocales * n * (n + 1) / 2): t;
+  writeln(t:string, " add:      ", && reduce [a in A] a.read() == total);
+
+  coforall loc in Locales do on loc do
+    for j in LocaleSpace do
+      for i in 1..n do
+        if i % 2 == 0 then A[j].sub(i:t); else A[j].fetchSub(i:t);
+  writeln(t:string, " sub:      ", && reduce [a in A] a.read() == 0:t);
+
+  // Each locale claims its own slot on locale 0 exactly once.
+  A[0].write(0:t);
+  var claimed: [LocaleSpace] bool;
+  coforall loc in Locales do on loc {
+    const me = here.id: t;
+    var expected = me;
+    while !A[0].compareExchange(expected, me + 1:t) {
+      expected = me;
+      chpl_task_yield();
+    }
+    claimed[here.id] = true;
+  }
+  writeln(t:string, " cmpxchg:  ", A[0].read() == numLocales:t &&
+                                   && reduce claimed);
+
+  // exchange hands back the previous value.
+  for j in LocaleSpace do A[j].write(j:t);
+  var prev: [LocaleSpace] t;
+  coforall loc in Locales do on loc do
+    prev[here.id] = A[(here.id + 1) % numLocales].exchange(7:t);
+  writeln(t:string, " exchange: ",
+          && reduce [j in LocaleSpace] prev[j] == ((j + 1) % numLocales):t);
+}
+
+proc testBits(type t) {
+  var A: [LocaleSpace] atomic t;
+
+  coforall loc in Locales do on loc do
+    for j in LocaleSpace do
+      if here.id % 2 == 0 then A[j].or((1 << here.id):t);
+      else A[j].fetchOr((1 << here.id):t);
+  const all = ((1 << numLocales) - 1): t;
+  writeln(t:string, " or:       ", && reduce [a in A] a.read() == all);
+
+  coforall loc in Locales do on loc do
+    for j in LocaleSpace do
+      A[j].and(~((1 << here.id):t));
+  writeln(t:string, " and:      ", && reduce [a in A] a.read() == 0:t);
+
+  coforall loc in Locales do on loc do
+    for j in LocaleSpace do
+      A[j].xor((1 << here.id):t);
+  coforall loc in Locales do on loc do
+    for j in LocaleSpace do
+      A[j].fetchXor((1 << here.id):t);
+  writeln(t:string, " xor:      ", && reduce [a in A] a.read() == 0:t);
+}
+
+test(int(32));
+test(int(64));
+test(uint(32));
+test(uint(64));
+test(real);
+testBits(int(32));
+testBits(int(64));
+testBits(uint(32));
+testBits(uint(64));
+
+var B: [LocaleSpace] atomic bool;
+coforall loc in Locales do on loc do
+  B[(here.id + 1) % numLocales].testAndSet();
+writeln("bool testAndSet: ", && reduce [b in B] b.read());
+coforall loc in Locales do on loc do
+  B[(here.id + 1) % numLocales].clear();
+writeln("bool clear: ", && reduce [b in B] !b.read());
@@ -35,7 +35,9 @@
 #include <sys/stat.h>
 
 // C++ Libraries
+#include <algorithm>
 #include <set>
+#include <vector>
 
 #ifndef MAXPATHLEN
 #define MAXPATHLEN 2048
@@ -43,8 +45,8 @@
 
 #define MAX_LINE_LEN 1024
 
-#define EXPECTED_VMAJOR 1
-#define EXPECTED_VMINOR 3
+#define EXPECTED_VMAJOR 2
+#define EXPECTED_VMINOR 0
 
 void DataModel::newList()
 {
@@ -793,6 +795,75 @@ int DataModel::LoadData(const char * filename, bool fromArgv)
 }
 
 
+// Add newEvent to the list, group Starts, Tags, Resumes and Ends together.
+// Other events are inserted by time, starting at itr.
+
+void DataModel::insertEvent (Event *newEvent, std::list<Event *>::iterator &itr,
+                             const char *fileToOpen)
+{
+  if (theEvents.empty()) {
+    theEvents.push_front (newEvent);
+  } else if (itr == theEvents.end()) {
+    theEvents.insert(itr, newEvent);
+  } else {
+    if (newEvent->Ekind() <= Ev_end) {
+      // Group together
+      while (itr != theEvents.end()
+             && (*itr)->Ekind() != newEvent->Ekind())
+        itr++;
+      if (itr == theEvents.end() || (*itr)->Ekind() != newEvent->Ekind()) {
+        fprintf (stderr, "Internal error, event mismatch. file '%s'\n", fileToOpen); \
+        printf ("newEvent: "); newEvent->print();
+        if (itr != theEvents.end()) {
+           printf ("itr: "); (*itr)->print();
+        } else {
+           printf ("At end of list\n");
+        }
+      } else {
+        // More complicated ... move past proper kinds ...
+        E_tag *tp = NULL;
+        if (newEvent->Ekind() == Ev_start || newEvent->Ekind() == Ev_end) {
+          // Just find the end of the group
+          while (itr != theEvents.end() && (*itr)->Ekind() == newEvent->Ekind())
+            itr++;
+        } else {
+          // Need to move past them only if they have the same tag!
+          if (newEvent->Ekind() == Ev_tag) {
+            // Work with tags
+            tp = (E_tag *)newEvent;
+            while (itr != theEvents.end()
+                   && (*itr)->Ekind() == Ev_tag
+                   && ((E_tag *)(*itr))->tagNo() == tp->tagNo())
+              itr++;
+          } else {
+            // Work with pauses
+            E_pause *rp = (E_pause *)newEvent;
+            while (itr != theEvents.end()
+                   && (*itr)->Ekind() == Ev_pause
+                   && ((E_pause *)(*itr))->tagId() == rp->tagId())
+              itr++;
+          }
+        }
+        theEvents.insert (itr, newEvent);
+      }
+    } else {
+      // Insert by time
+      while (itr != theEvents.end() &&
+             (*itr)->Ekind() > Ev_end &&
+             **itr < *newEvent)
+        itr++;
+      theEvents.insert (itr, newEvent);
+    }
+  }
+}
+
+
+static bool recBefore (const vdebugRec &a, const vdebugRec &b)
+{
+  return a.time < b.time;
+}
+
+
 // Load the data in the current file
 
 int DataModel::LoadFile (const char *fileToOpen, int index, double seq)
@@ -840,8 +911,8 @@ int DataModel::LoadFile (const char *fileToOpen, int index, double seq)
   }
 
   // Task Ids of tasks know to be part of the VisualDebug workings.
-  int nid0vdbtask = 0;
-  std::set<int> vdbTids;
+  long nid0vdbtask = 0;
+  std::set<long> vdbTids;
   if (findex != 0)
     (void)vdbTids.insert(vdbTid);
 
@@ -851,7 +922,6 @@ int DataModel::LoadFile (const char *fileToOpen, int index, double seq)
   // Other initializations
   numTags = 0;
 
-  // Now read the rest of the file
   Event *newEvent = new E_start(e_sec, e_usec, findex, u_sec, u_usec, s_sec, s_usec);
   if (itr == theEvents.end()) {
     theEvents.push_front(newEvent);
@@ -861,386 +931,323 @@ int DataModel::LoadFile (const char *fileToOpen, int index, double seq)
     theEvents.insert(itr,newEvent);
   }
 
+  // Clock samples, used to convert record times to times of day
+  int numClocks = 0;
+  unsigned long long clockTicks[2] = {0, 0};
+  double clockTime[2] = {0, 0};
+
+  int recSize = 0;
+  Event *endEvent = NULL;
+
+  // Read the rest of the text file: tables, clock samples and the End record.
   while ( fgets(line, MAX_LINE_LEN, data) == line ) {
-    // Common Data
     char *linedata;
     long linelen;
     long sec;
     long usec;
     long nextCh;
-
-    // Data for tasks and comm and fork and filename
-    int nid;    // Node id
-    char onstr[5];  // "O" or "L" for onExecute or local
-    int ix; //
-    int commID;
+    int nid;
+    int ix;
     int nlineno; // line number starting the task
     int nfileno;  // file number, indexes fileTbl.
     char tmpname[512];  // File name for fileTbl and funcTbl
+    int tagId;
+    unsigned long long ticks;
 
-    // comm
-    int isGet;  // put (0), get (1)  currently ignoring non-block and strid
-    int rnid;   // remote id
-    long locAddr;  // local address
-    long remAddr;  // remote address
-    int eSize;     // element size
-    int typeIx;    // type Index
-    int dlen;      // data length
-
-    // fork & task
-    int fid;
-
-    // task
-    int taskid;
-    int parentId;
+    linedata = strchr(line, ':');
+    if (!linedata) {
+      nErrs++;
+      continue;
+    }
 
-    // Tags
-    int tagId;
-    int slen;
+    if ( (findex == 0) && ( (strstr(line,"Tablesize:") == line)
+                            || (strstr(line,"fname:") == line)
+                            || (strstr(line,"tname:") == line)
+                            || (strstr(line,"FID") == line)
+                            || (strstr(line,"CHPL_HOME:") == line)
+                            || (strstr(line,"DIR:") == line)
+                            || (strstr(line,"SAVEC:") == line) )) {
+      switch (line[0]) {
+      case 'T': // filename Table size
+        if (sscanf(linedata, ": %d", &fileTblSize) != 1) {
+          fl_alert("Data file content error");
+          exit(1);
+        } else {
+          fileTbl = new filename[fileTblSize];
+        }
+        break;
 
-    int cvt;
+      case 'f':  //  file name ... should only be in file 0
+        if (sscanf(linedata, ": %d %511s", &nfileno, tmpname) != 2) {
+          printf ("Bad filename record.\n");
+        } else {
+          assert (0 <= nfileno && nfileno < fileTblSize);
+          fileTbl[nfileno].name = strdup(tmpname);
+          fileTbl[nfileno].rel2Home = strstr(tmpname,"$CHPL_HOME/")
+                                        == tmpname;
+        }
+        break;
 
-    // Process the line
-    linedata = strchr(line, ':');
-    if (linedata) {
-      if ( (findex == 0) && ( (strstr(line,"Tablesize:") == line)
-                              || (strstr(line,"fname:") == line)
-                              || (strstr(line,"tname:") == line)
-                              || (strstr(line,"FID") == line)
-                              || (strstr(line,"CHPL_HOME:") == line)
-                              || (strstr(line,"DIR:") == line)
-                              || (strstr(line,"SAVEC:") == line) )) {
-        switch (line[0]) {
-        case 'T': // filename Table size
-          if (sscanf(linedata, ": %d", &fileTblSize) != 1) {
-            fl_alert("Data file content error");
-            exit(1);
-          } else {
-            fileTbl = new filename[fileTblSize];
+      case 'F':  // Function name record
+        if (line[3] == 'N') {
+          // FIDNsize record
+          if (sscanf(linedata, ": %d", &funcTblSize) != 1)
+            printf ("Bad FIDNsize record\n");
+          else {
+            funcTbl = new funcInfo[funcTblSize+1];
+            funcTbl[funcTblSize].name = strdup("Unknown");
           }
-          break;
-
-        case 'f':  //  file name ... should only be in file 0
-          if (sscanf(linedata, ": %d %511s", &nfileno, tmpname) != 2) {
-            printf ("Bad filename record.\n");
+        } else {
+          // FIDname record
+          if (sscanf(linedata, ": %d %d %d %511s",
+                     &ix, &nlineno, &nfileno, tmpname) != 4) {
+            printf ("Bad FIDname data.\n");
           } else {
-            assert (0 <= nfileno && nfileno < fileTblSize);
-            fileTbl[nfileno].name = strdup(tmpname);
-            fileTbl[nfileno].rel2Home = strstr(tmpname,"$CHPL_HOME/")
-                                          == tmpname;
+            funcTbl[ix].name = strdup(tmpname);
+            funcTbl[ix].fileNo = nfileno;
+            funcTbl[ix].lineNo = nlineno;
           }
-          break;
+        }
+        break;
 
-        case 'F':  // Function name record
-          if (line[3] == 'N') {
-            // FIDNsize record
-            if (sscanf(linedata, ": %d", &funcTblSize) != 1)
-              printf ("Bad FIDNsize record\n");
-            else {
-              funcTbl = new funcInfo[funcTblSize+1];
-              funcTbl[funcTblSize].name = strdup("Unknown");
-            }
-          } else {
-            // FIDname record
-            if (sscanf(linedata, ": %d %d %d %511s",
-                       &ix, &nlineno, &nfileno, tmpname) != 4) {
-              printf ("Bad FIDname data.\n");
-            } else {
-              funcTbl[ix].name = strdup(tmpname);
-              funcTbl[ix].fileNo = nfileno;
-              funcTbl[ix].lineNo = nlineno;
-            }
+      case 't':  // tag name, enter in the name cache and add it to a vector
+        if (sscanf(linedata, ": %d %ln", &tagId, &nextCh) != 1) {
+          printf ("bad tag name record\n");
+        } else {
+          int len = strlen(&linedata[nextCh])+nextCh-1;
+          while (linedata[len] == '\n' || linedata[len] == ' ')
+            linedata[len] = 0;
+          const char *tag = strDB.getString(&linedata[nextCh]);
+          while (tagNames.size() <= (unsigned)tagId) {
+            if (tagNames.size() == 0)
+              tagNames.resize(64);
+            else
+              tagNames.resize(2*tagNames.size());
           }
-          break;
+          tagNames[tagId] = tag;
+        }
+        break;
 
-        case 't':  // tag name, enter in the name cache and add it to a vector
-          if (sscanf(linedata, ": %d %ln", &tagId, &nextCh) != 1) {
-            printf ("bad tag name record\n");
-          } else {
-            int len = strlen(&linedata[nextCh])+nextCh-1;
-            while (linedata[len] == '\n' || linedata[len] == ' ')
-              linedata[len] = 0;
-            const char *tag = strDB.getString(&linedata[nextCh]);
-            if (tagNames.size() <= (unsigned)tagId) {
-              if (tagNames.size() == 0)
-                tagNames.resize(64);
-              else
-                tagNames.resize(2*tagNames.size());
-            }
-            tagNames[tagId] = tag;
-          }
-          break;
+      case 'C': // The CHPL_HOME variable at run time
+        linedata++;
+        while (*linedata == ' ') linedata++;
+        linelen = strlen(linedata);
+        if (linedata[linelen-1] == '\n')
+          linedata[linelen-1] = 0;
+        chpl_home = strdup (linedata);
+        break;
 
-        case 'C': // The CHPL_HOME variable at run time
-          linedata++;
-          while (*linedata == ' ') linedata++;
-          linelen = strlen(linedata);
-          if (linedata[linelen-1] == '\n')
-            linedata[linelen-1] = 0;
-          chpl_home = strdup (linedata);
-          break;
+      case 'D': // The runtime directory ...
+        linedata++;
+        while (*linedata == ' ') linedata++;
+        linelen = strlen(linedata);
+        if (linedata[linelen-1] == '\n')
+          linedata[linelen-1] = 0;
+        dir = strdup (linedata);
+        break;
 
-        case 'D': // The runtime directory ...
-          linedata++;
-          while (*linedata == ' ') linedata++;
-          linelen = strlen(linedata);
-          if (linedata[linelen-1] == '\n')
-            linedata[linelen-1] = 0;
-          dir = strdup (linedata);
-          break;
+      case 'S': // the --savec directory (might be an empty string!)
+        linedata++;
+        while (*linedata == ' ') linedata++;
+        linelen = strlen(linedata);
+        if (linedata[linelen-1] == '\n')
+          linedata[linelen-1] = 0;
+        savec = strdup (linedata);
+        break;
 
-        case 'S': // the --savec directory (might be an empty string!)
-          linedata++;
-          while (*linedata == ' ') linedata++;
-          linelen = strlen(linedata);
-          if (linedata[linelen-1] == '\n')
-            linedata[linelen-1] = 0;
-          savec = strdup (linedata);
-          break;
+      }
+      continue;
+    }
 
-        }
-        continue;
+    if (strstr(line, "Records:") == line) {
+      if (sscanf(linedata, ": %d", &recSize) != 1)
+        nErrs++;
+    } else if (strstr(line, "Clock:") == line) {
+      if (sscanf(linedata, ": %llu %ld.%ld", &ticks, &sec, &usec) != 3) {
+        nErrs++;
+      } else if (numClocks < 2) {
+        clockTicks[numClocks] = ticks;
+        clockTime[numClocks] = sec + usec / 1e6;
+        numClocks++;
       } else {
-        if (sscanf (linedata, ": %ld.%ld%ln", &sec, &usec, &nextCh) != 2) {
-          printf ("Can't read time from '%s'\n", line);
-          nErrs++;
-          continue;
-        }
+        // Keep the first and the last sample
+        clockTicks[1] = ticks;
+        clockTime[1] = sec + usec / 1e6;
+      }
+    } else if (strstr(line, "Dropped:") == line) {
+      unsigned long long dropped;
+      if (sscanf(linedata, ": %llu", &dropped) != 1)
+        nErrs++;
+      else
+        fprintf (stderr, "%s: %llu events were dropped while logging, "
+                 "the data is incomplete.\n", fileToOpen, dropped);
+    } else if (strstr(line, "End:") == line) {
+      if (sscanf (linedata, ": %ld.%ld %ld.%ld %ld.%ld %d %d",
+                  &sec, &usec, &u_sec, &u_usec, &s_sec, &s_usec,
+                  &nid, &vdbTid) != 8 ) {
+        fprintf (stderr, "Bad 'End' line: %s\n", fileToOpen);
+        nErrs++;
+      } else {
+        endEvent = new E_end(sec, usec, nid, u_sec, u_usec, s_sec, s_usec,
+                             vdbTid);
       }
-    } else {
-      nErrs++;
-      continue;
     }
+  }
+
+  if ( !feof(data) ) {
+    fclose(data);
+    return 0;
+  }
+  fclose(data);
+
+  if (recSize != sizeof(vdebugRec) || numClocks == 0) {
+    fprintf (stderr, "Data file %s has no usable record information.\n",
+             fileToOpen);
+    return 0;
+  }
 
+  // Ticks per second, from the clock samples taken at start and stop
+  double tickRate = 1e9;
+  if (numClocks == 2 && clockTicks[1] > clockTicks[0]
+      && clockTime[1] > clockTime[0])
+    tickRate = (clockTicks[1] - clockTicks[0]) / (clockTime[1] - clockTime[0]);
+
+  // Read the binary event records.  Each thread buffers its own records,
+  // so they are in time order only within a thread; sort them.
+  std::vector<vdebugRec> recs;
+  {
+    char binName[MAXPATHLEN];
+    vdebugRec rec;
+    snprintf (binName, MAXPATHLEN, "%s.bin", fileToOpen);
+    FILE *bin = fopen(binName, "rb");
+    if (!bin) {
+      fprintf (stderr, "Could not open %s.\n", binName);
+      return 0;
+    }
+    while (fread(&rec, sizeof(rec), 1, bin) == 1)
+      recs.push_back(rec);
+    fclose(bin);
+  }
+  std::stable_sort(recs.begin(), recs.end(), recBefore);
+
+  for (size_t rx = 0; rx < recs.size(); rx++) {
+    const vdebugRec &r = recs[rx];
+    double when = clockTime[0] + ((double)r.time - (double)clockTicks[0]) / tickRate;
+    long sec = (long) floor(when);
+    long usec = (long) ((when - sec) * 1e6);
+    long taskid = (long) r.task;
+    int nfileno;
+    int fid;
+    int isGet;
 
     newEvent = NULL;
 
-    switch (line[0]) {
+    switch (r.kind) {
 
-      case 0:  // Bug in output???
-        nErrs++;
+      case Vk_mark: // mark the taskID as being a vdbTask
+        if (findex == 0)
+          nid0vdbtask = taskid;
+        else
+          (void)vdbTids.insert(taskid);
         break;
 
-      case 'V': // VdbMark ... mark the taskID as being a vdbTask
-        if (sscanf (&linedata[nextCh], "%d %d",
-                    &nid, &taskid) != 2) {
-          fprintf (stderr, "Bad VdbMark Line\n");
+      case Vk_task:  // new task, r.task is the parent
+        // On tasks are not real children of VDebug tasks
+        if (!r.aux2 && (vdbTids.find(taskid) != vdbTids.end()
+                        || (findex == 0 && taskid == nid0vdbtask))) {
+          // new task is also a vdbtask
+          (void)vdbTids.insert((long) r.addr);
         } else {
-          if (nid == 0)
-            nid0vdbtask = taskid;
-          else
-            (void)vdbTids.insert(taskid);
+          nfileno = r.filename;
+          if (nfileno < 0 || nfileno >= fileTblSize) nfileno = 0;
+          fid = r.aux < 0 ? 0 : r.aux;
+          newEvent = new E_task (sec, usec, findex, (long) r.addr, fid,
+                                 r.aux2 != 0, r.lineno, nfileno);
         }
         break;
 
-      case 't':  // new task line
-        //  task: s.u nodeID taskID O/L lineno fileno funcID
-        if (sscanf (&linedata[nextCh], "%d %d %d %4s %d %d %d",
-                    &nid, &taskid, &parentId, onstr, &nlineno, &nfileno,
-                    &fid) != 7) {
-          fprintf (stderr, "Bad task line: %s\n", fileToOpen);
-          fprintf (stderr, "nid = %d, taskid = %d, nbstr = '%s', nlineno = %d"
-                   " nfileno = '%d'\n", nid, taskid, onstr, nlineno, nfileno);
-          nErrs++;
-        } else {
-          // On tasks ('O' for the onstr) are not real children of VDebug tasks
-          if (onstr[0] != 'O' && (vdbTids.find(parentId) != vdbTids.end()
-                                  || (nid == 0 && parentId == nid0vdbtask))) {
-            // new task (taskid) is also a vdbtask
-            (void)vdbTids.insert(taskid);
-          } else {
-            if (nfileno < 0 || nfileno >= fileTblSize) nfileno = 0;
-            if (fid < 0) 
-              { fid = 0; }
-            newEvent = new E_task (sec, usec, nid, taskid, fid, onstr[0] == 'O',
-                                   nlineno, nfileno);
-          }
-
+      case Vk_put_nb:
+      case Vk_get_nb:
+      case Vk_put_strd:
+      case Vk_get_strd:
+      case Vk_get:
+      case Vk_put:
+        if (vdbTids.find(taskid) != vdbTids.end()) {
+          // Ignore this comm as being part of the xxxVdebug system
+          break;
         }
+        nfileno = r.filename;
+        if (nfileno < 0 || nfileno >= fileTblSize) nfileno = 0;
+        isGet = (r.kind == Vk_get || r.kind == Vk_get_nb
+                 || r.kind == Vk_get_strd);
+        if (isGet)
+          newEvent = new E_comm (sec, usec, r.rnode, findex, r.aux, r.size,
+                                 isGet, taskid, r.lineno, nfileno);
+        else
+          newEvent = new E_comm (sec, usec, findex, r.rnode, r.aux, r.size,
+                                 isGet, taskid, r.lineno, nfileno);
         break;
 
-      case 'n':  // non-blocking put or get
-      case 's':  // strid put or get
-      case 'g':  // regular get
-      case 'p':  // regular put
-        // All comm data:
-        // s.u nodeID otherNode loc-addr rem-addr elemSize typeIndex len commID lineno fileToOpen
-        if (sscanf (&linedata[nextCh], "%d %d %d 0x%lx 0x%lx %d %d %d %d %d %d",
-                    &nid, &rnid, &taskid, &locAddr, &remAddr, &eSize, & typeIx, &dlen,
-                    &commID, &nlineno, &nfileno) != 11) {
-          fprintf (stderr, "Bad comm line: %s\n  '%s'\n", fileToOpen, line);
-          nErrs++;
-        } else {
-          if (vdbTids.find(taskid) != vdbTids.end()) {
-            // Ignore this comm as being part of the xxxVdebug system
-            break;
-          }
-          if (nfileno < 0 || nfileno >= fileTblSize) nfileno = 0;
-          isGet = (line[0] == 'g' ? 1 :
-                   line[0] == 'p' ? 0 :
-                   line[3] == 'g' ? 1 : 0);
-          if (isGet)
-            newEvent = new E_comm (sec, usec, rnid, nid, eSize, dlen, isGet, taskid, nlineno,
-                                   nfileno);
-          else
-            newEvent = new E_comm (sec, usec, nid, rnid, eSize, dlen, isGet, taskid, nlineno,
-                                   nfileno);
-          //newEvent->print();
+      case Vk_fork:
+      case Vk_fork_nb:
+      case Vk_fork_fast:
+        if (vdbTids.find(taskid) != vdbTids.end()) {
+          break;
         }
+        fid = r.aux < 0 ? 0 : r.aux;
+        newEvent = new E_fork(sec, usec, findex, r.rnode, r.size,
+                              r.kind == Vk_fork_fast, taskid, fid);
         break;
 
-      case 'f':  // All the forks:
-        // s.u nodeID otherNode subloc fid arg arg_size
-        if ((cvt = sscanf (&linedata[nextCh], "%d %d %*d %d 0x%*x %d %d",
-                           &nid, &rnid, &fid, &dlen, &vdbTid)) != 5) {
-          fprintf (stderr, "Bad fork line: (cvt %d) %s\n", cvt, fileToOpen);
-          nErrs++;
-        } else {
-          if (vdbTids.find(vdbTid) != vdbTids.end()) {
-            break;
-          }
-          if (fid < 0) fid = 0;
-          newEvent = new E_fork(sec, usec, nid, rnid, dlen, line[1] == '_',
-                                vdbTid, fid);
-        }
+      case Vk_pause:  // Pause generating data
+        newEvent = new E_pause(sec, usec, findex,
+                               r.addr / 1000000, r.addr % 1000000,
+                               r.raddr / 1000000, r.raddr % 1000000,
+                               r.aux, taskid);
+        if (findex == 0)
+          nid0vdbtask = 0;
         break;
 
-      case 'P':  // Pause generating data
-        if (sscanf (&linedata[nextCh], "%ld.%ld %ld.%ld %d %d %d",
-                    &u_sec, &u_usec, &s_sec, &s_usec, &nid, &vdbTid, &tagId) != 7 ) {
-          fprintf (stderr, "Bad 'End' line: %s\n", fileToOpen);
+      case Vk_tag:  // Tag in the data
+        if (r.aux < 0 || (unsigned) r.aux >= tagNames.size()) {
+          fprintf (stderr, "Bad tag record: %s\n", fileToOpen);
           nErrs++;
-        } else {
-          newEvent = new E_pause(sec, usec, nid, u_sec, u_usec,
-                                 s_sec, s_usec, tagId, vdbTid);
-          if (nid == 0)
-            nid0vdbtask = 0;
+          break;
         }
-        break;
-
-      case 'T':  // Tag in the data
-        slen = strlen(line)-1;
-        if (line[slen] == '\n') line[slen] = 0;
-        if (sscanf (&linedata[nextCh], "%ld.%ld %ld.%ld %d %d %d",
-                    &u_sec, &u_usec, &s_sec, &s_usec, &nid, &vdbTid, &tagId)
-            != 7) {
-          fprintf (stderr, "Bad 'Tag' line: %s\n", fileToOpen);
-        } else {
-          newEvent = new E_tag(sec, usec, nid, u_sec, u_usec, s_sec, s_usec, tagId,
-                               tagNames[tagId], vdbTid);
-          if (tagId >= numTags)
-            numTags = tagId+1;
-          if (nid == 0) {
-            nid0vdbtask = 0;
-          }
+        newEvent = new E_tag(sec, usec, findex,
+                             r.addr / 1000000, r.addr % 1000000,
+                             r.raddr / 1000000, r.raddr % 1000000,
+                             r.aux, tagNames[r.aux], taskid);
+        if (r.aux >= numTags)
+          numTags = r.aux+1;
+        if (findex == 0) {
+          nid0vdbtask = 0;
         }
         break;
 
-      case 'E':  // end of the file or End of task
-        if (line[1] == 'n') {
-          // End of file
-          if (sscanf (&linedata[nextCh], "%ld.%ld %ld.%ld %d %d",
-                      &u_sec, &u_usec, &s_sec, &s_usec, &nid, &vdbTid) != 6 ) {
-            fprintf (stderr, "Bad 'End' line: %s\n", fileToOpen);
-            nErrs++;
-          } else {
-            newEvent = new E_end(sec, usec, nid, u_sec, u_usec, s_sec, s_usec, vdbTid);
-          }
-        } else {
-          // End of task
-          // printf("E");
-          if (sscanf (&linedata[nextCh], "%d %d",
-                      &nid, &taskid ) != 2) {
-            fprintf (stderr, "Bad Etask line: %s\n", fileToOpen);
-            nErrs++;
-          } else {
-            if (vdbTids.find(taskid) == vdbTids.end()) {
-              newEvent = new E_end_task(sec, usec, nid, taskid);
-            } else {
-              //printf ("end vdb tid: %d\n", taskid);
-            }
-          }
+      case Vk_end:  // End of task
+        if (vdbTids.find(taskid) == vdbTids.end()) {
+          newEvent = new E_end_task(sec, usec, findex, taskid);
         }
         break;
 
-      case 'B':  // Begin of task
-        if (sscanf (&linedata[nextCh], "%d %d",
-                    &nid, &taskid ) != 2) {
-          fprintf (stderr, "Bad Etask line: %s\n", fileToOpen);
-          nErrs++;
-        } else {
-          if (vdbTids.find(taskid) == vdbTids.end()) {
-            newEvent = new E_begin_task(sec, usec, nid, taskid);
-          }
+      case Vk_begin:  // Begin of task
+        if (vdbTids.find(taskid) == vdbTids.end()) {
+          newEvent = new E_begin_task(sec, usec, findex, taskid);
         }
         break;
 
       default:
-        /* Do nothing */ ;
+        nErrs++;
     }
 
-    //  Add the newEvent to the list, group Starts, Tags, Resumes and Ends together.
-    if (newEvent) {
-      if (theEvents.empty()) {
-        theEvents.push_front (newEvent);
-      } else if (itr == theEvents.end()) {
-        theEvents.insert(itr, newEvent);
-      } else {
-        if (newEvent->Ekind() <= Ev_end) {
-          // Group together
-          while (itr != theEvents.end()
-                 && (*itr)->Ekind() != newEvent->Ekind())
-            itr++;
-          if (itr == theEvents.end() || (*itr)->Ekind() != newEvent->Ekind()) {
-            fprintf (stderr, "Internal error, event mismatch. file '%s'\n", fileToOpen); \
-            printf ("newEvent: "); newEvent->print();
-            if (itr != theEvents.end()) {
-               printf ("itr: "); (*itr)->print();
-            } else {
-               printf ("At end of list\n");
-            }
-          } else {
-            // More complicated ... move past proper kinds ...
-            E_tag *tp = NULL;
-            if (newEvent->Ekind() == Ev_start || newEvent->Ekind() == Ev_end) {
-              // Just find the end of the group
-              while (itr != theEvents.end() && (*itr)->Ekind() == newEvent->Ekind())
-                itr++;
-            } else {
-              // Need to move past them only if they have the same tag!
-              if (newEvent->Ekind() == Ev_tag) {
-                // Work with tags
-                tp = (E_tag *)newEvent;
-                while (itr != theEvents.end()
-                       && (*itr)->Ekind() == Ev_tag
-                       && ((E_tag *)(*itr))->tagNo() == tp->tagNo())
-                  itr++;
-              } else {
-                // Work with pauses
-                E_pause *rp = (E_pause *)newEvent;
-                while (itr != theEvents.end()
-                       && (*itr)->Ekind() == Ev_pause
-                       && ((E_pause *)(*itr))->tagId() == rp->tagId())
-                  itr++;
-              }
-            }
-            /*std::list<Event*>::iterator newElem = */ theEvents.insert (itr, newEvent);
-            //      if (tp != NULL && tp->nodeId() == 0) {
-            //        tagVec[tp->tagNo()-1] = newElem;
-            //      }
-          }
-        } else {
-          // Insert by time
-          while (itr != theEvents.end() &&
-                 (*itr)->Ekind() > Ev_end &&
-                 **itr < *newEvent)
-            itr++;
-          theEvents.insert (itr, newEvent);
-        }
-      }
-    }
+    if (newEvent)
+      insertEvent(newEvent, itr, fileToOpen);
   }
 
+  if (endEvent)
+    insertEvent(endEvent, itr, fileToOpen);
+
   // Remove any task or Btask records that are in the vdbTids db.
   itr = theEvents.begin();
   while (itr != theEvents.end()) {
@@ -1273,13 +1280,6 @@ int DataModel::LoadFile (const char *fileToOpen, int index, double seq)
 
   if (nErrs) fprintf(stderr, "%d errors in data file '%s'.\n", nErrs, fileToOpen);
 
-  //  if (ignoreFork > 0 || ignoreTask > 0) {
-  //    fprintf (stderr, "%s: Error in data filters: ignoreFork = %d, ignoreTask = %d\n",
-  //         fileToOpen, ignoreFork, ignoreTask);
-  //  }
-
-  if ( !feof(data) ) return 0;
-
   return 1;
 }
 
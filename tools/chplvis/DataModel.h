@@ -21,6 +21,7 @@
 #define DATAMODEL_H
 
 #include "Event.h"
+#include <stdint.h>
 #include <list>
 #include <vector>
 #include <map>
@@ -34,12 +35,36 @@
 // This is the class that reads the files as generated by runtime/src/chpl-visual-debug.c
 // in the Chapel runtime.
 //
-// Initially the data files are in ascii.  To turn these into binary data files,
-// both this class and runtime/src/chpl-visual-debug.c need to be modified to
-// write (chpl-visual-debug.c) and read (this class) in binary.
+// Each locale has a text file with the header, name tables, clock samples
+// and End record, and a .bin file of fixed-size event records.  The format
+// is described in DataFormat.txt.
 
 // Support Structs used by DataModel
 
+// One binary event record.  This and vdebugKind must match chpl_vdebug_rec_t
+// and chpl_vdebug_kind_t in runtime/include/chpl-visual-debug.h.
+struct vdebugRec {
+  uint64_t time;
+  uint64_t task;
+  uint64_t addr;
+  uint64_t raddr;
+  uint64_t size;
+  uint16_t kind;
+  uint16_t pad;
+  int32_t  rnode;
+  int32_t  aux;
+  int32_t  aux2;
+  int32_t  lineno;
+  int32_t  filename;
+};
+
+enum vdebugKind {
+  Vk_task = 1, Vk_begin, Vk_end,
+  Vk_put, Vk_get, Vk_put_nb, Vk_get_nb, Vk_put_strd, Vk_get_strd,
+  Vk_fork, Vk_fork_nb, Vk_fork_fast,
+  Vk_mark, Vk_tag, Vk_pause
+};
+
 // Used to track communication,  each tag has a 2D array of commData, one for each direction
 struct commData {
   long numComms;
@@ -164,6 +189,9 @@ class DataModel {
   // Utility routines
   
   int LoadFile (const char *filename, int index, double seq);
+
+  void insertEvent (Event *newEvent, std::list<Event *>::iterator &itr,
+                    const char *fileToOpen);
   
   void newList ();
   
@@ -0,0 +1,185 @@
+#!/usr/bin/env python
+
+#
+# Copyright 2004-2018 Cray Inc.
+# Other additional copyright holders may be indicated within.
+#
+# The entirety of this work is licensed under the Apache License,
+# Version 2.0 (the "License"); you may not use this file except
+# in compliance with the License.
+#
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+from __future__ import print_function
+
+""" Convert VisualDebug data files to the Chrome trace event JSON format.
+
+The output can be loaded by chrome://tracing or by the Perfetto UI.  Each
+locale becomes a process and each task a thread; tasks are shown as
+duration slices named by their function, and communication, forks and
+tags as instant events.
+
+Usage: vdebug2trace.py <dir-or-file> [output.json]
+
+The data files are described in DataFormat.txt.
+"""
+
+import json
+import os
+import struct
+import sys
+
+# Must match chpl_vdebug_rec_t in runtime/include/chpl-visual-debug.h
+REC_FORMAT = '=QQQQQHHiiiii'
+REC_SIZE = struct.calcsize(REC_FORMAT)
+
+KIND_NAMES = {
+    1: 'task', 2: 'begin', 3: 'end',
+    4: 'put', 5: 'get', 6: 'put_nb', 7: 'get_nb',
+    8: 'put_strd', 9: 'get_strd',
+    10: 'fork', 11: 'fork_nb', 12: 'fork_fast',
+    13: 'mark', 14: 'tag', 15: 'pause',
+}
+
+COMM_KINDS = set(range(4, 10))
+FORK_KINDS = set(range(10, 13))
+
+
+def parse_time(s):
+    sec, usec = s.split('.')
+    return int(sec) + int(usec) / 1e6
+
+
+class LocaleData(object):
+    """ The text and binary files of one locale. """
+
+    def __init__(self, textfile):
+        self.clocks = []
+        self.tagnames = {}
+        self.funcs = {}
+        self.files = {}
+        self.records = []
+        with open(textfile) as f:
+            first = f.readline().split()
+            if first[0] != 'ChplVdebug:' or not first[2].startswith('2.'):
+                raise ValueError('%s: not a version 2 VisualDebug file'
+                                 % textfile)
+            self.numLocales = int(first[4])
+            self.nid = int(first[6])
+            for line in f:
+                fields = line.split()
+                if not fields:
+                    continue
+                if fields[0] == 'Clock:':
+                    self.clocks.append((int(fields[1]), parse_time(fields[2])))
+                elif fields[0] == 'tname:':
+                    self.tagnames[int(fields[1])] = ' '.join(fields[2:])
+                elif fields[0] == 'FIDname:':
+                    self.funcs[int(fields[1])] = fields[4]
+                elif fields[0] == 'fname:':
+                    self.files[int(fields[1])] = fields[2]
+                elif fields[0] == 'Dropped:':
+                    print('%s: %s events were dropped while logging, '
+                          'the data is incomplete' % (textfile, fields[1]),
+                          file=sys.stderr)
+        with open(textfile + '.bin', 'rb') as f:
+            data = f.read()
+        for off in range(0, len(data) - REC_SIZE + 1, REC_SIZE):
+            self.records.append(struct.unpack_from(REC_FORMAT, data, off))
+
+    def to_seconds(self, ticks):
+        """ Convert record ticks to a time of day using the clock samples. """
+        t0, w0 = self.clocks[0]
+        rate = 1e9
+        if len(self.clocks) > 1:
+            t1, w1 = self.clocks[-1]
+            if t1 > t0 and w1 > w0:
+                rate = (t1 - t0) / (w1 - w0)
+        return w0 + (ticks - t0) / rate
+
+
+def load(path):
+    if os.path.isdir(path):
+        base = os.path.join(path, os.path.basename(os.path.normpath(path)))
+    else:
+        base = path[:path.rindex('-')]
+    first = LocaleData(base + '-0')
+    locales = [first]
+    for i in range(1, first.numLocales):
+        locales.append(LocaleData('%s-%d' % (base, i)))
+    return locales
+
+
+def convert(locales):
+    names = locales[0]
+    events = []
+    start = min([loc.clocks[0][1] for loc in locales])
+
+    def us(loc, ticks):
+        return (loc.to_seconds(ticks) - start) * 1e6
+
+    for loc in locales:
+        pid = loc.nid
+        events.append({'ph': 'M', 'name': 'process_name', 'pid': pid,
+                       'args': {'name': 'locale %d' % pid}})
+        taskFunc = {}
+        for rec in sorted(loc.records, key=lambda r: r[0]):
+            (time, task, addr, raddr, size, kind, _,
+             rnode, aux, aux2, lineno, filename) = rec
+            ts = us(loc, time)
+            name = KIND_NAMES.get(kind, 'unknown')
+            if kind == 1:
+                taskFunc[addr] = names.funcs.get(aux, 'task')
+            elif kind == 2:
+                events.append({'ph': 'B', 'pid': pid, 'tid': task, 'ts': ts,
+                               'name': taskFunc.get(task, 'task')})
+            elif kind == 3:
+                events.append({'ph': 'E', 'pid': pid, 'tid': task, 'ts': ts})
+            elif kind in COMM_KINDS:
+                events.append({'ph': 'i', 's': 't', 'pid': pid, 'tid': task,
+                               'ts': ts, 'name': name, 'cat': 'comm',
+                               'args': {'remote': rnode, 'length': size,
+                                        'elemSize': aux,
+                                        'line': lineno,
+                                        'file': names.files.get(filename,
+                                                                '')}})
+            elif kind in FORK_KINDS:
+                events.append({'ph': 'i', 's': 't', 'pid': pid, 'tid': task,
+                               'ts': ts, 'name': name, 'cat': 'fork',
+                               'args': {'remote': rnode, 'argSize': size,
+                                        'function': names.funcs.get(aux,
+                                                                    '')}})
+            elif kind in (14, 15):
+                label = names.tagnames.get(aux, str(aux))
+                if kind == 15:
+                    label = 'pause ' + label
+                events.append({'ph': 'i', 's': 'p', 'pid': pid, 'tid': task,
+                               'ts': ts, 'name': label, 'cat': 'tag'})
+    return {'traceEvents': events, 'displayTimeUnit': 'ns'}
+
+
+def main(argv):
+    if len(argv) < 2 or len(argv) > 3:
+        print('usage: %s <dir-or-file> [output.json]' % argv[0],
+              file=sys.stderr)
+        return 1
+    trace = convert(load(argv[1]))
+    if len(argv) == 3:
+        with open(argv[2], 'w') as f:
+            json.dump(trace, f)
+    else:
+        json.dump(trace, sys.stdout)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))